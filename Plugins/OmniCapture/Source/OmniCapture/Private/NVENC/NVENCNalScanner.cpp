@@ -0,0 +1,350 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NVENC/NVENCNalScanner.h"
+
+#include "Algo/BinarySearch.h"
+#include "Dom/JsonObject.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Base64.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+#include <cstring>
+
+DEFINE_LOG_CATEGORY_STATIC(LogNVENCNalScanner, Log, All);
+
+namespace OmniNVENC
+{
+    namespace
+    {
+        constexpr int64 GCopyChunkBytes = 8 * 1024 * 1024;
+        const uint8 GStartCode[] = { 0x00, 0x00, 0x00, 0x01 };
+    }
+
+    int64 FNVENCNalScanner::FindStartCode(const uint8* Data, int64 Size, int64 From, int32* OutStartCodeSize)
+    {
+        // 0x01 is rare in coded slices, so letting memchr skip to it is much faster than testing every byte for zero.
+        int64 Position = From + 2;
+        while (Position < Size)
+        {
+            const uint8* Hit = static_cast<const uint8*>(std::memchr(Data + Position, 0x01, static_cast<size_t>(Size - Position)));
+            if (!Hit)
+            {
+                return INDEX_NONE;
+            }
+
+            const int64 One = Hit - Data;
+            if (Data[One - 1] == 0 && Data[One - 2] == 0)
+            {
+                int64 Start = One - 2;
+                int32 StartCodeSize = 3;
+                if (Start > From && Data[Start - 1] == 0)
+                {
+                    --Start;
+                    StartCodeSize = 4;
+                }
+                if (OutStartCodeSize)
+                {
+                    *OutStartCodeSize = StartCodeSize;
+                }
+                return Start;
+            }
+            Position = One + 1;
+        }
+        return INDEX_NONE;
+    }
+
+    ENVENCNalKind FNVENCNalScanner::Classify(ENVENCCodec Codec, const uint8* Nal, int64 Size, uint8* OutType)
+    {
+        if (Size <= 0)
+        {
+            return ENVENCNalKind::Other;
+        }
+
+        if (Codec == ENVENCCodec::HEVC)
+        {
+            const uint8 Type = (Nal[0] >> 1) & 0x3F;
+            if (OutType)
+            {
+                *OutType = Type;
+            }
+            if (Type <= 9)
+            {
+                return ENVENCNalKind::Slice;
+            }
+            if (Type >= 16 && Type <= 21)
+            {
+                return ENVENCNalKind::KeySlice;
+            }
+            switch (Type)
+            {
+            case 32: return ENVENCNalKind::VPS;
+            case 33: return ENVENCNalKind::SPS;
+            case 34: return ENVENCNalKind::PPS;
+            case 35: return ENVENCNalKind::AccessUnitDelimiter;
+            case 39:
+            case 40: return ENVENCNalKind::SEI;
+            default: return ENVENCNalKind::Other;
+            }
+        }
+
+        const uint8 Type = Nal[0] & 0x1F;
+        if (OutType)
+        {
+            *OutType = Type;
+        }
+        switch (Type)
+        {
+        case 1:
+        case 2:
+        case 3:
+        case 4: return ENVENCNalKind::Slice;
+        case 5: return ENVENCNalKind::KeySlice;
+        case 6: return ENVENCNalKind::SEI;
+        case 7: return ENVENCNalKind::SPS;
+        case 8: return ENVENCNalKind::PPS;
+        case 9: return ENVENCNalKind::AccessUnitDelimiter;
+        default: return ENVENCNalKind::Other;
+        }
+    }
+
+    void FNVENCNalScanner::ForEachNalUnit(TConstArrayView<uint8> Data, ENVENCCodec Codec, TFunctionRef<void(const FNVENCNalUnit&)> Visitor)
+    {
+        const uint8* Bytes = Data.GetData();
+        const int64 Size = Data.Num();
+
+        int32 StartCodeSize = 0;
+        int64 StartCode = FindStartCode(Bytes, Size, 0, &StartCodeSize);
+        while (StartCode != INDEX_NONE)
+        {
+            const int64 PayloadStart = StartCode + StartCodeSize;
+            int32 NextStartCodeSize = 0;
+            const int64 NextStartCode = FindStartCode(Bytes, Size, PayloadStart, &NextStartCodeSize);
+
+            int64 PayloadEnd = NextStartCode == INDEX_NONE ? Size : NextStartCode;
+            while (PayloadEnd > PayloadStart && Bytes[PayloadEnd - 1] == 0)
+            {
+                --PayloadEnd;
+            }
+
+            if (PayloadEnd > PayloadStart)
+            {
+                FNVENCNalUnit Unit;
+                Unit.Payload = TConstArrayView<uint8>(Bytes + PayloadStart, static_cast<int32>(PayloadEnd - PayloadStart));
+                Unit.Offset = PayloadStart;
+                Unit.Kind = Classify(Codec, Unit.Payload.GetData(), Unit.Payload.Num(), &Unit.Type);
+                Visitor(Unit);
+            }
+
+            StartCode = NextStartCode;
+            StartCodeSize = NextStartCodeSize;
+        }
+    }
+
+    int32 FNVENCNalScanner::Scan(TConstArrayView<uint8> Data, ENVENCCodec Codec, TArray<FNVENCNalUnit>& OutUnits)
+    {
+        OutUnits.Reset();
+        ForEachNalUnit(Data, Codec, [&OutUnits](const FNVENCNalUnit& Unit)
+        {
+            OutUnits.Add(Unit);
+        });
+        return OutUnits.Num();
+    }
+
+    bool FNVENCParameterSets::Add(const FNVENCNalUnit& Unit)
+    {
+        TArray<TArray<uint8>>* Target = nullptr;
+        switch (Unit.Kind)
+        {
+        case ENVENCNalKind::VPS: Target = &VPS; break;
+        case ENVENCNalKind::SPS: Target = &SPS; break;
+        case ENVENCNalKind::PPS: Target = &PPS; break;
+        default: return false;
+        }
+
+        for (const TArray<uint8>& Existing : *Target)
+        {
+            if (Existing.Num() == Unit.Payload.Num() && FMemory::Memcmp(Existing.GetData(), Unit.Payload.GetData(), Unit.Payload.Num()) == 0)
+            {
+                return true;
+            }
+        }
+        Target->Emplace(Unit.Payload.GetData(), Unit.Payload.Num());
+        return true;
+    }
+
+    bool FNVENCParameterSets::IsComplete(ENVENCCodec Codec) const
+    {
+        return SPS.Num() > 0 && PPS.Num() > 0 && (Codec != ENVENCCodec::HEVC || VPS.Num() > 0);
+    }
+
+    void FNVENCParameterSets::Reset()
+    {
+        VPS.Reset();
+        SPS.Reset();
+        PPS.Reset();
+    }
+
+    TArray<uint8> FNVENCParameterSets::ToAnnexB() const
+    {
+        TArray<uint8> Result;
+        for (const TArray<TArray<uint8>>* Sets : { &VPS, &SPS, &PPS })
+        {
+            for (const TArray<uint8>& Set : *Sets)
+            {
+                Result.Append(GStartCode, UE_ARRAY_COUNT(GStartCode));
+                Result.Append(Set);
+            }
+        }
+        return Result;
+    }
+
+    void FNVENCBitstreamIndex::Reset(ENVENCCodec InCodec)
+    {
+        Codec = InCodec;
+        AccessUnitCount = 0;
+        EndOffset = 0;
+        Keyframes.Reset();
+        ParameterSets.Reset();
+    }
+
+    void FNVENCBitstreamIndex::AddCodecConfig(TConstArrayView<uint8> AnnexB)
+    {
+        FNVENCNalScanner::ForEachNalUnit(AnnexB, Codec, [this](const FNVENCNalUnit& Unit)
+        {
+            ParameterSets.Add(Unit);
+        });
+    }
+
+    bool FNVENCBitstreamIndex::AddAccessUnit(TConstArrayView<uint8> AccessUnit, int64 ByteOffset)
+    {
+        bool bKeyframe = false;
+        FNVENCNalScanner::ForEachNalUnit(AccessUnit, Codec, [this, &bKeyframe](const FNVENCNalUnit& Unit)
+        {
+            bKeyframe |= Unit.Kind == ENVENCNalKind::KeySlice;
+            ParameterSets.Add(Unit);
+        });
+
+        if (bKeyframe)
+        {
+            FNVENCKeyframeEntry& Entry = Keyframes.AddDefaulted_GetRef();
+            Entry.AccessUnit = AccessUnitCount;
+            Entry.ByteOffset = ByteOffset;
+        }
+
+        ++AccessUnitCount;
+        EndOffset = FMath::Max(EndOffset, ByteOffset + AccessUnit.Num());
+        return bKeyframe;
+    }
+
+    const FNVENCKeyframeEntry* FNVENCBitstreamIndex::FindKeyframeAtOrBefore(int64 AccessUnit) const
+    {
+        const int32 UpperBound = Algo::UpperBoundBy(Keyframes, AccessUnit, &FNVENCKeyframeEntry::AccessUnit);
+        return UpperBound > 0 ? &Keyframes[UpperBound - 1] : nullptr;
+    }
+
+    bool FNVENCBitstreamIndex::ExtractSegment(const FString& SourcePath, int32 FirstKeyframe, int32 KeyframeCount, const FString& OutputPath) const
+    {
+        if (!Keyframes.IsValidIndex(FirstKeyframe) || KeyframeCount <= 0)
+        {
+            return false;
+        }
+
+        const int32 EndKeyframe = FirstKeyframe + KeyframeCount;
+        const int64 Begin = Keyframes[FirstKeyframe].ByteOffset;
+        const int64 End = Keyframes.IsValidIndex(EndKeyframe) ? Keyframes[EndKeyframe].ByteOffset : EndOffset;
+
+        IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+        TUniquePtr<IFileHandle> Source(PlatformFile.OpenRead(*SourcePath));
+        TUniquePtr<IFileHandle> Target(PlatformFile.OpenWrite(*OutputPath, false, false));
+        if (!Source || !Target || !Source->Seek(Begin))
+        {
+            UE_LOG(LogNVENCNalScanner, Warning, TEXT("Unable to cut %s into %s"), *SourcePath, *OutputPath);
+            return false;
+        }
+
+        // Repeating the parameter sets is harmless when the keyframe carries its own, and required when it does not.
+        const TArray<uint8> Header = ParameterSets.ToAnnexB();
+        bool bSuccess = Target->Write(Header.GetData(), Header.Num());
+
+        TArray<uint8> Chunk;
+        Chunk.SetNumUninitialized(static_cast<int32>(FMath::Clamp<int64>(End - Begin, 1, GCopyChunkBytes)));
+        for (int64 Remaining = End - Begin; bSuccess && Remaining > 0;)
+        {
+            const int64 Bytes = FMath::Min<int64>(Remaining, Chunk.Num());
+            bSuccess = Source->Read(Chunk.GetData(), Bytes) && Target->Write(Chunk.GetData(), Bytes);
+            Remaining -= Bytes;
+        }
+        return bSuccess && Target->Flush();
+    }
+
+    bool FNVENCBitstreamIndex::SaveToFile(const FString& Path) const
+    {
+        TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+        Root->SetStringField(TEXT("codec"), Codec == ENVENCCodec::HEVC ? TEXT("hevc") : TEXT("h264"));
+        Root->SetNumberField(TEXT("accessUnits"), static_cast<double>(AccessUnitCount));
+        Root->SetNumberField(TEXT("bytes"), static_cast<double>(EndOffset));
+
+        TArray<TSharedPtr<FJsonValue>> Entries;
+        Entries.Reserve(Keyframes.Num());
+        for (const FNVENCKeyframeEntry& Entry : Keyframes)
+        {
+            TArray<TSharedPtr<FJsonValue>> Pair;
+            Pair.Add(MakeShared<FJsonValueNumber>(static_cast<double>(Entry.AccessUnit)));
+            Pair.Add(MakeShared<FJsonValueNumber>(static_cast<double>(Entry.ByteOffset)));
+            Entries.Add(MakeShared<FJsonValueArray>(Pair));
+        }
+        Root->SetArrayField(TEXT("keyframes"), Entries);
+
+        Root->SetStringField(TEXT("parameterSets"), FBase64::Encode(ParameterSets.ToAnnexB()));
+
+        FString Output;
+        TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+        return FJsonSerializer::Serialize(Root, Writer) && FFileHelper::SaveStringToFile(Output, *Path);
+    }
+
+    bool FNVENCBitstreamIndex::LoadFromFile(const FString& Path)
+    {
+        FString Input;
+        if (!FFileHelper::LoadFileToString(Input, *Path))
+        {
+            return false;
+        }
+
+        TSharedPtr<FJsonObject> Root;
+        if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Input), Root) || !Root.IsValid())
+        {
+            UE_LOG(LogNVENCNalScanner, Warning, TEXT("Bitstream index %s is not valid JSON"), *Path);
+            return false;
+        }
+
+        Reset(Root->GetStringField(TEXT("codec")) == TEXT("hevc") ? ENVENCCodec::HEVC : ENVENCCodec::H264);
+        AccessUnitCount = static_cast<int64>(Root->GetNumberField(TEXT("accessUnits")));
+        EndOffset = static_cast<int64>(Root->GetNumberField(TEXT("bytes")));
+
+        for (const TSharedPtr<FJsonValue>& Value : Root->GetArrayField(TEXT("keyframes")))
+        {
+            const TArray<TSharedPtr<FJsonValue>>& Pair = Value->AsArray();
+            if (Pair.Num() == 2)
+            {
+                FNVENCKeyframeEntry& Entry = Keyframes.AddDefaulted_GetRef();
+                Entry.AccessUnit = static_cast<int64>(Pair[0]->AsNumber());
+                Entry.ByteOffset = static_cast<int64>(Pair[1]->AsNumber());
+            }
+        }
+
+        TArray<uint8> AnnexB;
+        if (FBase64::Decode(Root->GetStringField(TEXT("parameterSets")), AnnexB))
+        {
+            AddCodecConfig(AnnexB);
+        }
+        return true;
+    }
+
+    FString FNVENCBitstreamIndex::GetIndexPath(const FString& BitstreamPath)
+    {
+        return BitstreamPath + TEXT(".index.json");
+    }
+}
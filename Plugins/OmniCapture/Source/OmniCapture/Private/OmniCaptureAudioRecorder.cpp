@@ -1,13 +1,10 @@
 #include "OmniCaptureAudioRecorder.h"
 
-#include "AudioMixerBlueprintLibrary.h"
 #include "AudioDevice.h"
 #include "Engine/World.h"
 #include "Misc/Paths.h"
-#include "HAL/FileManager.h"
 #include "Sound/SoundWave.h"
 #include "Sound/SoundSubmix.h"
-#include "Misc/ScopeLock.h"
 
 #if WITH_AUDIOMIXER
 #include "AudioMixerDevice.h"
@@ -17,7 +14,13 @@ DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureAudio, Log, All);
 
 namespace
 {
-    constexpr int32 GMaxPendingAudioPackets = 256;
+    FString BuildOutputFilePath(const FString& OutputDirectory, const FString& BaseFileName)
+    {
+        const FString SanitizedName = BaseFileName.IsEmpty() ? TEXT("OmniCapture") : BaseFileName;
+        FString Directory = OutputDirectory.IsEmpty() ? (FPaths::ProjectSavedDir() / TEXT("OmniCaptures")) : OutputDirectory;
+        Directory = FPaths::ConvertRelativePathToFull(Directory);
+        return Directory / (SanitizedName + TEXT(".wav"));
+    }
 
 #if WITH_AUDIOMIXER
     class FOmniCaptureSubmixListener final : public Audio::ISubmixBufferListener
@@ -55,7 +58,7 @@ bool FOmniCaptureAudioRecorder::Initialize(UWorld* InWorld, const FOmniCaptureSe
             TargetSubmix = LoadedSubmix;
         }
     }
-    PendingPacketCount = 0;
+    AudioRing.Reset();
     DroppedPacketCount = 0;
     bLoggedOverflowWarning = false;
     AudioClockOrigin = -1.0;
@@ -79,7 +82,7 @@ bool FOmniCaptureAudioRecorder::Initialize(UWorld* InWorld, const FOmniCaptureSe
     return WorldPtr.IsValid();
 }
 
-void FOmniCaptureAudioRecorder::Start()
+void FOmniCaptureAudioRecorder::Start(const FString& OutputDirectory, const FString& BaseFileName)
 {
     if (!WorldPtr.IsValid() || bIsRecording)
     {
@@ -89,44 +92,44 @@ void FOmniCaptureAudioRecorder::Start()
     DroppedPacketCount = 0;
     bLoggedOverflowWarning = false;
 
-    RegisterListener();
-    AudioStartTime = FPlatformTime::Seconds();
+    OutputFilePath = BuildOutputFilePath(OutputDirectory, BaseFileName);
+    WavWriter = MakeUnique<FOmniCaptureWavWriter>();
+    if (!WavWriter->Open(OutputFilePath))
+    {
+        UE_LOG(LogOmniCaptureAudio, Warning, TEXT("Audio will not be written to disk: %s could not be opened."), *OutputFilePath);
+        WavWriter.Reset();
+        OutputFilePath.Reset();
+    }
 
-    USoundSubmix* Submix = TargetSubmix.IsValid() ? TargetSubmix.Get() : nullptr;
-    UAudioMixerBlueprintLibrary::StartRecordingOutput(WorldPtr.Get(), 0.0f, Submix);
+    AudioStartTime = FPlatformTime::Seconds();
     bIsRecording = true;
     bPaused.Store(false);
+    RegisterListener();
 }
 
-void FOmniCaptureAudioRecorder::Stop(const FString& OutputDirectory, const FString& BaseFileName)
+void FOmniCaptureAudioRecorder::Stop()
 {
-    if (!WorldPtr.IsValid() || !bIsRecording)
+    if (!bIsRecording)
     {
         return;
     }
 
-    const FString SanitizedName = BaseFileName.IsEmpty() ? TEXT("OmniCapture") : BaseFileName;
-    FString Directory = OutputDirectory.IsEmpty() ? (FPaths::ProjectSavedDir() / TEXT("OmniCaptures")) : OutputDirectory;
-    Directory = FPaths::ConvertRelativePathToFull(Directory);
-    IFileManager::Get().MakeDirectory(*Directory, true);
-
-    USoundSubmix* Submix = TargetSubmix.IsValid() ? TargetSubmix.Get() : nullptr;
-    UAudioMixerBlueprintLibrary::StopRecordingOutput(WorldPtr.Get(), EAudioRecordingExportType::WavFile, SanitizedName, Directory, Submix);
-    OutputFilePath = Directory / (SanitizedName + TEXT(".wav"));
-
     UnregisterListener();
 
     bIsRecording = false;
 
+    if (WavWriter)
     {
-        FScopeLock Lock(&PacketCS);
-        FOmniAudioPacket Packet;
-        while (PendingPackets.Dequeue(Packet))
+        OutputFilePath = WavWriter->Close();
+        if (WavWriter->GetDroppedBufferCount() > 0)
         {
+            UE_LOG(LogOmniCaptureAudio, Warning, TEXT("%d audio buffers did not reach %s."), WavWriter->GetDroppedBufferCount(), *OutputFilePath);
         }
-        PendingPacketCount = 0;
+        WavWriter.Reset();
     }
 
+    AudioRing.Discard();
+
     AudioClockOrigin = -1.0;
     AudioStartTime = 0.0;
     DroppedPacketCount = 0;
@@ -134,33 +137,26 @@ void FOmniCaptureAudioRecorder::Stop(const FString& OutputDirectory, const FStri
     bPaused.Store(false);
 }
 
-void FOmniCaptureAudioRecorder::GatherAudio(double FrameTimestamp, TArray<FOmniAudioPacket>& OutPackets)
+TFuture<FString> FOmniCaptureAudioRecorder::SplitOutput(const FString& OutputDirectory, const FString& BaseFileName)
 {
-    FScopeLock Lock(&PacketCS);
-
-    const double Threshold = FrameTimestamp + (1.0 / 120.0);
-    for (;;)
+    if (!WavWriter)
     {
-        FOmniAudioPacket Packet;
-        if (!PendingPackets.Peek(Packet))
-        {
-            break;
-        }
+        return TFuture<FString>();
+    }
 
-        if (Packet.Timestamp > Threshold)
-        {
-            break;
-        }
+    TFuture<FString> Closed = WavWriter->Split(BuildOutputFilePath(OutputDirectory, BaseFileName));
+    OutputFilePath = WavWriter->GetFilePath();
+    return Closed;
+}
 
-        PendingPackets.Dequeue(Packet);
-        PendingPacketCount.DecrementExchange();
-        OutPackets.Add(MoveTemp(Packet));
-    }
+void FOmniCaptureAudioRecorder::GatherAudio(double FrameTimestamp, TArray<FOmniAudioPacket>& OutPackets)
+{
+    AudioRing.Read(FrameTimestamp + (1.0 / 120.0), OutPackets);
 }
 
 FString FOmniCaptureAudioRecorder::GetDebugStatus() const
 {
-    const int32 Pending = PendingPacketCount.Load();
+    const int32 Pending = AudioRing.GetPendingChunkCount();
     const int32 Dropped = DroppedPacketCount.Load();
     const FString SubmixName = TargetSubmix.IsValid() ? TargetSubmix->GetName() : TEXT("Master");
     return FString::Printf(TEXT("AudioPackets:%d Dropped:%d SR:%d Submix:%s"), Pending, Dropped, CachedSampleRate, *SubmixName);
@@ -168,7 +164,7 @@ FString FOmniCaptureAudioRecorder::GetDebugStatus() const
 
 int32 FOmniCaptureAudioRecorder::GetPendingPacketCount() const
 {
-    return PendingPacketCount.Load();
+    return AudioRing.GetPendingChunkCount();
 }
 
 void FOmniCaptureAudioRecorder::SetPaused(bool bInPaused)
@@ -231,42 +227,17 @@ void FOmniCaptureAudioRecorder::HandleSubmixBuffer(const float* AudioData, int32
     }
 
     const double RelativeTimestamp = FMath::Max(0.0, AudioClock - AudioClockOrigin);
-    FOmniAudioPacket Packet;
-    Packet.Timestamp = RelativeTimestamp;
-    Packet.SampleRate = SampleRate;
-    Packet.NumChannels = NumChannels;
-    Packet.PCM16.SetNumUninitialized(NumSamples);
-
-    for (int32 Index = 0; Index < NumSamples; ++Index)
+    if (WavWriter)
     {
-        const float SampleValue = AudioData[Index] * Gain;
-        const int32 IntValue = FMath::RoundToInt(SampleValue * 32767.0f);
-        Packet.PCM16[Index] = static_cast<int16>(FMath::Clamp(IntValue, -32768, 32767));
+        WavWriter->Push(AudioData, NumSamples, NumChannels, SampleRate, RelativeTimestamp, Gain);
     }
 
+    if (!AudioRing.Write(AudioData, NumSamples, NumChannels, SampleRate, RelativeTimestamp, Gain))
     {
-        FScopeLock Lock(&PacketCS);
-        bool bDropped = false;
-        while (PendingPacketCount.Load() >= GMaxPendingAudioPackets)
-        {
-            FOmniAudioPacket DiscardedPacket;
-            if (!PendingPackets.Dequeue(DiscardedPacket))
-            {
-                PendingPacketCount = 0;
-                break;
-            }
-
-            PendingPacketCount.DecrementExchange();
-            DroppedPacketCount.IncrementExchange();
-            bDropped = true;
-        }
-
-        PendingPackets.Enqueue(MoveTemp(Packet));
-        PendingPacketCount.IncrementExchange();
-
-        if (bDropped && !bLoggedOverflowWarning.Exchange(true))
+        DroppedPacketCount.IncrementExchange();
+        if (!bLoggedOverflowWarning.Exchange(true))
         {
-            UE_LOG(LogOmniCaptureAudio, Warning, TEXT("OmniCapture audio queue overflowed. Dropping oldest packets to keep audio in sync."));
+            UE_LOG(LogOmniCaptureAudio, Warning, TEXT("OmniCapture audio ring is full; dropping submix buffers until the capture tick catches up."));
         }
     }
 #else
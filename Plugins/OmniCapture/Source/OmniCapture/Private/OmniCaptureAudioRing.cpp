@@ -0,0 +1,189 @@
+#include "OmniCaptureAudioRing.h"
+
+#include "Math/VectorRegister.h"
+
+namespace
+{
+    // Chunks closer than this to the end of the previous one are treated as continuous and merged on read.
+    constexpr double GChunkContinuityToleranceSeconds = 0.001;
+
+    double GetChunkDuration(int32 NumSamples, int32 NumChannels, int32 SampleRate)
+    {
+        return (SampleRate > 0 && NumChannels > 0) ? static_cast<double>(NumSamples) / (static_cast<double>(SampleRate) * NumChannels) : 0.0;
+    }
+}
+
+void FOmniCaptureAudioRing::Reset(int32 InSampleCapacity, int32 InChunkCapacity)
+{
+    const uint32 SampleCapacity = FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::Max(InSampleCapacity, 16)));
+    const uint32 ChunkCapacity = FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::Max(InChunkCapacity, 2)));
+
+    Samples.SetNumZeroed(SampleCapacity);
+    Chunks.SetNum(ChunkCapacity);
+    SampleMask = SampleCapacity - 1;
+    ChunkMask = ChunkCapacity - 1;
+
+    SampleWrite.store(0);
+    ChunkWrite.store(0);
+    SampleRead.store(0);
+    ChunkRead.store(0);
+}
+
+bool FOmniCaptureAudioRing::Write(const float* Source, int32 NumSamples, int32 NumChannels, int32 SampleRate, double Timestamp, float Gain)
+{
+    if (NumSamples <= 0 || Chunks.Num() == 0)
+    {
+        return false;
+    }
+
+    const uint64 SamplePosition = SampleWrite.load(std::memory_order_relaxed);
+    const uint64 ChunkPosition = ChunkWrite.load(std::memory_order_relaxed);
+    if (ChunkPosition - ChunkRead.load(std::memory_order_acquire) > ChunkMask)
+    {
+        return false;
+    }
+    if (SamplePosition + NumSamples - SampleRead.load(std::memory_order_acquire) > SampleMask + 1)
+    {
+        return false;
+    }
+
+    const uint64 Offset = SamplePosition & SampleMask;
+    const int32 FirstSpan = static_cast<int32>(FMath::Min<uint64>(NumSamples, SampleMask + 1 - Offset));
+    ConvertToPCM16(Source, Samples.GetData() + Offset, FirstSpan, Gain);
+    if (FirstSpan < NumSamples)
+    {
+        ConvertToPCM16(Source + FirstSpan, Samples.GetData(), NumSamples - FirstSpan, Gain);
+    }
+
+    FChunk& Chunk = Chunks[ChunkPosition & ChunkMask];
+    Chunk.Timestamp = Timestamp;
+    Chunk.SampleStart = SamplePosition;
+    Chunk.NumSamples = NumSamples;
+    Chunk.NumChannels = NumChannels;
+    Chunk.SampleRate = SampleRate;
+
+    SampleWrite.store(SamplePosition + NumSamples, std::memory_order_release);
+    ChunkWrite.store(ChunkPosition + 1, std::memory_order_release);
+    return true;
+}
+
+int32 FOmniCaptureAudioRing::Read(double MaxTimestamp, TArray<FOmniAudioPacket>& OutPackets)
+{
+    const uint64 ChunkEnd = ChunkWrite.load(std::memory_order_acquire);
+    uint64 ChunkPosition = ChunkRead.load(std::memory_order_relaxed);
+
+    // Count what will be consumed first so every packet's storage is allocated once instead of growing per chunk.
+    uint64 ReadEnd = ChunkPosition;
+    int64 RemainingSamples = 0;
+    for (; ReadEnd < ChunkEnd && Chunks[ReadEnd & ChunkMask].Timestamp <= MaxTimestamp; ++ReadEnd)
+    {
+        RemainingSamples += Chunks[ReadEnd & ChunkMask].NumSamples;
+    }
+
+    FOmniAudioPacket* Packet = nullptr;
+    double PacketEndTime = 0.0;
+    int32 Consumed = 0;
+    for (; ChunkPosition < ReadEnd; ++ChunkPosition, ++Consumed)
+    {
+        const FChunk& Chunk = Chunks[ChunkPosition & ChunkMask];
+
+        const bool bContinues = Packet
+            && Packet->SampleRate == Chunk.SampleRate
+            && Packet->NumChannels == Chunk.NumChannels
+            && FMath::Abs(Chunk.Timestamp - PacketEndTime) <= GChunkContinuityToleranceSeconds;
+        if (!bContinues)
+        {
+            Packet = &OutPackets.AddDefaulted_GetRef();
+            Packet->Timestamp = Chunk.Timestamp;
+            Packet->SampleRate = Chunk.SampleRate;
+            Packet->NumChannels = Chunk.NumChannels;
+            Packet->PCM16.Reserve(static_cast<int32>(RemainingSamples));
+        }
+        RemainingSamples -= Chunk.NumSamples;
+
+        const uint64 Offset = Chunk.SampleStart & SampleMask;
+        const int32 FirstSpan = static_cast<int32>(FMath::Min<uint64>(Chunk.NumSamples, SampleMask + 1 - Offset));
+        Packet->PCM16.Append(Samples.GetData() + Offset, FirstSpan);
+        if (FirstSpan < Chunk.NumSamples)
+        {
+            Packet->PCM16.Append(Samples.GetData(), Chunk.NumSamples - FirstSpan);
+        }
+        PacketEndTime = Chunk.Timestamp + GetChunkDuration(Chunk.NumSamples, Chunk.NumChannels, Chunk.SampleRate);
+
+        SampleRead.store(Chunk.SampleStart + Chunk.NumSamples, std::memory_order_release);
+    }
+
+    ChunkRead.store(ChunkPosition, std::memory_order_release);
+    return Consumed;
+}
+
+int32 FOmniCaptureAudioRing::Consume(int32 MaxChunks, TFunctionRef<void(const FChunkView&)> Visitor)
+{
+    const uint64 ChunkEnd = ChunkWrite.load(std::memory_order_acquire);
+    uint64 ChunkPosition = ChunkRead.load(std::memory_order_relaxed);
+
+    int32 Consumed = 0;
+    for (; ChunkPosition < ChunkEnd && Consumed < MaxChunks; ++ChunkPosition, ++Consumed)
+    {
+        const FChunk& Chunk = Chunks[ChunkPosition & ChunkMask];
+        const uint64 Offset = Chunk.SampleStart & SampleMask;
+        const int32 FirstSpan = static_cast<int32>(FMath::Min<uint64>(Chunk.NumSamples, SampleMask + 1 - Offset));
+
+        FChunkView View;
+        View.Timestamp = Chunk.Timestamp;
+        View.First = TConstArrayView<int16>(Samples.GetData() + Offset, FirstSpan);
+        View.Second = TConstArrayView<int16>(Samples.GetData(), Chunk.NumSamples - FirstSpan);
+        View.NumChannels = Chunk.NumChannels;
+        View.SampleRate = Chunk.SampleRate;
+        Visitor(View);
+
+        SampleRead.store(Chunk.SampleStart + Chunk.NumSamples, std::memory_order_release);
+        ChunkRead.store(ChunkPosition + 1, std::memory_order_release);
+    }
+    return Consumed;
+}
+
+void FOmniCaptureAudioRing::Discard()
+{
+    const uint64 ChunkEnd = ChunkWrite.load(std::memory_order_acquire);
+    if (ChunkEnd == ChunkRead.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    const FChunk& Last = Chunks[(ChunkEnd - 1) & ChunkMask];
+    SampleRead.store(Last.SampleStart + Last.NumSamples, std::memory_order_release);
+    ChunkRead.store(ChunkEnd, std::memory_order_release);
+}
+
+int32 FOmniCaptureAudioRing::GetPendingChunkCount() const
+{
+    return static_cast<int32>(ChunkWrite.load(std::memory_order_acquire) - ChunkRead.load(std::memory_order_acquire));
+}
+
+void FOmniCaptureAudioRing::ConvertToPCM16(const float* Source, int16* Destination, int32 NumSamples, float Gain)
+{
+    const float Scale = Gain * 32767.0f;
+    const VectorRegister4Float ScaleVector = VectorSetFloat1(Scale);
+    const VectorRegister4Float MinVector = VectorSetFloat1(-32768.0f);
+    const VectorRegister4Float MaxVector = VectorSetFloat1(32767.0f);
+
+    int32 Index = 0;
+    for (; Index + 4 <= NumSamples; Index += 4)
+    {
+        // Clamping in float first keeps the int conversion in range.
+        const VectorRegister4Float Scaled = VectorMin(VectorMax(VectorMultiply(VectorLoad(Source + Index), ScaleVector), MinVector), MaxVector);
+        alignas(16) int32 Rounded[4];
+        VectorIntStoreAligned(VectorRoundToIntHalfToEven(Scaled), Rounded);
+        Destination[Index + 0] = static_cast<int16>(Rounded[0]);
+        Destination[Index + 1] = static_cast<int16>(Rounded[1]);
+        Destination[Index + 2] = static_cast<int16>(Rounded[2]);
+        Destination[Index + 3] = static_cast<int16>(Rounded[3]);
+    }
+
+    for (; Index < NumSamples; ++Index)
+    {
+        const float Scaled = FMath::Clamp(Source[Index] * Scale, -32768.0f, 32767.0f);
+        Destination[Index] = static_cast<int16>(FMath::RoundHalfToEven(Scaled));
+    }
+}
@@ -0,0 +1,39 @@
+#include "OmniCaptureBufferPool.h"
+
+FOmniCaptureBufferPool::FOmniCaptureBufferPool(int64 InMaxPooledBytes)
+    : MaxPooledBytes(FMath::Max<int64>(0, InMaxPooledBytes))
+{
+}
+
+void FOmniCaptureBufferPool::AcquirePreviewPixels(TArray<FColor>& OutPixels, int32 NumPixels)
+{
+    if (OutPixels.Max() >= NumPixels)
+    {
+        OutPixels.SetNumUninitialized(NumPixels, EAllowShrinking::No);
+        return;
+    }
+
+    OutPixels.Empty();
+    Acquire(PreviewBuffers, OutPixels, NumPixels, false);
+}
+
+void FOmniCaptureBufferPool::ReleasePreviewPixels(TArray<FColor>&& Pixels)
+{
+    Release(PreviewBuffers, MoveTemp(Pixels), 0);
+}
+
+void FOmniCaptureBufferPool::Trim()
+{
+    FScopeLock Lock(&PoolCS);
+    ColorBuffers.Buckets.Empty();
+    HalfBuffers.Buckets.Empty();
+    FloatBuffers.Buckets.Empty();
+    PreviewBuffers.Buckets.Empty();
+    Stats.PooledBytes = 0;
+}
+
+FOmniCaptureBufferPoolStats FOmniCaptureBufferPool::GetStats() const
+{
+    FScopeLock Lock(&PoolCS);
+    return Stats;
+}
@@ -0,0 +1,357 @@
+#include "OmniCaptureCPUSampleMap.h"
+
+#include "Async/ParallelFor.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureSampleMap, Log, All);
+
+namespace
+{
+    FCriticalSection GCachedSampleMapCS;
+    TSharedPtr<const FOmniCaptureCPUSampleMap, ESPMode::ThreadSafe> GCachedSampleMap;
+
+    FVector DirectionFromEquirectPixelCPU(const FIntPoint& Pixel, const FIntPoint& EyeResolution, double LongitudeSpan, double LatitudeSpan, float& OutLatitude)
+    {
+        const FVector2D UV((static_cast<double>(Pixel.X) + 0.5) / EyeResolution.X, (static_cast<double>(Pixel.Y) + 0.5) / EyeResolution.Y);
+        const double Longitude = (UV.X * 2.0 - 1.0) * LongitudeSpan;
+        const double Latitude = (0.5 - UV.Y) * LatitudeSpan * 2.0;
+        OutLatitude = static_cast<float>(Latitude);
+
+        const double CosLat = FMath::Cos(Latitude);
+        const double SinLat = FMath::Sin(Latitude);
+        const double CosLon = FMath::Cos(Longitude);
+        const double SinLon = FMath::Sin(Longitude);
+
+        FVector Direction;
+        Direction.X = CosLat * CosLon;
+        Direction.Y = SinLat;
+        Direction.Z = CosLat * SinLon;
+        return Direction.GetSafeNormal();
+    }
+
+    FVector DirectionFromFisheyePixelCPU(const FIntPoint& Pixel, const FIntPoint& EyeResolution, double FovRadians, bool& bOutValid)
+    {
+        if (EyeResolution.X <= 0 || EyeResolution.Y <= 0)
+        {
+            bOutValid = false;
+            return FVector::ZeroVector;
+        }
+
+        const FVector2D UV((static_cast<double>(Pixel.X) + 0.5) / EyeResolution.X, (static_cast<double>(Pixel.Y) + 0.5) / EyeResolution.Y);
+        FVector2D Normalized = FVector2D(UV.X * 2.0 - 1.0, 1.0 - UV.Y * 2.0);
+
+        const double Radius = Normalized.Size();
+        if (Radius > 1.0)
+        {
+            bOutValid = false;
+            return FVector::ZeroVector;
+        }
+
+        const double HalfFov = FMath::Clamp(FovRadians * 0.5, 0.0, PI);
+        const double Theta = Radius * HalfFov;
+        const double Phi = FMath::Atan2(Normalized.Y, Normalized.X);
+        const double SinTheta = FMath::Sin(Theta);
+
+        FVector Direction;
+        Direction.X = FMath::Cos(Theta);
+        Direction.Y = SinTheta * FMath::Sin(Phi);
+        Direction.Z = SinTheta * FMath::Cos(Phi);
+
+        bOutValid = true;
+        return Direction.GetSafeNormal();
+    }
+
+    void DirectionToFaceUVCPU(const FVector& Direction, uint32& OutFaceIndex, FVector2D& OutUV, int32 FaceResolution, float SeamStrength)
+    {
+        int32 FaceIndex = 0;
+        FOmniCaptureCPUSampleMap::DirectionToFaceUV(Direction, FaceIndex, OutUV);
+        OutFaceIndex = static_cast<uint32>(FaceIndex);
+
+        const double Resolution = static_cast<double>(FMath::Max(1, FaceResolution));
+        const double Scale = FMath::Lerp(1.0, (Resolution - 1.0) / Resolution, SeamStrength);
+        const double Bias = (0.5 / Resolution) * SeamStrength;
+        OutUV = FVector2D(OutUV.X * Scale + Bias, OutUV.Y * Scale + Bias);
+        OutUV.X = FMath::Clamp(OutUV.X, 0.0f, 1.0f);
+        OutUV.Y = FMath::Clamp(OutUV.Y, 0.0f, 1.0f);
+    }
+
+    void ApplyPolarMitigation(float PolarStrength, float Latitude, FVector& Direction)
+    {
+        if (PolarStrength <= 0.0f)
+        {
+            return;
+        }
+
+        double PoleFactor = FMath::Clamp(FMath::Abs(Latitude) / (PI * 0.5), 0.0, 1.0);
+        PoleFactor = FMath::Pow(PoleFactor, 4.0);
+        const double Blend = PoleFactor * PolarStrength;
+        if (Blend <= 0.0)
+        {
+            return;
+        }
+
+        const FVector PoleVector(0.0f, Latitude >= 0.0f ? 1.0f : -1.0f, 0.0f);
+        Direction = FVector(FMath::Lerp(Direction.X, PoleVector.X, Blend),
+            FMath::Lerp(Direction.Y, PoleVector.Y, Blend),
+            FMath::Lerp(Direction.Z, PoleVector.Z, Blend));
+        Direction.Normalize();
+    }
+
+    uint16 QuantizeUV(double Value)
+    {
+        return static_cast<uint16>(FMath::Clamp(FMath::RoundToInt(Value * 65535.0), 0, 65535));
+    }
+
+    FOmniCaptureCPUSample EncodeSample(const FVector& Direction, bool bRightEye, const FOmniCaptureCPUSampleMap::FKey& Key)
+    {
+        uint32 FaceIndex = 0;
+        FVector2D FaceUV = FVector2D::ZeroVector;
+        DirectionToFaceUVCPU(Direction, FaceIndex, FaceUV, Key.FaceResolution, Key.SeamBlend);
+
+        FOmniCaptureCPUSample Sample;
+        Sample.FaceAndFlags = static_cast<uint16>(FaceIndex) | (bRightEye ? FOmniCaptureCPUSample::RightEyeFlag : 0);
+        Sample.U = QuantizeUV(FaceUV.X);
+        Sample.V = QuantizeUV(FaceUV.Y);
+        return Sample;
+    }
+
+    FOmniCaptureCPUSample BuildEquirectSample(int32 X, int32 Y, const FOmniCaptureCPUSampleMap::FKey& Key)
+    {
+        const int32 OutputWidth = Key.OutputSize.X;
+        const int32 OutputHeight = Key.OutputSize.Y;
+
+        FIntPoint EyePixel(X, Y);
+        FIntPoint EyeResolution(OutputWidth, OutputHeight);
+        bool bRightEye = false;
+
+        if (Key.bStereo)
+        {
+            if (Key.bSideBySide)
+            {
+                const int32 EyeWidth = OutputWidth / 2;
+                bRightEye = X >= EyeWidth;
+                EyePixel.X = X % EyeWidth;
+                EyeResolution = FIntPoint(EyeWidth, OutputHeight);
+            }
+            else
+            {
+                const int32 EyeHeight = OutputHeight / 2;
+                bRightEye = Y >= EyeHeight;
+                EyePixel.Y = Y % EyeHeight;
+                EyeResolution = FIntPoint(OutputWidth, EyeHeight);
+            }
+        }
+
+        float Latitude = 0.0f;
+        FVector Direction = DirectionFromEquirectPixelCPU(EyePixel, EyeResolution, Key.LongitudeSpan, Key.LatitudeSpan, Latitude);
+        ApplyPolarMitigation(Key.PolarDampening, Latitude, Direction);
+
+        if (Key.bHalfSphere && Direction.X < 0.0f)
+        {
+            return FOmniCaptureCPUSample();
+        }
+
+        return EncodeSample(Direction, bRightEye, Key);
+    }
+
+    FOmniCaptureCPUSample BuildFisheyeSample(int32 X, int32 Y, const FOmniCaptureCPUSampleMap::FKey& Key)
+    {
+        FIntPoint EyePixel(X, Y);
+        FIntPoint EyeResolution = Key.FisheyeEyeSize;
+        bool bRightEye = false;
+
+        if (Key.bStereo)
+        {
+            if (Key.bSideBySide)
+            {
+                const int32 EyeWidth = FMath::Max(1, Key.FisheyeEyeSize.X);
+                bRightEye = X >= EyeWidth;
+                EyePixel.X = X % EyeWidth;
+                EyeResolution = FIntPoint(EyeWidth, Key.FisheyeEyeSize.Y);
+            }
+            else
+            {
+                const int32 EyeHeight = FMath::Max(1, Key.FisheyeEyeSize.Y);
+                bRightEye = Y >= EyeHeight;
+                EyePixel.Y = Y % EyeHeight;
+                EyeResolution = FIntPoint(Key.FisheyeEyeSize.X, EyeHeight);
+            }
+        }
+
+        bool bValid = false;
+        const FVector Direction = DirectionFromFisheyePixelCPU(EyePixel, EyeResolution, Key.FisheyeFovRadians, bValid);
+        if (!bValid || (Key.bHalfSphere && Direction.X < 0.0f))
+        {
+            return FOmniCaptureCPUSample();
+        }
+
+        return EncodeSample(Direction, bRightEye, Key);
+    }
+}
+
+void FOmniCaptureCPUSampleMap::DirectionToFaceUV(const FVector& Direction, int32& OutFaceIndex, FVector2D& OutUV)
+{
+    const FVector AbsDir = Direction.GetAbs();
+
+    if (AbsDir.X >= AbsDir.Y && AbsDir.X >= AbsDir.Z)
+    {
+        if (Direction.X > 0.0f)
+        {
+            OutFaceIndex = 0;
+            OutUV = FVector2D(-Direction.Z, Direction.Y) / AbsDir.X;
+        }
+        else
+        {
+            OutFaceIndex = 1;
+            OutUV = FVector2D(Direction.Z, Direction.Y) / AbsDir.X;
+        }
+    }
+    else if (AbsDir.Y >= AbsDir.X && AbsDir.Y >= AbsDir.Z)
+    {
+        if (Direction.Y > 0.0f)
+        {
+            OutFaceIndex = 2;
+            OutUV = FVector2D(Direction.X, -Direction.Z) / AbsDir.Y;
+        }
+        else
+        {
+            OutFaceIndex = 3;
+            OutUV = FVector2D(Direction.X, Direction.Z) / AbsDir.Y;
+        }
+    }
+    else
+    {
+        if (Direction.Z > 0.0f)
+        {
+            OutFaceIndex = 4;
+            OutUV = FVector2D(Direction.X, Direction.Y) / AbsDir.Z;
+        }
+        else
+        {
+            OutFaceIndex = 5;
+            OutUV = FVector2D(-Direction.X, Direction.Y) / AbsDir.Z;
+        }
+    }
+
+    OutUV = (OutUV + FVector2D(1.0, 1.0)) * 0.5f;
+}
+
+FVector FOmniCaptureCPUSampleMap::FaceUVToDirection(int32 FaceIndex, const FVector2D& UV)
+{
+    const double S = UV.X * 2.0 - 1.0;
+    const double T = UV.Y * 2.0 - 1.0;
+
+    switch (FaceIndex)
+    {
+    case 0: return FVector(1.0, T, -S);
+    case 1: return FVector(-1.0, T, S);
+    case 2: return FVector(S, 1.0, -T);
+    case 3: return FVector(S, -1.0, T);
+    case 4: return FVector(S, T, 1.0);
+    default: return FVector(-S, T, -1.0);
+    }
+}
+
+bool FOmniCaptureCPUSampleMap::FKey::operator==(const FKey& Other) const
+{
+    return Projection == Other.Projection
+        && OutputSize == Other.OutputSize
+        && FisheyeEyeSize == Other.FisheyeEyeSize
+        && FaceResolution == Other.FaceResolution
+        && bStereo == Other.bStereo
+        && bSideBySide == Other.bSideBySide
+        && bHalfSphere == Other.bHalfSphere
+        && LongitudeSpan == Other.LongitudeSpan
+        && LatitudeSpan == Other.LatitudeSpan
+        && FisheyeFovRadians == Other.FisheyeFovRadians
+        && SeamBlend == Other.SeamBlend
+        && PolarDampening == Other.PolarDampening;
+}
+
+FOmniCaptureCPUSampleMap::FKey FOmniCaptureCPUSampleMap::MakeKey(const FOmniCaptureSettings& Settings, int32 FaceResolution)
+{
+    FKey NewKey;
+    NewKey.Projection = Settings.IsFisheye() ? EOmniCaptureProjection::Fisheye : EOmniCaptureProjection::Equirectangular;
+    NewKey.FaceResolution = FaceResolution;
+    NewKey.bStereo = Settings.Mode == EOmniCaptureMode::Stereo;
+    NewKey.bSideBySide = NewKey.bStereo && Settings.StereoLayout == EOmniCaptureStereoLayout::SideBySide;
+    NewKey.bHalfSphere = Settings.IsVR180();
+    NewKey.SeamBlend = Settings.SeamBlend;
+
+    if (Settings.IsFisheye())
+    {
+        NewKey.OutputSize = Settings.GetOutputResolution();
+        NewKey.FisheyeEyeSize = Settings.GetFisheyeResolution();
+        NewKey.FisheyeFovRadians = FMath::DegreesToRadians(FMath::Clamp(Settings.FisheyeFOV, 0.0f, 360.0f));
+    }
+    else
+    {
+        NewKey.OutputSize = Settings.GetEquirectResolution();
+        NewKey.LongitudeSpan = Settings.GetLongitudeSpanRadians();
+        NewKey.LatitudeSpan = Settings.GetLatitudeSpanRadians();
+        NewKey.PolarDampening = Settings.PolarDampening;
+    }
+
+    return NewKey;
+}
+
+TSharedPtr<const FOmniCaptureCPUSampleMap, ESPMode::ThreadSafe> FOmniCaptureCPUSampleMap::GetOrBuild(const FOmniCaptureSettings& Settings, int32 FaceResolution)
+{
+    const FKey RequestedKey = MakeKey(Settings, FaceResolution);
+
+    FScopeLock Lock(&GCachedSampleMapCS);
+    if (GCachedSampleMap.IsValid() && GCachedSampleMap->GetKey() == RequestedKey)
+    {
+        return GCachedSampleMap;
+    }
+
+    // Drop the stale map before allocating its replacement so both are never resident at once.
+    GCachedSampleMap.Reset();
+
+    TSharedPtr<FOmniCaptureCPUSampleMap, ESPMode::ThreadSafe> NewMap = MakeShared<FOmniCaptureCPUSampleMap, ESPMode::ThreadSafe>();
+    if (!NewMap->Build(RequestedKey))
+    {
+        return nullptr;
+    }
+
+    GCachedSampleMap = NewMap;
+    return GCachedSampleMap;
+}
+
+void FOmniCaptureCPUSampleMap::ReleaseCached()
+{
+    FScopeLock Lock(&GCachedSampleMapCS);
+    GCachedSampleMap.Reset();
+}
+
+bool FOmniCaptureCPUSampleMap::Build(const FKey& InKey)
+{
+    Key = InKey;
+    Samples.Reset();
+
+    if (Key.OutputSize.X <= 0 || Key.OutputSize.Y <= 0 || Key.FaceResolution <= 0)
+    {
+        return false;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    const int32 Width = Key.OutputSize.X;
+    Samples.SetNumUninitialized(static_cast<int64>(Width) * Key.OutputSize.Y);
+
+    const bool bFisheye = Key.Projection == EOmniCaptureProjection::Fisheye;
+    ParallelFor(Key.OutputSize.Y, [this, Width, bFisheye](int32 Y)
+    {
+        FOmniCaptureCPUSample* Row = Samples.GetData() + static_cast<int64>(Y) * Width;
+        for (int32 X = 0; X < Width; ++X)
+        {
+            Row[X] = bFisheye ? BuildFisheyeSample(X, Y, Key) : BuildEquirectSample(X, Y, Key);
+        }
+    });
+
+    UE_LOG(LogOmniCaptureSampleMap, Log, TEXT("Built CPU sample map %dx%d (%.1f MB) in %.2f ms"),
+        Key.OutputSize.X,
+        Key.OutputSize.Y,
+        static_cast<double>(GetAllocatedSize()) / (1024.0 * 1024.0),
+        (FPlatformTime::Seconds() - StartTime) * 1000.0);
+    return true;
+}
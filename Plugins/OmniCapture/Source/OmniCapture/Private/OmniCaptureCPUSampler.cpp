@@ -0,0 +1,297 @@
+#include "OmniCaptureCPUSampler.h"
+
+#include "Math/VectorRegister.h"
+
+namespace
+{
+    constexpr float GFixedPointScale = 1.0f / 65535.0f;
+
+    template <typename PixelType>
+    const PixelType* GetFaceRow(const FOmniCaptureCPUFace& Face, int32 Y);
+
+    template <>
+    FORCEINLINE const FLinearColor* GetFaceRow<FLinearColor>(const FOmniCaptureCPUFace& Face, int32 Y)
+    {
+        return Face.GetRow(Y);
+    }
+
+    template <>
+    FORCEINLINE const FFloat16Color* GetFaceRow<FFloat16Color>(const FOmniCaptureCPUFace& Face, int32 Y)
+    {
+        return Face.GetHalfRow(Y);
+    }
+
+    FORCEINLINE VectorRegister4Float LoadTexel(const FLinearColor& Texel)
+    {
+        return VectorLoad(&Texel.R);
+    }
+
+    /** Widens one half texel; the platform layer uses F16C or NEON conversions where the target has them. */
+    FORCEINLINE VectorRegister4Float LoadTexel(const FFloat16Color& Texel)
+    {
+        alignas(16) float Widened[4];
+        FPlatformMath::VectorLoadHalf(Widened, reinterpret_cast<const uint16*>(&Texel));
+        return VectorLoadAligned(Widened);
+    }
+
+    template <typename PixelType>
+    FORCEINLINE void SampleNearest(const FOmniCaptureCPUFace& Face, const FOmniCaptureCPUSample& Sample, FLinearColor& OutColor)
+    {
+        const uint32 MaxCoord = static_cast<uint32>(Face.Resolution - 1);
+        const int32 SampleX = static_cast<int32>((Sample.U * MaxCoord) / 65535u);
+        const int32 SampleY = static_cast<int32>((Sample.V * MaxCoord) / 65535u);
+        VectorStore(LoadTexel(GetFaceRow<PixelType>(Face, SampleY)[SampleX]), &OutColor.R);
+    }
+
+    template <typename PixelType>
+    FORCEINLINE VectorRegister4Float BlendBilinear(const PixelType* Row0, int32 Stride, const VectorRegister4Float& WeightX, const VectorRegister4Float& WeightY)
+    {
+        const PixelType* Row1 = Row0 + Stride;
+        const VectorRegister4Float C00 = LoadTexel(Row0[0]);
+        const VectorRegister4Float C10 = LoadTexel(Row0[1]);
+        const VectorRegister4Float C01 = LoadTexel(Row1[0]);
+        const VectorRegister4Float C11 = LoadTexel(Row1[1]);
+
+        const VectorRegister4Float Top = VectorMultiplyAdd(VectorSubtract(C10, C00), WeightX, C00);
+        const VectorRegister4Float Bottom = VectorMultiplyAdd(VectorSubtract(C11, C01), WeightX, C01);
+        return VectorMultiplyAdd(VectorSubtract(Bottom, Top), WeightY, Top);
+    }
+
+    template <typename PixelType>
+    FORCEINLINE void SampleBilinear(const FOmniCaptureCPUFace& Face, const FOmniCaptureCPUSample& Sample, FLinearColor& OutColor)
+    {
+        // Texel centres sit at (i + 0.5) / Resolution. The one texel border means x0 may be -1 and x0 + 1 may be
+        // Resolution without leaving the padded allocation.
+        const float Scale = GFixedPointScale * static_cast<float>(Face.Resolution);
+        const float FX = static_cast<float>(Sample.U) * Scale - 0.5f;
+        const float FY = static_cast<float>(Sample.V) * Scale - 0.5f;
+        const int32 X0 = FMath::Clamp(FMath::FloorToInt32(FX), -1, Face.Resolution - 1);
+        const int32 Y0 = FMath::Clamp(FMath::FloorToInt32(FY), -1, Face.Resolution - 1);
+
+        const VectorRegister4Float WeightX = VectorSetFloat1(FMath::Clamp(FX - static_cast<float>(X0), 0.0f, 1.0f));
+        const VectorRegister4Float WeightY = VectorSetFloat1(FMath::Clamp(FY - static_cast<float>(Y0), 0.0f, 1.0f));
+        VectorStore(BlendBilinear(GetFaceRow<PixelType>(Face, Y0) + X0, Face.GetStride(), WeightX, WeightY), &OutColor.R);
+    }
+
+    /**
+     * Bilinear taps for four valid samples at once. Texel addresses and weights are computed in one register per axis,
+     * then each lane gathers its 2x2 footprint and blends it with its weights splatted across the channels. Taps and
+     * weights are the same as SampleBilinear's. Both eyes must share one face resolution.
+     */
+    template <typename PixelType>
+    FORCEINLINE void SampleBilinearQuad(const FOmniCaptureCPUCubemap& LeftCubemap, const FOmniCaptureCPUCubemap& RightCubemap, const FOmniCaptureCPUSample* Samples, FLinearColor* OutColors)
+    {
+        const int32 FaceResolution = LeftCubemap.Faces[0].Resolution;
+        const int32 Stride = LeftCubemap.Faces[0].GetStride();
+
+        alignas(16) float U[4];
+        alignas(16) float V[4];
+        for (int32 Lane = 0; Lane < 4; ++Lane)
+        {
+            U[Lane] = static_cast<float>(Samples[Lane].U);
+            V[Lane] = static_cast<float>(Samples[Lane].V);
+        }
+
+        const VectorRegister4Float Scale = VectorSetFloat1(GFixedPointScale * static_cast<float>(FaceResolution));
+        const VectorRegister4Float HalfTexel = VectorSetFloat1(0.5f);
+        const VectorRegister4Float MinCoord = VectorSetFloat1(-1.0f);
+        const VectorRegister4Float MaxCoord = VectorSetFloat1(static_cast<float>(FaceResolution - 1));
+        const VectorRegister4Float FX = VectorSubtract(VectorMultiply(VectorLoadAligned(U), Scale), HalfTexel);
+        const VectorRegister4Float FY = VectorSubtract(VectorMultiply(VectorLoadAligned(V), Scale), HalfTexel);
+        const VectorRegister4Float X0 = VectorMin(VectorMax(VectorFloor(FX), MinCoord), MaxCoord);
+        const VectorRegister4Float Y0 = VectorMin(VectorMax(VectorFloor(FY), MinCoord), MaxCoord);
+
+        alignas(16) float TexelX[4];
+        alignas(16) float TexelY[4];
+        alignas(16) float WeightX[4];
+        alignas(16) float WeightY[4];
+        VectorStoreAligned(X0, TexelX);
+        VectorStoreAligned(Y0, TexelY);
+        VectorStoreAligned(VectorMin(VectorMax(VectorSubtract(FX, X0), VectorZeroFloat()), VectorOneFloat()), WeightX);
+        VectorStoreAligned(VectorMin(VectorMax(VectorSubtract(FY, Y0), VectorZeroFloat()), VectorOneFloat()), WeightY);
+
+        for (int32 Lane = 0; Lane < 4; ++Lane)
+        {
+            const FOmniCaptureCPUSample& Sample = Samples[Lane];
+            const FOmniCaptureCPUFace& Face = (Sample.IsRightEye() ? RightCubemap : LeftCubemap).Faces[Sample.GetFace()];
+            const PixelType* Row0 = GetFaceRow<PixelType>(Face, static_cast<int32>(TexelY[Lane])) + static_cast<int32>(TexelX[Lane]);
+            VectorStore(BlendBilinear(Row0, Stride, VectorLoadFloat1(&WeightX[Lane]), VectorLoadFloat1(&WeightY[Lane])), &OutColors[Lane].R);
+        }
+    }
+
+    template <bool bBilinear, typename PixelType>
+    FORCEINLINE void SampleOne(const FOmniCaptureCPUCubemap& LeftCubemap, const FOmniCaptureCPUCubemap& RightCubemap, const FOmniCaptureCPUSample& Sample, FLinearColor& OutColor)
+    {
+        if (!Sample.IsValid())
+        {
+            OutColor = FLinearColor::Transparent;
+            return;
+        }
+
+        const FOmniCaptureCPUCubemap& Cubemap = Sample.IsRightEye() ? RightCubemap : LeftCubemap;
+        const FOmniCaptureCPUFace& Face = Cubemap.Faces[Sample.GetFace()];
+        if (bBilinear)
+        {
+            SampleBilinear<PixelType>(Face, Sample, OutColor);
+        }
+        else
+        {
+            SampleNearest<PixelType>(Face, Sample, OutColor);
+        }
+    }
+
+    template <bool bBilinear, typename PixelType>
+    void SampleRunImpl(const FOmniCaptureCPUCubemap& LeftCubemap, const FOmniCaptureCPUCubemap& RightCubemap, const FOmniCaptureCPUSample* Samples, int32 NumSamples, FLinearColor* OutColors)
+    {
+        int32 Index = 0;
+        const bool bSharedResolution = !RightCubemap.IsValid() || RightCubemap.Faces[0].Resolution == LeftCubemap.Faces[0].Resolution;
+        if (bBilinear && bSharedResolution)
+        {
+            // Runs of valid samples go four at a time; groups touching an invalid sample (fisheye corners, VR180
+            // backs) fall back to per-sample taps.
+            for (; Index + 4 <= NumSamples; Index += 4)
+            {
+                const FOmniCaptureCPUSample* Group = Samples + Index;
+                if (Group[0].IsValid() && Group[1].IsValid() && Group[2].IsValid() && Group[3].IsValid())
+                {
+                    SampleBilinearQuad<PixelType>(LeftCubemap, RightCubemap, Group, OutColors + Index);
+                    continue;
+                }
+
+                for (int32 Lane = 0; Lane < 4; ++Lane)
+                {
+                    SampleOne<true, PixelType>(LeftCubemap, RightCubemap, Group[Lane], OutColors[Index + Lane]);
+                }
+            }
+        }
+
+        for (; Index < NumSamples; ++Index)
+        {
+            SampleOne<bBilinear, PixelType>(LeftCubemap, RightCubemap, Samples[Index], OutColors[Index]);
+        }
+    }
+
+    template <typename PixelType>
+    void SampleRunTyped(const FOmniCaptureCPUCubemap& LeftCubemap, const FOmniCaptureCPUCubemap& RightCubemap, const FOmniCaptureCPUSample* Samples, int32 NumSamples, EOmniCaptureCPUSampling Sampling, FLinearColor* OutColors)
+    {
+        if (Sampling == EOmniCaptureCPUSampling::Bilinear)
+        {
+            SampleRunImpl<true, PixelType>(LeftCubemap, RightCubemap, Samples, NumSamples, OutColors);
+        }
+        else
+        {
+            SampleRunImpl<false, PixelType>(LeftCubemap, RightCubemap, Samples, NumSamples, OutColors);
+        }
+    }
+}
+
+void FOmniCaptureCPUFace::Allocate(int32 InResolution)
+{
+    Resolution = FMath::Max(0, InResolution);
+    const int32 Stride = GetStride();
+    const int32 NumTexels = Resolution > 0 ? Stride * Stride : 0;
+    if (IsHalf())
+    {
+        HalfPixels.SetNumUninitialized(NumTexels, EAllowShrinking::No);
+        Pixels.Empty();
+    }
+    else
+    {
+        Pixels.SetNumUninitialized(NumTexels, EAllowShrinking::No);
+        HalfPixels.Empty();
+    }
+}
+
+bool FOmniCaptureCPUFace::IsValid() const
+{
+    const int32 NumTexels = IsHalf() ? HalfPixels.Num() : Pixels.Num();
+    return Resolution > 0 && NumTexels == GetStride() * GetStride();
+}
+
+bool FOmniCaptureCPUCubemap::IsValid() const
+{
+    for (int32 Index = 0; Index < 6; ++Index)
+    {
+        if (!Faces[Index].IsValid() || Faces[Index].Resolution != Faces[0].Resolution || Faces[Index].IsHalf() != Faces[0].IsHalf())
+        {
+            return false;
+        }
+    }
+
+    return Precision != EOmniCapturePixelPrecision::Unknown;
+}
+
+void FOmniCaptureCPUCubemap::FillSeamBorders()
+{
+    if (!IsValid())
+    {
+        return;
+    }
+
+    const int32 Resolution = Faces[0].Resolution;
+    const double InvResolution = 1.0 / Resolution;
+
+    auto CopyAcrossSeam = [this, Resolution, InvResolution](int32 FaceIndex, int32 X, int32 Y)
+    {
+        const FVector2D UV((X + 0.5) * InvResolution, (Y + 0.5) * InvResolution);
+        const FVector Direction = FOmniCaptureCPUSampleMap::FaceUVToDirection(FaceIndex, UV);
+
+        int32 SourceFace = 0;
+        FVector2D SourceUV = FVector2D::ZeroVector;
+        FOmniCaptureCPUSampleMap::DirectionToFaceUV(Direction, SourceFace, SourceUV);
+
+        const int32 SourceX = FMath::Clamp(FMath::FloorToInt32(SourceUV.X * Resolution), 0, Resolution - 1);
+        const int32 SourceY = FMath::Clamp(FMath::FloorToInt32(SourceUV.Y * Resolution), 0, Resolution - 1);
+        if (Faces[FaceIndex].IsHalf())
+        {
+            Faces[FaceIndex].GetHalfRow(Y)[X] = Faces[SourceFace].GetHalfRow(SourceY)[SourceX];
+        }
+        else
+        {
+            Faces[FaceIndex].GetRow(Y)[X] = Faces[SourceFace].GetRow(SourceY)[SourceX];
+        }
+    };
+
+    for (int32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
+    {
+        for (int32 X = -1; X <= Resolution; ++X)
+        {
+            CopyAcrossSeam(FaceIndex, X, -1);
+            CopyAcrossSeam(FaceIndex, X, Resolution);
+        }
+
+        for (int32 Y = 0; Y < Resolution; ++Y)
+        {
+            CopyAcrossSeam(FaceIndex, -1, Y);
+            CopyAcrossSeam(FaceIndex, Resolution, Y);
+        }
+    }
+}
+
+void FOmniCaptureCPUSampler::SampleRun(
+    const FOmniCaptureCPUCubemap& LeftCubemap,
+    const FOmniCaptureCPUCubemap& RightCubemap,
+    const FOmniCaptureCPUSample* Samples,
+    int32 NumSamples,
+    EOmniCaptureCPUSampling Sampling,
+    FLinearColor* OutColors)
+{
+    const bool bHalf = LeftCubemap.Faces[0].IsHalf();
+    if (!ensureMsgf(!RightCubemap.IsValid() || RightCubemap.Faces[0].IsHalf() == bHalf, TEXT("Left and right cubemaps use different texel storage")))
+    {
+        for (int32 Index = 0; Index < NumSamples; ++Index)
+        {
+            OutColors[Index] = FLinearColor::Transparent;
+        }
+        return;
+    }
+
+    if (bHalf)
+    {
+        SampleRunTyped<FFloat16Color>(LeftCubemap, RightCubemap, Samples, NumSamples, Sampling, OutColors);
+    }
+    else
+    {
+        SampleRunTyped<FLinearColor>(LeftCubemap, RightCubemap, Samples, NumSamples, Sampling, OutColors);
+    }
+}
@@ -0,0 +1,226 @@
+#include "OmniCaptureColorConversion.h"
+
+#include "Math/VectorRegister.h"
+
+namespace
+{
+    // Linear values below 2^-13 encode to 0 and values from 1 up encode to 255. The octaves in between are split into
+    // 128 buckets each. No bucket spans a whole code, so it holds at most one rounding threshold, and storing
+    // that threshold next to the bucket's base code makes the lookup exact.
+    constexpr uint32 GSRGBTableMinBits = 114u << 23; // 2^-13
+    constexpr int32 GSRGBTableBucketBits = 7;
+    constexpr int32 GSRGBTableBucketShift = 23 - GSRGBTableBucketBits;
+    constexpr int32 GSRGBTableSize = 13 << GSRGBTableBucketBits;
+
+    constexpr float GBayer4x4[4][4] =
+    {
+        { 0.0f / 16.0f, 8.0f / 16.0f, 2.0f / 16.0f, 10.0f / 16.0f },
+        { 12.0f / 16.0f, 4.0f / 16.0f, 14.0f / 16.0f, 6.0f / 16.0f },
+        { 3.0f / 16.0f, 11.0f / 16.0f, 1.0f / 16.0f, 9.0f / 16.0f },
+        { 15.0f / 16.0f, 7.0f / 16.0f, 13.0f / 16.0f, 5.0f / 16.0f }
+    };
+
+    FORCEINLINE uint32 FloatBits(float Value)
+    {
+        uint32 Bits;
+        FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+        return Bits;
+    }
+
+    double DecodeSRGB(double Encoded)
+    {
+        return Encoded <= 0.04045 ? Encoded / 12.92 : FMath::Pow((Encoded + 0.055) / 1.055, 2.4);
+    }
+
+    struct FSRGBTable
+    {
+        float Thresholds[GSRGBTableSize];
+        uint8 Codes[GSRGBTableSize];
+
+        FSRGBTable()
+        {
+            // CodeStart[K] is the smallest linear value that rounds to code K.
+            float CodeStart[257];
+            CodeStart[0] = 0.0f;
+            for (int32 Code = 1; Code < 256; ++Code)
+            {
+                CodeStart[Code] = static_cast<float>(DecodeSRGB((Code - 0.5) / 255.0));
+            }
+            CodeStart[256] = MAX_flt;
+
+            int32 Code = 0;
+            for (int32 Index = 0; Index < GSRGBTableSize; ++Index)
+            {
+                const uint32 Bits = GSRGBTableMinBits + (static_cast<uint32>(Index) << GSRGBTableBucketShift);
+                float BucketStart;
+                FMemory::Memcpy(&BucketStart, &Bits, sizeof(BucketStart));
+                while (Code < 255 && CodeStart[Code + 1] <= BucketStart)
+                {
+                    ++Code;
+                }
+                Codes[Index] = static_cast<uint8>(Code);
+                Thresholds[Index] = CodeStart[Code + 1];
+            }
+        }
+
+        FORCEINLINE uint8 Encode(float Linear) const
+        {
+            if (!(Linear > 0.0f))
+            {
+                return 0;
+            }
+            if (Linear >= 1.0f)
+            {
+                return 255;
+            }
+
+            const uint32 Bits = FloatBits(Linear);
+            if (Bits < GSRGBTableMinBits)
+            {
+                return 0;
+            }
+
+            const uint32 Index = (Bits - GSRGBTableMinBits) >> GSRGBTableBucketShift;
+            return Codes[Index] + (Linear >= Thresholds[Index] ? 1 : 0);
+        }
+    };
+
+    const FSRGBTable& GetSRGBTable()
+    {
+        static const FSRGBTable Table;
+        return Table;
+    }
+
+    FORCEINLINE VectorRegister4Float LoadLinear(const FLinearColor& Pixel)
+    {
+        return VectorLoad(&Pixel.R);
+    }
+
+    FORCEINLINE VectorRegister4Float LoadLinear(const FFloat16Color& Pixel)
+    {
+        alignas(16) float Widened[4];
+        FPlatformMath::VectorLoadHalf(Widened, reinterpret_cast<const uint16*>(&Pixel));
+        return VectorLoadAligned(Widened);
+    }
+
+    /** Loads a pixel as clamped B, G, R, A lanes with RGB optionally sRGB encoded. */
+    template <typename PixelType>
+    FORCEINLINE VectorRegister4Float LoadEncoded(const PixelType& Pixel, bool bEncodeSRGB)
+    {
+        const VectorRegister4Float Linear = VectorMin(VectorMax(VectorSwizzle(LoadLinear(Pixel), 2, 1, 0, 3), VectorZeroFloat()), VectorOneFloat());
+        if (!bEncodeSRGB)
+        {
+            return Linear;
+        }
+
+        // Vectorized pow through the platform's polynomial exp/log; the linear toe is selected below 0.0031308.
+        const VectorRegister4Float Curve = VectorMultiplyAdd(VectorPow(Linear, VectorSetFloat1(1.0f / 2.4f)), VectorSetFloat1(1.055f), VectorSetFloat1(-0.055f));
+        const VectorRegister4Float Toe = VectorMultiply(Linear, VectorSetFloat1(12.92f));
+        const VectorRegister4Float Encoded = VectorSelect(VectorCompareGT(Linear, VectorSetFloat1(0.0031308f)), Curve, Toe);
+        return VectorSelect(GlobalVectorConstants::XYZMask(), Encoded, Linear);
+    }
+
+    /** Rounding offset per lane: 0.5 for round-to-nearest, or the Bayer threshold for RGB when dithering. */
+    FORCEINLINE VectorRegister4Float GetQuantizeOffset(int32 X, int32 RowIndex, bool bDither)
+    {
+        if (!bDither)
+        {
+            return VectorSetFloat1(0.5f);
+        }
+
+        const float Threshold = GBayer4x4[RowIndex & 3][X & 3];
+        return VectorSet(Threshold, Threshold, Threshold, 0.5f);
+    }
+
+    /**
+     * Table encoding with the clamp, bucket index, threshold compare and byte packing done on B, G, R, A lanes at once.
+     * The vector abstraction has no gather, so only the three table reads per pixel stay scalar.
+     */
+    template <typename PixelType>
+    void ConvertRowToSRGB8(const PixelType* Source, FColor* Dest, int32 Count)
+    {
+        const FSRGBTable& Table = GetSRGBTable();
+        const VectorRegister4Int MinBits = VectorIntSet1(static_cast<int32>(GSRGBTableMinBits));
+        const VectorRegister4Int MaxIndex = VectorIntSet1(GSRGBTableSize - 1);
+        // Alpha follows FLinearColor::ToFColor so opaque and transparent pixels are unchanged.
+        const VectorRegister4Float AlphaScale = VectorSetFloat1(255.999f);
+        alignas(16) int32 Indices[4];
+
+        for (int32 X = 0; X < Count; ++X)
+        {
+            const VectorRegister4Float Linear = VectorMin(VectorMax(VectorSwizzle(LoadLinear(Source[X]), 2, 1, 0, 3), VectorZeroFloat()), VectorOneFloat());
+
+            // Clamped values are non-negative, so their bit patterns order like the values. Anything below the table
+            // lands in bucket 0, whose threshold is above it, and 1.0 lands in the last bucket, which encodes 255.
+            const VectorRegister4Int Offset = VectorIntMax(VectorIntSubtract(VectorCastFloatToInt(Linear), MinBits), GlobalVectorConstants::IntZero);
+            VectorIntStoreAligned(VectorIntMin(VectorShiftRightImmLogical(Offset, GSRGBTableBucketShift), MaxIndex), Indices);
+
+            const VectorRegister4Float Base = VectorSet(Table.Codes[Indices[0]], Table.Codes[Indices[1]], Table.Codes[Indices[2]], 0.0f);
+            const VectorRegister4Float Threshold = VectorSet(Table.Thresholds[Indices[0]], Table.Thresholds[Indices[1]], Table.Thresholds[Indices[2]], MAX_flt);
+            const VectorRegister4Float Codes = VectorAdd(Base, VectorSelect(VectorCompareGE(Linear, Threshold), VectorOneFloat(), VectorZeroFloat()));
+
+            // Codes are whole numbers and VectorStoreByte4 truncates, which floors the scaled alpha.
+            VectorStoreByte4(VectorSelect(GlobalVectorConstants::XYZMask(), Codes, VectorMultiply(Linear, AlphaScale)), &Dest[X]);
+        }
+    }
+
+    template <typename PixelType>
+    void ConvertRowTo8(const PixelType* Source, FColor* Dest, int32 Count, int32 RowIndex, const FOmniCaptureQuantizeOptions& Options)
+    {
+        if (Options.bEncodeSRGB && !Options.bDither)
+        {
+            ConvertRowToSRGB8(Source, Dest, Count);
+            return;
+        }
+
+        const VectorRegister4Float Scale = VectorSetFloat1(255.0f);
+        for (int32 X = 0; X < Count; ++X)
+        {
+            const VectorRegister4Float Encoded = LoadEncoded(Source[X], Options.bEncodeSRGB);
+            // VectorStoreByte4 truncates; the offset supplies the rounding or the dither.
+            VectorStoreByte4(VectorMultiplyAdd(Encoded, Scale, GetQuantizeOffset(X, RowIndex, Options.bDither)), &Dest[X]);
+        }
+    }
+
+    template <typename PixelType>
+    void ConvertRowTo16(const PixelType* Source, uint16* Dest, int32 Count, int32 RowIndex, const FOmniCaptureQuantizeOptions& Options)
+    {
+        const VectorRegister4Float Scale = VectorSetFloat1(65535.0f);
+        alignas(16) float Quantized[4];
+        for (int32 X = 0; X < Count; ++X)
+        {
+            const VectorRegister4Float Encoded = LoadEncoded(Source[X], Options.bEncodeSRGB);
+            VectorStoreAligned(VectorMultiplyAdd(Encoded, Scale, GetQuantizeOffset(X, RowIndex, Options.bDither)), Quantized);
+            uint16* Pixel = Dest + static_cast<int64>(X) * 4;
+            Pixel[0] = static_cast<uint16>(Quantized[0]);
+            Pixel[1] = static_cast<uint16>(Quantized[1]);
+            Pixel[2] = static_cast<uint16>(Quantized[2]);
+            Pixel[3] = static_cast<uint16>(Quantized[3]);
+        }
+    }
+}
+
+void FOmniCaptureColorConversion::ConvertRow(const FLinearColor* Source, FColor* Dest, int32 Count, int32 RowIndex, const FOmniCaptureQuantizeOptions& Options)
+{
+    ConvertRowTo8(Source, Dest, Count, RowIndex, Options);
+}
+
+void FOmniCaptureColorConversion::ConvertRow(const FFloat16Color* Source, FColor* Dest, int32 Count, int32 RowIndex, const FOmniCaptureQuantizeOptions& Options)
+{
+    ConvertRowTo8(Source, Dest, Count, RowIndex, Options);
+}
+
+void FOmniCaptureColorConversion::ConvertRow(const FLinearColor* Source, uint16* Dest, int32 Count, int32 RowIndex, const FOmniCaptureQuantizeOptions& Options)
+{
+    ConvertRowTo16(Source, Dest, Count, RowIndex, Options);
+}
+
+void FOmniCaptureColorConversion::ConvertRow(const FFloat16Color* Source, uint16* Dest, int32 Count, int32 RowIndex, const FOmniCaptureQuantizeOptions& Options)
+{
+    ConvertRowTo16(Source, Dest, Count, RowIndex, Options);
+}
+
+uint8 FOmniCaptureColorConversion::LinearToSRGB8(float Linear)
+{
+    return GetSRGBTable().Encode(Linear);
+}
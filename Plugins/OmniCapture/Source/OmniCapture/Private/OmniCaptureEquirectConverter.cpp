@@ -2,6 +2,10 @@
 
 #include "OmniCaptureIncludeFixes.h" // 统一兼容：TRT2D + TRTResource
 #include "OmniCaptureTypes.h"
+#include "OmniCaptureCPUSampleMap.h"
+#include "OmniCaptureCPUSampler.h"
+#include "OmniCaptureBufferPool.h"
+#include "OmniCaptureColorConversion.h"
 
 #include "GlobalShader.h"
 #include "PixelShaderUtils.h"
@@ -20,39 +24,47 @@
 #endif
 #include "RHICommandList.h"
 #include "HAL/PlatformProcess.h"
+#include "HAL/IConsoleManager.h"
+#include "Async/ParallelFor.h"
+#include "Math/VectorRegister.h"
+#include "Misc/ScopeLock.h"
 
 namespace
 {
-    struct FCPUFaceData
+    // Set by the capturing subsystem for the lifetime of a capture; conversions run on the game and render threads.
+    TSharedPtr<FOmniCaptureBufferPool, ESPMode::ThreadSafe> GActiveBufferPool;
+    FCriticalSection GActiveBufferPoolCS;
+
+    TSharedPtr<FOmniCaptureBufferPool, ESPMode::ThreadSafe> GetActiveBufferPool()
     {
-        int32 Resolution = 0;
-        EOmniCapturePixelPrecision Precision = EOmniCapturePixelPrecision::Unknown;
-        TArray<FLinearColor> Pixels;
+        FScopeLock Lock(&GActiveBufferPoolCS);
+        return GActiveBufferPool;
+    }
 
-        bool IsValid() const
+    /** Output pixels are uninitialized; every caller overwrites the full image. */
+    template <typename PixelType>
+    TUniquePtr<TImagePixelData<PixelType>> AllocatePixelData(const FIntPoint& Size)
+    {
+        if (const TSharedPtr<FOmniCaptureBufferPool, ESPMode::ThreadSafe> Pool = GetActiveBufferPool())
         {
-            return Resolution > 0 && Pixels.Num() == Resolution * Resolution;
+            return Pool->AcquirePixelData<PixelType>(Size);
         }
-    };
 
-    struct FCPUCubemap
-    {
-        FCPUFaceData Faces[6];
-        EOmniCapturePixelPrecision Precision = EOmniCapturePixelPrecision::Unknown;
+        TUniquePtr<TImagePixelData<PixelType>> PixelData = MakeUnique<TImagePixelData<PixelType>>(Size);
+        PixelData->Pixels.SetNumUninitialized(static_cast<int64>(Size.X) * Size.Y);
+        return PixelData;
+    }
 
-        bool IsValid() const
+    void AllocatePreviewPixels(TArray<FColor>& OutPixels, int32 PixelCount)
+    {
+        if (const TSharedPtr<FOmniCaptureBufferPool, ESPMode::ThreadSafe> Pool = GetActiveBufferPool())
         {
-            for (int32 Index = 0; Index < 6; ++Index)
-            {
-                if (!Faces[Index].IsValid())
-                {
-                    return false;
-                }
-            }
-
-            return Precision != EOmniCapturePixelPrecision::Unknown;
+            Pool->AcquirePreviewPixels(OutPixels, PixelCount);
+            return;
         }
-    };
+
+        OutPixels.SetNumUninitialized(PixelCount);
+    }
 
     EOmniCapturePixelPrecision PixelPrecisionFromFormat(EPixelFormat Format)
     {
@@ -236,7 +248,7 @@ namespace
 
     IMPLEMENT_GLOBAL_SHADER(FOmniConvertToBGRACS, "/Plugin/OmniCapture/Private/OmniColorConvertCS.usf", "ConvertBGRA", SF_Compute);
 
-    bool ReadFaceData(UTextureRenderTarget2D* RenderTarget, FCPUFaceData& OutFace)
+    bool ReadFaceData(UTextureRenderTarget2D* RenderTarget, FOmniCaptureCPUFace& OutFace)
     {
         if (!RenderTarget)
         {
@@ -256,7 +268,6 @@ namespace
             return false;
         }
 
-        OutFace.Pixels.Reset();
         OutFace.Precision = PixelPrecisionFromFormat(RenderTarget->GetFormat());
 
         // Use the standard UNorm readback mode instead of the Min/Max resolve
@@ -270,32 +281,39 @@ namespace
 
         if (OutFace.Precision == EOmniCapturePixelPrecision::FullFloat)
         {
-            if (!Resource->ReadLinearColorPixels(OutFace.Pixels, Flags, FIntRect()))
+            TArray<FLinearColor> LinearPixels;
+            if (!Resource->ReadLinearColorPixels(LinearPixels, Flags, FIntRect()) || LinearPixels.Num() != SizeX * SizeY)
             {
                 return false;
             }
+
+            OutFace.Allocate(SizeX);
+            for (int32 Row = 0; Row < SizeY; ++Row)
+            {
+                FMemory::Memcpy(OutFace.GetRow(Row), LinearPixels.GetData() + Row * SizeX, SizeX * sizeof(FLinearColor));
+            }
         }
         else
         {
             TArray<FFloat16Color> HalfPixels;
-            if (!Resource->ReadFloat16Pixels(HalfPixels, Flags, FIntRect()))
+            if (!Resource->ReadFloat16Pixels(HalfPixels, Flags, FIntRect()) || HalfPixels.Num() != SizeX * SizeY)
             {
                 return false;
             }
 
+            // Half faces stay half; the sampler widens only the texels it taps.
             OutFace.Precision = EOmniCapturePixelPrecision::HalfFloat;
-            OutFace.Pixels.SetNum(HalfPixels.Num());
-            for (int32 Index = 0; Index < HalfPixels.Num(); ++Index)
+            OutFace.Allocate(SizeX);
+            for (int32 Row = 0; Row < SizeY; ++Row)
             {
-                OutFace.Pixels[Index] = FLinearColor(HalfPixels[Index]);
+                FMemory::Memcpy(OutFace.GetHalfRow(Row), HalfPixels.GetData() + Row * SizeX, SizeX * sizeof(FFloat16Color));
             }
         }
 
-        OutFace.Resolution = SizeX;
         return OutFace.IsValid();
     }
 
-    bool BuildCPUCubemap(const FOmniEyeCapture& Eye, FCPUCubemap& OutCubemap)
+    bool BuildCPUCubemap(const FOmniEyeCapture& Eye, FOmniCaptureCPUCubemap& OutCubemap, EOmniCaptureCPUSampling Sampling)
     {
         OutCubemap.Precision = EOmniCapturePixelPrecision::Unknown;
 
@@ -317,150 +335,17 @@ namespace
             }
         }
 
-        return OutCubemap.IsValid();
-    }
-
-    FVector DirectionFromEquirectPixelCPU(const FIntPoint& Pixel, const FIntPoint& EyeResolution, double LongitudeSpan, double LatitudeSpan, float& OutLatitude)
-    {
-        const FVector2D UV((static_cast<double>(Pixel.X) + 0.5) / EyeResolution.X, (static_cast<double>(Pixel.Y) + 0.5) / EyeResolution.Y);
-        const double Longitude = (UV.X * 2.0 - 1.0) * LongitudeSpan;
-        const double Latitude = (0.5 - UV.Y) * LatitudeSpan * 2.0;
-        OutLatitude = static_cast<float>(Latitude);
-
-        const double CosLat = FMath::Cos(Latitude);
-        const double SinLat = FMath::Sin(Latitude);
-        const double CosLon = FMath::Cos(Longitude);
-        const double SinLon = FMath::Sin(Longitude);
-
-        FVector Direction;
-        Direction.X = CosLat * CosLon;
-        Direction.Y = SinLat;
-        Direction.Z = CosLat * SinLon;
-        return Direction.GetSafeNormal();
-    }
-
-    FVector DirectionFromFisheyePixelCPU(const FIntPoint& Pixel, const FIntPoint& EyeResolution, double FovRadians, bool& bOutValid)
-    {
-        if (EyeResolution.X <= 0 || EyeResolution.Y <= 0)
-        {
-            bOutValid = false;
-            return FVector::ZeroVector;
-        }
-
-        const FVector2D UV((static_cast<double>(Pixel.X) + 0.5) / EyeResolution.X, (static_cast<double>(Pixel.Y) + 0.5) / EyeResolution.Y);
-        FVector2D Normalized = FVector2D(UV.X * 2.0 - 1.0, 1.0 - UV.Y * 2.0);
-
-        const double Radius = Normalized.Size();
-        if (Radius > 1.0)
-        {
-            bOutValid = false;
-            return FVector::ZeroVector;
-        }
-
-        const double HalfFov = FMath::Clamp(FovRadians * 0.5, 0.0, PI);
-        const double Theta = Radius * HalfFov;
-        const double Phi = FMath::Atan2(Normalized.Y, Normalized.X);
-        const double SinTheta = FMath::Sin(Theta);
-
-        FVector Direction;
-        Direction.X = FMath::Cos(Theta);
-        Direction.Y = SinTheta * FMath::Sin(Phi);
-        Direction.Z = SinTheta * FMath::Cos(Phi);
-
-        bOutValid = true;
-        return Direction.GetSafeNormal();
-    }
-
-    void DirectionToFaceUVCPU(const FVector& Direction, uint32& OutFaceIndex, FVector2D& OutUV, int32 FaceResolution, float SeamStrength)
-    {
-        const FVector AbsDir = Direction.GetAbs();
-
-        if (AbsDir.X >= AbsDir.Y && AbsDir.X >= AbsDir.Z)
-        {
-            if (Direction.X > 0.0f)
-            {
-                OutFaceIndex = 0;
-                OutUV = FVector2D(-Direction.Z, Direction.Y) / AbsDir.X;
-            }
-            else
-            {
-                OutFaceIndex = 1;
-                OutUV = FVector2D(Direction.Z, Direction.Y) / AbsDir.X;
-            }
-        }
-        else if (AbsDir.Y >= AbsDir.X && AbsDir.Y >= AbsDir.Z)
-        {
-            if (Direction.Y > 0.0f)
-            {
-                OutFaceIndex = 2;
-                OutUV = FVector2D(Direction.X, -Direction.Z) / AbsDir.Y;
-            }
-            else
-            {
-                OutFaceIndex = 3;
-                OutUV = FVector2D(Direction.X, Direction.Z) / AbsDir.Y;
-            }
-        }
-        else
-        {
-            if (Direction.Z > 0.0f)
-            {
-                OutFaceIndex = 4;
-                OutUV = FVector2D(Direction.X, Direction.Y) / AbsDir.Z;
-            }
-            else
-            {
-                OutFaceIndex = 5;
-                OutUV = FVector2D(-Direction.X, Direction.Y) / AbsDir.Z;
-            }
-        }
-
-        OutUV = (OutUV + FVector2D(1.0, 1.0)) * 0.5f;
-
-        const double Resolution = static_cast<double>(FMath::Max(1, FaceResolution));
-        const double Scale = FMath::Lerp(1.0, (Resolution - 1.0) / Resolution, SeamStrength);
-        const double Bias = (0.5 / Resolution) * SeamStrength;
-        OutUV = FVector2D(OutUV.X * Scale + Bias, OutUV.Y * Scale + Bias);
-        OutUV.X = FMath::Clamp(OutUV.X, 0.0f, 1.0f);
-        OutUV.Y = FMath::Clamp(OutUV.Y, 0.0f, 1.0f);
-    }
-
-    FLinearColor SampleCubemapCPU(const FCPUCubemap& Cubemap, const FVector& Direction, int32 FaceResolution, float SeamStrength)
-    {
-        uint32 FaceIndex = 0;
-        FVector2D FaceUV = FVector2D::ZeroVector;
-        DirectionToFaceUVCPU(Direction, FaceIndex, FaceUV, FaceResolution, SeamStrength);
-
-        const FCPUFaceData& Face = Cubemap.Faces[FaceIndex];
-        const int32 SampleX = FMath::Clamp(static_cast<int32>(FaceUV.X * (Face.Resolution - 1)), 0, Face.Resolution - 1);
-        const int32 SampleY = FMath::Clamp(static_cast<int32>(FaceUV.Y * (Face.Resolution - 1)), 0, Face.Resolution - 1);
-        const int32 SampleIndex = SampleY * Face.Resolution + SampleX;
-
-        return Face.Pixels.IsValidIndex(SampleIndex)
-            ? FLinearColor(Face.Pixels[SampleIndex])
-            : FLinearColor::Black;
-    }
-
-    void ApplyPolarMitigation(float PolarStrength, float Latitude, FVector& Direction)
-    {
-        if (PolarStrength <= 0.0f)
+        if (!OutCubemap.IsValid())
         {
-            return;
+            return false;
         }
 
-        double PoleFactor = FMath::Clamp(FMath::Abs(Latitude) / (PI * 0.5), 0.0, 1.0);
-        PoleFactor = FMath::Pow(PoleFactor, 4.0);
-        const double Blend = PoleFactor * PolarStrength;
-        if (Blend <= 0.0)
+        if (Sampling == EOmniCaptureCPUSampling::Bilinear)
         {
-            return;
+            OutCubemap.FillSeamBorders();
         }
 
-        const FVector PoleVector(0.0f, Latitude >= 0.0f ? 1.0f : -1.0f, 0.0f);
-        Direction = FVector(FMath::Lerp(Direction.X, PoleVector.X, Blend),
-            FMath::Lerp(Direction.Y, PoleVector.Y, Blend),
-            FMath::Lerp(Direction.Z, PoleVector.Z, Blend));
-        Direction.Normalize();
+        return true;
     }
 
     void AddYUVConversionPasses(
@@ -597,7 +482,111 @@ namespace
         return ArrayTexture;
     }
 
-    void ConvertOnRenderThread(const FOmniCaptureSettings Settings, const TArray<FTextureRHIRef, TInlineAllocator<6>> LeftFaces, const TArray<FTextureRHIRef, TInlineAllocator<6>> RightFaces, FOmniCaptureEquirectResult& OutResult)
+    /** Copies a finished readback into OutResult's pixel buffer. Render thread only. */
+    void ResolveReadback(FRHIGPUTextureReadback& Readback, const FIntPoint& OutputSize, EOmniCapturePixelPrecision Precision, bool bUseLinear, FOmniCaptureEquirectResult& OutResult)
+    {
+        const int32 OutputWidth = OutputSize.X;
+        const int32 OutputHeight = OutputSize.Y;
+        const uint32 BytesPerPixel = Precision == EOmniCapturePixelPrecision::FullFloat ? sizeof(FLinearColor) : sizeof(FFloat16Color);
+        int32 RowPitchInPixels = 0;
+        const uint8* RawData = static_cast<const uint8*>(Readback.Lock(RowPitchInPixels));
+
+        if (RawData)
+        {
+            const uint32 RowPitch = RowPitchInPixels > 0 ? static_cast<uint32>(RowPitchInPixels) : static_cast<uint32>(OutputWidth);
+            if (bUseLinear)
+            {
+                if (Precision == EOmniCapturePixelPrecision::FullFloat)
+                {
+                    TUniquePtr<TImagePixelData<FLinearColor>> PixelData = AllocatePixelData<FLinearColor>(FIntPoint(OutputWidth, OutputHeight));
+
+                    FLinearColor* DestData = PixelData->Pixels.GetData();
+                    const FLinearColor* SourcePixels = reinterpret_cast<const FLinearColor*>(RawData);
+                    for (int32 Row = 0; Row < OutputHeight; ++Row)
+                    {
+                        const FLinearColor* SourceRow = SourcePixels + RowPitch * Row;
+                        FMemory::Memcpy(DestData + Row * OutputWidth, SourceRow, OutputWidth * BytesPerPixel);
+                    }
+
+                    OutResult.PixelData = MoveTemp(PixelData);
+                    OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat32;
+                }
+                else
+                {
+                    TUniquePtr<TImagePixelData<FFloat16Color>> PixelData = AllocatePixelData<FFloat16Color>(FIntPoint(OutputWidth, OutputHeight));
+
+                    FFloat16Color* DestData = PixelData->Pixels.GetData();
+                    const FFloat16Color* SourcePixels = reinterpret_cast<const FFloat16Color*>(RawData);
+                    for (int32 Row = 0; Row < OutputHeight; ++Row)
+                    {
+                        const FFloat16Color* SourceRow = SourcePixels + RowPitch * Row;
+                        FMemory::Memcpy(DestData + Row * OutputWidth, SourceRow, OutputWidth * BytesPerPixel);
+                    }
+
+                    OutResult.PixelData = MoveTemp(PixelData);
+                    OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat16;
+                }
+            }
+            else
+            {
+                TUniquePtr<TImagePixelData<FColor>> PixelData = AllocatePixelData<FColor>(FIntPoint(OutputWidth, OutputHeight));
+
+                // Same quantization as the image writers, so a frame encodes identically whichever side converts it.
+                const FOmniCaptureQuantizeOptions QuantizeOptions;
+                const uint8* SourcePixels = RawData;
+                for (int32 Row = 0; Row < OutputHeight; ++Row)
+                {
+                    const uint8* SourceRow = SourcePixels + (RowPitch * Row * BytesPerPixel);
+                    FColor* DestRow = PixelData->Pixels.GetData() + Row * OutputWidth;
+                    if (Precision == EOmniCapturePixelPrecision::FullFloat)
+                    {
+                        FOmniCaptureColorConversion::ConvertRow(reinterpret_cast<const FLinearColor*>(SourceRow), DestRow, OutputWidth, Row, QuantizeOptions);
+                    }
+                    else
+                    {
+                        FOmniCaptureColorConversion::ConvertRow(reinterpret_cast<const FFloat16Color*>(SourceRow), DestRow, OutputWidth, Row, QuantizeOptions);
+                    }
+                }
+
+                OutResult.PixelData = MoveTemp(PixelData);
+                OutResult.PixelDataType = EOmniCapturePixelDataType::Color8;
+            }
+        }
+
+        Readback.Unlock();
+        OutResult.PixelPrecision = Precision;
+    }
+
+    /**
+     * Queues the copy of the converted output. Without an async conversion this waits for the GPU and resolves in
+     * place; with one, the readback is parked on it and resolved by a later poll.
+     */
+    void SubmitReadback(FRHICommandListImmediate& RHICmdList, FRHITexture* OutputTextureRHI, const FIntPoint& OutputSize, EOmniCapturePixelPrecision Precision, bool bUseLinear, const TCHAR* ReadbackName, FOmniCaptureEquirectResult& OutResult, FOmniCaptureAsyncConversion* AsyncConversion)
+    {
+        TUniquePtr<FRHIGPUTextureReadback> Readback = MakeUnique<FRHIGPUTextureReadback>(ReadbackName);
+        Readback->EnqueueCopy(RHICmdList, OutputTextureRHI, FResolveRect(0, 0, OutputSize.X, OutputSize.Y));
+
+        if (AsyncConversion)
+        {
+            RHICmdList.ImmediateFlush(EImmediateFlushType::DispatchToRHIThread);
+            AsyncConversion->Readback = MoveTemp(Readback);
+            AsyncConversion->ReadbackSize = OutputSize;
+            AsyncConversion->ReadbackPrecision = Precision;
+            AsyncConversion->bReadbackLinear = bUseLinear;
+            return;
+        }
+
+        RHICmdList.SubmitCommandsAndFlushGPU();
+
+        while (!Readback->IsReady())
+        {
+            FPlatformProcess::SleepNoStats(0.001f);
+        }
+
+        ResolveReadback(*Readback, OutputSize, Precision, bUseLinear, OutResult);
+    }
+
+    void ConvertOnRenderThread(const FOmniCaptureSettings Settings, const TArray<FTextureRHIRef, TInlineAllocator<6>> LeftFaces, const TArray<FTextureRHIRef, TInlineAllocator<6>> RightFaces, FOmniCaptureEquirectResult& OutResult, FOmniCaptureAsyncConversion* AsyncConversion = nullptr)
     {
         const int32 FaceResolution = Settings.Resolution;
         const bool bStereo = Settings.Mode == EOmniCaptureMode::Stereo;
@@ -741,120 +730,10 @@ namespace
             return;
         }
 
-        FRHIGPUTextureReadback Readback(TEXT("OmniEquirectReadback"));
-        Readback.EnqueueCopy(RHICmdList, OutputTextureRHI, FResolveRect(0, 0, OutputWidth, OutputHeight));
-        RHICmdList.SubmitCommandsAndFlushGPU();
-
-        while (!Readback.IsReady())
-        {
-            FPlatformProcess::SleepNoStats(0.001f);
-        }
-
-        const uint32 PixelCount = OutputWidth * OutputHeight;
-        const uint32 BytesPerPixel = Precision == EOmniCapturePixelPrecision::FullFloat ? sizeof(FLinearColor) : sizeof(FFloat16Color);
-        int32 RowPitchInPixels = 0;
-        const uint8* RawData = static_cast<const uint8*>(Readback.Lock(RowPitchInPixels));
-
-        if (RawData)
-        {
-            const uint32 RowPitch = RowPitchInPixels > 0 ? static_cast<uint32>(RowPitchInPixels) : static_cast<uint32>(OutputWidth);
-            if (bUseLinear)
-            {
-                if (Precision == EOmniCapturePixelPrecision::FullFloat)
-                {
-                    TUniquePtr<TImagePixelData<FLinearColor>> PixelData = MakeUnique<TImagePixelData<FLinearColor>>(FIntPoint(OutputWidth, OutputHeight));
-                    PixelData->Pixels.SetNum(PixelCount);
-
-                    FLinearColor* DestData = PixelData->Pixels.GetData();
-                    const FLinearColor* SourcePixels = reinterpret_cast<const FLinearColor*>(RawData);
-                    for (int32 Row = 0; Row < OutputHeight; ++Row)
-                    {
-                        const FLinearColor* SourceRow = SourcePixels + RowPitch * Row;
-                        FMemory::Memcpy(DestData + Row * OutputWidth, SourceRow, OutputWidth * BytesPerPixel);
-                    }
-
-                    OutResult.PixelData = MoveTemp(PixelData);
-                    OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat32;
-
-                    OutResult.PreviewPixels.SetNum(PixelCount);
-                    const TImagePixelData<FLinearColor>* FloatData = static_cast<const TImagePixelData<FLinearColor>*>(OutResult.PixelData.Get());
-                    if (FloatData)
-                    {
-                        for (uint32 Index = 0; Index < PixelCount; ++Index)
-                        {
-                            OutResult.PreviewPixels[Index] = FloatData->Pixels[Index].ToFColor(true);
-                        }
-                    }
-                }
-                else
-                {
-                    TUniquePtr<TImagePixelData<FFloat16Color>> PixelData = MakeUnique<TImagePixelData<FFloat16Color>>(FIntPoint(OutputWidth, OutputHeight));
-                    PixelData->Pixels.SetNum(PixelCount);
-
-                    FFloat16Color* DestData = PixelData->Pixels.GetData();
-                    const FFloat16Color* SourcePixels = reinterpret_cast<const FFloat16Color*>(RawData);
-                    for (int32 Row = 0; Row < OutputHeight; ++Row)
-                    {
-                        const FFloat16Color* SourceRow = SourcePixels + RowPitch * Row;
-                        FMemory::Memcpy(DestData + Row * OutputWidth, SourceRow, OutputWidth * BytesPerPixel);
-                    }
-
-                    OutResult.PixelData = MoveTemp(PixelData);
-                    OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat16;
-
-                    OutResult.PreviewPixels.SetNum(PixelCount);
-                    const TImagePixelData<FFloat16Color>* FloatData = static_cast<const TImagePixelData<FFloat16Color>*>(OutResult.PixelData.Get());
-                    if (FloatData)
-                    {
-                        for (uint32 Index = 0; Index < PixelCount; ++Index)
-                        {
-                            const FFloat16Color& Source = FloatData->Pixels[Index];
-                            const FLinearColor Linear(Source.R.GetFloat(), Source.G.GetFloat(), Source.B.GetFloat(), Source.A.GetFloat());
-                            OutResult.PreviewPixels[Index] = Linear.ToFColor(true);
-                        }
-                    }
-                }
-            }
-            else
-            {
-                TUniquePtr<TImagePixelData<FColor>> PixelData = MakeUnique<TImagePixelData<FColor>>(FIntPoint(OutputWidth, OutputHeight));
-                PixelData->Pixels.SetNum(PixelCount);
-                OutResult.PreviewPixels.SetNum(PixelCount);
-
-                const uint8* SourcePixels = RawData;
-                for (int32 Row = 0; Row < OutputHeight; ++Row)
-                {
-                    const uint8* SourceRow = SourcePixels + (RowPitch * Row * BytesPerPixel);
-                    FColor* DestRow = PixelData->Pixels.GetData() + Row * OutputWidth;
-                    for (int32 Column = 0; Column < OutputWidth; ++Column)
-                    {
-                        FLinearColor Linear;
-                        if (Precision == EOmniCapturePixelPrecision::FullFloat)
-                        {
-                            const FLinearColor* Pixel = reinterpret_cast<const FLinearColor*>(SourceRow) + Column;
-                            Linear = *Pixel;
-                        }
-                        else
-                        {
-                            const FFloat16Color* Pixel = reinterpret_cast<const FFloat16Color*>(SourceRow) + Column;
-                            Linear = FLinearColor(Pixel->R.GetFloat(), Pixel->G.GetFloat(), Pixel->B.GetFloat(), Pixel->A.GetFloat());
-                        }
-                        const FColor SRGB = Linear.ToFColor(true);
-                        DestRow[Column] = SRGB;
-                        OutResult.PreviewPixels[Row * OutputWidth + Column] = SRGB;
-                    }
-                }
-
-                OutResult.PixelData = MoveTemp(PixelData);
-                OutResult.PixelDataType = EOmniCapturePixelDataType::Color8;
-            }
-        }
-
-        Readback.Unlock();
-        OutResult.PixelPrecision = Precision;
+        SubmitReadback(RHICmdList, OutputTextureRHI, FIntPoint(OutputWidth, OutputHeight), Precision, bUseLinear, TEXT("OmniEquirectReadback"), OutResult, AsyncConversion);
     }
 
-    void ConvertFisheyeOnRenderThread(const FOmniCaptureSettings Settings, const TArray<FTextureRHIRef, TInlineAllocator<6>> LeftFaces, const TArray<FTextureRHIRef, TInlineAllocator<6>> RightFaces, FOmniCaptureEquirectResult& OutResult)
+    void ConvertFisheyeOnRenderThread(const FOmniCaptureSettings Settings, const TArray<FTextureRHIRef, TInlineAllocator<6>> LeftFaces, const TArray<FTextureRHIRef, TInlineAllocator<6>> RightFaces, FOmniCaptureEquirectResult& OutResult, FOmniCaptureAsyncConversion* AsyncConversion = nullptr)
     {
         const int32 FaceResolution = Settings.Resolution;
         const bool bStereo = Settings.Mode == EOmniCaptureMode::Stereo;
@@ -1011,140 +890,30 @@ namespace
             return;
         }
 
-        FRHIGPUTextureReadback Readback(TEXT("OmniFisheyeReadback"));
-        Readback.EnqueueCopy(RHICmdList, OutputTextureRHI, FResolveRect(0, 0, OutputSize.X, OutputSize.Y));
-        RHICmdList.SubmitCommandsAndFlushGPU();
+        SubmitReadback(RHICmdList, OutputTextureRHI, OutputSize, Precision, bUseLinear, TEXT("OmniFisheyeReadback"), OutResult, AsyncConversion);
+    }
+}
 
-        while (!Readback.IsReady())
+    void ConvertPlanarOnRenderThread(const FOmniCaptureSettings Settings, FTextureRHIRef SourceTexture, const FIntPoint OutputSize, bool bSourceLinear, FOmniCaptureEquirectResult& OutResult)
+    {
+        if (!SourceTexture.IsValid())
         {
-            FPlatformProcess::SleepNoStats(0.001f);
+            return;
         }
 
-        const uint32 PixelCount = OutputSize.X * OutputSize.Y;
-        const uint32 BytesPerPixel = Precision == EOmniCapturePixelPrecision::FullFloat ? sizeof(FLinearColor) : sizeof(FFloat16Color);
-        int32 RowPitchInPixels = 0;
-        const uint8* RawData = static_cast<const uint8*>(Readback.Lock(RowPitchInPixels));
+        const int32 OutputWidth = OutputSize.X;
+        const int32 OutputHeight = OutputSize.Y;
 
-        if (RawData)
+        FRHICommandListImmediate& RHICmdList = FRHICommandListExecutor::GetImmediateCommandList();
+        FRDGBuilder GraphBuilder(RHICmdList);
+
+        EOmniCapturePixelPrecision Precision = PixelPrecisionFromFormat(SourceTexture->GetFormat());
+        if (Precision == EOmniCapturePixelPrecision::Unknown)
         {
-            const uint32 RowPitch = RowPitchInPixels > 0 ? static_cast<uint32>(RowPitchInPixels) : static_cast<uint32>(OutputSize.X);
-            if (bUseLinear)
-            {
-                if (Precision == EOmniCapturePixelPrecision::FullFloat)
-                {
-                    TUniquePtr<TImagePixelData<FLinearColor>> PixelData = MakeUnique<TImagePixelData<FLinearColor>>(OutputSize);
-                    PixelData->Pixels.SetNum(PixelCount);
-
-                    FLinearColor* DestData = PixelData->Pixels.GetData();
-                    const FLinearColor* SourcePixels = reinterpret_cast<const FLinearColor*>(RawData);
-                    for (int32 Row = 0; Row < OutputSize.Y; ++Row)
-                    {
-                        const FLinearColor* SourceRow = SourcePixels + RowPitch * Row;
-                        FMemory::Memcpy(DestData + Row * OutputSize.X, SourceRow, OutputSize.X * BytesPerPixel);
-                    }
-
-                    OutResult.PixelData = MoveTemp(PixelData);
-                    OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat32;
-
-                    OutResult.PreviewPixels.SetNum(PixelCount);
-                    const TImagePixelData<FLinearColor>* FloatData = static_cast<const TImagePixelData<FLinearColor>*>(OutResult.PixelData.Get());
-                    if (FloatData)
-                    {
-                        for (uint32 Index = 0; Index < PixelCount; ++Index)
-                        {
-                            OutResult.PreviewPixels[Index] = FloatData->Pixels[Index].ToFColor(true);
-                        }
-                    }
-                }
-                else
-                {
-                    TUniquePtr<TImagePixelData<FFloat16Color>> PixelData = MakeUnique<TImagePixelData<FFloat16Color>>(OutputSize);
-                    PixelData->Pixels.SetNum(PixelCount);
-
-                    FFloat16Color* DestData = PixelData->Pixels.GetData();
-                    const FFloat16Color* SourcePixels = reinterpret_cast<const FFloat16Color*>(RawData);
-                    for (int32 Row = 0; Row < OutputSize.Y; ++Row)
-                    {
-                        const FFloat16Color* SourceRow = SourcePixels + RowPitch * Row;
-                        FMemory::Memcpy(DestData + Row * OutputSize.X, SourceRow, OutputSize.X * BytesPerPixel);
-                    }
-
-                    OutResult.PixelData = MoveTemp(PixelData);
-                    OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat16;
-
-                    OutResult.PreviewPixels.SetNum(PixelCount);
-                    const TImagePixelData<FFloat16Color>* FloatData = static_cast<const TImagePixelData<FFloat16Color>*>(OutResult.PixelData.Get());
-                    if (FloatData)
-                    {
-                        for (uint32 Index = 0; Index < PixelCount; ++Index)
-                        {
-                            const FFloat16Color& Source = FloatData->Pixels[Index];
-                            const FLinearColor Linear(Source.R.GetFloat(), Source.G.GetFloat(), Source.B.GetFloat(), Source.A.GetFloat());
-                            OutResult.PreviewPixels[Index] = Linear.ToFColor(true);
-                        }
-                    }
-                }
-            }
-            else
-            {
-                TUniquePtr<TImagePixelData<FColor>> PixelData = MakeUnique<TImagePixelData<FColor>>(OutputSize);
-                PixelData->Pixels.SetNum(PixelCount);
-                OutResult.PreviewPixels.SetNum(PixelCount);
-
-                const uint8* SourcePixels = RawData;
-                for (int32 Row = 0; Row < OutputSize.Y; ++Row)
-                {
-                    const uint8* SourceRow = SourcePixels + (RowPitch * Row * BytesPerPixel);
-                    FColor* DestRow = PixelData->Pixels.GetData() + Row * OutputSize.X;
-                    for (int32 Column = 0; Column < OutputSize.X; ++Column)
-                    {
-                        FLinearColor Linear;
-                        if (Precision == EOmniCapturePixelPrecision::FullFloat)
-                        {
-                            const FLinearColor* Pixel = reinterpret_cast<const FLinearColor*>(SourceRow) + Column;
-                            Linear = *Pixel;
-                        }
-                        else
-                        {
-                            const FFloat16Color* Pixel = reinterpret_cast<const FFloat16Color*>(SourceRow) + Column;
-                            Linear = FLinearColor(Pixel->R.GetFloat(), Pixel->G.GetFloat(), Pixel->B.GetFloat(), Pixel->A.GetFloat());
-                        }
-                        const FColor SRGB = Linear.ToFColor(true);
-                        DestRow[Column] = SRGB;
-                        OutResult.PreviewPixels[Row * OutputSize.X + Column] = SRGB;
-                    }
-                }
-
-                OutResult.PixelData = MoveTemp(PixelData);
-                OutResult.PixelDataType = EOmniCapturePixelDataType::Color8;
-            }
-        }
-
-        Readback.Unlock();
-        OutResult.PixelPrecision = Precision;
-    }
-}
-
-    void ConvertPlanarOnRenderThread(const FOmniCaptureSettings Settings, FTextureRHIRef SourceTexture, const FIntPoint OutputSize, bool bSourceLinear, FOmniCaptureEquirectResult& OutResult)
-    {
-        if (!SourceTexture.IsValid())
-        {
-            return;
-        }
-
-        const int32 OutputWidth = OutputSize.X;
-        const int32 OutputHeight = OutputSize.Y;
-
-        FRHICommandListImmediate& RHICmdList = FRHICommandListExecutor::GetImmediateCommandList();
-        FRDGBuilder GraphBuilder(RHICmdList);
-
-        EOmniCapturePixelPrecision Precision = PixelPrecisionFromFormat(SourceTexture->GetFormat());
-        if (Precision == EOmniCapturePixelPrecision::Unknown)
-        {
-            Precision = Settings.HDRPrecision == EOmniCaptureHDRPrecision::FullFloat
-                ? EOmniCapturePixelPrecision::FullFloat
-                : EOmniCapturePixelPrecision::HalfFloat;
-        }
+            Precision = Settings.HDRPrecision == EOmniCaptureHDRPrecision::FullFloat
+                ? EOmniCapturePixelPrecision::FullFloat
+                : EOmniCapturePixelPrecision::HalfFloat;
+        }
 
         FRDGTextureRef Source = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(SourceTexture, TEXT("OmniPlanarSource")));
 
@@ -1234,312 +1003,409 @@ namespace
 
 namespace
 {
-    void ConvertOnCPU(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, FOmniCaptureEquirectResult& OutResult)
+    TAutoConsoleVariable<int32> CVarOmniCaptureCPUConvertTileRows(
+        TEXT("OmniCapture.CPUConvert.TileRows"),
+        32,
+        TEXT("Number of output rows processed per task by the CPU projection fallback. 0 runs the conversion on the calling thread."),
+        ECVF_Default);
+
+    // Every output pixel is computed independently from the read-only cubemaps and each tile owns a
+    // disjoint row range, so the result is bit-identical regardless of tile size or scheduling order.
+    void ParallelForRowTiles(int32 NumRows, TFunctionRef<void(int32 RowStart, int32 RowEnd)> Body)
     {
-        FCPUCubemap LeftCubemap;
-        if (!BuildCPUCubemap(LeftEye, LeftCubemap))
+        if (NumRows <= 0)
         {
             return;
         }
 
-        FCPUCubemap RightCubemap;
-        if (Settings.Mode == EOmniCaptureMode::Stereo)
+        const int32 TileRows = CVarOmniCaptureCPUConvertTileRows.GetValueOnAnyThread();
+        if (TileRows <= 0 || TileRows >= NumRows)
         {
-            if (!BuildCPUCubemap(RightEye, RightCubemap))
-            {
-                return;
-            }
+            Body(0, NumRows);
+            return;
         }
 
-        const bool bStereo = Settings.Mode == EOmniCaptureMode::Stereo;
-        const bool bSideBySide = bStereo && Settings.StereoLayout == EOmniCaptureStereoLayout::SideBySide;
-        const int32 FaceResolution = LeftCubemap.Faces[0].Resolution;
-        const FIntPoint OutputSize = Settings.GetEquirectResolution();
-        const int32 OutputWidth = OutputSize.X;
-        const int32 OutputHeight = OutputSize.Y;
-        const double LongitudeSpan = Settings.GetLongitudeSpanRadians();
-        const double LatitudeSpan = Settings.GetLatitudeSpanRadians();
-        const bool bHalfSphere = Settings.IsVR180();
-
-        OutResult.Size = FIntPoint(OutputWidth, OutputHeight);
-        OutResult.bIsLinear = Settings.Gamma == EOmniCaptureGamma::Linear;
-        OutResult.bUsedCPUFallback = true;
-        OutResult.OutputTarget.SafeRelease();
-        OutResult.Texture.SafeRelease();
-        OutResult.ReadyFence.SafeRelease();
-        OutResult.EncoderPlanes.Reset();
-
-        const int32 PixelCount = OutputWidth * OutputHeight;
-        OutResult.PreviewPixels.SetNum(PixelCount);
-        OutResult.PixelPrecision = LeftCubemap.Precision;
-
-        auto ProcessPixel = [&](auto& PixelArray, auto ConvertColor)
+        const int32 NumTiles = FMath::DivideAndRoundUp(NumRows, TileRows);
+        ParallelFor(NumTiles, [&Body, NumRows, TileRows](int32 TileIndex)
         {
-            for (int32 Y = 0; Y < OutputHeight; ++Y)
-            {
-                for (int32 X = 0; X < OutputWidth; ++X)
-                {
-                    const int32 Index = Y * OutputWidth + X;
+            const int32 RowStart = TileIndex * TileRows;
+            Body(RowStart, FMath::Min(RowStart + TileRows, NumRows));
+        });
+    }
+}
 
-                    FIntPoint EyePixel(X, Y);
-                    FIntPoint EyeResolution(OutputWidth, OutputHeight);
-                    bool bRightEye = false;
+bool FOmniCaptureEquirectConverter::ConvertCubemapsOnCPU(const FOmniCaptureSettings& Settings, const FOmniCaptureCPUCubemap& LeftCubemap, const FOmniCaptureCPUCubemap& RightCubemap, FOmniCaptureEquirectResult& OutResult)
+{
+    const TSharedPtr<const FOmniCaptureCPUSampleMap, ESPMode::ThreadSafe> SampleMap = FOmniCaptureCPUSampleMap::GetOrBuild(Settings, LeftCubemap.Faces[0].Resolution);
+    if (!SampleMap.IsValid())
+    {
+        return false;
+    }
 
-                    if (bStereo)
-                    {
-                        if (bSideBySide)
-                        {
-                            const int32 EyeWidth = OutputWidth / 2;
-                            bRightEye = X >= EyeWidth;
-                            EyePixel.X = X % EyeWidth;
-                            EyeResolution = FIntPoint(EyeWidth, OutputHeight);
-                        }
-                        else
-                        {
-                            const int32 EyeHeight = OutputHeight / 2;
-                            bRightEye = Y >= EyeHeight;
-                            EyePixel.Y = Y % EyeHeight;
-                            EyeResolution = FIntPoint(OutputWidth, EyeHeight);
-                        }
-                    }
+    const FIntPoint OutputSize = SampleMap->GetSize();
+    const int32 OutputWidth = OutputSize.X;
+    const FOmniCaptureCPUSample* Samples = SampleMap->GetSamples().GetData();
 
-                    float Latitude = 0.0f;
-                    FVector Direction = DirectionFromEquirectPixelCPU(EyePixel, EyeResolution, LongitudeSpan, LatitudeSpan, Latitude);
-                    ApplyPolarMitigation(Settings.PolarDampening, Latitude, Direction);
+    OutResult.Size = OutputSize;
+    OutResult.bIsLinear = Settings.Gamma == EOmniCaptureGamma::Linear;
+    OutResult.bUsedCPUFallback = true;
+    OutResult.OutputTarget.SafeRelease();
+    OutResult.Texture.SafeRelease();
+    OutResult.ReadyFence.SafeRelease();
+    OutResult.EncoderPlanes.Reset();
 
-                    if (bHalfSphere && Direction.X < 0.0f)
-                    {
-                        PixelArray[Index] = ConvertColor(FLinearColor::Transparent);
-                        OutResult.PreviewPixels[Index] = FColor::Transparent;
-                        continue;
-                    }
+    OutResult.PreviewPixels.Reset();
+    OutResult.PreviewSize = FIntPoint::ZeroValue;
+    OutResult.PixelPrecision = LeftCubemap.Precision;
 
-                    const FLinearColor LinearColor = SampleCubemapCPU(
-                        (bStereo && bRightEye) ? RightCubemap : LeftCubemap,
-                        Direction,
-                        FaceResolution,
-                        Settings.SeamBlend);
+    auto ProcessRows = [&](auto& PixelArray, auto WriteRow)
+    {
+        ParallelForRowTiles(OutputSize.Y, [&](int32 RowStart, int32 RowEnd)
+        {
+            TArray<FLinearColor> RowColors;
+            RowColors.SetNumUninitialized(OutputWidth);
 
-                    PixelArray[Index] = ConvertColor(LinearColor);
-                    OutResult.PreviewPixels[Index] = LinearColor.ToFColor(true);
-                }
+            for (int32 Y = RowStart; Y < RowEnd; ++Y)
+            {
+                const int32 RowOffset = Y * OutputWidth;
+                FOmniCaptureCPUSampler::SampleRun(LeftCubemap, RightCubemap, Samples + RowOffset, OutputWidth, Settings.CPUSampling, RowColors.GetData());
+
+                WriteRow(RowColors.GetData(), PixelArray.GetData() + RowOffset, Y);
             }
-        };
+        });
+    };
 
-        if (OutResult.bIsLinear)
+    if (OutResult.bIsLinear)
+    {
+        if (OutResult.PixelPrecision == EOmniCapturePixelPrecision::FullFloat)
         {
-            if (OutResult.PixelPrecision == EOmniCapturePixelPrecision::FullFloat)
+            TUniquePtr<TImagePixelData<FLinearColor>> PixelData = AllocatePixelData<FLinearColor>(OutputSize);
+            ProcessRows(PixelData->Pixels, [OutputWidth](const FLinearColor* Source, FLinearColor* Dest, int32 Y)
             {
-                TUniquePtr<TImagePixelData<FLinearColor>> PixelData = MakeUnique<TImagePixelData<FLinearColor>>(OutResult.Size);
-                PixelData->Pixels.SetNum(PixelCount);
-                ProcessPixel(PixelData->Pixels, [](const FLinearColor& Linear) { return Linear; });
-                OutResult.PixelData = MoveTemp(PixelData);
-                OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat32;
-            }
-            else
-            {
-                OutResult.PixelPrecision = EOmniCapturePixelPrecision::HalfFloat;
-                TUniquePtr<TImagePixelData<FFloat16Color>> PixelData = MakeUnique<TImagePixelData<FFloat16Color>>(OutResult.Size);
-                PixelData->Pixels.SetNum(PixelCount);
-                ProcessPixel(PixelData->Pixels, [](const FLinearColor& Linear) { return FFloat16Color(Linear); });
-                OutResult.PixelData = MoveTemp(PixelData);
-                OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat16;
-            }
+                FMemory::Memcpy(Dest, Source, OutputWidth * sizeof(FLinearColor));
+            });
+            OutResult.PixelData = MoveTemp(PixelData);
+            OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat32;
         }
         else
         {
-            TUniquePtr<TImagePixelData<FColor>> PixelData = MakeUnique<TImagePixelData<FColor>>(OutResult.Size);
-            PixelData->Pixels.SetNum(PixelCount);
-            ProcessPixel(PixelData->Pixels, [](const FLinearColor& Linear) { return Linear.ToFColor(true); });
+            OutResult.PixelPrecision = EOmniCapturePixelPrecision::HalfFloat;
+            TUniquePtr<TImagePixelData<FFloat16Color>> PixelData = AllocatePixelData<FFloat16Color>(OutputSize);
+            ProcessRows(PixelData->Pixels, [OutputWidth](const FLinearColor* Source, FFloat16Color* Dest, int32 Y)
+            {
+                for (int32 X = 0; X < OutputWidth; ++X)
+                {
+                    FPlatformMath::VectorStoreHalf(reinterpret_cast<uint16*>(&Dest[X]), &Source[X].R);
+                }
+            });
             OutResult.PixelData = MoveTemp(PixelData);
-            OutResult.PixelDataType = EOmniCapturePixelDataType::Color8;
+            OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat16;
         }
     }
+    else
+    {
+        TUniquePtr<TImagePixelData<FColor>> PixelData = AllocatePixelData<FColor>(OutputSize);
+        ProcessRows(PixelData->Pixels, [OutputWidth](const FLinearColor* Source, FColor* Dest, int32 Y)
+        {
+            FOmniCaptureColorConversion::ConvertRow(Source, Dest, OutputWidth, Y, FOmniCaptureQuantizeOptions());
+        });
+        OutResult.PixelData = MoveTemp(PixelData);
+        OutResult.PixelDataType = EOmniCapturePixelDataType::Color8;
+    }
+
+    return true;
+}
+
+bool FOmniCaptureEquirectConverter::ReadCubemapOnCPU(const FOmniEyeCapture& Eye, FOmniCaptureCPUCubemap& OutCubemap)
+{
+    return BuildCPUCubemap(Eye, OutCubemap, EOmniCaptureCPUSampling::Nearest);
+}
 
-    void ConvertFisheyeOnCPU(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, FOmniCaptureEquirectResult& OutResult)
+namespace
+{
+    // Shared by the equirect and fisheye fallbacks; the projection is baked into the sample map.
+    bool ConvertOnCPU(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, FOmniCaptureEquirectResult& OutResult)
     {
-        FCPUCubemap LeftCubemap;
-        if (!BuildCPUCubemap(LeftEye, LeftCubemap))
+        FOmniCaptureCPUCubemap LeftCubemap;
+        if (!BuildCPUCubemap(LeftEye, LeftCubemap, Settings.CPUSampling))
         {
-            return;
+            return false;
         }
 
-        FCPUCubemap RightCubemap;
+        FOmniCaptureCPUCubemap RightCubemap;
         if (Settings.Mode == EOmniCaptureMode::Stereo)
         {
-            if (!BuildCPUCubemap(RightEye, RightCubemap))
+            if (!BuildCPUCubemap(RightEye, RightCubemap, Settings.CPUSampling))
             {
-                return;
+                return false;
             }
         }
 
-        const bool bStereo = Settings.Mode == EOmniCaptureMode::Stereo;
-        const bool bSideBySide = bStereo && Settings.StereoLayout == EOmniCaptureStereoLayout::SideBySide;
-        const int32 FaceResolution = LeftCubemap.Faces[0].Resolution;
-        const FIntPoint OutputSize = Settings.GetOutputResolution();
-        const FIntPoint EyeSize = Settings.GetFisheyeResolution();
-        const bool bHalfSphere = Settings.IsVR180();
-        const double FovRadians = FMath::DegreesToRadians(FMath::Clamp(Settings.FisheyeFOV, 0.0f, 360.0f));
-
-        OutResult.Size = OutputSize;
-        OutResult.bIsLinear = Settings.Gamma == EOmniCaptureGamma::Linear;
-        OutResult.bUsedCPUFallback = true;
-        OutResult.OutputTarget.SafeRelease();
-        OutResult.Texture.SafeRelease();
-        OutResult.ReadyFence.SafeRelease();
-        OutResult.EncoderPlanes.Reset();
-
-        const int32 PixelCount = OutputSize.X * OutputSize.Y;
-        OutResult.PreviewPixels.SetNum(PixelCount);
-        OutResult.PixelPrecision = LeftCubemap.Precision;
+        return FOmniCaptureEquirectConverter::ConvertCubemapsOnCPU(Settings, LeftCubemap, RightCubemap, OutResult);
+    }
 
-        auto ProcessPixel = [&](auto& PixelArray, auto ConvertColor)
+    bool GatherFaceTextures(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, TArray<FTextureRHIRef, TInlineAllocator<6>>& OutLeftFaces, TArray<FTextureRHIRef, TInlineAllocator<6>>& OutRightFaces)
+    {
+        for (int32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
         {
-            for (int32 Y = 0; Y < OutputSize.Y; ++Y)
+            if (UTextureRenderTarget2D* LeftTarget = LeftEye.Faces[FaceIndex].RenderTarget)
             {
-                for (int32 X = 0; X < OutputSize.X; ++X)
+                if (FTextureRenderTargetResource* Resource = LeftTarget->GameThread_GetRenderTargetResource())
                 {
-                    const int32 Index = Y * OutputSize.X + X;
-
-                    FIntPoint EyePixel(X, Y);
-                    FIntPoint EyeResolution = EyeSize;
-                    bool bRightEye = false;
-
-                    if (bStereo)
-                    {
-                        if (bSideBySide)
-                        {
-                            const int32 EyeWidth = FMath::Max(1, EyeSize.X);
-                            bRightEye = X >= EyeWidth;
-                            EyePixel.X = X % EyeWidth;
-                            EyeResolution = FIntPoint(EyeWidth, EyeSize.Y);
-                        }
-                        else
-                        {
-                            const int32 EyeHeight = FMath::Max(1, EyeSize.Y);
-                            bRightEye = Y >= EyeHeight;
-                            EyePixel.Y = Y % EyeHeight;
-                            EyeResolution = FIntPoint(EyeSize.X, EyeHeight);
-                        }
-                    }
-
-                    bool bValid = false;
-                    FVector Direction = DirectionFromFisheyePixelCPU(EyePixel, EyeResolution, FovRadians, bValid);
-                    if (!bValid)
-                    {
-                        PixelArray[Index] = ConvertColor(FLinearColor::Transparent);
-                        OutResult.PreviewPixels[Index] = FColor::Transparent;
-                        continue;
-                    }
-
-                    if (bHalfSphere && Direction.X < 0.0f)
+                    if (FTextureRHIRef Texture = Resource->GetTextureRHI())
                     {
-                        PixelArray[Index] = ConvertColor(FLinearColor::Transparent);
-                        OutResult.PreviewPixels[Index] = FColor::Transparent;
-                        continue;
+                        OutLeftFaces.Add(Texture);
                     }
-
-                    const FLinearColor LinearColor = SampleCubemapCPU(
-                        (bStereo && bRightEye) ? RightCubemap : LeftCubemap,
-                        Direction,
-                        FaceResolution,
-                        Settings.SeamBlend);
-
-                    PixelArray[Index] = ConvertColor(LinearColor);
-                    OutResult.PreviewPixels[Index] = LinearColor.ToFColor(true);
                 }
             }
-        };
 
-        if (OutResult.bIsLinear)
-        {
-            if (OutResult.PixelPrecision == EOmniCapturePixelPrecision::FullFloat)
+            if (Settings.Mode == EOmniCaptureMode::Stereo)
             {
-                TUniquePtr<TImagePixelData<FLinearColor>> PixelData = MakeUnique<TImagePixelData<FLinearColor>>(OutputSize);
-                PixelData->Pixels.SetNum(PixelCount);
-                ProcessPixel(PixelData->Pixels, [](const FLinearColor& Linear) { return Linear; });
-                OutResult.PixelData = MoveTemp(PixelData);
-                OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat32;
-            }
-            else
-            {
-                OutResult.PixelPrecision = EOmniCapturePixelPrecision::HalfFloat;
-                TUniquePtr<TImagePixelData<FFloat16Color>> PixelData = MakeUnique<TImagePixelData<FFloat16Color>>(OutputSize);
-                PixelData->Pixels.SetNum(PixelCount);
-                ProcessPixel(PixelData->Pixels, [](const FLinearColor& Linear) { return FFloat16Color(Linear); });
-                OutResult.PixelData = MoveTemp(PixelData);
-                OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat16;
+                if (UTextureRenderTarget2D* RightTarget = RightEye.Faces[FaceIndex].RenderTarget)
+                {
+                    if (FTextureRenderTargetResource* Resource = RightTarget->GameThread_GetRenderTargetResource())
+                    {
+                        if (FTextureRHIRef Texture = Resource->GetTextureRHI())
+                        {
+                            OutRightFaces.Add(Texture);
+                        }
+                    }
+                }
             }
         }
-        else
+
+        if (OutLeftFaces.Num() != 6)
         {
-            TUniquePtr<TImagePixelData<FColor>> PixelData = MakeUnique<TImagePixelData<FColor>>(OutputSize);
-            PixelData->Pixels.SetNum(PixelCount);
-            ProcessPixel(PixelData->Pixels, [](const FLinearColor& Linear) { return Linear.ToFColor(true); });
-            OutResult.PixelData = MoveTemp(PixelData);
-            OutResult.PixelDataType = EOmniCapturePixelDataType::Color8;
+            return false;
         }
+
+        return Settings.Mode != EOmniCaptureMode::Stereo || OutRightFaces.Num() == 6;
+    }
+
+    bool SupportsComputeConversion()
+    {
+        bool bSupportsCompute = GDynamicRHI != nullptr;
+#if defined(GRHISupportsComputeShaders)
+        bSupportsCompute = bSupportsCompute && GRHISupportsComputeShaders;
+#elif defined(GSupportsComputeShaders)
+        bSupportsCompute = bSupportsCompute && GSupportsComputeShaders;
+#else
+        bSupportsCompute = false;
+#endif
+        return bSupportsCompute;
     }
 }
 
-FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertToEquirectangular(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye)
+void FOmniCaptureEquirectConverter::PrepareCPUConversion(const FOmniCaptureSettings& Settings, int32 FaceResolution)
 {
-    FOmniCaptureEquirectResult Result;
+    if (Settings.IsPlanar() || FaceResolution <= 0 || SupportsComputeConversion())
+    {
+        return;
+    }
 
-    if (Settings.Resolution <= 0)
+    FOmniCaptureCPUSampleMap::GetOrBuild(Settings, FaceResolution);
+}
+
+void FOmniCaptureEquirectConverter::ReleaseCPUConversionCache()
+{
+    FOmniCaptureCPUSampleMap::ReleaseCached();
+}
+
+namespace
+{
+    FORCEINLINE VectorRegister4Float LoadPreviewSource(const FLinearColor& Pixel)
     {
-        return Result;
+        return VectorLoad(&Pixel.R);
     }
 
-    TArray<FTextureRHIRef, TInlineAllocator<6>> LeftFaces;
-    TArray<FTextureRHIRef, TInlineAllocator<6>> RightFaces;
+    FORCEINLINE VectorRegister4Float LoadPreviewSource(const FFloat16Color& Pixel)
+    {
+        const FLinearColor Linear(Pixel);
+        return VectorLoad(&Linear.R);
+    }
 
-    for (int32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
+    /** Averages Factor x Factor blocks of linear source pixels and encodes each average to sRGB. */
+    template <typename PixelType>
+    void BoxDownsampleLinear(const TArray<PixelType>& Source, int32 SourceWidth, int32 Factor, const FIntPoint& PreviewSize, TArray<FColor>& OutPixels)
     {
-        if (UTextureRenderTarget2D* LeftTarget = LeftEye.Faces[FaceIndex].RenderTarget)
+        const VectorRegister4Float Scale = VectorSetFloat1(1.0f / (Factor * Factor));
+        ParallelFor(PreviewSize.Y, [&](int32 PreviewY)
         {
-            if (FTextureRenderTargetResource* Resource = LeftTarget->GameThread_GetRenderTargetResource())
+            TArray<FLinearColor> Averages;
+            Averages.SetNumUninitialized(PreviewSize.X);
+            for (int32 PreviewX = 0; PreviewX < PreviewSize.X; ++PreviewX)
             {
-                if (FTextureRHIRef Texture = Resource->GetTextureRHI())
+                VectorRegister4Float Sum = VectorZeroFloat();
+                for (int32 RowOffset = 0; RowOffset < Factor; ++RowOffset)
                 {
-                    LeftFaces.Add(Texture);
+                    const PixelType* SourceRow = Source.GetData() + static_cast<int64>(PreviewY * Factor + RowOffset) * SourceWidth + PreviewX * Factor;
+                    for (int32 Column = 0; Column < Factor; ++Column)
+                    {
+                        Sum = VectorAdd(Sum, LoadPreviewSource(SourceRow[Column]));
+                    }
                 }
+
+                VectorStore(VectorMultiply(Sum, Scale), &Averages[PreviewX].R);
             }
-        }
 
-        if (Settings.Mode == EOmniCaptureMode::Stereo)
+            FColor* DestRow = OutPixels.GetData() + static_cast<int64>(PreviewY) * PreviewSize.X;
+            FOmniCaptureColorConversion::ConvertRow(Averages.GetData(), DestRow, PreviewSize.X, PreviewY, FOmniCaptureQuantizeOptions());
+        });
+    }
+
+    /** Averages Factor x Factor blocks of already encoded 8-bit pixels. */
+    void BoxDownsampleColor(const TArray<FColor>& Source, int32 SourceWidth, int32 Factor, const FIntPoint& PreviewSize, TArray<FColor>& OutPixels)
+    {
+        const VectorRegister4Float Scale = VectorSetFloat1(1.0f / (Factor * Factor));
+        const VectorRegister4Float Half = VectorSetFloat1(0.5f);
+        ParallelFor(PreviewSize.Y, [&](int32 PreviewY)
         {
-            if (UTextureRenderTarget2D* RightTarget = RightEye.Faces[FaceIndex].RenderTarget)
+            FColor* DestRow = OutPixels.GetData() + static_cast<int64>(PreviewY) * PreviewSize.X;
+            for (int32 PreviewX = 0; PreviewX < PreviewSize.X; ++PreviewX)
             {
-                if (FTextureRenderTargetResource* Resource = RightTarget->GameThread_GetRenderTargetResource())
+                VectorRegister4Float Sum = VectorZeroFloat();
+                for (int32 RowOffset = 0; RowOffset < Factor; ++RowOffset)
                 {
-                    if (FTextureRHIRef Texture = Resource->GetTextureRHI())
+                    const FColor* SourceRow = Source.GetData() + static_cast<int64>(PreviewY * Factor + RowOffset) * SourceWidth + PreviewX * Factor;
+                    for (int32 Column = 0; Column < Factor; ++Column)
                     {
-                        RightFaces.Add(Texture);
+                        Sum = VectorAdd(Sum, VectorLoadByte4(&SourceRow[Column]));
                     }
                 }
+
+                // VectorStoreByte4 truncates, so bias by half a step to round. Channel order is kept as loaded.
+                VectorStoreByte4(VectorMultiplyAdd(Sum, Scale, Half), &DestRow[PreviewX]);
             }
+        });
+    }
+}
+
+bool FOmniCaptureEquirectConverter::BuildPreview(const FOmniCaptureSettings& Settings, FOmniCaptureEquirectResult& InOutResult)
+{
+    InOutResult.PreviewSize = FIntPoint::ZeroValue;
+    const FImagePixelData* PixelData = InOutResult.PixelData.Get();
+    const FIntPoint SourceSize = InOutResult.Size;
+    if (!PixelData || SourceSize.X <= 0 || SourceSize.Y <= 0)
+    {
+        return false;
+    }
+
+    // A whole-pixel box keeps the filter a plain average; trailing rows and columns that do not fill a box are dropped.
+    const FIntPoint MaxSize = Settings.GetPreviewResolution();
+    int32 Factor = FMath::Max3(1, FMath::DivideAndRoundUp(SourceSize.X, FMath::Max(1, MaxSize.X)), FMath::DivideAndRoundUp(SourceSize.Y, FMath::Max(1, MaxSize.Y)));
+    Factor = FMath::Min(Factor, FMath::Min(SourceSize.X, SourceSize.Y));
+    const FIntPoint PreviewSize(SourceSize.X / Factor, SourceSize.Y / Factor);
+    AllocatePreviewPixels(InOutResult.PreviewPixels, PreviewSize.X * PreviewSize.Y);
+
+    switch (PixelData->GetType())
+    {
+    case EImagePixelType::Color:
+        BoxDownsampleColor(static_cast<const TImagePixelData<FColor>*>(PixelData)->Pixels, SourceSize.X, Factor, PreviewSize, InOutResult.PreviewPixels);
+        break;
+    case EImagePixelType::Float16:
+        BoxDownsampleLinear(static_cast<const TImagePixelData<FFloat16Color>*>(PixelData)->Pixels, SourceSize.X, Factor, PreviewSize, InOutResult.PreviewPixels);
+        break;
+    case EImagePixelType::Float32:
+        BoxDownsampleLinear(static_cast<const TImagePixelData<FLinearColor>*>(PixelData)->Pixels, SourceSize.X, Factor, PreviewSize, InOutResult.PreviewPixels);
+        break;
+    default:
+        InOutResult.PreviewPixels.Reset();
+        return false;
+    }
+
+    InOutResult.PreviewSize = PreviewSize;
+    return true;
+}
+
+void FOmniCaptureEquirectConverter::SetBufferPool(const TSharedPtr<FOmniCaptureBufferPool, ESPMode::ThreadSafe>& BufferPool)
+{
+    FScopeLock Lock(&GActiveBufferPoolCS);
+    GActiveBufferPool = BufferPool;
+}
+
+TSharedPtr<FOmniCaptureAsyncConversion, ESPMode::ThreadSafe> FOmniCaptureEquirectConverter::BeginAsyncConversion(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye)
+{
+    if (Settings.IsPlanar() || Settings.Resolution <= 0 || !SupportsComputeConversion())
+    {
+        return nullptr;
+    }
+
+    TArray<FTextureRHIRef, TInlineAllocator<6>> LeftFaces;
+    TArray<FTextureRHIRef, TInlineAllocator<6>> RightFaces;
+    if (!GatherFaceTextures(Settings, LeftEye, RightEye, LeftFaces, RightFaces))
+    {
+        return nullptr;
+    }
+
+    const bool bFisheye = Settings.IsFisheye() && !Settings.ShouldConvertFisheyeToEquirect();
+    TSharedPtr<FOmniCaptureAsyncConversion, ESPMode::ThreadSafe> Conversion = MakeShared<FOmniCaptureAsyncConversion, ESPMode::ThreadSafe>();
+
+    ENQUEUE_RENDER_COMMAND(OmniCaptureAsyncConvert)([Settings, LeftFaces, RightFaces, Conversion, bFisheye](FRHICommandListImmediate&)
+    {
+        if (bFisheye)
+        {
+            ConvertFisheyeOnRenderThread(Settings, LeftFaces, RightFaces, Conversion->Result, Conversion.Get());
+        }
+        else
+        {
+            ConvertOnRenderThread(Settings, LeftFaces, RightFaces, Conversion->Result, Conversion.Get());
+        }
+
+        if (!Conversion->Readback.IsValid())
+        {
+            // The GPU passes bailed out; complete with an empty result so the frame is reported as dropped.
+            Conversion->bComplete = true;
+        }
+    });
+
+    return Conversion;
+}
+
+void FOmniCaptureEquirectConverter::ResolveAsyncConversion_RenderThread(FOmniCaptureAsyncConversion& Conversion, bool bWait)
+{
+    check(IsInRenderingThread());
+
+    if (Conversion.IsComplete() || !Conversion.Readback.IsValid())
+    {
+        return;
+    }
+
+    if (!Conversion.Readback->IsReady())
+    {
+        if (!bWait)
+        {
+            return;
+        }
+
+        FRHICommandListExecutor::GetImmediateCommandList().SubmitCommandsAndFlushGPU();
+        while (!Conversion.Readback->IsReady())
+        {
+            FPlatformProcess::SleepNoStats(0.001f);
         }
     }
 
-    if (LeftFaces.Num() != 6)
+    ResolveReadback(*Conversion.Readback, Conversion.ReadbackSize, Conversion.ReadbackPrecision, Conversion.bReadbackLinear, Conversion.Result);
+    Conversion.Readback.Reset();
+    Conversion.bComplete = true;
+}
+
+FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertToEquirectangular(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye)
+{
+    FOmniCaptureEquirectResult Result;
+
+    if (Settings.Resolution <= 0)
     {
         return Result;
     }
 
-    if (Settings.Mode == EOmniCaptureMode::Stereo && RightFaces.Num() != 6)
+    TArray<FTextureRHIRef, TInlineAllocator<6>> LeftFaces;
+    TArray<FTextureRHIRef, TInlineAllocator<6>> RightFaces;
+    if (!GatherFaceTextures(Settings, LeftEye, RightEye, LeftFaces, RightFaces))
     {
         return Result;
     }
 
-    bool bSupportsCompute = GDynamicRHI != nullptr;
-#if defined(GRHISupportsComputeShaders)
-    bSupportsCompute = bSupportsCompute && GRHISupportsComputeShaders;
-#elif defined(GSupportsComputeShaders)
-    bSupportsCompute = bSupportsCompute && GSupportsComputeShaders;
-#else
-    bSupportsCompute = false;
-#endif
+    const bool bSupportsCompute = SupportsComputeConversion();
     if (!bSupportsCompute)
     {
         ConvertOnCPU(Settings, LeftEye, RightEye, Result);
@@ -1576,53 +1442,12 @@ FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertToFisheye(const
 
     TArray<FTextureRHIRef, TInlineAllocator<6>> LeftFaces;
     TArray<FTextureRHIRef, TInlineAllocator<6>> RightFaces;
-
-    for (int32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
-    {
-        if (UTextureRenderTarget2D* LeftTarget = LeftEye.Faces[FaceIndex].RenderTarget)
-        {
-            if (FTextureRenderTargetResource* Resource = LeftTarget->GameThread_GetRenderTargetResource())
-            {
-                if (FTextureRHIRef Texture = Resource->GetTextureRHI())
-                {
-                    LeftFaces.Add(Texture);
-                }
-            }
-        }
-
-        if (Settings.Mode == EOmniCaptureMode::Stereo)
-        {
-            if (UTextureRenderTarget2D* RightTarget = RightEye.Faces[FaceIndex].RenderTarget)
-            {
-                if (FTextureRenderTargetResource* Resource = RightTarget->GameThread_GetRenderTargetResource())
-                {
-                    if (FTextureRHIRef Texture = Resource->GetTextureRHI())
-                    {
-                        RightFaces.Add(Texture);
-                    }
-                }
-            }
-        }
-    }
-
-    if (LeftFaces.Num() != 6)
+    if (!GatherFaceTextures(Settings, LeftEye, RightEye, LeftFaces, RightFaces))
     {
         return Result;
     }
 
-    if (Settings.Mode == EOmniCaptureMode::Stereo && RightFaces.Num() != 6)
-    {
-        return Result;
-    }
-
-    bool bSupportsCompute = GDynamicRHI != nullptr;
-#if defined(GRHISupportsComputeShaders)
-    bSupportsCompute = bSupportsCompute && GRHISupportsComputeShaders;
-#elif defined(GSupportsComputeShaders)
-    bSupportsCompute = bSupportsCompute && GSupportsComputeShaders;
-#else
-    bSupportsCompute = false;
-#endif
+    const bool bSupportsCompute = SupportsComputeConversion();
 
     if (bSupportsCompute)
     {
@@ -1638,7 +1463,7 @@ FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertToFisheye(const
     }
     else
     {
-        ConvertFisheyeOnCPU(Settings, LeftEye, RightEye, Result);
+        ConvertOnCPU(Settings, LeftEye, RightEye, Result);
     }
 
     return Result;
@@ -1679,8 +1504,6 @@ FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertToPlanar(const
     Result.OutputTarget.SafeRelease();
     Result.GPUSource.SafeRelease();
 
-    const int32 PixelCount = OutputSize.X * OutputSize.Y;
-
     if (Result.bIsLinear)
     {
         TUniquePtr<TImagePixelData<FFloat16Color>> PixelData = MakeUnique<TImagePixelData<FFloat16Color>>(OutputSize);
@@ -1716,36 +1539,9 @@ FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertToPlanar(const
 
     if (!Result.PixelData.IsValid())
     {
-        Result.PreviewPixels.Reset();
         return Result;
     }
 
-    Result.PreviewPixels.SetNum(PixelCount);
-    if (Result.bIsLinear)
-    {
-        const TImagePixelData<FFloat16Color>* FloatData = static_cast<const TImagePixelData<FFloat16Color>*>(Result.PixelData.Get());
-        if (FloatData)
-        {
-            for (int32 Index = 0; Index < PixelCount; ++Index)
-            {
-                Result.PreviewPixels[Index] = FLinearColor(FloatData->Pixels[Index]).ToFColor(true);
-            }
-        }
-    }
-    else
-    {
-        const TImagePixelData<FColor>* ColorData = static_cast<const TImagePixelData<FColor>*>(Result.PixelData.Get());
-        if (ColorData)
-        {
-            Result.PreviewPixels = ColorData->Pixels;
-        }
-    }
-
-    if (Result.PreviewPixels.Num() != PixelCount)
-    {
-        Result.PreviewPixels.Init(FColor::Black, PixelCount);
-    }
-
     Result.Texture = Resource->GetRenderTargetTexture();
 
     if (Result.Texture.IsValid() && Settings.OutputFormat == EOmniOutputFormat::NVENCHardware)
@@ -0,0 +1,417 @@
+#include "OmniCaptureFFmpegPipe.h"
+
+#include "OmniCaptureColorConversion.h"
+#include "OmniCaptureMuxer.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "ImagePixelData.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureFFmpegPipe, Log, All);
+
+namespace
+{
+    constexpr uint32 GPipeWaitMs = 100;
+    // WritePipe takes an int32 length; larger frames are written in chunks.
+    constexpr int64 GMaxPipeChunkBytes = 16 * 1024 * 1024;
+
+    /** Packs linear float pixels as 16-bit sRGB bgra64le, one row at a time. */
+    template <typename PixelType>
+    bool PackSRGB16(const TArray64<PixelType>& Pixels, const FIntPoint& Size, TArray64<uint8>& OutBytes)
+    {
+        if (Pixels.Num() != static_cast<int64>(Size.X) * Size.Y)
+        {
+            return false;
+        }
+
+        OutBytes.SetNumUninitialized(Pixels.Num() * 4 * sizeof(uint16), EAllowShrinking::No);
+        uint16* Dest = reinterpret_cast<uint16*>(OutBytes.GetData());
+        const FOmniCaptureQuantizeOptions Options;
+        for (int32 Y = 0; Y < Size.Y; ++Y)
+        {
+            const int64 RowStart = static_cast<int64>(Y) * Size.X;
+            FOmniCaptureColorConversion::ConvertRow(Pixels.GetData() + RowStart, Dest + RowStart * 4, Size.X, Y, Options);
+        }
+        return true;
+    }
+}
+
+class FOmniCaptureFFmpegPipeWriter final : public FRunnable
+{
+public:
+    explicit FOmniCaptureFFmpegPipeWriter(FOmniCaptureFFmpegPipe& InOwner)
+        : Owner(InOwner)
+    {
+    }
+
+    virtual uint32 Run() override
+    {
+        Owner.RunWriter();
+        return 0;
+    }
+
+private:
+    FOmniCaptureFFmpegPipe& Owner;
+};
+
+FOmniCaptureFFmpegPipe::FOmniCaptureFFmpegPipe() = default;
+
+FOmniCaptureFFmpegPipe::~FOmniCaptureFFmpegPipe()
+{
+    StopWriter();
+    ClosePipes();
+
+    if (ProcessHandle.IsValid())
+    {
+        // Finalize was skipped (capture cancelled); the partial file is not worth waiting for.
+        if (FPlatformProcess::IsProcRunning(ProcessHandle))
+        {
+            FPlatformProcess::TerminateProc(ProcessHandle, true);
+        }
+        FPlatformProcess::CloseProc(ProcessHandle);
+    }
+
+    if (DataEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(DataEvent);
+        DataEvent = nullptr;
+    }
+    if (SpaceEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(SpaceEvent);
+        SpaceEvent = nullptr;
+    }
+}
+
+bool FOmniCaptureFFmpegPipe::Initialize(const FOmniCaptureSettings& InSettings, const FString& InOutputDirectory, bool bSeparateVideoFile)
+{
+    Settings = InSettings;
+    {
+        FScopeLock Lock(&ErrorCS);
+        LastError.Reset();
+    }
+
+    if (!FOmniCaptureMuxer::IsFFmpegAvailable(Settings, &FFmpegBinary))
+    {
+        FScopeLock Lock(&ErrorCS);
+        LastError = TEXT("FFmpeg pipe output requires an FFmpeg binary; none was found.");
+        return false;
+    }
+
+    OutputDirectory = InOutputDirectory.IsEmpty() ? (FPaths::ProjectSavedDir() / TEXT("OmniCaptures")) : InOutputDirectory;
+    OutputDirectory = FPaths::ConvertRelativePathToFull(OutputDirectory);
+    IFileManager::Get().MakeDirectory(*OutputDirectory, true);
+
+    const FString BaseFileName = Settings.OutputFileName.IsEmpty() ? TEXT("OmniCapture") : Settings.OutputFileName;
+    OutputFilePath = OutputDirectory / (BaseFileName + (bSeparateVideoFile ? TEXT("_video.mp4") : TEXT(".mp4")));
+
+    MaxPendingFrames = FMath::Max(1, Settings.FFmpegPipeQueueDepth);
+    DataEvent = FPlatformProcess::GetSynchEventFromPool();
+    SpaceEvent = FPlatformProcess::GetSynchEventFromPool();
+    bInitialized = true;
+    return true;
+}
+
+void FOmniCaptureFFmpegPipe::EnqueueFrame(const FOmniCaptureFrame& Frame)
+{
+    if (!bInitialized || bFailed.Load())
+    {
+        return;
+    }
+
+    if (!Frame.PixelData.IsValid())
+    {
+        FramesDropped.IncrementExchange();
+        return;
+    }
+
+    const FImagePixelData& PixelData = *Frame.PixelData;
+    if (!ProcessHandle.IsValid() && !StartProcess(PixelData.GetSize(), PixelData.GetType()))
+    {
+        return;
+    }
+
+    if (PixelData.GetSize() != FrameSize || PixelData.GetType() != FramePixelType)
+    {
+        UE_LOG(LogOmniCaptureFFmpegPipe, Warning, TEXT("Dropping frame %d: %dx%d does not match the %dx%d stream FFmpeg was started with."),
+            Frame.Metadata.FrameIndex, PixelData.GetSize().X, PixelData.GetSize().Y, FrameSize.X, FrameSize.Y);
+        FramesDropped.IncrementExchange();
+        return;
+    }
+
+    TArray64<uint8> Bytes;
+    {
+        FScopeLock Lock(&QueueCS);
+        if (FreeBuffers.Num() > 0)
+        {
+            Bytes = FreeBuffers.Pop(EAllowShrinking::No);
+        }
+    }
+
+    if (!PackFrame(PixelData, Bytes))
+    {
+        FramesDropped.IncrementExchange();
+        return;
+    }
+
+    while (true)
+    {
+        {
+            FScopeLock Lock(&QueueCS);
+            if (bFailed.Load())
+            {
+                return;
+            }
+            if (PendingFrames.Num() < MaxPendingFrames)
+            {
+                PendingFrames.Add(MoveTemp(Bytes));
+                break;
+            }
+        }
+        SpaceEvent->Wait(GPipeWaitMs);
+    }
+
+    DataEvent->Trigger();
+}
+
+bool FOmniCaptureFFmpegPipe::Finalize()
+{
+    if (!bInitialized)
+    {
+        return false;
+    }
+    bInitialized = false;
+
+    StopWriter();
+
+    // Closing our end of stdin is FFmpeg's end-of-stream; it then flushes the encoder and writes the moov atom.
+    ClosePipes();
+
+    if (!ProcessHandle.IsValid())
+    {
+        FScopeLock Lock(&ErrorCS);
+        if (LastError.IsEmpty())
+        {
+            LastError = TEXT("No frames reached the FFmpeg pipe.");
+        }
+        UE_LOG(LogOmniCaptureFFmpegPipe, Warning, TEXT("%s"), *LastError);
+        return false;
+    }
+
+    FPlatformProcess::WaitForProc(ProcessHandle);
+    int32 ReturnCode = 0;
+    FPlatformProcess::GetProcReturnCode(ProcessHandle, &ReturnCode);
+    FPlatformProcess::CloseProc(ProcessHandle);
+
+    if (ReturnCode != 0)
+    {
+        Fail(FString::Printf(TEXT("FFmpeg returned non-zero exit code %d"), ReturnCode));
+    }
+
+    UE_LOG(LogOmniCaptureFFmpegPipe, Log, TEXT("FFmpeg pipe closed: %d frames (%.1f MB) streamed, %d dropped -> %s"),
+        FramesWritten, BytesWritten.Load() / (1024.0 * 1024.0), FramesDropped.Load(), *OutputFilePath);
+
+    return !bFailed.Load() && FPaths::FileExists(OutputFilePath);
+}
+
+const TCHAR* FOmniCaptureFFmpegPipe::GetRawPixelFormat(EImagePixelType PixelType)
+{
+    switch (PixelType)
+    {
+    case EImagePixelType::Color:
+        return TEXT("bgra");
+    case EImagePixelType::Float16:
+    case EImagePixelType::Float32:
+        return TEXT("bgra64le");
+    default:
+        return nullptr;
+    }
+}
+
+bool FOmniCaptureFFmpegPipe::PackFrame(const FImagePixelData& PixelData, TArray64<uint8>& OutBytes)
+{
+    const FIntPoint Size = PixelData.GetSize();
+    const int64 PixelCount = static_cast<int64>(Size.X) * Size.Y;
+
+    switch (PixelData.GetType())
+    {
+    case EImagePixelType::Color:
+    {
+        // FColor is already laid out as bgra.
+        const TArray64<FColor>& Pixels = static_cast<const TImagePixelData<FColor>&>(PixelData).Pixels;
+        if (Pixels.Num() != PixelCount)
+        {
+            return false;
+        }
+        OutBytes.SetNumUninitialized(PixelCount * sizeof(FColor), EAllowShrinking::No);
+        FMemory::Memcpy(OutBytes.GetData(), Pixels.GetData(), OutBytes.Num());
+        return true;
+    }
+    case EImagePixelType::Float16:
+        return PackSRGB16(static_cast<const TImagePixelData<FFloat16Color>&>(PixelData).Pixels, Size, OutBytes);
+    case EImagePixelType::Float32:
+        return PackSRGB16(static_cast<const TImagePixelData<FLinearColor>&>(PixelData).Pixels, Size, OutBytes);
+    default:
+        return false;
+    }
+}
+
+bool FOmniCaptureFFmpegPipe::StartProcess(const FIntPoint& Size, EImagePixelType PixelType)
+{
+    const TCHAR* PixelFormat = GetRawPixelFormat(PixelType);
+    if (!PixelFormat)
+    {
+        Fail(TEXT("Frame pixel type cannot be streamed to FFmpeg."));
+        return false;
+    }
+
+    if (!FPlatformProcess::CreatePipe(PipeRead, PipeWrite, true))
+    {
+        Fail(TEXT("Failed to create the FFmpeg stdin pipe."));
+        return false;
+    }
+
+    const double FrameRate = Settings.TargetFrameRate > 0.0f ? Settings.TargetFrameRate : 30.0;
+    FString CommandLine = FString::Printf(TEXT("-y -hide_banner -nostats -loglevel error -f rawvideo -pix_fmt %s -s %dx%d -framerate %.3f -i pipe:0 -an"),
+        PixelFormat, Size.X, Size.Y, FrameRate);
+    CommandLine += FOmniCaptureMuxer::BuildVideoEncodeArguments(Settings, false);
+    CommandLine += FString::Printf(TEXT(" \"%s\""), *OutputFilePath);
+
+    UE_LOG(LogOmniCaptureFFmpegPipe, Log, TEXT("Starting FFmpeg pipe: %s %s"), *FFmpegBinary, *CommandLine);
+
+    ProcessHandle = FPlatformProcess::CreateProc(*FFmpegBinary, *CommandLine, true, true, true, nullptr, 0, *OutputDirectory, nullptr, PipeRead);
+    if (!ProcessHandle.IsValid())
+    {
+        ClosePipes();
+        Fail(TEXT("Failed to launch FFmpeg process."));
+        return false;
+    }
+
+    FrameSize = Size;
+    FramePixelType = PixelType;
+
+    bRunning = true;
+    Writer = new FOmniCaptureFFmpegPipeWriter(*this);
+    WriterThread.Reset(FRunnableThread::Create(Writer, TEXT("OmniCaptureFFmpegPipe")));
+    return true;
+}
+
+void FOmniCaptureFFmpegPipe::StopWriter()
+{
+    if (!WriterThread.IsValid())
+    {
+        return;
+    }
+
+    bRunning = false;
+    DataEvent->Trigger();
+    WriterThread->WaitForCompletion();
+    WriterThread.Reset();
+
+    delete Writer;
+    Writer = nullptr;
+}
+
+void FOmniCaptureFFmpegPipe::ClosePipes()
+{
+    if (PipeRead || PipeWrite)
+    {
+        FPlatformProcess::ClosePipe(PipeRead, PipeWrite);
+        PipeRead = nullptr;
+        PipeWrite = nullptr;
+    }
+}
+
+void FOmniCaptureFFmpegPipe::RunWriter()
+{
+    while (true)
+    {
+        TArray64<uint8> Bytes;
+        bool bHasFrame = false;
+        {
+            FScopeLock Lock(&QueueCS);
+            if (PendingFrames.Num() > 0)
+            {
+                Bytes = MoveTemp(PendingFrames[0]);
+                PendingFrames.RemoveAt(0, 1, EAllowShrinking::No);
+                bHasFrame = true;
+            }
+            else if (!bRunning.Load())
+            {
+                break;
+            }
+        }
+
+        if (!bHasFrame)
+        {
+            DataEvent->Wait(GPipeWaitMs);
+            continue;
+        }
+
+        SpaceEvent->Trigger();
+
+        // After a failure the queue is still drained so a blocked producer wakes up and sees bFailed.
+        if (!bFailed.Load())
+        {
+            if (WriteToPipe(Bytes))
+            {
+                ++FramesWritten;
+            }
+            else
+            {
+                Fail(TEXT("Writing to the FFmpeg pipe failed; FFmpeg may have exited early."));
+            }
+        }
+
+        FScopeLock Lock(&QueueCS);
+        FreeBuffers.Add(MoveTemp(Bytes));
+    }
+}
+
+bool FOmniCaptureFFmpegPipe::WriteToPipe(const TArray64<uint8>& Bytes)
+{
+    int64 Offset = 0;
+    while (Offset < Bytes.Num())
+    {
+        const int32 ChunkBytes = static_cast<int32>(FMath::Min(Bytes.Num() - Offset, GMaxPipeChunkBytes));
+        int32 Written = 0;
+        if (!FPlatformProcess::WritePipe(PipeWrite, Bytes.GetData() + Offset, ChunkBytes, &Written))
+        {
+            return false;
+        }
+
+        if (Written <= 0)
+        {
+            // Pipe buffer is full; FFmpeg is still encoding earlier frames.
+            if (!FPlatformProcess::IsProcRunning(ProcessHandle))
+            {
+                return false;
+            }
+            FPlatformProcess::Sleep(0.001f);
+            continue;
+        }
+
+        Offset += Written;
+        BytesWritten += Written;
+    }
+    return true;
+}
+
+FString FOmniCaptureFFmpegPipe::GetLastError() const
+{
+    FScopeLock Lock(&ErrorCS);
+    return LastError;
+}
+
+void FOmniCaptureFFmpegPipe::Fail(const FString& Message)
+{
+    if (!bFailed.Exchange(true))
+    {
+        FScopeLock Lock(&ErrorCS);
+        LastError = Message;
+        UE_LOG(LogOmniCaptureFFmpegPipe, Error, TEXT("%s"), *Message);
+    }
+}
@@ -0,0 +1,159 @@
+#include "OmniCaptureFinalizer.h"
+
+#include "Async/Async.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "OmniCaptureFFmpegPipe.h"
+#include "OmniCaptureImageWriter.h"
+#include "OmniCaptureMuxer.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureFinalizer, Log, All);
+
+FOmniCaptureFinalizeJob::FOmniCaptureFinalizeJob() = default;
+FOmniCaptureFinalizeJob::FOmniCaptureFinalizeJob(FOmniCaptureFinalizeJob&&) = default;
+FOmniCaptureFinalizeJob& FOmniCaptureFinalizeJob::operator=(FOmniCaptureFinalizeJob&&) = default;
+FOmniCaptureFinalizeJob::~FOmniCaptureFinalizeJob() = default;
+
+FOmniCaptureFinalizer::FOmniCaptureFinalizer(int32 InMaxConcurrentJobs)
+    : MaxConcurrentJobs(FMath::Max(1, InMaxConcurrentJobs))
+{
+}
+
+FOmniCaptureFinalizer::~FOmniCaptureFinalizer()
+{
+    WaitForAll();
+}
+
+void FOmniCaptureFinalizer::SetMaxConcurrentJobs(int32 InMaxConcurrentJobs)
+{
+    FScopeLock Lock(&JobsCS);
+    MaxConcurrentJobs = FMath::Max(1, InMaxConcurrentJobs);
+    LaunchQueuedJobs();
+}
+
+void FOmniCaptureFinalizer::Submit(FOmniCaptureFinalizeJob&& Job)
+{
+    FScopeLock Lock(&JobsCS);
+    QueuedJobs.Add(MakeUnique<FOmniCaptureFinalizeJob>(MoveTemp(Job)));
+    LaunchQueuedJobs();
+}
+
+void FOmniCaptureFinalizer::ConsumeCompleted(TArray<FOmniCaptureFinalizeResult>& OutResults)
+{
+    FScopeLock Lock(&JobsCS);
+    OutResults.Append(MoveTemp(CompletedResults));
+    CompletedResults.Reset();
+    RunningTasks.RemoveAll([](const TFuture<void>& Task) { return Task.IsReady(); });
+}
+
+void FOmniCaptureFinalizer::WaitForAll()
+{
+    for (;;)
+    {
+        TArray<TFuture<void>> Tasks;
+        {
+            FScopeLock Lock(&JobsCS);
+            if (RunningTasks.Num() == 0 && QueuedJobs.Num() == 0)
+            {
+                return;
+            }
+            Tasks = MoveTemp(RunningTasks);
+            RunningTasks.Reset();
+        }
+
+        // Finishing jobs launch queued ones, so keep going until a pass finds nothing new.
+        for (TFuture<void>& Task : Tasks)
+        {
+            Task.Wait();
+        }
+    }
+}
+
+bool FOmniCaptureFinalizer::IsIdle() const
+{
+    FScopeLock Lock(&JobsCS);
+    return QueuedJobs.Num() == 0 && RunningJobs == 0 && CompletedResults.Num() == 0;
+}
+
+FOmniCaptureFinalizationProgress FOmniCaptureFinalizer::GetProgress() const
+{
+    FScopeLock Lock(&JobsCS);
+    FOmniCaptureFinalizationProgress Progress;
+    Progress.QueuedSegments = QueuedJobs.Num();
+    Progress.RunningSegments = RunningJobs;
+    Progress.CompletedSegments = CompletedJobs;
+    Progress.FailedSegments = FailedJobs;
+    return Progress;
+}
+
+void FOmniCaptureFinalizer::LaunchQueuedJobs()
+{
+    while (RunningJobs < MaxConcurrentJobs && QueuedJobs.Num() > 0)
+    {
+        TUniquePtr<FOmniCaptureFinalizeJob> Job = MoveTemp(QueuedJobs[0]);
+        QueuedJobs.RemoveAt(0);
+        ++RunningJobs;
+
+        RunningTasks.Add(Async(EAsyncExecution::Thread, [this, Job = MoveTemp(Job)]() mutable
+        {
+            FOmniCaptureFinalizeResult Result = RunJob(*Job);
+            Job.Reset();
+
+            FScopeLock Lock(&JobsCS);
+            --RunningJobs;
+            ++(Result.bSuccess ? CompletedJobs : FailedJobs);
+            CompletedResults.Add(MoveTemp(Result));
+            LaunchQueuedJobs();
+        }));
+    }
+}
+
+FOmniCaptureFinalizeResult FOmniCaptureFinalizer::RunJob(FOmniCaptureFinalizeJob& Job)
+{
+    const double StartTime = FPlatformTime::Seconds();
+    FOmniCaptureFinalizeResult Result;
+    Result.bRequestedNVENC = Job.bRequestedNVENC;
+
+    if (Job.ImageWriter)
+    {
+        // Let queued frames land before the writer is shut down; Flush on its own would cancel them.
+        Job.ImageWriter->WaitForPendingWrites();
+        Job.ImageWriter->Flush();
+        const FOmniCaptureImageWriterStats WriterStats = Job.ImageWriter->GetStats();
+        UE_LOG(LogOmniCaptureFinalizer, Log, TEXT("Segment %d image writer peak in-flight %.1f MB, %d memory budget stalls"), Job.Segment.SegmentIndex, WriterStats.PeakInFlightBytes / (1024.0 * 1024.0), WriterStats.BudgetStalls);
+        Job.ImageWriter.Reset();
+    }
+
+    if (Job.FFmpegPipe)
+    {
+        if (!Job.FFmpegPipe->Finalize())
+        {
+            Result.WriterError = FString::Printf(TEXT("FFmpeg pipe did not produce %s: %s"), *Job.FFmpegPipe->GetOutputFilePath(), *Job.FFmpegPipe->GetLastError());
+        }
+        Job.FFmpegPipe.Reset();
+    }
+
+    if (Job.AudioFileClosed.IsValid())
+    {
+        Job.AudioFileClosed.Wait();
+    }
+
+    FOmniCaptureMuxer Muxer;
+    Muxer.Initialize(Job.Settings, Job.Segment.Directory);
+    const bool bMuxed = Muxer.FinalizeCapture(Job.Settings, Job.Segment.Frames, Job.Segment.AudioPath, Job.Segment.VideoPath, Job.Segment.DroppedFrames);
+
+    Result.bMuxingExpected = Job.Settings.OutputFormat != EOmniOutputFormat::ImageSequence;
+    Result.FinalVideoPath = Job.Segment.Directory / (Job.Segment.BaseFileName + TEXT(".mp4"));
+    const bool bFinalFileExists = !Result.bMuxingExpected || FPaths::FileExists(Result.FinalVideoPath);
+    Result.bSuccess = bMuxed && bFinalFileExists;
+
+    Result.FrameCount = Job.Segment.Frames.Num();
+    Result.Settings = MoveTemp(Job.Settings);
+    Result.Segment = MoveTemp(Job.Segment);
+    Result.Segment.Frames.Empty();
+    Result.DurationSeconds = FPlatformTime::Seconds() - StartTime;
+
+    UE_LOG(LogOmniCaptureFinalizer, Log, TEXT("Segment %d finalized in %.2fs (%s)"), Result.Segment.SegmentIndex, Result.DurationSeconds, Result.bSuccess ? TEXT("ok") : TEXT("failed"));
+    return Result;
+}
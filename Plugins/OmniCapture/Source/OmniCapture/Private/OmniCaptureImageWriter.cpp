@@ -3,18 +3,25 @@
 
 #include "Async/Async.h"
 #include "Async/Future.h"
+#include "Async/ParallelFor.h"
 #include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
 #include "IImageWrapperModule.h"
 #include "IImageWrapper.h"
 #include "ImageWriteQueue.h"
 #include "ImageWriteTypes.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/ScopeExit.h"
 #include "Modules/ModuleManager.h"
 #include "Containers/StringConv.h"
 #include "Internationalization/Internationalization.h"
 #include "Math/Vector2D.h"
 #include "OmniCaptureVersion.h"
+#include "OmniCaptureColorConversion.h"
+#include "OmniCapturePNGEncoder.h"
+#include "OmniCaptureStageProfiler.h"
 
 #include <exception>
 
@@ -36,6 +43,11 @@ THIRD_PARTY_INCLUDES_START
 #include "OpenEXR/ImfStringAttribute.h"
 #include "OpenEXR/ImfCompression.h"
 #include "OpenEXR/ImfNamespace.h"
+#include "OpenEXR/ImfPartType.h"
+#include "OpenEXR/ImfThreading.h"
+#include "OpenEXR/ImfTileDescription.h"
+#include "OpenEXR/ImfTiledOutputFile.h"
+#include "OpenEXR/ImfTiledOutputPart.h"
 #include "Imath/half.h"
 THIRD_PARTY_INCLUDES_END
 #endif
@@ -82,38 +94,110 @@ namespace
         }
     }
 
+    static_assert(sizeof(FFloat16Color) == 4 * sizeof(IMATH_NAMESPACE::half), "FFloat16Color must be four packed halves for EXR slices");
+    static_assert(sizeof(FLinearColor) == 4 * sizeof(float), "FLinearColor must be four packed floats for EXR slices");
+
+    /** One RGBA layer whose slices read straight out of the layer's pixel data. */
     struct FPreparedExrLayer
     {
         std::string Name;
         OPENEXR_IMF_NAMESPACE::PixelType PixelType = OPENEXR_IMF_NAMESPACE::PixelType::HALF;
         int32 ChannelCount = 4;
-        TArray<float> FloatBuffer;
-        TArray<IMATH_NAMESPACE::half> HalfBuffer;
+        const char* BasePointer = nullptr;
+        size_t ComponentSize = sizeof(IMATH_NAMESPACE::half);
+        /** 8-bit payloads have no EXR pixel type, so only they are widened into a copy. */
+        TArray<FLinearColor> WidenedPixels;
 
-        const char* GetBasePointer() const
+        void InsertChannels(OPENEXR_IMF_NAMESPACE::Header& Header, OPENEXR_IMF_NAMESPACE::FrameBuffer& FrameBuffer, const std::string& Prefix, int32 Width) const
         {
-            if (PixelType == OPENEXR_IMF_NAMESPACE::PixelType::FLOAT)
+            const size_t PixelStride = ComponentSize * ChannelCount;
+            const size_t RowStride = PixelStride * Width;
+            for (int32 ChannelIndex = 0; ChannelIndex < ChannelCount; ++ChannelIndex)
             {
-                return reinterpret_cast<const char*>(FloatBuffer.GetData());
+                const std::string ChannelName = Prefix + TCHAR_TO_UTF8(GetChannelSuffix(ChannelIndex));
+                Header.channels().insert(ChannelName.c_str(), OPENEXR_IMF_NAMESPACE::Channel(PixelType));
+                // RGBA components are packed in channel order in both FLinearColor and FFloat16Color.
+                char* ChannelBase = const_cast<char*>(BasePointer) + ComponentSize * ChannelIndex;
+                FrameBuffer.insert(ChannelName.c_str(), OPENEXR_IMF_NAMESPACE::Slice(PixelType, ChannelBase, PixelStride, RowStride));
             }
+        }
+    };
 
-            return reinterpret_cast<const char*>(HalfBuffer.GetData());
+    void ConfigureExrHeader(OPENEXR_IMF_NAMESPACE::Header& Header, EOmniCaptureEXRCompression Compression, EOmniCaptureEXRLayout Layout, int32 TileSize)
+    {
+        Header.compression() = ToOpenExrCompression(Compression);
+        if (Layout == EOmniCaptureEXRLayout::Tiled)
+        {
+            Header.setTileDescription(OPENEXR_IMF_NAMESPACE::TileDescription(TileSize, TileSize, OPENEXR_IMF_NAMESPACE::ONE_LEVEL));
+            Header.setType(OPENEXR_IMF_NAMESPACE::TILEDIMAGE);
         }
+        else
+        {
+            Header.setType(OPENEXR_IMF_NAMESPACE::SCANLINEIMAGE);
+        }
+    }
 
-        int32 GetComponentSize() const
+    /**
+     * The OpenEXR pool is process wide and resizing it waits for every queued line block, including those of a previous
+     * writer whose finalizer is still encoding. It is sized by the first writer and afterwards only ever grows.
+     */
+    void EnsureExrThreadCount(int32 RequestedThreads)
+    {
+        static FCriticalSection ExrThreadPoolCS;
+        FScopeLock Lock(&ExrThreadPoolCS);
+        if (OPENEXR_IMF_NAMESPACE::globalThreadCount() < RequestedThreads)
         {
-            return PixelType == OPENEXR_IMF_NAMESPACE::PixelType::FLOAT ? sizeof(float) : sizeof(IMATH_NAMESPACE::half);
+            OPENEXR_IMF_NAMESPACE::setGlobalThreadCount(RequestedThreads);
         }
-    };
+    }
 #endif
 
+    template <typename PixelType>
+    TUniquePtr<TImagePixelData<FColor>> QuantizeToColor(const TImagePixelData<PixelType>& PixelData, const FOmniCaptureQuantizeOptions& Options)
+    {
+        const FIntPoint Size = PixelData.GetSize();
+        TUniquePtr<TImagePixelData<FColor>> ColorData = MakeUnique<TImagePixelData<FColor>>(Size);
+        ColorData->Pixels.SetNumUninitialized(static_cast<int64>(Size.X) * Size.Y);
+        ParallelFor(Size.Y, [&PixelData, &ColorData, &Options, Width = Size.X](int32 Row)
+        {
+            const int64 RowOffset = static_cast<int64>(Row) * Width;
+            FOmniCaptureColorConversion::ConvertRow(PixelData.Pixels.GetData() + RowOffset, ColorData->Pixels.GetData() + RowOffset, Width, Row, Options);
+        });
+        return ColorData;
+    }
+
+    /** Quantizes rows as the PNG encoder asks for them, so conversion runs alongside compression. */
+    template <typename PixelType>
+    auto MakeLinearPNGRowSource(const TImagePixelData<PixelType>& PixelData, const FOmniCaptureQuantizeOptions& Options, bool bSixteenBit)
+    {
+        return [&PixelData, Options, bSixteenBit](int32 RowStart, int32 RowCount, int64 BytesPerRow, TArray64<uint8>& TempBuffer, TArray<uint8*>& RowPointers)
+        {
+            TempBuffer.SetNum(BytesPerRow * RowCount, EAllowShrinking::No);
+            const int32 Width = PixelData.GetSize().X;
+            for (int32 Row = 0; Row < RowCount; ++Row)
+            {
+                uint8* RowData = TempBuffer.GetData() + BytesPerRow * Row;
+                RowPointers[Row] = RowData;
+                const PixelType* Source = PixelData.Pixels.GetData() + static_cast<int64>(RowStart + Row) * Width;
+                if (bSixteenBit)
+                {
+                    FOmniCaptureColorConversion::ConvertRow(Source, reinterpret_cast<uint16*>(RowData), Width, RowStart + Row, Options);
+                }
+                else
+                {
+                    FOmniCaptureColorConversion::ConvertRow(Source, reinterpret_cast<FColor*>(RowData), Width, RowStart + Row, Options);
+                }
+            }
+        };
+    }
+
     TSharedPtr<IImageWrapper> CreateImageWrapper(EImageFormat Format)
     {
         IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
         return ImageWrapperModule.CreateImageWrapper(Format);
     }
 
-    bool WritePNGWithImageWrapper(const FString& FilePath, const FIntPoint& Size, const void* RawData, int64 RawSizeInBytes, ERGBFormat Format, int32 BitDepth)
+    bool WritePNGWithImageWrapper(const FString& FilePath, const FIntPoint& Size, const void* RawData, int64 RawSizeInBytes, ERGBFormat Format, int32 BitDepth, int64& OutFileBytes)
     {
         if (!RawData || RawSizeInBytes <= 0 || Size.X <= 0 || Size.Y <= 0)
         {
@@ -138,7 +222,23 @@ namespace
         }
 
         IFileManager::Get().Delete(*FilePath, false, true, false);
-        return FFileHelper::SaveArrayToFile(CompressedData, *FilePath);
+        if (!FFileHelper::SaveArrayToFile(CompressedData, *FilePath))
+        {
+            return false;
+        }
+        OutFileBytes = CompressedData.Num();
+        return true;
+    }
+
+    int64 GetPixelDataBytes(const FImagePixelData* PixelData)
+    {
+        const void* RawData = nullptr;
+        int64 SizeInBytes = 0;
+        if (PixelData && PixelData->GetRawData(RawData, SizeInBytes))
+        {
+            return SizeInBytes;
+        }
+        return 0;
     }
 
     FString NormalizeFilePath(const FString& InPath)
@@ -180,6 +280,22 @@ namespace
         }
     }
 
+    int32 GetPngFilterFlags(EOmniCapturePNGFilter Filter)
+    {
+        switch (Filter)
+        {
+        case EOmniCapturePNGFilter::None:
+            return PNG_FILTER_NONE;
+        case EOmniCapturePNGFilter::Sub:
+            return PNG_FILTER_SUB;
+        case EOmniCapturePNGFilter::Up:
+            return PNG_FILTER_UP;
+        case EOmniCapturePNGFilter::Adaptive:
+        default:
+            return PNG_ALL_FILTERS;
+        }
+    }
+
     void PngWriteDataCallback(png_structp PngPtr, png_bytep Data, png_size_t Length)
     {
         FArchive* Archive = static_cast<FArchive*>(png_get_io_ptr(PngPtr));
@@ -209,6 +325,10 @@ namespace
 FOmniCaptureImageWriter::FOmniCaptureImageWriter()
 {
     bStopRequested.Store(false);
+    InFlightBytes.Store(0);
+    PeakInFlightBytes.Store(0);
+    BudgetStalls.Store(0);
+    BytesWritten.Store(0);
 }
 FOmniCaptureImageWriter::~FOmniCaptureImageWriter() { Flush(); }
 
@@ -220,11 +340,38 @@ void FOmniCaptureImageWriter::Initialize(const FOmniCaptureSettings& Settings, c
     IFileManager::Get().MakeDirectory(*OutputDirectory, true);
     TargetFormat = Settings.ImageFormat;
     TargetPNGBitDepth = Settings.PNGBitDepth;
+    bParallelPNGEncoding = Settings.bParallelPNGEncoding;
+    PNGEncodeOptions.CompressionLevel = FMath::Clamp(Settings.PNGCompressionLevel, 0, 9);
+    PNGEncodeOptions.Filter = Settings.PNGFilter;
+    bDitherQuantization = Settings.bDitherQuantization;
     MaxPendingTasks = FMath::Max(1, Settings.MaxPendingImageTasks);
+    MaxInFlightBytes = static_cast<int64>(FMath::Max(0, Settings.MaxPendingImageMemoryMB)) * 1024 * 1024;
     bPackEXRAuxiliaryLayers = Settings.bPackEXRAuxiliaryLayers;
     bUseEXRMultiPart = Settings.bUseEXRMultiPart;
     TargetEXRCompression = Settings.EXRCompression;
+    TargetEXRLayout = Settings.EXRLayout;
+    EXRTileSize = FMath::Max(16, Settings.EXRTileSize);
+#if WITH_OMNICAPTURE_OPENEXR
+    // Packed EXR frames compress their line blocks or tiles across this pool; other formats leave the shared pool alone.
+    if (TargetFormat == EOmniCaptureImageFormat::EXR)
+    {
+        EnsureExrThreadCount(Settings.EXRThreadCount > 0 ? Settings.EXRThreadCount : FPlatformMisc::NumberOfWorkerThreadsToSpawn());
+    }
+#endif
     bStopRequested.Store(false);
+    BytesWritten.Store(0);
+
+    RawDumpWriter.Reset();
+    if (TargetFormat == EOmniCaptureImageFormat::RawDump)
+    {
+        RawDumpWriter = MakeUnique<FOmniCaptureRawDumpWriter>();
+        if (!RawDumpWriter->Open(OutputDirectory, SequenceBaseName, static_cast<int64>(FMath::Max(64, Settings.RawDumpSegmentSizeMB)) * 1024 * 1024))
+        {
+            RawDumpWriter.Reset();
+            return;
+        }
+    }
+
     bInitialized = true;
 }
 
@@ -235,10 +382,14 @@ void FOmniCaptureImageWriter::EnqueueFrame(TUniquePtr<FOmniCaptureFrame>&& Frame
         return;
     }
 
-    PruneCompletedTasks();
-    WaitForAvailableTaskSlot();
+    int64 FrameBytes = GetPixelDataBytes(Frame->PixelData.Get());
+    for (const TPair<FName, FOmniCaptureLayerPayload>& Pair : Frame->AuxiliaryLayers)
+    {
+        FrameBytes += GetPixelDataBytes(Pair.Value.PixelData.Get());
+    }
 
-    if (IsStopRequested())
+    PruneCompletedTasks();
+    if (!ReserveTaskSlot(FrameBytes))
     {
         return;
     }
@@ -251,6 +402,7 @@ void FOmniCaptureImageWriter::EnqueueFrame(TUniquePtr<FOmniCaptureFrame>&& Frame
     TMap<FName, FOmniCaptureLayerPayload> AuxiliaryLayers = MoveTemp(Frame->AuxiliaryLayers);
     if (!PixelData.IsValid())
     {
+        CancelTaskSlot(FrameBytes);
         return;
     }
 
@@ -260,8 +412,46 @@ void FOmniCaptureImageWriter::EnqueueFrame(TUniquePtr<FOmniCaptureFrame>&& Frame
     const FString LayerBaseName = FPaths::GetBaseFilename(TargetPath);
     const FString LayerExtension = FPaths::GetExtension(TargetPath, true);
 
-    TFuture<bool> Future = Async(EAsyncExecution::ThreadPool, [this, FilePath = MoveTemp(TargetPath), Format = TargetFormat, bIsLinear, PixelPrecision, PixelDataType, PixelData = MoveTemp(PixelData), AuxiliaryLayers = MoveTemp(AuxiliaryLayers), LayerDirectory, LayerBaseName, LayerExtension]() mutable
+    if (RawDumpWriter.IsValid())
+    {
+        // Raw payloads are written as-is, so the frame's own type and precision travel with it into the index.
+        TFuture<bool> RawFuture = Async(EAsyncExecution::ThreadPool, [this, FrameBytes, Metadata, FrameName = LayerBaseName, bIsLinear, PixelPrecision, PixelDataType, PixelData = MoveTemp(PixelData), AuxiliaryLayers = MoveTemp(AuxiliaryLayers), Profiler = StageProfiler]() mutable
+        {
+            OMNICAPTURE_STAGE_SCOPE(DiskWrite);
+            const double WriteBegin = FPlatformTime::Seconds();
+            const bool bResult = RawDumpWriter->WriteFrame(Metadata, FrameName, *PixelData, bIsLinear, PixelPrecision, PixelDataType, AuxiliaryLayers);
+            PixelData.Reset();
+            AuxiliaryLayers.Reset();
+            ReleaseInFlightBytes(FrameBytes);
+            if (Profiler.IsValid())
+            {
+                Profiler->Record(Metadata.FrameIndex, EOmniCaptureStage::DiskWrite, WriteBegin, FPlatformTime::Seconds());
+            }
+            return bResult;
+        });
+
+        TrackPendingTask(MoveTemp(RawFuture));
+        PruneCompletedTasks();
+        EnforcePendingTaskLimit();
+        RecordCapturedMetadata(Metadata);
+        return;
+    }
+
+    TFuture<bool> Future = Async(EAsyncExecution::ThreadPool, [this, FrameBytes, FilePath = MoveTemp(TargetPath), Format = TargetFormat, bIsLinear, PixelPrecision, PixelDataType, PixelData = MoveTemp(PixelData), AuxiliaryLayers = MoveTemp(AuxiliaryLayers), LayerDirectory, LayerBaseName, LayerExtension, FrameIndex = Metadata.FrameIndex, Profiler = StageProfiler]() mutable
     {
+        OMNICAPTURE_STAGE_SCOPE(DiskWrite);
+        const double WriteBegin = FPlatformTime::Seconds();
+        ON_SCOPE_EXIT
+        {
+            // Layers are written and freed one by one, but the frame is charged until its whole task is done.
+            AuxiliaryLayers.Reset();
+            ReleaseInFlightBytes(FrameBytes);
+            if (Profiler.IsValid())
+            {
+                Profiler->Record(FrameIndex, EOmniCaptureStage::DiskWrite, WriteBegin, FPlatformTime::Seconds());
+            }
+        };
+
         if (Format == EOmniCaptureImageFormat::EXR)
         {
             return WriteEXRFrame(FilePath, bIsLinear, MoveTemp(PixelData), PixelPrecision, PixelDataType, MoveTemp(AuxiliaryLayers), LayerDirectory, LayerBaseName, LayerExtension);
@@ -303,11 +493,19 @@ void FOmniCaptureImageWriter::EnqueueFrame(TUniquePtr<FOmniCaptureFrame>&& Frame
     TrackPendingTask(MoveTemp(Future));
     PruneCompletedTasks();
     EnforcePendingTaskLimit();
+    RecordCapturedMetadata(Metadata);
+}
 
+void FOmniCaptureImageWriter::RecordCapturedMetadata(const FOmniCaptureFrameMetadata& Metadata)
+{
+    // Ring workers may hand frames over out of order; keep the list sorted so manifests stay in FrameIndex order.
+    FScopeLock Lock(&MetadataCS);
+    int32 InsertIndex = CapturedMetadata.Num();
+    while (InsertIndex > 0 && CapturedMetadata[InsertIndex - 1].FrameIndex > Metadata.FrameIndex)
     {
-        FScopeLock Lock(&MetadataCS);
-        CapturedMetadata.Add(Metadata);
+        --InsertIndex;
     }
+    CapturedMetadata.Insert(Metadata, InsertIndex);
 }
 
 void FOmniCaptureImageWriter::Flush()
@@ -315,9 +513,44 @@ void FOmniCaptureImageWriter::Flush()
     RequestStop();
     PruneCompletedTasks();
     WaitForAllTasks();
+    if (RawDumpWriter.IsValid())
+    {
+        RawDumpWriter->Close();
+    }
     bInitialized = false;
 }
 
+void FOmniCaptureImageWriter::WaitForPendingWrites()
+{
+    PruneCompletedTasks();
+    WaitForAllTasks();
+}
+
+FOmniCaptureImageWriterStats FOmniCaptureImageWriter::GetStats() const
+{
+    FOmniCaptureImageWriterStats Stats;
+    {
+        FScopeLock Lock(&PendingTasksCS);
+        Stats.PendingTasks = PendingTasks.Num();
+    }
+    Stats.InFlightBytes = InFlightBytes.Load();
+    Stats.PeakInFlightBytes = PeakInFlightBytes.Load();
+    Stats.BudgetBytes = MaxInFlightBytes;
+    Stats.BudgetStalls = BudgetStalls.Load();
+    return Stats;
+}
+
+int64 FOmniCaptureImageWriter::GetBytesWritten() const
+{
+    // Raw segments are preallocated, so the dump writer's payload counter is the only meaningful size for them.
+    return BytesWritten.Load() + (RawDumpWriter.IsValid() ? RawDumpWriter->GetBytesWritten() : 0);
+}
+
+void FOmniCaptureImageWriter::AddBytesWritten(int64 Bytes) const
+{
+    BytesWritten.AddExchange(Bytes);
+}
+
 TArray<FOmniCaptureFrameMetadata> FOmniCaptureImageWriter::ConsumeCapturedFrames()
 {
     FScopeLock Lock(&MetadataCS);
@@ -551,9 +784,11 @@ bool FOmniCaptureImageWriter::WritePNGRaw(const FString& FilePath, const FIntPoi
         return true;
     }
 
-    if (BitDepth == 8)
+    int64 FileBytes = 0;
+    if (BitDepth == 8 && WritePNGWithImageWrapper(FilePath, Size, RawData, RawSizeInBytes, Format, BitDepth, FileBytes))
     {
-        return WritePNGWithImageWrapper(FilePath, Size, RawData, RawSizeInBytes, Format, BitDepth);
+        AddBytesWritten(FileBytes);
+        return true;
     }
 
     return false;
@@ -598,6 +833,20 @@ bool FOmniCaptureImageWriter::WritePNGWithRowSource(const FString& FilePath, con
         return false;
     }
 
+    if (bParallelPNGEncoding && (Format == ERGBFormat::BGRA || Format == ERGBFormat::RGBA || Format == ERGBFormat::Gray) && (BitDepth == 8 || BitDepth == 16))
+    {
+        const bool bEncoded = FOmniCaptureParallelPNGEncoder::Encode(*Archive, Size, Channels, BitDepth, Format == ERGBFormat::BGRA, PNGEncodeOptions, PrepareRows, [this]() { return IsStopRequested(); });
+        const int64 FileBytes = Archive->Tell();
+        Archive->Close();
+        if (!bEncoded || Archive->IsError())
+        {
+            IFileManager::Get().Delete(*FilePath, false, true, true);
+            return false;
+        }
+        AddBytesWritten(FileBytes);
+        return true;
+    }
+
     png_structp PngPtr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
     if (!PngPtr)
     {
@@ -623,6 +872,8 @@ bool FOmniCaptureImageWriter::WritePNGWithRowSource(const FString& FilePath, con
 
     png_set_write_fn(PngPtr, Archive.Get(), PngWriteDataCallback, PngFlushCallback);
     png_set_IHDR(PngPtr, InfoPtr, Size.X, Size.Y, BitDepth, ColorType, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_set_compression_level(PngPtr, PNGEncodeOptions.CompressionLevel);
+    png_set_filter(PngPtr, PNG_FILTER_TYPE_BASE, GetPngFilterFlags(PNGEncodeOptions.Filter));
 
     if (BitDepth == 16)
     {
@@ -665,8 +916,14 @@ bool FOmniCaptureImageWriter::WritePNGWithRowSource(const FString& FilePath, con
     png_write_end(PngPtr, InfoPtr);
     png_destroy_write_struct(&PngPtr, &InfoPtr);
 
+    const int64 FileBytes = Archive->Tell();
     Archive->Close();
-    return !Archive->IsError();
+    if (Archive->IsError())
+    {
+        return false;
+    }
+    AddBytesWritten(FileBytes);
+    return true;
 #else
     return false;
 #endif
@@ -768,14 +1025,18 @@ bool FOmniCaptureImageWriter::WriteBMP(const TImagePixelData<FColor>& PixelData,
     }
 
     IFileManager::Get().Delete(*FilePath, false, true, false);
-    return FFileHelper::SaveArrayToFile(CompressedData, *FilePath);
+    if (!FFileHelper::SaveArrayToFile(CompressedData, *FilePath))
+    {
+        return false;
+    }
+    AddBytesWritten(CompressedData.Num());
+    return true;
 }
 
 bool FOmniCaptureImageWriter::WritePNGFromLinear(const TImagePixelData<FFloat16Color>& PixelData, const FString& FilePath) const
 {
     const FIntPoint Size = PixelData.GetSize();
-    const int32 ExpectedCount = Size.X * Size.Y;
-    if (PixelData.Pixels.Num() != ExpectedCount)
+    if (PixelData.Pixels.Num() != static_cast<int64>(Size.X) * Size.Y)
     {
         return false;
     }
@@ -785,83 +1046,30 @@ bool FOmniCaptureImageWriter::WritePNGFromLinear(const TImagePixelData<FFloat16C
         return false;
     }
 
-    if (TargetPNGBitDepth == EOmniCapturePNGBitDepth::BitDepth16)
-    {
-        auto PrepareRows = [&PixelData, &Size](int32 RowStart, int32 RowCount, int64 BytesPerRow, TArray64<uint8>& TempBuffer, TArray<uint8*>& RowPointers)
-        {
-            const int64 RequiredSize = BytesPerRow * RowCount;
-            TempBuffer.SetNum(RequiredSize, EAllowShrinking::No);
-
-            const auto ToUInt16 = [](float Value) -> uint16
-            {
-                const float Clamped = FMath::Clamp(Value, 0.0f, 1.0f);
-                return static_cast<uint16>(FMath::RoundToInt(Clamped * 65535.0f));
-            };
+    // 16-bit PNGs keep their linear values; 8-bit output is sRGB encoded.
+    const bool bSixteenBit = TargetPNGBitDepth == EOmniCapturePNGBitDepth::BitDepth16;
+    FOmniCaptureQuantizeOptions Options;
+    Options.bEncodeSRGB = !bSixteenBit;
+    Options.bDither = bDitherQuantization;
 
-            for (int32 Row = 0; Row < RowCount; ++Row)
-            {
-                uint8* RowData = TempBuffer.GetData() + BytesPerRow * Row;
-                RowPointers[Row] = RowData;
-                uint16* Dest = reinterpret_cast<uint16*>(RowData);
-                const int64 PixelRowStart = static_cast<int64>(RowStart + Row) * Size.X;
-                for (int32 Column = 0; Column < Size.X; ++Column)
-                {
-                    const FFloat16Color& Pixel = PixelData.Pixels[PixelRowStart + Column];
-                    *Dest++ = ToUInt16(Pixel.B.GetFloat());
-                    *Dest++ = ToUInt16(Pixel.G.GetFloat());
-                    *Dest++ = ToUInt16(Pixel.R.GetFloat());
-                    *Dest++ = ToUInt16(Pixel.A.GetFloat());
-                }
-            }
-        };
-
-        return WritePNGWithRowSource(FilePath, Size, ERGBFormat::BGRA, 16, PrepareRows);
-    }
-
-    const int64 PixelCount = static_cast<int64>(Size.X) * Size.Y;
-    const int64 BytesPerRow = static_cast<int64>(Size.X) * 4;
-    TArray64<uint8> ConvertedPixels;
-    ConvertedPixels.SetNum(PixelCount * 4, EAllowShrinking::No);
-
-    for (int64 PixelIndex = 0; PixelIndex < PixelCount; ++PixelIndex)
+    if (WritePNGWithRowSource(FilePath, Size, ERGBFormat::BGRA, bSixteenBit ? 16 : 8, MakeLinearPNGRowSource(PixelData, Options, bSixteenBit)))
     {
-        const FFloat16Color& Pixel = PixelData.Pixels[PixelIndex];
-        const FLinearColor Linear(
-            Pixel.R.GetFloat(),
-            Pixel.G.GetFloat(),
-            Pixel.B.GetFloat(),
-            Pixel.A.GetFloat());
-        const FColor Converted = Linear.ToFColor(true);
-        const int64 Offset = PixelIndex * 4;
-        ConvertedPixels[Offset + 0] = Converted.B;
-        ConvertedPixels[Offset + 1] = Converted.G;
-        ConvertedPixels[Offset + 2] = Converted.R;
-        ConvertedPixels[Offset + 3] = Converted.A;
+        return true;
     }
 
-    uint8* ConvertedBasePtr = ConvertedPixels.GetData();
-    auto PrepareRows = [ConvertedBasePtr, BytesPerRow](int32 RowStart, int32 RowCount, int64, TArray64<uint8>& TempBuffer, TArray<uint8*>& RowPointers)
-    {
-        (void)TempBuffer;
-        for (int32 Row = 0; Row < RowCount; ++Row)
-        {
-            RowPointers[Row] = ConvertedBasePtr + BytesPerRow * (RowStart + Row);
-        }
-    };
-
-    if (WritePNGWithRowSource(FilePath, Size, ERGBFormat::BGRA, 8, PrepareRows))
+    if (bSixteenBit || IsStopRequested())
     {
-        return true;
+        return false;
     }
 
-    return WritePNGWithImageWrapper(FilePath, Size, ConvertedPixels.GetData(), ConvertedPixels.Num(), ERGBFormat::BGRA, 8);
+    const TUniquePtr<TImagePixelData<FColor>> ColorData = QuantizeToColor(PixelData, Options);
+    return WritePNGRaw(FilePath, Size, ColorData->Pixels.GetData(), ColorData->Pixels.Num() * sizeof(FColor), ERGBFormat::BGRA, 8);
 }
 
 bool FOmniCaptureImageWriter::WritePNGFromLinearFloat32(const TImagePixelData<FLinearColor>& PixelData, const FString& FilePath) const
 {
     const FIntPoint Size = PixelData.GetSize();
-    const int32 ExpectedCount = Size.X * Size.Y;
-    if (PixelData.Pixels.Num() != ExpectedCount)
+    if (PixelData.Pixels.Num() != static_cast<int64>(Size.X) * Size.Y)
     {
         return false;
     }
@@ -871,70 +1079,30 @@ bool FOmniCaptureImageWriter::WritePNGFromLinearFloat32(const TImagePixelData<FL
         return false;
     }
 
-    if (TargetPNGBitDepth == EOmniCapturePNGBitDepth::BitDepth16)
-    {
-        auto PrepareRows = [&PixelData, &Size](int32 RowStart, int32 RowCount, int64 BytesPerRow, TArray64<uint8>& TempBuffer, TArray<uint8*>& RowPointers)
-        {
-            const int64 RequiredSize = BytesPerRow * RowCount;
-            TempBuffer.SetNum(RequiredSize, EAllowShrinking::No);
+    // 16-bit PNGs keep their linear values; 8-bit output is sRGB encoded.
+    const bool bSixteenBit = TargetPNGBitDepth == EOmniCapturePNGBitDepth::BitDepth16;
+    FOmniCaptureQuantizeOptions Options;
+    Options.bEncodeSRGB = !bSixteenBit;
+    Options.bDither = bDitherQuantization;
 
-            const auto ToUInt16 = [](float Value) -> uint16
-            {
-                const float Clamped = FMath::Clamp(Value, 0.0f, 1.0f);
-                return static_cast<uint16>(FMath::RoundToInt(Clamped * 65535.0f));
-            };
-
-            for (int32 Row = 0; Row < RowCount; ++Row)
-            {
-                uint8* RowData = TempBuffer.GetData() + BytesPerRow * Row;
-                RowPointers[Row] = RowData;
-                uint16* Dest = reinterpret_cast<uint16*>(RowData);
-                const int64 PixelRowStart = static_cast<int64>(RowStart + Row) * Size.X;
-                for (int32 Column = 0; Column < Size.X; ++Column)
-                {
-                    const FLinearColor& Pixel = PixelData.Pixels[PixelRowStart + Column];
-                    *Dest++ = ToUInt16(Pixel.B);
-                    *Dest++ = ToUInt16(Pixel.G);
-                    *Dest++ = ToUInt16(Pixel.R);
-                    *Dest++ = ToUInt16(Pixel.A);
-                }
-            }
-        };
-
-        return WritePNGWithRowSource(FilePath, Size, ERGBFormat::BGRA, 16, PrepareRows);
+    if (WritePNGWithRowSource(FilePath, Size, ERGBFormat::BGRA, bSixteenBit ? 16 : 8, MakeLinearPNGRowSource(PixelData, Options, bSixteenBit)))
+    {
+        return true;
     }
 
-    auto PrepareRows8Bit = [&PixelData, &Size](int32 RowStart, int32 RowCount, int64 BytesPerRow, TArray64<uint8>& TempBuffer, TArray<uint8*>& RowPointers)
+    if (bSixteenBit || IsStopRequested())
     {
-        const int64 RequiredSize = BytesPerRow * RowCount;
-        TempBuffer.SetNum(RequiredSize, EAllowShrinking::No);
-
-        for (int32 Row = 0; Row < RowCount; ++Row)
-        {
-            uint8* RowData = TempBuffer.GetData() + BytesPerRow * Row;
-            RowPointers[Row] = RowData;
-            const int64 PixelRowStart = static_cast<int64>(RowStart + Row) * Size.X;
-            for (int32 Column = 0; Column < Size.X; ++Column)
-            {
-                const FLinearColor& Pixel = PixelData.Pixels[PixelRowStart + Column];
-                const FColor Converted = Pixel.ToFColor(true);
-                const int64 Offset = static_cast<int64>(Column) * 4;
-                RowData[Offset + 0] = Converted.B;
-                RowData[Offset + 1] = Converted.G;
-                RowData[Offset + 2] = Converted.R;
-                RowData[Offset + 3] = Converted.A;
-            }
-        }
-    };
+        return false;
+    }
 
-    return WritePNGWithRowSource(FilePath, Size, ERGBFormat::BGRA, 8, PrepareRows8Bit);
+    const TUniquePtr<TImagePixelData<FColor>> ColorData = QuantizeToColor(PixelData, Options);
+    return WritePNGRaw(FilePath, Size, ColorData->Pixels.GetData(), ColorData->Pixels.Num() * sizeof(FColor), ERGBFormat::BGRA, 8);
 }
 
 bool FOmniCaptureImageWriter::WriteBMPFromLinear(const TImagePixelData<FFloat16Color>& PixelData, const FString& FilePath) const
 {
     const FIntPoint Size = PixelData.GetSize();
-    const int32 ExpectedCount = Size.X * Size.Y;
-    if (PixelData.Pixels.Num() != ExpectedCount)
+    if (PixelData.Pixels.Num() != static_cast<int64>(Size.X) * Size.Y)
     {
         return false;
     }
@@ -944,29 +1112,15 @@ bool FOmniCaptureImageWriter::WriteBMPFromLinear(const TImagePixelData<FFloat16C
         return false;
     }
 
-    TArray<FColor> Converted;
-    Converted.SetNum(ExpectedCount);
-    for (int32 Index = 0; Index < ExpectedCount; ++Index)
-    {
-        const FFloat16Color& Pixel = PixelData.Pixels[Index];
-        const FLinearColor Linear(
-            Pixel.R.GetFloat(),
-            Pixel.G.GetFloat(),
-            Pixel.B.GetFloat(),
-            Pixel.A.GetFloat());
-        Converted[Index] = Linear.ToFColor(true);
-    }
-
-    TUniquePtr<TImagePixelData<FColor>> TempData = MakeUnique<TImagePixelData<FColor>>(Size);
-    TempData->Pixels = MoveTemp(Converted);
-    return WriteBMP(*TempData, FilePath);
+    FOmniCaptureQuantizeOptions Options;
+    Options.bDither = bDitherQuantization;
+    return WriteBMP(*QuantizeToColor(PixelData, Options), FilePath);
 }
 
 bool FOmniCaptureImageWriter::WriteBMPFromLinearFloat32(const TImagePixelData<FLinearColor>& PixelData, const FString& FilePath) const
 {
     const FIntPoint Size = PixelData.GetSize();
-    const int32 ExpectedCount = Size.X * Size.Y;
-    if (PixelData.Pixels.Num() != ExpectedCount)
+    if (PixelData.Pixels.Num() != static_cast<int64>(Size.X) * Size.Y)
     {
         return false;
     }
@@ -976,15 +1130,9 @@ bool FOmniCaptureImageWriter::WriteBMPFromLinearFloat32(const TImagePixelData<FL
         return false;
     }
 
-    TUniquePtr<TImagePixelData<FColor>> TempData = MakeUnique<TImagePixelData<FColor>>(Size);
-    TempData->Pixels.SetNum(ExpectedCount);
-
-    for (int32 Index = 0; Index < ExpectedCount; ++Index)
-    {
-        TempData->Pixels[Index] = PixelData.Pixels[Index].ToFColor(true);
-    }
-
-    return WriteBMP(*TempData, FilePath);
+    FOmniCaptureQuantizeOptions Options;
+    Options.bDither = bDitherQuantization;
+    return WriteBMP(*QuantizeToColor(PixelData, Options), FilePath);
 }
 
 bool FOmniCaptureImageWriter::WriteJPEG(const TImagePixelData<FColor>& PixelData, const FString& FilePath) const
@@ -1019,14 +1167,18 @@ bool FOmniCaptureImageWriter::WriteJPEG(const TImagePixelData<FColor>& PixelData
     }
 
     IFileManager::Get().Delete(*FilePath, false, true, false);
-    return FFileHelper::SaveArrayToFile(CompressedData, *FilePath);
+    if (!FFileHelper::SaveArrayToFile(CompressedData, *FilePath))
+    {
+        return false;
+    }
+    AddBytesWritten(CompressedData.Num());
+    return true;
 }
 
 bool FOmniCaptureImageWriter::WriteJPEGFromLinear(const TImagePixelData<FFloat16Color>& PixelData, const FString& FilePath) const
 {
     const FIntPoint Size = PixelData.GetSize();
-    const int32 ExpectedCount = Size.X * Size.Y;
-    if (PixelData.Pixels.Num() != ExpectedCount)
+    if (PixelData.Pixels.Num() != static_cast<int64>(Size.X) * Size.Y)
     {
         return false;
     }
@@ -1036,29 +1188,15 @@ bool FOmniCaptureImageWriter::WriteJPEGFromLinear(const TImagePixelData<FFloat16
         return false;
     }
 
-    TArray<FColor> Converted;
-    Converted.SetNum(ExpectedCount);
-    for (int32 Index = 0; Index < ExpectedCount; ++Index)
-    {
-        const FFloat16Color& Pixel = PixelData.Pixels[Index];
-        const FLinearColor Linear(
-            Pixel.R.GetFloat(),
-            Pixel.G.GetFloat(),
-            Pixel.B.GetFloat(),
-            Pixel.A.GetFloat());
-        Converted[Index] = Linear.ToFColor(true);
-    }
-
-    TUniquePtr<TImagePixelData<FColor>> TempData = MakeUnique<TImagePixelData<FColor>>(Size);
-    TempData->Pixels = MoveTemp(Converted);
-    return WriteJPEG(*TempData, FilePath);
+    FOmniCaptureQuantizeOptions Options;
+    Options.bDither = bDitherQuantization;
+    return WriteJPEG(*QuantizeToColor(PixelData, Options), FilePath);
 }
 
 bool FOmniCaptureImageWriter::WriteJPEGFromLinearFloat32(const TImagePixelData<FLinearColor>& PixelData, const FString& FilePath) const
 {
     const FIntPoint Size = PixelData.GetSize();
-    const int32 ExpectedCount = Size.X * Size.Y;
-    if (PixelData.Pixels.Num() != ExpectedCount)
+    if (PixelData.Pixels.Num() != static_cast<int64>(Size.X) * Size.Y)
     {
         return false;
     }
@@ -1068,15 +1206,9 @@ bool FOmniCaptureImageWriter::WriteJPEGFromLinearFloat32(const TImagePixelData<F
         return false;
     }
 
-    TUniquePtr<TImagePixelData<FColor>> TempData = MakeUnique<TImagePixelData<FColor>>(Size);
-    TempData->Pixels.SetNum(ExpectedCount);
-
-    for (int32 Index = 0; Index < ExpectedCount; ++Index)
-    {
-        TempData->Pixels[Index] = PixelData.Pixels[Index].ToFColor(true);
-    }
-
-    return WriteJPEG(*TempData, FilePath);
+    FOmniCaptureQuantizeOptions Options;
+    Options.bDither = bDitherQuantization;
+    return WriteJPEG(*QuantizeToColor(PixelData, Options), FilePath);
 }
 
 bool FOmniCaptureImageWriter::WriteEXRFrame(const FString& FilePath, bool bIsLinear, TUniquePtr<FImagePixelData> PixelData, EOmniCapturePixelPrecision PixelPrecision, EOmniCapturePixelDataType PixelDataType, TMap<FName, FOmniCaptureLayerPayload>&& AuxiliaryLayers, const FString& LayerDirectory, const FString& LayerBaseName, const FString& LayerExtension) const
@@ -1223,54 +1355,26 @@ bool FOmniCaptureImageWriter::WriteCombinedEXR(const FString& FilePath, TArray<F
         switch (Layer.PixelDataType)
         {
         case EOmniCapturePixelDataType::LinearColorFloat32:
-        {
-            const TImagePixelData<FLinearColor>* Float32Data = static_cast<const TImagePixelData<FLinearColor>*>(PixelData);
             Prepared.PixelType = OPENEXR_IMF_NAMESPACE::PixelType::FLOAT;
-            Prepared.FloatBuffer.SetNum(PixelCount * 4);
-
-            for (int64 Index = 0; Index < PixelCount; ++Index)
-            {
-                const FLinearColor& Src = Float32Data->Pixels[Index];
-                const int64 Base = Index * 4;
-                Prepared.FloatBuffer[Base + 0] = Src.R;
-                Prepared.FloatBuffer[Base + 1] = Src.G;
-                Prepared.FloatBuffer[Base + 2] = Src.B;
-                Prepared.FloatBuffer[Base + 3] = Src.A;
-            }
+            Prepared.ComponentSize = sizeof(float);
+            Prepared.BasePointer = reinterpret_cast<const char*>(static_cast<const TImagePixelData<FLinearColor>*>(PixelData)->Pixels.GetData());
             break;
-        }
         case EOmniCapturePixelDataType::LinearColorFloat16:
-        {
-            const TImagePixelData<FFloat16Color>* Float16Data = static_cast<const TImagePixelData<FFloat16Color>*>(PixelData);
             Prepared.PixelType = OPENEXR_IMF_NAMESPACE::PixelType::HALF;
-            Prepared.HalfBuffer.SetNum(PixelCount * 4);
-
-            for (int64 Index = 0; Index < PixelCount; ++Index)
-            {
-                const FFloat16Color& Src = Float16Data->Pixels[Index];
-                const int64 Base = Index * 4;
-                Prepared.HalfBuffer[Base + 0] = IMATH_NAMESPACE::half(Src.R.GetFloat());
-                Prepared.HalfBuffer[Base + 1] = IMATH_NAMESPACE::half(Src.G.GetFloat());
-                Prepared.HalfBuffer[Base + 2] = IMATH_NAMESPACE::half(Src.B.GetFloat());
-                Prepared.HalfBuffer[Base + 3] = IMATH_NAMESPACE::half(Src.A.GetFloat());
-            }
+            Prepared.ComponentSize = sizeof(IMATH_NAMESPACE::half);
+            Prepared.BasePointer = reinterpret_cast<const char*>(static_cast<const TImagePixelData<FFloat16Color>*>(PixelData)->Pixels.GetData());
             break;
-        }
         case EOmniCapturePixelDataType::Color8:
         {
             const TImagePixelData<FColor>* ColorData = static_cast<const TImagePixelData<FColor>*>(PixelData);
-            Prepared.PixelType = OPENEXR_IMF_NAMESPACE::PixelType::FLOAT;
-            Prepared.FloatBuffer.SetNum(PixelCount * 4);
-
+            Prepared.WidenedPixels.SetNumUninitialized(PixelCount);
             for (int64 Index = 0; Index < PixelCount; ++Index)
             {
-                const FLinearColor Src = ColorData->Pixels[Index].ReinterpretAsLinear();
-                const int64 Base = Index * 4;
-                Prepared.FloatBuffer[Base + 0] = Src.R;
-                Prepared.FloatBuffer[Base + 1] = Src.G;
-                Prepared.FloatBuffer[Base + 2] = Src.B;
-                Prepared.FloatBuffer[Base + 3] = Src.A;
+                Prepared.WidenedPixels[Index] = ColorData->Pixels[Index].ReinterpretAsLinear();
             }
+            Prepared.PixelType = OPENEXR_IMF_NAMESPACE::PixelType::FLOAT;
+            Prepared.ComponentSize = sizeof(float);
+            Prepared.BasePointer = reinterpret_cast<const char*>(Prepared.WidenedPixels.GetData());
             break;
         }
         default:
@@ -1285,6 +1389,7 @@ bool FOmniCaptureImageWriter::WriteCombinedEXR(const FString& FilePath, TArray<F
 
     try
     {
+        const bool bTiled = TargetEXRLayout == EOmniCaptureEXRLayout::Tiled;
         if (bUseEXRMultiPart)
         {
             TArray<OPENEXR_IMF_NAMESPACE::Header> Headers;
@@ -1294,71 +1399,58 @@ bool FOmniCaptureImageWriter::WriteCombinedEXR(const FString& FilePath, TArray<F
 
             for (const FPreparedExrLayer& Prepared : PreparedLayers)
             {
-                OPENEXR_IMF_NAMESPACE::Header Header(ExpectedSize.X, ExpectedSize.Y);
-                Header.compression() = ToOpenExrCompression(TargetEXRCompression);
+                OPENEXR_IMF_NAMESPACE::Header& Header = Headers.Emplace_GetRef(ExpectedSize.X, ExpectedSize.Y);
+                ConfigureExrHeader(Header, TargetEXRCompression, TargetEXRLayout, EXRTileSize);
                 if (!Prepared.Name.empty())
                 {
                     Header.setName(Prepared.Name.c_str());
                 }
 
-                OPENEXR_IMF_NAMESPACE::FrameBuffer Buffer;
-                for (int32 ChannelIndex = 0; ChannelIndex < Prepared.ChannelCount; ++ChannelIndex)
-                {
-                    const TCHAR* ChannelSuffix = GetChannelSuffix(ChannelIndex);
-                    FTCHARToUTF8 ChannelUtf8(ChannelSuffix);
-                    Header.channels().insert(ChannelUtf8.Get(), OPENEXR_IMF_NAMESPACE::Channel(Prepared.PixelType));
-
-                    const char* BasePtr = Prepared.GetBasePointer();
-                    const int32 ComponentSize = Prepared.GetComponentSize();
-                    const size_t PixelStride = static_cast<size_t>(ComponentSize) * Prepared.ChannelCount;
-                    const size_t RowStride = PixelStride * ExpectedSize.X;
-                    const size_t ChannelOffset = static_cast<size_t>(ComponentSize) * ChannelIndex;
-
-                    Buffer.insert(ChannelUtf8.Get(), OPENEXR_IMF_NAMESPACE::Slice(Prepared.PixelType, const_cast<char*>(BasePtr) + ChannelOffset, PixelStride, RowStride));
-                }
-
-                Headers.Add(Header);
-                FrameBuffers.Add(Buffer);
+                Prepared.InsertChannels(Header, FrameBuffers.Emplace_GetRef(), std::string(), ExpectedSize.X);
             }
 
             OPENEXR_IMF_NAMESPACE::MultiPartOutputFile OutputFile(TCHAR_TO_UTF8(*FilePath), Headers.GetData(), Headers.Num());
             for (int32 PartIndex = 0; PartIndex < Headers.Num(); ++PartIndex)
             {
-                OPENEXR_IMF_NAMESPACE::OutputPart Part(OutputFile, PartIndex);
-                Part.setFrameBuffer(FrameBuffers[PartIndex]);
-                Part.writePixels(ExpectedSize.Y);
+                if (bTiled)
+                {
+                    OPENEXR_IMF_NAMESPACE::TiledOutputPart Part(OutputFile, PartIndex);
+                    Part.setFrameBuffer(FrameBuffers[PartIndex]);
+                    Part.writeTiles(0, Part.numXTiles() - 1, 0, Part.numYTiles() - 1);
+                }
+                else
+                {
+                    OPENEXR_IMF_NAMESPACE::OutputPart Part(OutputFile, PartIndex);
+                    Part.setFrameBuffer(FrameBuffers[PartIndex]);
+                    Part.writePixels(ExpectedSize.Y);
+                }
             }
         }
         else
         {
             OPENEXR_IMF_NAMESPACE::Header Header(ExpectedSize.X, ExpectedSize.Y);
-            Header.compression() = ToOpenExrCompression(TargetEXRCompression);
+            ConfigureExrHeader(Header, TargetEXRCompression, TargetEXRLayout, EXRTileSize);
             OPENEXR_IMF_NAMESPACE::FrameBuffer FrameBuffer;
 
             for (const FPreparedExrLayer& Prepared : PreparedLayers)
             {
                 const std::string Prefix = Prepared.Name.empty() ? std::string() : Prepared.Name + ".";
-                for (int32 ChannelIndex = 0; ChannelIndex < Prepared.ChannelCount; ++ChannelIndex)
-                {
-                    const TCHAR* ChannelSuffix = GetChannelSuffix(ChannelIndex);
-                    FTCHARToUTF8 ChannelUtf8(ChannelSuffix);
-                    const std::string ChannelName = Prefix + ChannelUtf8.Get();
-
-                    Header.channels().insert(ChannelName.c_str(), OPENEXR_IMF_NAMESPACE::Channel(Prepared.PixelType));
-
-                    const char* BasePtr = Prepared.GetBasePointer();
-                    const int32 ComponentSize = Prepared.GetComponentSize();
-                    const size_t PixelStride = static_cast<size_t>(ComponentSize) * Prepared.ChannelCount;
-                    const size_t RowStride = PixelStride * ExpectedSize.X;
-                    const size_t ChannelOffset = static_cast<size_t>(ComponentSize) * ChannelIndex;
-
-                    FrameBuffer.insert(ChannelName.c_str(), OPENEXR_IMF_NAMESPACE::Slice(Prepared.PixelType, const_cast<char*>(BasePtr) + ChannelOffset, PixelStride, RowStride));
-                }
+                Prepared.InsertChannels(Header, FrameBuffer, Prefix, ExpectedSize.X);
             }
 
-            OPENEXR_IMF_NAMESPACE::OutputFile OutputFile(TCHAR_TO_UTF8(*FilePath), Header);
-            OutputFile.setFrameBuffer(FrameBuffer);
-            OutputFile.writePixels(ExpectedSize.Y);
+            // A single writePixels/writeTiles call over the whole image lets OpenEXR compress blocks on its thread pool.
+            if (bTiled)
+            {
+                OPENEXR_IMF_NAMESPACE::TiledOutputFile OutputFile(TCHAR_TO_UTF8(*FilePath), Header);
+                OutputFile.setFrameBuffer(FrameBuffer);
+                OutputFile.writeTiles(0, OutputFile.numXTiles() - 1, 0, OutputFile.numYTiles() - 1);
+            }
+            else
+            {
+                OPENEXR_IMF_NAMESPACE::OutputFile OutputFile(TCHAR_TO_UTF8(*FilePath), Header);
+                OutputFile.setFrameBuffer(FrameBuffer);
+                OutputFile.writePixels(ExpectedSize.Y);
+            }
         }
 
         bSucceeded = true;
@@ -1374,6 +1466,9 @@ bool FOmniCaptureImageWriter::WriteCombinedEXR(const FString& FilePath, TArray<F
         {
             Layer.PixelData.Reset();
         }
+
+        // OpenEXR owns the file stream, so the finished size is read back once here on the writer thread.
+        AddBytesWritten(FMath::Max<int64>(0, IFileManager::Get().FileSize(*FilePath)));
     }
 
     return bSucceeded;
@@ -1507,7 +1602,12 @@ bool FOmniCaptureImageWriter::WriteEXRInternal(TUniquePtr<FImagePixelData> Pixel
     });
 
     WriteQueue.Enqueue(MoveTemp(Task));
-    return CompletionFuture.Get();
+    if (!CompletionFuture.Get())
+    {
+        return false;
+    }
+    AddBytesWritten(FMath::Max<int64>(0, IFileManager::Get().FileSize(*FilePath)));
+    return true;
 #endif // OMNICAPTURE_UE_VERSION_AT_LEAST(5, 5, 0)
 }
 
@@ -1521,25 +1621,39 @@ bool FOmniCaptureImageWriter::IsStopRequested() const
     return bStopRequested.Load();
 }
 
-void FOmniCaptureImageWriter::WaitForAvailableTaskSlot()
+bool FOmniCaptureImageWriter::ReserveTaskSlot(int64 IncomingBytes)
 {
-    if (MaxPendingTasks <= 0)
-    {
-        return;
-    }
-
+    bool bCountedStall = false;
     while (!IsStopRequested())
     {
         TFuture<bool> TaskToWait;
         {
             FScopeLock Lock(&PendingTasksCS);
-            if (PendingTasks.Num() < MaxPendingTasks)
+            // Reserved slots count as pending: their frames are charged but their tasks are not tracked yet.
+            const int32 TasksInFlight = PendingTasks.Num() + ReservedTaskSlots;
+            const bool bTaskLimitReached = MaxPendingTasks > 0 && TasksInFlight >= MaxPendingTasks;
+            // A frame larger than the whole budget is still let through once nothing else is in flight.
+            const bool bByteBudgetReached = MaxInFlightBytes > 0 && TasksInFlight > 0 && InFlightBytes.Load() + IncomingBytes > MaxInFlightBytes;
+            if (!bTaskLimitReached && !bByteBudgetReached)
             {
-                break;
+                // Charged under the lock that passed the check, so concurrent ring workers cannot all slip under the
+                // budget before any of them is counted.
+                ++ReservedTaskSlots;
+                ChargeInFlightBytes(IncomingBytes);
+                return true;
             }
 
-            TaskToWait = MoveTemp(PendingTasks[0]);
-            PendingTasks.RemoveAt(0, 1, EAllowShrinking::No);
+            if (bByteBudgetReached && !bTaskLimitReached && !bCountedStall)
+            {
+                BudgetStalls.IncrementExchange();
+                bCountedStall = true;
+            }
+
+            if (PendingTasks.Num() > 0)
+            {
+                TaskToWait = MoveTemp(PendingTasks[0]);
+                PendingTasks.RemoveAt(0, 1, EAllowShrinking::No);
+            }
         }
 
         if (TaskToWait.IsValid())
@@ -1550,13 +1664,41 @@ void FOmniCaptureImageWriter::WaitForAvailableTaskSlot()
                 UE_LOG(LogTemp, Warning, TEXT("OmniCapture image write task failed"));
             }
         }
+        else
+        {
+            // Only other workers' reservations are outstanding; their tasks are about to be tracked.
+            FPlatformProcess::SleepNoStats(0.001f);
+        }
     }
+    return false;
+}
+
+void FOmniCaptureImageWriter::CancelTaskSlot(int64 Bytes)
+{
+    FScopeLock Lock(&PendingTasksCS);
+    --ReservedTaskSlots;
+    ReleaseInFlightBytes(Bytes);
+}
+
+void FOmniCaptureImageWriter::ChargeInFlightBytes(int64 Bytes)
+{
+    const int64 InFlightAfterCharge = InFlightBytes.AddExchange(Bytes) + Bytes;
+    int64 Peak = PeakInFlightBytes.Load();
+    while (InFlightAfterCharge > Peak && !PeakInFlightBytes.CompareExchange(Peak, InFlightAfterCharge))
+    {
+    }
+}
+
+void FOmniCaptureImageWriter::ReleaseInFlightBytes(int64 Bytes)
+{
+    InFlightBytes.SubExchange(Bytes);
 }
 
 void FOmniCaptureImageWriter::TrackPendingTask(TFuture<bool>&& TaskFuture)
 {
     FScopeLock Lock(&PendingTasksCS);
     PendingTasks.Add(MoveTemp(TaskFuture));
+    --ReservedTaskSlots;
 }
 
 void FOmniCaptureImageWriter::PruneCompletedTasks()
@@ -0,0 +1,888 @@
+#include "OmniCaptureMP4Writer.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "NVENC/NVENCNalScanner.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureMP4, Log, All);
+
+namespace
+{
+    constexpr uint32 GMovieTimescale = 1000;
+    constexpr int64 GMaxMoovReserveBytes = 64 * 1024 * 1024;
+    constexpr int64 GRewriteChunkBytes = 8 * 1024 * 1024;
+    constexpr uint16 GLanguageUndetermined = 0x55C4;
+    const uint8 GCompressorName[] = "OmniCapture";
+
+    /** Appends big-endian fields and boxes to a byte buffer. Boxes are sized when they are closed. */
+    class FMP4BoxWriter
+    {
+    public:
+        explicit FMP4BoxWriter(TArray<uint8>& InBuffer)
+            : Buffer(InBuffer)
+        {
+        }
+
+        void U8(uint8 Value) { Buffer.Add(Value); }
+        void U16(uint16 Value) { U8(static_cast<uint8>(Value >> 8)); U8(static_cast<uint8>(Value)); }
+        void U24(uint32 Value) { U8(static_cast<uint8>(Value >> 16)); U16(static_cast<uint16>(Value)); }
+        void U32(uint32 Value) { U16(static_cast<uint16>(Value >> 16)); U16(static_cast<uint16>(Value)); }
+        void U64(uint64 Value) { U32(static_cast<uint32>(Value >> 32)); U32(static_cast<uint32>(Value)); }
+        void FourCC(const char* Code) { Buffer.Append(reinterpret_cast<const uint8*>(Code), 4); }
+        void Bytes(const uint8* Data, int32 Size) { Buffer.Append(Data, Size); }
+        void Zeros(int32 Count) { Buffer.AddZeroed(Count); }
+
+        int32 Begin(const char* Type)
+        {
+            const int32 Start = Buffer.Num();
+            U32(0);
+            FourCC(Type);
+            return Start;
+        }
+
+        int32 BeginFull(const char* Type, uint8 Version, uint32 Flags)
+        {
+            const int32 Start = Begin(Type);
+            U8(Version);
+            U24(Flags);
+            return Start;
+        }
+
+        void End(int32 Start)
+        {
+            const uint32 Size = static_cast<uint32>(Buffer.Num() - Start);
+            Buffer[Start + 0] = static_cast<uint8>(Size >> 24);
+            Buffer[Start + 1] = static_cast<uint8>(Size >> 16);
+            Buffer[Start + 2] = static_cast<uint8>(Size >> 8);
+            Buffer[Start + 3] = static_cast<uint8>(Size);
+        }
+
+    private:
+        TArray<uint8>& Buffer;
+    };
+
+    /** Exp-Golomb reader over an RBSP (emulation prevention bytes already removed). */
+    class FNalBitReader
+    {
+    public:
+        explicit FNalBitReader(const TArray<uint8>& InData)
+            : Data(InData)
+        {
+        }
+
+        uint32 ReadBits(int32 Count)
+        {
+            uint32 Value = 0;
+            for (int32 Index = 0; Index < Count; ++Index)
+            {
+                uint32 Bit = 0;
+                if (BitOffset < static_cast<int64>(Data.Num()) * 8)
+                {
+                    Bit = (Data[BitOffset >> 3] >> (7 - (BitOffset & 7))) & 1;
+                }
+                else
+                {
+                    bOverrun = true;
+                }
+                Value = (Value << 1) | Bit;
+                ++BitOffset;
+            }
+            return Value;
+        }
+
+        uint32 ReadUE()
+        {
+            int32 LeadingZeros = 0;
+            while (ReadBits(1) == 0 && !bOverrun && LeadingZeros < 31)
+            {
+                ++LeadingZeros;
+            }
+            return ((1u << LeadingZeros) - 1) + ReadBits(LeadingZeros);
+        }
+
+        void Skip(int64 Count) { BitOffset += Count; }
+        bool HasOverrun() const { return bOverrun || BitOffset > static_cast<int64>(Data.Num()) * 8; }
+
+    private:
+        const TArray<uint8>& Data;
+        int64 BitOffset = 0;
+        bool bOverrun = false;
+    };
+
+    TArray<uint8> ToRbsp(const uint8* Data, int64 Size)
+    {
+        TArray<uint8> Rbsp;
+        Rbsp.Reserve(static_cast<int32>(Size));
+        int32 Zeros = 0;
+        for (int64 Index = 0; Index < Size; ++Index)
+        {
+            if (Zeros >= 2 && Data[Index] == 0x03)
+            {
+                Zeros = 0;
+                continue;
+            }
+            Zeros = Data[Index] == 0 ? Zeros + 1 : 0;
+            Rbsp.Add(Data[Index]);
+        }
+        return Rbsp;
+    }
+
+    void WriteParameterSets(FMP4BoxWriter& Writer, const TArray<TArray<uint8>>& Sets)
+    {
+        for (const TArray<uint8>& Set : Sets)
+        {
+            Writer.U16(static_cast<uint16>(Set.Num()));
+            Writer.Bytes(Set.GetData(), Set.Num());
+        }
+    }
+
+    void WriteAvcC(FMP4BoxWriter& Writer, const TArray<TArray<uint8>>& SPS, const TArray<TArray<uint8>>& PPS)
+    {
+        const TArray<uint8>& First = SPS[0];
+        const uint8 ProfileIdc = First.Num() > 1 ? First[1] : 66;
+
+        const int32 Box = Writer.Begin("avcC");
+        Writer.U8(1);
+        Writer.U8(ProfileIdc);
+        Writer.U8(First.Num() > 2 ? First[2] : 0);
+        Writer.U8(First.Num() > 3 ? First[3] : 0);
+        Writer.U8(0xFF);
+        Writer.U8(static_cast<uint8>(0xE0 | SPS.Num()));
+        WriteParameterSets(Writer, SPS);
+        Writer.U8(static_cast<uint8>(PPS.Num()));
+        WriteParameterSets(Writer, PPS);
+
+        if (ProfileIdc == 100 || ProfileIdc == 110 || ProfileIdc == 122 || ProfileIdc == 144)
+        {
+            uint32 ChromaFormat = 1;
+            uint32 LumaDepthMinus8 = 0;
+            uint32 ChromaDepthMinus8 = 0;
+            if (ProfileIdc != 144)
+            {
+                const TArray<uint8> Rbsp = ToRbsp(First.GetData() + 1, First.Num() - 1);
+                FNalBitReader Reader(Rbsp);
+                Reader.Skip(24);
+                Reader.ReadUE();
+                ChromaFormat = Reader.ReadUE();
+                if (ChromaFormat == 3)
+                {
+                    Reader.Skip(1);
+                }
+                LumaDepthMinus8 = Reader.ReadUE();
+                ChromaDepthMinus8 = Reader.ReadUE();
+                if (Reader.HasOverrun())
+                {
+                    ChromaFormat = 1;
+                    LumaDepthMinus8 = 0;
+                    ChromaDepthMinus8 = 0;
+                }
+            }
+            Writer.U8(static_cast<uint8>(0xFC | (ChromaFormat & 0x3)));
+            Writer.U8(static_cast<uint8>(0xF8 | (LumaDepthMinus8 & 0x7)));
+            Writer.U8(static_cast<uint8>(0xF8 | (ChromaDepthMinus8 & 0x7)));
+            Writer.U8(0);
+        }
+        Writer.End(Box);
+    }
+
+    void WriteHvcC(FMP4BoxWriter& Writer, const TArray<TArray<uint8>>& VPS, const TArray<TArray<uint8>>& SPS, const TArray<TArray<uint8>>& PPS)
+    {
+        // SPS RBSP: vps id, max sub layers and nesting flag in one byte, then the 12-byte general profile_tier_level,
+        // which hvcC stores verbatim.
+        const TArray<uint8>& First = SPS[0];
+        const TArray<uint8> Rbsp = First.Num() > 2 ? ToRbsp(First.GetData() + 2, First.Num() - 2) : TArray<uint8>();
+
+        uint8 GeneralPTL[12] = { 0x01, 0x60, 0x00, 0x00, 0x00, 0x90, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5D };
+        uint32 MaxSubLayersMinus1 = 0;
+        uint32 TemporalIdNesting = 1;
+        uint32 ChromaFormat = 1;
+        uint32 LumaDepthMinus8 = 0;
+        uint32 ChromaDepthMinus8 = 0;
+
+        if (Rbsp.Num() >= 13)
+        {
+            FMemory::Memcpy(GeneralPTL, Rbsp.GetData() + 1, sizeof(GeneralPTL));
+
+            FNalBitReader Reader(Rbsp);
+            Reader.Skip(4);
+            MaxSubLayersMinus1 = Reader.ReadBits(3);
+            TemporalIdNesting = Reader.ReadBits(1);
+            Reader.Skip(96);
+
+            bool bSubLayerProfilePresent[8] = {};
+            bool bSubLayerLevelPresent[8] = {};
+            for (uint32 Index = 0; Index < MaxSubLayersMinus1; ++Index)
+            {
+                bSubLayerProfilePresent[Index] = Reader.ReadBits(1) != 0;
+                bSubLayerLevelPresent[Index] = Reader.ReadBits(1) != 0;
+            }
+            if (MaxSubLayersMinus1 > 0)
+            {
+                Reader.Skip(2 * (8 - MaxSubLayersMinus1));
+            }
+            for (uint32 Index = 0; Index < MaxSubLayersMinus1; ++Index)
+            {
+                Reader.Skip(bSubLayerProfilePresent[Index] ? 88 : 0);
+                Reader.Skip(bSubLayerLevelPresent[Index] ? 8 : 0);
+            }
+
+            Reader.ReadUE();
+            ChromaFormat = Reader.ReadUE();
+            if (ChromaFormat == 3)
+            {
+                Reader.Skip(1);
+            }
+            Reader.ReadUE();
+            Reader.ReadUE();
+            if (Reader.ReadBits(1))
+            {
+                Reader.ReadUE();
+                Reader.ReadUE();
+                Reader.ReadUE();
+                Reader.ReadUE();
+            }
+            LumaDepthMinus8 = Reader.ReadUE();
+            ChromaDepthMinus8 = Reader.ReadUE();
+            if (Reader.HasOverrun())
+            {
+                ChromaFormat = 1;
+                LumaDepthMinus8 = 0;
+                ChromaDepthMinus8 = 0;
+            }
+        }
+
+        const int32 Box = Writer.Begin("hvcC");
+        Writer.U8(1);
+        Writer.Bytes(GeneralPTL, sizeof(GeneralPTL));
+        Writer.U16(0xF000);
+        Writer.U8(0xFC);
+        Writer.U8(static_cast<uint8>(0xFC | (ChromaFormat & 0x3)));
+        Writer.U8(static_cast<uint8>(0xF8 | (LumaDepthMinus8 & 0x7)));
+        Writer.U8(static_cast<uint8>(0xF8 | (ChromaDepthMinus8 & 0x7)));
+        Writer.U16(0);
+        Writer.U8(static_cast<uint8>(((MaxSubLayersMinus1 + 1) << 3) | (TemporalIdNesting << 2) | 0x3));
+
+        const TArray<TArray<uint8>>* Arrays[] = { &VPS, &SPS, &PPS };
+        const uint8 ArrayTypes[] = { 32, 33, 34 };
+        Writer.U8(3);
+        for (int32 Index = 0; Index < 3; ++Index)
+        {
+            Writer.U8(static_cast<uint8>(0x80 | ArrayTypes[Index]));
+            Writer.U16(static_cast<uint16>(Arrays[Index]->Num()));
+            WriteParameterSets(Writer, *Arrays[Index]);
+        }
+        Writer.End(Box);
+    }
+
+    void WriteColr(FMP4BoxWriter& Writer, EOmniCaptureColorSpace ColorSpace)
+    {
+        uint16 Primaries = 1;
+        uint16 Transfer = 1;
+        uint16 Matrix = 1;
+        switch (ColorSpace)
+        {
+        case EOmniCaptureColorSpace::BT2020:
+            Primaries = 9;
+            Transfer = 14;
+            Matrix = 9;
+            break;
+        case EOmniCaptureColorSpace::HDR10:
+            Primaries = 9;
+            Transfer = 16;
+            Matrix = 9;
+            break;
+        default:
+            break;
+        }
+
+        const int32 Box = Writer.Begin("colr");
+        Writer.FourCC("nclx");
+        Writer.U16(Primaries);
+        Writer.U16(Transfer);
+        Writer.U16(Matrix);
+        Writer.U8(0);
+        Writer.End(Box);
+    }
+
+    /** Google Spherical Video V2 boxes, equivalent to the FFmpeg path's stereo_mode/projection metadata. */
+    void WriteSphericalBoxes(FMP4BoxWriter& Writer, const FOmniCaptureSettings& Settings)
+    {
+        uint8 StereoMode = 0;
+        if (Settings.IsStereo())
+        {
+            StereoMode = Settings.StereoLayout == EOmniCaptureStereoLayout::TopBottom ? 1 : 2;
+        }
+
+        const int32 St3d = Writer.BeginFull("st3d", 0, 0);
+        Writer.U8(StereoMode);
+        Writer.End(St3d);
+
+        const int32 Sv3d = Writer.Begin("sv3d");
+        const int32 Svhd = Writer.BeginFull("svhd", 0, 0);
+        Writer.Bytes(GCompressorName, sizeof(GCompressorName));
+        Writer.End(Svhd);
+
+        const int32 Proj = Writer.Begin("proj");
+        const int32 Prhd = Writer.BeginFull("prhd", 0, 0);
+        Writer.U32(0);
+        Writer.U32(0);
+        Writer.U32(0);
+        Writer.End(Prhd);
+
+        // Bounds are 0.32 fixed-point fractions cropped from each edge; VR180 keeps the middle half horizontally.
+        const uint32 HorizontalCrop = Settings.IsVR180() ? 0x40000000u : 0u;
+        const int32 Equi = Writer.BeginFull("equi", 0, 0);
+        Writer.U32(0);
+        Writer.U32(0);
+        Writer.U32(HorizontalCrop);
+        Writer.U32(HorizontalCrop);
+        Writer.End(Equi);
+        Writer.End(Proj);
+        Writer.End(Sv3d);
+    }
+
+    void WriteMatrix(FMP4BoxWriter& Writer)
+    {
+        const uint32 Matrix[9] = { 0x00010000, 0, 0, 0, 0x00010000, 0, 0, 0, 0x40000000 };
+        for (uint32 Value : Matrix)
+        {
+            Writer.U32(Value);
+        }
+    }
+
+    void WriteDurationFields(FMP4BoxWriter& Writer, bool bVersion1, uint64 Duration)
+    {
+        if (bVersion1)
+        {
+            Writer.U64(Duration);
+        }
+        else
+        {
+            Writer.U32(static_cast<uint32>(Duration));
+        }
+    }
+
+    void WriteTrackHeader(FMP4BoxWriter& Writer, uint32 TrackId, uint64 MovieDuration, const FIntPoint& Size, bool bAudio)
+    {
+        const bool bVersion1 = MovieDuration > MAX_uint32;
+        const int32 Box = Writer.BeginFull("tkhd", bVersion1 ? 1 : 0, 0x3);
+        WriteDurationFields(Writer, bVersion1, 0);
+        WriteDurationFields(Writer, bVersion1, 0);
+        Writer.U32(TrackId);
+        Writer.U32(0);
+        WriteDurationFields(Writer, bVersion1, MovieDuration);
+        Writer.Zeros(8);
+        Writer.U16(0);
+        Writer.U16(0);
+        Writer.U16(bAudio ? 0x0100 : 0);
+        Writer.U16(0);
+        WriteMatrix(Writer);
+        Writer.U32(static_cast<uint32>(Size.X) << 16);
+        Writer.U32(static_cast<uint32>(Size.Y) << 16);
+        Writer.End(Box);
+    }
+
+    void WriteMediaHeader(FMP4BoxWriter& Writer, uint32 Timescale, uint64 Duration)
+    {
+        const bool bVersion1 = Duration > MAX_uint32;
+        const int32 Box = Writer.BeginFull("mdhd", bVersion1 ? 1 : 0, 0);
+        WriteDurationFields(Writer, bVersion1, 0);
+        WriteDurationFields(Writer, bVersion1, 0);
+        Writer.U32(Timescale);
+        WriteDurationFields(Writer, bVersion1, Duration);
+        Writer.U16(GLanguageUndetermined);
+        Writer.U16(0);
+        Writer.End(Box);
+    }
+
+    void WriteHandler(FMP4BoxWriter& Writer, const char* HandlerType, const char* Name)
+    {
+        const int32 Box = Writer.BeginFull("hdlr", 0, 0);
+        Writer.U32(0);
+        Writer.FourCC(HandlerType);
+        Writer.Zeros(12);
+        Writer.Bytes(reinterpret_cast<const uint8*>(Name), FCStringAnsi::Strlen(Name) + 1);
+        Writer.End(Box);
+    }
+
+    void WriteDataInformation(FMP4BoxWriter& Writer)
+    {
+        const int32 Dinf = Writer.Begin("dinf");
+        const int32 Dref = Writer.BeginFull("dref", 0, 0);
+        Writer.U32(1);
+        const int32 Url = Writer.BeginFull("url ", 0, 0x1);
+        Writer.End(Url);
+        Writer.End(Dref);
+        Writer.End(Dinf);
+    }
+}
+
+FOmniCaptureMP4Writer::~FOmniCaptureMP4Writer()
+{
+    if (IsOpen())
+    {
+        Finalize();
+    }
+}
+
+bool FOmniCaptureMP4Writer::Open(const FString& InFilePath, const FOmniCaptureSettings& InSettings, const FIntPoint& InVideoSize, double InFrameRate, int64 InMoovReserveBytes)
+{
+    FScopeLock Lock(&WriterCS);
+
+    FilePath = InFilePath;
+    Settings = InSettings;
+    VideoSize = InVideoSize;
+    const double FrameRate = InFrameRate > 0.0 ? InFrameRate : 30.0;
+    VideoSampleDelta = static_cast<uint32>(FMath::Max(1, FMath::RoundToInt(VideoTimescale / FrameRate)));
+
+    ParameterSets.Reset();
+    Video = FTrack();
+    Audio = FTrack();
+    AudioSampleRate = 0;
+    AudioChannels = 0;
+
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(FilePath), true);
+    Handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*FilePath, false, false));
+    if (!Handle)
+    {
+        UE_LOG(LogOmniCaptureMP4, Error, TEXT("Unable to open MP4 output %s"), *FilePath);
+        return false;
+    }
+
+    FtypBox.Reset();
+    FMP4BoxWriter Ftyp(FtypBox);
+    const int32 FtypStart = Ftyp.Begin("ftyp");
+    Ftyp.FourCC("isom");
+    Ftyp.U32(0x200);
+    Ftyp.FourCC("isom");
+    Ftyp.FourCC("iso2");
+    Ftyp.FourCC(Settings.Codec == EOmniCaptureCodec::HEVC ? "hvc1" : "avc1");
+    Ftyp.FourCC("mp41");
+    Ftyp.End(FtypStart);
+
+    // A free box holds the place of the moov until Finalize, followed by an mdat with a 64-bit size patched at the end.
+    ReserveBytes = FMath::Clamp<int64>(InMoovReserveBytes, 8, GMaxMoovReserveBytes);
+    TArray<uint8> Header = FtypBox;
+    FMP4BoxWriter HeaderWriter(Header);
+    HeaderWriter.U32(static_cast<uint32>(ReserveBytes));
+    HeaderWriter.FourCC("free");
+    HeaderWriter.Zeros(static_cast<int32>(ReserveBytes - 8));
+    HeaderWriter.U32(1);
+    HeaderWriter.FourCC("mdat");
+    HeaderWriter.U64(0);
+
+    ReserveOffset = FtypBox.Num();
+    MdatOffset = ReserveOffset + ReserveBytes;
+    WriteOffset = 0;
+    if (!WriteToMdat(Header.GetData(), Header.Num()))
+    {
+        Handle.Reset();
+        return false;
+    }
+    return true;
+}
+
+void FOmniCaptureMP4Writer::SetCodecConfig(TConstArrayView<uint8> AnnexBParameterSets)
+{
+    FScopeLock Lock(&WriterCS);
+    OmniNVENC::FNVENCNalScanner::ForEachNalUnit(AnnexBParameterSets, GetNalCodec(), [this](const OmniNVENC::FNVENCNalUnit& Unit)
+    {
+        ParameterSets.Add(Unit);
+    });
+}
+
+bool FOmniCaptureMP4Writer::WriteVideoSample(TConstArrayView<uint8> AnnexBAccessUnit, bool bKeyFrame)
+{
+    FScopeLock Lock(&WriterCS);
+    if (!Handle)
+    {
+        return false;
+    }
+
+    bool bContainsKeySlice = false;
+    SampleScratch.Reset();
+    OmniNVENC::FNVENCNalScanner::ForEachNalUnit(AnnexBAccessUnit, GetNalCodec(), [this, &bContainsKeySlice](const OmniNVENC::FNVENCNalUnit& Unit)
+    {
+        // Parameter sets live in avcC/hvcC, which is what hvc1/avc1 sample entries require.
+        if (ParameterSets.Add(Unit) || Unit.Kind == OmniNVENC::ENVENCNalKind::AccessUnitDelimiter)
+        {
+            return;
+        }
+        bContainsKeySlice |= Unit.Kind == OmniNVENC::ENVENCNalKind::KeySlice;
+
+        FMP4BoxWriter(SampleScratch).U32(static_cast<uint32>(Unit.Payload.Num()));
+        SampleScratch.Append(Unit.Payload.GetData(), Unit.Payload.Num());
+    });
+
+    if (SampleScratch.Num() == 0)
+    {
+        return true;
+    }
+
+    const int64 SampleOffset = WriteOffset;
+    if (!WriteToMdat(SampleScratch.GetData(), SampleScratch.Num()))
+    {
+        return false;
+    }
+
+    Video.SampleSizes.Add(static_cast<uint32>(SampleScratch.Num()));
+    Video.ChunkOffsets.Add(SampleOffset);
+    Video.ChunkSampleCounts.Add(1);
+    ++Video.SampleCount;
+    if (bKeyFrame || bContainsKeySlice)
+    {
+        Video.SyncSamples.Add(static_cast<uint32>(Video.SampleCount));
+    }
+    return true;
+}
+
+bool FOmniCaptureMP4Writer::WriteAudio(const FOmniAudioPacket& Packet)
+{
+    FScopeLock Lock(&WriterCS);
+    if (!Handle || Packet.SampleRate <= 0 || Packet.NumChannels <= 0)
+    {
+        return false;
+    }
+
+    if (AudioSampleRate == 0)
+    {
+        AudioSampleRate = Packet.SampleRate;
+        AudioChannels = Packet.NumChannels;
+    }
+    else if (Packet.SampleRate != AudioSampleRate || Packet.NumChannels != AudioChannels)
+    {
+        UE_LOG(LogOmniCaptureMP4, Warning, TEXT("Dropping audio packet: %d Hz x%d does not match the %d Hz x%d track."), Packet.SampleRate, Packet.NumChannels, AudioSampleRate, AudioChannels);
+        return false;
+    }
+
+    const int32 FrameCount = Packet.PCM16.Num() / AudioChannels;
+    if (FrameCount == 0)
+    {
+        return true;
+    }
+
+    // PCM16 is little-endian on every supported platform, which is exactly the 'sowt' layout.
+    const int64 ChunkOffset = WriteOffset;
+    if (!WriteToMdat(reinterpret_cast<const uint8*>(Packet.PCM16.GetData()), static_cast<int64>(FrameCount) * AudioChannels * sizeof(int16)))
+    {
+        return false;
+    }
+
+    Audio.ChunkOffsets.Add(ChunkOffset);
+    Audio.ChunkSampleCounts.Add(static_cast<uint32>(FrameCount));
+    Audio.SampleCount += FrameCount;
+    return true;
+}
+
+bool FOmniCaptureMP4Writer::Finalize()
+{
+    FScopeLock Lock(&WriterCS);
+    if (!Handle)
+    {
+        return false;
+    }
+
+    if (Video.SampleCount == 0 || !ParameterSets.IsComplete(GetNalCodec()))
+    {
+        UE_LOG(LogOmniCaptureMP4, Warning, TEXT("MP4 %s has no video samples or parameter sets; it will not be playable."), *FilePath);
+        Handle.Reset();
+        return false;
+    }
+
+    TArray<uint8> MdatSize;
+    FMP4BoxWriter(MdatSize).U64(static_cast<uint64>(WriteOffset - MdatOffset));
+    bool bSuccess = Handle->Seek(MdatOffset + 8) && Handle->Write(MdatSize.GetData(), MdatSize.Num());
+
+    TArray<uint8> Moov = BuildMoov(0);
+    const int64 Remaining = ReserveBytes - Moov.Num();
+    if (Remaining == 0 || Remaining >= 8)
+    {
+        if (Remaining > 0)
+        {
+            FMP4BoxWriter Free(Moov);
+            Free.U32(static_cast<uint32>(Remaining));
+            Free.FourCC("free");
+        }
+        bSuccess &= Handle->Seek(ReserveOffset) && Handle->Write(Moov.GetData(), Moov.Num());
+        bSuccess &= Handle->Flush();
+        Handle.Reset();
+    }
+    else
+    {
+        Handle.Reset();
+        UE_LOG(LogOmniCaptureMP4, Log, TEXT("MP4 index (%d bytes) outgrew its %lld byte reservation; rewriting %s with the index in front."), Moov.Num(), ReserveBytes, *FilePath);
+        bSuccess &= RewriteWithMoovAtFront(FtypBox, MdatOffset, WriteOffset);
+    }
+
+    UE_LOG(LogOmniCaptureMP4, Log, TEXT("MP4 finalized: %s (%lld video samples, %lld audio frames)"), *FilePath, Video.SampleCount, Audio.SampleCount);
+    return bSuccess;
+}
+
+bool FOmniCaptureMP4Writer::IsOpen() const
+{
+    FScopeLock Lock(&WriterCS);
+    return Handle.IsValid();
+}
+
+int32 FOmniCaptureMP4Writer::GetVideoSampleCount() const
+{
+    FScopeLock Lock(&WriterCS);
+    return static_cast<int32>(Video.SampleCount);
+}
+
+OmniNVENC::ENVENCCodec FOmniCaptureMP4Writer::GetNalCodec() const
+{
+    return Settings.Codec == EOmniCaptureCodec::HEVC ? OmniNVENC::ENVENCCodec::HEVC : OmniNVENC::ENVENCCodec::H264;
+}
+
+bool FOmniCaptureMP4Writer::WriteToMdat(const uint8* Data, int64 Size)
+{
+    if (!Handle->Write(Data, Size))
+    {
+        UE_LOG(LogOmniCaptureMP4, Error, TEXT("Failed to write %lld bytes to %s"), Size, *FilePath);
+        return false;
+    }
+    WriteOffset += Size;
+    BytesWritten.Store(WriteOffset);
+    return true;
+}
+
+TArray<uint8> FOmniCaptureMP4Writer::BuildMoov(int64 OffsetShift) const
+{
+    TArray<uint8> Buffer;
+    FMP4BoxWriter Writer(Buffer);
+
+    const bool bHEVC = Settings.Codec == EOmniCaptureCodec::HEVC;
+    const bool bHasAudio = Audio.SampleCount > 0;
+    const uint64 VideoDuration = static_cast<uint64>(Video.SampleCount) * VideoSampleDelta;
+    const uint64 VideoMovieDuration = VideoDuration * GMovieTimescale / VideoTimescale;
+    const uint64 AudioMovieDuration = bHasAudio ? static_cast<uint64>(Audio.SampleCount) * GMovieTimescale / AudioSampleRate : 0;
+
+    auto WriteChunkTables = [&Writer, OffsetShift](const FTrack& Track)
+    {
+        TArray<TPair<uint32, uint32>> Runs;
+        for (int32 Index = 0; Index < Track.ChunkSampleCounts.Num(); ++Index)
+        {
+            if (Runs.Num() == 0 || Runs.Last().Value != Track.ChunkSampleCounts[Index])
+            {
+                Runs.Emplace(static_cast<uint32>(Index + 1), Track.ChunkSampleCounts[Index]);
+            }
+        }
+        const int32 Stsc = Writer.BeginFull("stsc", 0, 0);
+        Writer.U32(static_cast<uint32>(Runs.Num()));
+        for (const TPair<uint32, uint32>& Run : Runs)
+        {
+            Writer.U32(Run.Key);
+            Writer.U32(Run.Value);
+            Writer.U32(1);
+        }
+        Writer.End(Stsc);
+
+        const bool bLargeOffsets = Track.ChunkOffsets.Num() > 0 && Track.ChunkOffsets.Last() + OffsetShift > MAX_uint32;
+        const int32 Stco = Writer.BeginFull(bLargeOffsets ? "co64" : "stco", 0, 0);
+        Writer.U32(static_cast<uint32>(Track.ChunkOffsets.Num()));
+        for (int64 Offset : Track.ChunkOffsets)
+        {
+            if (bLargeOffsets)
+            {
+                Writer.U64(static_cast<uint64>(Offset + OffsetShift));
+            }
+            else
+            {
+                Writer.U32(static_cast<uint32>(Offset + OffsetShift));
+            }
+        }
+        Writer.End(Stco);
+    };
+
+    const int32 Moov = Writer.Begin("moov");
+    {
+        const uint64 MovieDuration = FMath::Max(VideoMovieDuration, AudioMovieDuration);
+        const bool bVersion1 = MovieDuration > MAX_uint32;
+        const int32 Mvhd = Writer.BeginFull("mvhd", bVersion1 ? 1 : 0, 0);
+        WriteDurationFields(Writer, bVersion1, 0);
+        WriteDurationFields(Writer, bVersion1, 0);
+        Writer.U32(GMovieTimescale);
+        WriteDurationFields(Writer, bVersion1, MovieDuration);
+        Writer.U32(0x00010000);
+        Writer.U16(0x0100);
+        Writer.Zeros(10);
+        WriteMatrix(Writer);
+        Writer.Zeros(24);
+        Writer.U32(bHasAudio ? 3 : 2);
+        Writer.End(Mvhd);
+    }
+
+    {
+        const int32 Trak = Writer.Begin("trak");
+        WriteTrackHeader(Writer, 1, VideoMovieDuration, VideoSize, false);
+        const int32 Mdia = Writer.Begin("mdia");
+        WriteMediaHeader(Writer, VideoTimescale, VideoDuration);
+        WriteHandler(Writer, "vide", "OmniCapture Video");
+        const int32 Minf = Writer.Begin("minf");
+        const int32 Vmhd = Writer.BeginFull("vmhd", 0, 0x1);
+        Writer.Zeros(8);
+        Writer.End(Vmhd);
+        WriteDataInformation(Writer);
+
+        const int32 Stbl = Writer.Begin("stbl");
+        const int32 Stsd = Writer.BeginFull("stsd", 0, 0);
+        Writer.U32(1);
+        const int32 Entry = Writer.Begin(bHEVC ? "hvc1" : "avc1");
+        Writer.Zeros(6);
+        Writer.U16(1);
+        Writer.Zeros(16);
+        Writer.U16(static_cast<uint16>(VideoSize.X));
+        Writer.U16(static_cast<uint16>(VideoSize.Y));
+        Writer.U32(0x00480000);
+        Writer.U32(0x00480000);
+        Writer.U32(0);
+        Writer.U16(1);
+        Writer.U8(static_cast<uint8>(sizeof(GCompressorName) - 1));
+        Writer.Bytes(GCompressorName, sizeof(GCompressorName) - 1);
+        Writer.Zeros(32 - sizeof(GCompressorName));
+        Writer.U16(0x0018);
+        Writer.U16(0xFFFF);
+        if (bHEVC)
+        {
+            WriteHvcC(Writer, ParameterSets.VPS, ParameterSets.SPS, ParameterSets.PPS);
+        }
+        else
+        {
+            WriteAvcC(Writer, ParameterSets.SPS, ParameterSets.PPS);
+        }
+        WriteColr(Writer, Settings.ColorSpace);
+        if (Settings.bInjectFFmpegMetadata && Settings.SupportsSphericalMetadata())
+        {
+            WriteSphericalBoxes(Writer, Settings);
+        }
+        Writer.End(Entry);
+        Writer.End(Stsd);
+
+        const int32 Stts = Writer.BeginFull("stts", 0, 0);
+        Writer.U32(1);
+        Writer.U32(static_cast<uint32>(Video.SampleCount));
+        Writer.U32(VideoSampleDelta);
+        Writer.End(Stts);
+
+        const int32 Stss = Writer.BeginFull("stss", 0, 0);
+        Writer.U32(static_cast<uint32>(Video.SyncSamples.Num()));
+        for (uint32 SampleNumber : Video.SyncSamples)
+        {
+            Writer.U32(SampleNumber);
+        }
+        Writer.End(Stss);
+
+        const int32 Stsz = Writer.BeginFull("stsz", 0, 0);
+        Writer.U32(0);
+        Writer.U32(static_cast<uint32>(Video.SampleSizes.Num()));
+        for (uint32 SampleSize : Video.SampleSizes)
+        {
+            Writer.U32(SampleSize);
+        }
+        Writer.End(Stsz);
+
+        WriteChunkTables(Video);
+        Writer.End(Stbl);
+        Writer.End(Minf);
+        Writer.End(Mdia);
+        Writer.End(Trak);
+    }
+
+    if (bHasAudio)
+    {
+        const int32 Trak = Writer.Begin("trak");
+        WriteTrackHeader(Writer, 2, AudioMovieDuration, FIntPoint::ZeroValue, true);
+        const int32 Mdia = Writer.Begin("mdia");
+        WriteMediaHeader(Writer, static_cast<uint32>(AudioSampleRate), static_cast<uint64>(Audio.SampleCount));
+        WriteHandler(Writer, "soun", "OmniCapture Audio");
+        const int32 Minf = Writer.Begin("minf");
+        const int32 Smhd = Writer.BeginFull("smhd", 0, 0);
+        Writer.Zeros(4);
+        Writer.End(Smhd);
+        WriteDataInformation(Writer);
+
+        const int32 Stbl = Writer.Begin("stbl");
+        const int32 Stsd = Writer.BeginFull("stsd", 0, 0);
+        Writer.U32(1);
+        const int32 Entry = Writer.Begin("sowt");
+        Writer.Zeros(6);
+        Writer.U16(1);
+        Writer.Zeros(8);
+        Writer.U16(static_cast<uint16>(AudioChannels));
+        Writer.U16(16);
+        Writer.U32(0);
+        Writer.U32(static_cast<uint32>(FMath::Min(AudioSampleRate, 0xFFFF)) << 16);
+        Writer.End(Entry);
+        Writer.End(Stsd);
+
+        // One sample per PCM frame, so every field below counts frames.
+        const int32 Stts = Writer.BeginFull("stts", 0, 0);
+        Writer.U32(1);
+        Writer.U32(static_cast<uint32>(Audio.SampleCount));
+        Writer.U32(1);
+        Writer.End(Stts);
+
+        const int32 Stsz = Writer.BeginFull("stsz", 0, 0);
+        Writer.U32(static_cast<uint32>(AudioChannels * sizeof(int16)));
+        Writer.U32(static_cast<uint32>(Audio.SampleCount));
+        Writer.End(Stsz);
+
+        WriteChunkTables(Audio);
+        Writer.End(Stbl);
+        Writer.End(Minf);
+        Writer.End(Mdia);
+        Writer.End(Trak);
+    }
+
+    Writer.End(Moov);
+    return Buffer;
+}
+
+bool FOmniCaptureMP4Writer::RewriteWithMoovAtFront(const TArray<uint8>& Ftyp, int64 InMdatOffset, int64 MdatEnd)
+{
+    // Dropping the free box moves mdat by however much the moov outgrew it. Switching stco to co64 can grow the moov
+    // again, so settle the size before writing anything.
+    TArray<uint8> Moov = BuildMoov(0);
+    int64 Shift = 0;
+    do
+    {
+        Shift = Moov.Num() - ReserveBytes;
+        Moov = BuildMoov(Shift);
+    }
+    while (Moov.Num() - ReserveBytes != Shift);
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    const FString TempPath = FilePath + TEXT(".tmp");
+    bool bSuccess = false;
+    {
+        TUniquePtr<IFileHandle> Source(PlatformFile.OpenRead(*FilePath));
+        TUniquePtr<IFileHandle> Target(PlatformFile.OpenWrite(*TempPath, false, false));
+        if (Source && Target && Source->Seek(InMdatOffset))
+        {
+            bSuccess = Target->Write(Ftyp.GetData(), Ftyp.Num()) && Target->Write(Moov.GetData(), Moov.Num());
+
+            TArray<uint8> Chunk;
+            Chunk.SetNumUninitialized(static_cast<int32>(FMath::Min(GRewriteChunkBytes, FMath::Max<int64>(MdatEnd - InMdatOffset, 1))));
+            int64 Remaining = MdatEnd - InMdatOffset;
+            while (bSuccess && Remaining > 0)
+            {
+                const int64 Bytes = FMath::Min<int64>(Remaining, Chunk.Num());
+                bSuccess = Source->Read(Chunk.GetData(), Bytes) && Target->Write(Chunk.GetData(), Bytes);
+                Remaining -= Bytes;
+            }
+            bSuccess = bSuccess && Target->Flush();
+        }
+    }
+
+    if (!bSuccess)
+    {
+        UE_LOG(LogOmniCaptureMP4, Error, TEXT("Failed to rewrite %s with the index in front."), *FilePath);
+        PlatformFile.DeleteFile(*TempPath);
+        return false;
+    }
+
+    return PlatformFile.DeleteFile(*FilePath) && PlatformFile.MoveFile(*FilePath, *TempPath);
+}
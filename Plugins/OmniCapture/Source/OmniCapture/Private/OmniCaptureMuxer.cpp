@@ -230,6 +230,10 @@ bool FOmniCaptureMuxer::WriteManifest(const FOmniCaptureSettings& Settings, cons
     {
         OutputFormatString = TEXT("ImageSequence");
     }
+    else if (Settings.OutputFormat == EOmniOutputFormat::FFmpegPipe)
+    {
+        OutputFormatString = TEXT("FFmpegPipe");
+    }
     Root->SetStringField(TEXT("outputFormat"), OutputFormatString);
     Root->SetStringField(TEXT("mode"), Settings.Mode == EOmniCaptureMode::Stereo ? TEXT("Stereo") : TEXT("Mono"));
     Root->SetStringField(TEXT("coverage"), ToCoverageString(Settings.Coverage));
@@ -466,31 +470,8 @@ bool FOmniCaptureMuxer::WriteSpatialMetadata(const FOmniCaptureSettings& Setting
     return bSuccess;
 }
 
-bool FOmniCaptureMuxer::TryInvokeFFmpeg(const FOmniCaptureSettings& Settings, const TArray<FOmniCaptureFrameMetadata>& Frames, const FString& AudioPath, const FString& VideoPath) const
+FString FOmniCaptureMuxer::BuildVideoEncodeArguments(const FOmniCaptureSettings& Settings, bool bCopyVideo)
 {
-    if (Frames.Num() == 0)
-    {
-        UE_LOG(LogTemp, Warning, TEXT("No frames captured; skipping FFmpeg mux."));
-        return false;
-    }
-
-    const bool bImageSequenceOutput = IsImageSequenceFormat(Settings.OutputFormat);
-
-    const FString Binary = CachedFFmpegPath.IsEmpty() ? BuildFFmpegBinaryPath() : CachedFFmpegPath;
-    if (Binary.IsEmpty())
-    {
-        UE_LOG(LogTemp, Warning, TEXT("FFmpeg not configured. Skipping automatic muxing."));
-        return bImageSequenceOutput;
-    }
-    if (!Binary.Equals(TEXT("ffmpeg"), ESearchCase::IgnoreCase) && !FPaths::FileExists(Binary))
-    {
-        UE_LOG(LogTemp, Warning, TEXT("FFmpeg binary %s was not found on disk."), *Binary);
-        return bImageSequenceOutput;
-    }
-
-    const double FrameRate = CalculateFrameRate(Frames);
-    const double EffectiveFrameRate = FrameRate <= 0.0 ? 30.0 : FrameRate;
-
     FString ColorSpaceArg = TEXT("bt709");
     FString ColorPrimariesArg = TEXT("bt709");
     FString ColorTransferArg = TEXT("bt709");
@@ -514,43 +495,7 @@ bool FOmniCaptureMuxer::TryInvokeFFmpeg(const FOmniCaptureSettings& Settings, co
         break;
     }
 
-    FString OutputFile = OutputDirectory / (BaseFileName + TEXT(".mp4"));
     FString CommandLine;
-
-    if (bImageSequenceOutput)
-    {
-        const FString Extension = Settings.GetImageFileExtension();
-        FString Pattern = OutputDirectory / FString::Printf(TEXT("%s_%%06d%s"), *BaseFileName, *Extension);
-        CommandLine = FString::Printf(TEXT("-y -framerate %.3f -i \"%s\""), EffectiveFrameRate, *Pattern);
-    }
-    else if (Settings.OutputFormat == EOmniOutputFormat::NVENCHardware)
-    {
-        const FString BitstreamPath = !VideoPath.IsEmpty() ? VideoPath : (OutputDirectory / (BaseFileName + TEXT(".h264")));
-        if (!FPaths::FileExists(BitstreamPath))
-        {
-            UE_LOG(LogTemp, Warning, TEXT("NVENC bitstream %s not found; skipping FFmpeg mux."), *BitstreamPath);
-            return false;
-        }
-        CommandLine = FString::Printf(TEXT("-y -framerate %.3f -i \"%s\""), EffectiveFrameRate, *BitstreamPath);
-    }
-    else
-    {
-        return false;
-    }
-
-    if (!AudioPath.IsEmpty() && FPaths::FileExists(AudioPath))
-    {
-        CommandLine += FString::Printf(TEXT(" -i \"%s\" -c:a aac -b:a 192k"), *AudioPath);
-    }
-    else
-    {
-        CommandLine += TEXT(" -an");
-        if (!AudioPath.IsEmpty())
-        {
-            UE_LOG(LogTemp, Warning, TEXT("Audio file %s was not found; muxed output will be silent."), *AudioPath);
-        }
-    }
-
     const FString StereoModeTag = Settings.GetStereoModeMetadataTag();
     const TCHAR* StereoMode = *StereoModeTag;
     const bool bHalfSphere = Settings.IsVR180();
@@ -561,12 +506,12 @@ bool FOmniCaptureMuxer::TryInvokeFFmpeg(const FOmniCaptureSettings& Settings, co
     const int32 CroppedTop = 0;
     const TCHAR* ViewTag = bHalfSphere ? TEXT("VR180") : TEXT("VR360");
 
-    if (IsImageSequenceFormat(Settings.OutputFormat))
+    if (!bCopyVideo)
     {
         const TCHAR* CodecName = Settings.Codec == EOmniCaptureCodec::HEVC ? TEXT("libx265") : TEXT("libx264");
         CommandLine += FString::Printf(TEXT(" -c:v %s -pix_fmt %s"), CodecName, *PixelFormatArg);
     }
-    else if (Settings.OutputFormat == EOmniOutputFormat::NVENCHardware)
+    else
     {
         CommandLine += TEXT(" -c:v copy");
     }
@@ -609,6 +554,100 @@ bool FOmniCaptureMuxer::TryInvokeFFmpeg(const FOmniCaptureSettings& Settings, co
         CommandLine += TEXT(" -movflags +faststart");
     }
 
+    return CommandLine;
+}
+
+bool FOmniCaptureMuxer::TryInvokeFFmpeg(const FOmniCaptureSettings& Settings, const TArray<FOmniCaptureFrameMetadata>& Frames, const FString& AudioPath, const FString& VideoPath) const
+{
+    if (Frames.Num() == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("No frames captured; skipping FFmpeg mux."));
+        return false;
+    }
+
+    const bool bImageSequenceOutput = IsImageSequenceFormat(Settings.OutputFormat);
+    if (bImageSequenceOutput && Settings.ImageFormat == EOmniCaptureImageFormat::RawDump)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Raw dump captured; FFmpeg muxing runs after TranscodeRawDump."));
+        return true;
+    }
+
+    if (Settings.OutputFormat == EOmniOutputFormat::NVENCHardware && FPaths::GetExtension(VideoPath).Equals(TEXT("mp4"), ESearchCase::IgnoreCase))
+    {
+        // The encoder muxed video, audio and spherical metadata itself.
+        const bool bVideoExists = FPaths::FileExists(VideoPath);
+        UE_LOG(LogTemp, Log, TEXT("NVENC output was muxed natively: %s"), *VideoPath);
+        return bVideoExists;
+    }
+
+    const FString Binary = CachedFFmpegPath.IsEmpty() ? BuildFFmpegBinaryPath() : CachedFFmpegPath;
+    if (Binary.IsEmpty())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FFmpeg not configured. Skipping automatic muxing."));
+        return bImageSequenceOutput;
+    }
+    if (!Binary.Equals(TEXT("ffmpeg"), ESearchCase::IgnoreCase) && !FPaths::FileExists(Binary))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FFmpeg binary %s was not found on disk."), *Binary);
+        return bImageSequenceOutput;
+    }
+
+    const double FrameRate = CalculateFrameRate(Frames);
+    const double EffectiveFrameRate = FrameRate <= 0.0 ? 30.0 : FrameRate;
+
+    FString OutputFile = OutputDirectory / (BaseFileName + TEXT(".mp4"));
+    FString CommandLine;
+
+    if (bImageSequenceOutput)
+    {
+        const FString Extension = Settings.GetImageFileExtension();
+        FString Pattern = OutputDirectory / FString::Printf(TEXT("%s_%%06d%s"), *BaseFileName, *Extension);
+        CommandLine = FString::Printf(TEXT("-y -framerate %.3f -i \"%s\""), EffectiveFrameRate, *Pattern);
+    }
+    else if (Settings.OutputFormat == EOmniOutputFormat::NVENCHardware)
+    {
+        const FString BitstreamPath = !VideoPath.IsEmpty() ? VideoPath : (OutputDirectory / (BaseFileName + TEXT(".h264")));
+        if (!FPaths::FileExists(BitstreamPath))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("NVENC bitstream %s not found; skipping FFmpeg mux."), *BitstreamPath);
+            return false;
+        }
+        CommandLine = FString::Printf(TEXT("-y -framerate %.3f -i \"%s\""), EffectiveFrameRate, *BitstreamPath);
+    }
+    else if (Settings.OutputFormat == EOmniOutputFormat::FFmpegPipe)
+    {
+        // The pipe already encoded the video during capture; only a recorded audio track still has to be muxed in.
+        if (VideoPath.IsEmpty() || !FPaths::FileExists(VideoPath))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("FFmpeg pipe output %s not found; skipping FFmpeg mux."), *VideoPath);
+            return false;
+        }
+        if (FPaths::IsSamePath(VideoPath, OutputFile))
+        {
+            return true;
+        }
+        CommandLine = FString::Printf(TEXT("-y -i \"%s\""), *VideoPath);
+    }
+    else
+    {
+        return false;
+    }
+
+    if (!AudioPath.IsEmpty() && FPaths::FileExists(AudioPath))
+    {
+        CommandLine += FString::Printf(TEXT(" -i \"%s\" -c:a aac -b:a 192k"), *AudioPath);
+    }
+    else
+    {
+        CommandLine += TEXT(" -an");
+        if (!AudioPath.IsEmpty())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Audio file %s was not found; muxed output will be silent."), *AudioPath);
+        }
+    }
+
+    CommandLine += BuildVideoEncodeArguments(Settings, !bImageSequenceOutput);
+
     CommandLine += FString::Printf(TEXT(" -shortest \"%s\""), *OutputFile);
 
     UE_LOG(LogTemp, Log, TEXT("Invoking FFmpeg: %s %s"), *Binary, *CommandLine);
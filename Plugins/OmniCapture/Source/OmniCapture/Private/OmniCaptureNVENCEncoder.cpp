@@ -899,6 +899,7 @@ void FOmniCaptureNVENCEncoder::Initialize(const FOmniCaptureSettings& Settings,
 
     LastErrorMessage.Reset();
     bInitialized = false;
+    BytesWritten.Store(0);
 
 #if OMNI_WITH_NVENC
     AnnexB.Reset();
@@ -961,13 +962,30 @@ void FOmniCaptureNVENCEncoder::Initialize(const FOmniCaptureSettings& Settings,
         ActiveParameters.QPMax = 51;
     }
 
-    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-    BitstreamFile.Reset(PlatformFile.OpenWrite(*OutputFilePath, /*bAppend=*/false));
-    if (!BitstreamFile)
+    if (Settings.bNativeMP4Muxing)
     {
-        LastErrorMessage = FString::Printf(TEXT("Unable to open NVENC output file at %s."), *OutputFilePath);
-        UE_LOG(LogOmniCaptureNVENC, Error, TEXT("%s"), *LastErrorMessage);
-        return;
+        OutputFilePath = FPaths::Combine(OutputDirectory, Settings.OutputFileName + TEXT(".mp4"));
+        MP4Writer = MakeUnique<FOmniCaptureMP4Writer>();
+        if (!MP4Writer->Open(OutputFilePath, Settings, OutputSize, ActiveParameters.Framerate))
+        {
+            MP4Writer.Reset();
+            LastErrorMessage = FString::Printf(TEXT("Unable to open NVENC output file at %s."), *OutputFilePath);
+            UE_LOG(LogOmniCaptureNVENC, Error, TEXT("%s"), *LastErrorMessage);
+            return;
+        }
+        BytesWritten.Store(MP4Writer->GetBytesWritten());
+    }
+    else
+    {
+        IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+        BitstreamIndex.Reset(ActiveParameters.Codec);
+        BitstreamFile.Reset(PlatformFile.OpenWrite(*OutputFilePath, /*bAppend=*/false));
+        if (!BitstreamFile)
+        {
+            LastErrorMessage = FString::Printf(TEXT("Unable to open NVENC output file at %s."), *OutputFilePath);
+            UE_LOG(LogOmniCaptureNVENC, Error, TEXT("%s"), *LastErrorMessage);
+            return;
+        }
     }
 
     bInitialized = true;
@@ -1003,7 +1021,7 @@ namespace
 void FOmniCaptureNVENCEncoder::EnqueueFrame(const FOmniCaptureFrame& Frame)
 {
 #if PLATFORM_WINDOWS && OMNI_WITH_NVENC
-    if (!bInitialized || !BitstreamFile)
+    if (!bInitialized || (!BitstreamFile && !MP4Writer))
     {
         return;
     }
@@ -1034,6 +1052,25 @@ void FOmniCaptureNVENCEncoder::EnqueueFrame(const FOmniCaptureFrame& Frame)
 #endif
 }
 
+void FOmniCaptureNVENCEncoder::WriteAudio(const TArray<FOmniAudioPacket>& Packets)
+{
+#if PLATFORM_WINDOWS && OMNI_WITH_NVENC
+    FScopeLock Lock(&EncoderCS);
+    if (!MP4Writer)
+    {
+        return;
+    }
+
+    for (const FOmniAudioPacket& Packet : Packets)
+    {
+        MP4Writer->WriteAudio(Packet);
+    }
+    BytesWritten.Store(MP4Writer->GetBytesWritten());
+#else
+    (void)Packets;
+#endif
+}
+
 void FOmniCaptureNVENCEncoder::Finalize()
 {
 #if PLATFORM_WINDOWS && OMNI_WITH_NVENC
@@ -1043,6 +1080,18 @@ void FOmniCaptureNVENCEncoder::Finalize()
     {
         BitstreamFile->Flush();
         BitstreamFile.Reset();
+
+        // The sidecar lets the raw stream be seeked and cut at IDR boundaries without rescanning it.
+        if (!BitstreamIndex.SaveToFile(OmniNVENC::FNVENCBitstreamIndex::GetIndexPath(OutputFilePath)))
+        {
+            UE_LOG(LogOmniCaptureNVENC, Warning, TEXT("Unable to write keyframe index for %s."), *OutputFilePath);
+        }
+    }
+
+    if (MP4Writer)
+    {
+        MP4Writer->Finalize();
+        MP4Writer.Reset();
     }
 
     Bitstream.Release();
@@ -1074,16 +1123,42 @@ bool FOmniCaptureNVENCEncoder::WriteAnnexBHeader()
 
     AnnexB.SetCodecConfig(SequenceData);
     const TArray<uint8>& Header = AnnexB.GetCodecConfig();
-    if (Header.Num() == 0 || !BitstreamFile)
+    if (Header.Num() == 0 || (!BitstreamFile && !MP4Writer))
     {
         return false;
     }
 
-    BitstreamFile->Write(Header.GetData(), Header.Num());
+    if (MP4Writer)
+    {
+        MP4Writer->SetCodecConfig(Header);
+    }
+    else
+    {
+        BitstreamIndex.AddCodecConfig(Header);
+        BitstreamFile->Write(Header.GetData(), Header.Num());
+        BytesWritten.AddExchange(Header.Num());
+    }
     bAnnexBHeaderWritten = true;
     UE_LOG(LogOmniCaptureNVENC, Verbose, TEXT("Wrote NVENC Annex B header (%d bytes)."), Header.Num());
     return true;
 }
+
+void FOmniCaptureNVENCEncoder::WriteEncodedPacket(const OmniNVENC::FNVENCEncodedPacket& Packet)
+{
+    if (MP4Writer)
+    {
+        MP4Writer->WriteVideoSample(Packet.Data, Packet.bKeyFrame);
+        BytesWritten.Store(MP4Writer->GetBytesWritten());
+    }
+    else if (BitstreamFile)
+    {
+        BitstreamIndex.AddAccessUnit(Packet.Data, BitstreamFile->Tell());
+        if (BitstreamFile->Write(Packet.Data.GetData(), Packet.Data.Num()))
+        {
+            BytesWritten.AddExchange(Packet.Data.Num());
+        }
+    }
+}
 #else
 bool FOmniCaptureNVENCEncoder::WriteAnnexBHeader()
 {
@@ -1224,9 +1299,9 @@ bool FOmniCaptureNVENCEncoder::EncodeFrameD3D11(const FOmniCaptureFrame& Frame)
     }
 
     OmniNVENC::FNVENCEncodedPacket Packet;
-    if (Bitstream.ExtractPacket(Packet) && Packet.Data.Num() > 0 && BitstreamFile)
+    if (Bitstream.ExtractPacket(Packet) && Packet.Data.Num() > 0)
     {
-        BitstreamFile->Write(Packet.Data.GetData(), Packet.Data.Num());
+        WriteEncodedPacket(Packet);
     }
 
     Bitstream.Unlock();
@@ -1440,9 +1515,9 @@ bool FOmniCaptureNVENCEncoder::EncodeFrameD3D12(const FOmniCaptureFrame& Frame)
     }
 
     OmniNVENC::FNVENCEncodedPacket Packet;
-    if (Bitstream.ExtractPacket(Packet) && Packet.Data.Num() > 0 && BitstreamFile)
+    if (Bitstream.ExtractPacket(Packet) && Packet.Data.Num() > 0)
     {
-        BitstreamFile->Write(Packet.Data.GetData(), Packet.Data.Num());
+        WriteEncodedPacket(Packet);
     }
 
     Bitstream.Unlock();
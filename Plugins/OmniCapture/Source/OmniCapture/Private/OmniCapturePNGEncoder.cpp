@@ -0,0 +1,387 @@
+#include "OmniCapturePNGEncoder.h"
+
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Serialization/Archive.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace
+{
+    constexpr int64 GDeflateWindowBytes = 32 * 1024;
+    constexpr int64 GMinStripBytes = 256 * 1024;
+    constexpr int64 GMaxStripBytes = 64ll * 1024ll * 1024ll;
+    constexpr int32 GStripsPerWorker = 2;
+
+    enum class EPngRowFilter : uint8 { None = 0, Sub = 1, Up = 2, Average = 3, Paeth = 4 };
+
+    struct FEncodedStrip
+    {
+        TArray64<uint8> Compressed;
+        uLong Adler = 0;
+        int64 FilteredBytes = 0;
+        bool bSucceeded = false;
+    };
+
+    uint8 PaethPredictor(int32 Left, int32 Up, int32 UpLeft)
+    {
+        const int32 Estimate = Left + Up - UpLeft;
+        const int32 DistanceLeft = FMath::Abs(Estimate - Left);
+        const int32 DistanceUp = FMath::Abs(Estimate - Up);
+        const int32 DistanceUpLeft = FMath::Abs(Estimate - UpLeft);
+        if (DistanceLeft <= DistanceUp && DistanceLeft <= DistanceUpLeft)
+        {
+            return static_cast<uint8>(Left);
+        }
+        return static_cast<uint8>(DistanceUp <= DistanceUpLeft ? Up : UpLeft);
+    }
+
+    void ApplyRowFilter(EPngRowFilter Filter, const uint8* Row, const uint8* Prev, int64 RowBytes, int32 PixelBytes, uint8* Out)
+    {
+        switch (Filter)
+        {
+        case EPngRowFilter::Sub:
+            for (int64 Index = 0; Index < RowBytes; ++Index)
+            {
+                Out[Index] = static_cast<uint8>(Row[Index] - (Index >= PixelBytes ? Row[Index - PixelBytes] : 0));
+            }
+            break;
+        case EPngRowFilter::Up:
+            for (int64 Index = 0; Index < RowBytes; ++Index)
+            {
+                Out[Index] = static_cast<uint8>(Row[Index] - Prev[Index]);
+            }
+            break;
+        case EPngRowFilter::Average:
+            for (int64 Index = 0; Index < RowBytes; ++Index)
+            {
+                const int32 Left = Index >= PixelBytes ? Row[Index - PixelBytes] : 0;
+                Out[Index] = static_cast<uint8>(Row[Index] - ((Left + Prev[Index]) >> 1));
+            }
+            break;
+        case EPngRowFilter::Paeth:
+            for (int64 Index = 0; Index < RowBytes; ++Index)
+            {
+                const int32 Left = Index >= PixelBytes ? Row[Index - PixelBytes] : 0;
+                const int32 UpLeft = Index >= PixelBytes ? Prev[Index - PixelBytes] : 0;
+                Out[Index] = static_cast<uint8>(Row[Index] - PaethPredictor(Left, Prev[Index], UpLeft));
+            }
+            break;
+        case EPngRowFilter::None:
+        default:
+            FMemory::Memcpy(Out, Row, RowBytes);
+            break;
+        }
+    }
+
+    uint64 SumOfAbsoluteResiduals(const uint8* Filtered, int64 RowBytes)
+    {
+        uint64 Sum = 0;
+        for (int64 Index = 0; Index < RowBytes; ++Index)
+        {
+            Sum += static_cast<uint64>(FMath::Abs(static_cast<int32>(static_cast<int8>(Filtered[Index]))));
+        }
+        return Sum;
+    }
+
+    /** Writes filter byte + filtered row to Out. Scratch must hold RowBytes. */
+    void FilterRow(EOmniCapturePNGFilter Strategy, const uint8* Row, const uint8* Prev, int64 RowBytes, int32 PixelBytes, uint8* Out, TArray64<uint8>& Scratch)
+    {
+        EPngRowFilter Chosen = EPngRowFilter::None;
+        switch (Strategy)
+        {
+        case EOmniCapturePNGFilter::Sub:
+            Chosen = EPngRowFilter::Sub;
+            break;
+        case EOmniCapturePNGFilter::Up:
+            Chosen = EPngRowFilter::Up;
+            break;
+        case EOmniCapturePNGFilter::Adaptive:
+        {
+            // Minimum sum of absolute differences, the same heuristic libpng uses for PNG_ALL_FILTERS.
+            uint64 BestScore = MAX_uint64;
+            for (uint8 Candidate = static_cast<uint8>(EPngRowFilter::None); Candidate <= static_cast<uint8>(EPngRowFilter::Paeth); ++Candidate)
+            {
+                ApplyRowFilter(static_cast<EPngRowFilter>(Candidate), Row, Prev, RowBytes, PixelBytes, Scratch.GetData());
+                const uint64 Score = SumOfAbsoluteResiduals(Scratch.GetData(), RowBytes);
+                if (Score < BestScore)
+                {
+                    BestScore = Score;
+                    Chosen = static_cast<EPngRowFilter>(Candidate);
+                }
+            }
+            break;
+        }
+        case EOmniCapturePNGFilter::None:
+        default:
+            break;
+        }
+
+        Out[0] = static_cast<uint8>(Chosen);
+        ApplyRowFilter(Chosen, Row, Prev, RowBytes, PixelBytes, Out + 1);
+    }
+
+    /** Reorders a native row into PNG byte order: RGBA channel order and big-endian 16-bit samples. */
+    void ConvertRowToPngOrder(const uint8* Source, uint8* Dest, int32 Width, int32 Channels, int32 BytesPerChannel, bool bSourceIsBGRA)
+    {
+        const bool bSwapRedBlue = bSourceIsBGRA && Channels == 4;
+        if (BytesPerChannel == 1)
+        {
+            if (!bSwapRedBlue)
+            {
+                FMemory::Memcpy(Dest, Source, static_cast<int64>(Width) * Channels);
+                return;
+            }
+
+            for (int32 Pixel = 0; Pixel < Width; ++Pixel, Source += 4, Dest += 4)
+            {
+                Dest[0] = Source[2];
+                Dest[1] = Source[1];
+                Dest[2] = Source[0];
+                Dest[3] = Source[3];
+            }
+            return;
+        }
+
+        const uint16* SourceSamples = reinterpret_cast<const uint16*>(Source);
+        for (int32 Pixel = 0; Pixel < Width; ++Pixel, SourceSamples += Channels)
+        {
+            for (int32 Channel = 0; Channel < Channels; ++Channel)
+            {
+                const int32 SourceChannel = (bSwapRedBlue && Channel != 1 && Channel != 3) ? 2 - Channel : Channel;
+                const uint16 Sample = SourceSamples[SourceChannel];
+                *Dest++ = static_cast<uint8>(Sample >> 8);
+                *Dest++ = static_cast<uint8>(Sample & 0xFF);
+            }
+        }
+    }
+
+    bool DeflateInto(z_stream& Stream, TArray64<uint8>& Output, int64& Written, int32 Flush)
+    {
+        for (;;)
+        {
+            if (Output.Num() - Written < 1024)
+            {
+                Output.SetNumUninitialized(Output.Num() + FMath::Max<int64>(Output.Num() / 2, 64 * 1024), EAllowShrinking::No);
+            }
+
+            const int64 Space = FMath::Min<int64>(Output.Num() - Written, MAX_uint32);
+            Stream.next_out = Output.GetData() + Written;
+            Stream.avail_out = static_cast<uInt>(Space);
+            const int32 Result = deflate(&Stream, Flush);
+            Written += Space - Stream.avail_out;
+
+            if (Result == Z_STREAM_ERROR)
+            {
+                return false;
+            }
+
+            if (Flush == Z_FINISH ? Result == Z_STREAM_END : Stream.avail_out != 0)
+            {
+                return true;
+            }
+        }
+    }
+
+    void WriteBigEndian32(uint8* Dest, uint32 Value)
+    {
+        Dest[0] = static_cast<uint8>(Value >> 24);
+        Dest[1] = static_cast<uint8>(Value >> 16);
+        Dest[2] = static_cast<uint8>(Value >> 8);
+        Dest[3] = static_cast<uint8>(Value);
+    }
+
+    void WriteChunk(FArchive& Archive, const char* Type, const uint8* Data, int64 Length)
+    {
+        uint8 Header[8];
+        WriteBigEndian32(Header, static_cast<uint32>(Length));
+        FMemory::Memcpy(Header + 4, Type, 4);
+
+        uLong Crc = crc32(0L, Z_NULL, 0);
+        Crc = crc32(Crc, Header + 4, 4);
+        if (Length > 0)
+        {
+            Crc = crc32(Crc, Data, static_cast<uInt>(Length));
+        }
+
+        uint8 Footer[4];
+        WriteBigEndian32(Footer, static_cast<uint32>(Crc));
+
+        Archive.Serialize(Header, sizeof(Header));
+        if (Length > 0)
+        {
+            Archive.Serialize(const_cast<uint8*>(Data), Length);
+        }
+        Archive.Serialize(Footer, sizeof(Footer));
+    }
+
+    uint8 GetZlibHeaderFlags(int32 CompressionLevel)
+    {
+        // FLEVEL hint plus the FCHECK bits that make (0x78 << 8 | FLG) a multiple of 31.
+        if (CompressionLevel <= 1)
+        {
+            return 0x01;
+        }
+        if (CompressionLevel <= 5)
+        {
+            return 0x5E;
+        }
+        return CompressionLevel == 6 ? 0x9C : 0xDA;
+    }
+}
+
+bool FOmniCaptureParallelPNGEncoder::Encode(FArchive& Archive, const FIntPoint& Size, int32 Channels, int32 BitDepth, bool bSourceIsBGRA, const FOmniCapturePNGEncodeOptions& Options, FPrepareRows PrepareRows, TFunctionRef<bool()> ShouldCancel)
+{
+    if ((Channels != 1 && Channels != 4) || (BitDepth != 8 && BitDepth != 16) || Size.X <= 0 || Size.Y <= 0)
+    {
+        return false;
+    }
+
+    const int32 BytesPerChannel = BitDepth / 8;
+    const int32 PixelBytes = Channels * BytesPerChannel;
+    const int64 BytesPerRow = static_cast<int64>(Size.X) * PixelBytes;
+    const int64 FilteredRowBytes = BytesPerRow + 1;
+    const int32 CompressionLevel = FMath::Clamp(Options.CompressionLevel, 0, 9);
+    const int32 Strategy = Options.Filter == EOmniCapturePNGFilter::None ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+
+    int32 StripRows = Options.StripRows;
+    if (StripRows <= 0)
+    {
+        const int32 Workers = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+        StripRows = FMath::DivideAndRoundUp(Size.Y, Workers * GStripsPerWorker);
+        StripRows = FMath::Max(StripRows, static_cast<int32>(FMath::DivideAndRoundUp(GMinStripBytes, FilteredRowBytes)));
+    }
+    StripRows = FMath::Clamp(StripRows, 1, FMath::Max(1, static_cast<int32>(GMaxStripBytes / FilteredRowBytes)));
+    StripRows = FMath::Min(StripRows, Size.Y);
+
+    const int32 NumStrips = FMath::DivideAndRoundUp(Size.Y, StripRows);
+    const int32 DictionaryRows = static_cast<int32>(FMath::DivideAndRoundUp(GDeflateWindowBytes, FilteredRowBytes));
+
+    TArray<FEncodedStrip> Strips;
+    Strips.SetNum(NumStrips);
+
+    ParallelFor(NumStrips, [&](int32 StripIndex)
+    {
+        if (ShouldCancel())
+        {
+            return;
+        }
+
+        FEncodedStrip& Strip = Strips[StripIndex];
+        const int32 RowStart = StripIndex * StripRows;
+        const int32 RowCount = FMath::Min(StripRows, Size.Y - RowStart);
+        const bool bLastStrip = StripIndex == NumStrips - 1;
+
+        // Rows ahead of the strip are re-filtered (deterministically) to rebuild the previous strip's window, and one more
+        // row ahead of those feeds the Up/Average/Paeth predictors.
+        const int32 LeadRows = FMath::Min(RowStart, DictionaryRows);
+        const int32 FirstFilteredRow = RowStart - LeadRows;
+        const bool bHasPredecessor = FirstFilteredRow > 0;
+        const int32 SourceStart = FirstFilteredRow - (bHasPredecessor ? 1 : 0);
+        const int32 SourceCount = RowStart + RowCount - SourceStart;
+
+        TArray64<uint8> TempBuffer;
+        TArray<uint8*> RowPointers;
+        RowPointers.SetNum(SourceCount);
+        PrepareRows(SourceStart, SourceCount, BytesPerRow, TempBuffer, RowPointers);
+
+        TArray64<uint8> PrevRow;
+        TArray64<uint8> CurrentRow;
+        TArray64<uint8> Scratch;
+        PrevRow.SetNumZeroed(BytesPerRow);
+        CurrentRow.SetNumUninitialized(BytesPerRow);
+        Scratch.SetNumUninitialized(BytesPerRow);
+
+        int32 SourceIndex = 0;
+        if (bHasPredecessor)
+        {
+            ConvertRowToPngOrder(RowPointers[SourceIndex++], PrevRow.GetData(), Size.X, Channels, BytesPerChannel, bSourceIsBGRA);
+        }
+
+        const int32 FilteredRowCount = LeadRows + RowCount;
+        TArray64<uint8> Filtered;
+        Filtered.SetNumUninitialized(FilteredRowBytes * FilteredRowCount);
+        for (int32 Row = 0; Row < FilteredRowCount; ++Row, ++SourceIndex)
+        {
+            ConvertRowToPngOrder(RowPointers[SourceIndex], CurrentRow.GetData(), Size.X, Channels, BytesPerChannel, bSourceIsBGRA);
+            FilterRow(Options.Filter, CurrentRow.GetData(), PrevRow.GetData(), BytesPerRow, PixelBytes, Filtered.GetData() + FilteredRowBytes * Row, Scratch);
+            Swap(PrevRow, CurrentRow);
+        }
+
+        TempBuffer.Empty();
+        RowPointers.Empty();
+
+        const int64 LeadBytes = FilteredRowBytes * LeadRows;
+        const uint8* StripData = Filtered.GetData() + LeadBytes;
+        Strip.FilteredBytes = FilteredRowBytes * RowCount;
+        Strip.Adler = adler32(adler32(0L, Z_NULL, 0), StripData, static_cast<uInt>(Strip.FilteredBytes));
+
+        z_stream Stream;
+        FMemory::Memzero(Stream);
+        if (deflateInit2(&Stream, CompressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Strategy) != Z_OK)
+        {
+            return;
+        }
+
+        if (LeadBytes > 0)
+        {
+            const int64 DictionaryBytes = FMath::Min(LeadBytes, GDeflateWindowBytes);
+            deflateSetDictionary(&Stream, StripData - DictionaryBytes, static_cast<uInt>(DictionaryBytes));
+        }
+
+        // The first strip carries the zlib header; the last leaves room for the combined Adler-32 trailer.
+        int64 Written = StripIndex == 0 ? 2 : 0;
+        Strip.Compressed.SetNumUninitialized(Written + static_cast<int64>(deflateBound(&Stream, static_cast<uLong>(Strip.FilteredBytes))) + 16);
+        if (StripIndex == 0)
+        {
+            Strip.Compressed[0] = 0x78;
+            Strip.Compressed[1] = GetZlibHeaderFlags(CompressionLevel);
+        }
+
+        Stream.next_in = const_cast<Bytef*>(StripData);
+        Stream.avail_in = static_cast<uInt>(Strip.FilteredBytes);
+
+        // Sync flush ends every strip but the last on a byte boundary with no final block, so the raw streams concatenate.
+        Strip.bSucceeded = DeflateInto(Stream, Strip.Compressed, Written, bLastStrip ? Z_FINISH : Z_SYNC_FLUSH);
+        deflateEnd(&Stream);
+        Strip.Compressed.SetNum(Written, EAllowShrinking::No);
+    });
+
+    uLong Adler = adler32(0L, Z_NULL, 0);
+    for (const FEncodedStrip& Strip : Strips)
+    {
+        if (!Strip.bSucceeded)
+        {
+            return false;
+        }
+        Adler = adler32_combine(Adler, Strip.Adler, static_cast<z_off_t>(Strip.FilteredBytes));
+    }
+
+    TArray64<uint8>& Tail = Strips.Last().Compressed;
+    const int64 TailOffset = Tail.Num();
+    Tail.AddUninitialized(4);
+    WriteBigEndian32(Tail.GetData() + TailOffset, static_cast<uint32>(Adler));
+
+    static const uint8 Signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    Archive.Serialize(const_cast<uint8*>(Signature), sizeof(Signature));
+
+    uint8 Header[13];
+    WriteBigEndian32(Header, static_cast<uint32>(Size.X));
+    WriteBigEndian32(Header + 4, static_cast<uint32>(Size.Y));
+    Header[8] = static_cast<uint8>(BitDepth);
+    Header[9] = Channels == 4 ? 6 : 0;
+    Header[10] = 0;
+    Header[11] = 0;
+    Header[12] = 0;
+    WriteChunk(Archive, "IHDR", Header, sizeof(Header));
+
+    for (const FEncodedStrip& Strip : Strips)
+    {
+        WriteChunk(Archive, "IDAT", Strip.Compressed.GetData(), Strip.Compressed.Num());
+    }
+
+    WriteChunk(Archive, "IEND", nullptr, 0);
+    return !Archive.IsError();
+}
@@ -7,6 +7,15 @@
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Materials/MaterialInterface.h"
 #include "OmniCaptureIncludeFixes.h"
+#include "RenderingThread.h"
+
+/** Pixels handed to UpdateTextureRegions; they and Region must outlive the render command that reads them. */
+struct FOmniCapturePreviewUpload
+{
+    TArray<FColor> Pixels;
+    FUpdateTextureRegion2D Region;
+    TAtomic<bool> bInFlight{ false };
+};
 
 namespace
 {
@@ -141,83 +150,66 @@ void AOmniCapturePreviewActor::SetPreviewView(EOmniCapturePreviewView InView)
     PreviewViewMode = InView;
 }
 
-void AOmniCapturePreviewActor::UpdatePreviewTexture(const FOmniCaptureEquirectResult& Result, const FOmniCaptureSettings& Settings)
+void AOmniCapturePreviewActor::UpdatePreviewTexture(FOmniCaptureEquirectResult& Result, const FOmniCaptureSettings& Settings)
 {
-    const FIntPoint Size = Result.Size;
-    if (Size.X <= 0 || Size.Y <= 0)
+    const FIntPoint Size = Result.PreviewSize;
+    if (Size.X <= 0 || Size.Y <= 0 || Result.PreviewPixels.Num() != Size.X * Size.Y)
     {
         return;
     }
 
     const bool bStereo = Settings.IsStereo();
     const bool bShowSingleEye = bStereo && PreviewViewMode != EOmniCapturePreviewView::StereoComposite;
+    const bool bRightEye = PreviewViewMode == EOmniCapturePreviewView::RightEye;
 
+    // A single eye is uploaded straight out of the packed stereo frame by offsetting the source region.
     FIntPoint TargetSize = Size;
+    FIntPoint SourceOffset = FIntPoint::ZeroValue;
     if (bShowSingleEye)
     {
         if (Settings.StereoLayout == EOmniCaptureStereoLayout::SideBySide)
         {
             TargetSize.X = FMath::Max(1, Size.X / 2);
+            SourceOffset.X = bRightEye ? Size.X - TargetSize.X : 0;
         }
         else
         {
             TargetSize.Y = FMath::Max(1, Size.Y / 2);
+            SourceOffset.Y = bRightEye ? Size.Y - TargetSize.Y : 0;
         }
     }
 
     ResizePreviewTexture(TargetSize);
-    if (!PreviewTexture)
+    if (!PreviewTexture || !PreviewTexture->GetResource())
     {
         return;
     }
 
-    FTexture2DMipMap& Mip = PreviewTexture->GetPlatformData()->Mips[0];
-    void* TextureMemory = Mip.BulkData.Lock(LOCK_READ_WRITE);
-
-    if (Result.PreviewPixels.Num() != Size.X * Size.Y)
+    TSharedPtr<FOmniCapturePreviewUpload, ESPMode::ThreadSafe>& Upload = Uploads[NextUpload];
+    if (!Upload.IsValid())
+    {
+        Upload = MakeShared<FOmniCapturePreviewUpload, ESPMode::ThreadSafe>();
+    }
+    else if (Upload->bInFlight.Load())
     {
-        Mip.BulkData.Unlock();
+        // Both buffers are still queued on the render thread; drop this update rather than stall the game thread.
         return;
     }
 
-    if (bShowSingleEye)
-    {
-        const int32 OutputPixels = TargetSize.X * TargetSize.Y;
-        PreviewScratchBuffer.SetNum(OutputPixels, EAllowShrinking::No);
+    Swap(Upload->Pixels, Result.PreviewPixels);
+    Upload->Region = FUpdateTextureRegion2D(0, 0, SourceOffset.X, SourceOffset.Y, TargetSize.X, TargetSize.Y);
+    Upload->bInFlight.Store(true);
+    NextUpload ^= 1;
 
-        if (Settings.StereoLayout == EOmniCaptureStereoLayout::SideBySide)
+    PreviewTexture->UpdateTextureRegions(
+        0,
+        1,
+        &Upload->Region,
+        Size.X * sizeof(FColor),
+        sizeof(FColor),
+        reinterpret_cast<uint8*>(Upload->Pixels.GetData()),
+        [Upload](uint8*, const FUpdateTextureRegion2D*)
         {
-            const int32 EyeWidth = TargetSize.X;
-            const int32 SourceWidth = Size.X;
-            const int32 StartX = PreviewViewMode == EOmniCapturePreviewView::LeftEye ? 0 : EyeWidth;
-            for (int32 Row = 0; Row < Size.Y; ++Row)
-            {
-                const int32 DestIndex = Row * EyeWidth;
-                const int32 SourceIndex = Row * SourceWidth + StartX;
-                FMemory::Memcpy(PreviewScratchBuffer.GetData() + DestIndex, Result.PreviewPixels.GetData() + SourceIndex, EyeWidth * sizeof(FColor));
-            }
-        }
-        else
-        {
-            const int32 EyeHeight = TargetSize.Y;
-            const int32 SourceWidth = Size.X;
-            const int32 StartRow = PreviewViewMode == EOmniCapturePreviewView::LeftEye ? 0 : EyeHeight;
-            for (int32 Row = 0; Row < EyeHeight; ++Row)
-            {
-                const int32 DestIndex = Row * TargetSize.X;
-                const int32 SourceIndex = (StartRow + Row) * SourceWidth;
-                FMemory::Memcpy(PreviewScratchBuffer.GetData() + DestIndex, Result.PreviewPixels.GetData() + SourceIndex, TargetSize.X * sizeof(FColor));
-            }
-        }
-
-        FMemory::Memcpy(TextureMemory, PreviewScratchBuffer.GetData(), PreviewScratchBuffer.Num() * sizeof(FColor));
-    }
-    else
-    {
-        const int32 CopyCount = FMath::Min(Result.PreviewPixels.Num(), TargetSize.X * TargetSize.Y);
-        FMemory::Memcpy(TextureMemory, Result.PreviewPixels.GetData(), CopyCount * sizeof(FColor));
-    }
-
-    Mip.BulkData.Unlock();
-    PreviewTexture->UpdateResource();
+            Upload->bInFlight.Store(false);
+        });
 }
@@ -0,0 +1,423 @@
+#include "OmniCaptureRawDump.h"
+
+#include "OmniCaptureImageWriter.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureRawDump, Log, All);
+
+namespace
+{
+    // Record alignment keeps payloads on sector/page boundaries for unbuffered readers and tools.
+    constexpr int64 GRawRecordAlignment = 4096;
+    constexpr double GIndexFlushIntervalSeconds = 1.0;
+    const TCHAR* GRawIndexSuffix = TEXT(".omniraw.jsonl");
+
+    EOmniCapturePixelDataType ResolvePixelDataType(EOmniCapturePixelDataType PixelDataType, bool bLinear, EOmniCapturePixelPrecision Precision)
+    {
+        if (PixelDataType != EOmniCapturePixelDataType::Unknown)
+        {
+            return PixelDataType;
+        }
+        if (!bLinear)
+        {
+            return EOmniCapturePixelDataType::Color8;
+        }
+        return Precision == EOmniCapturePixelPrecision::FullFloat ? EOmniCapturePixelDataType::LinearColorFloat32 : EOmniCapturePixelDataType::LinearColorFloat16;
+    }
+
+    FString SerializeRecord(const FOmniCaptureRawDumpRecord& Record)
+    {
+        TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+        Object->SetNumberField(TEXT("frame"), Record.FrameIndex);
+        Object->SetNumberField(TEXT("timecode"), Record.Timecode);
+        Object->SetStringField(TEXT("name"), Record.FrameName);
+        Object->SetStringField(TEXT("layer"), Record.Layer);
+        Object->SetNumberField(TEXT("segment"), Record.Segment);
+        Object->SetNumberField(TEXT("offset"), static_cast<double>(Record.Offset));
+        Object->SetNumberField(TEXT("bytes"), static_cast<double>(Record.Bytes));
+        Object->SetNumberField(TEXT("width"), Record.Size.X);
+        Object->SetNumberField(TEXT("height"), Record.Size.Y);
+        Object->SetBoolField(TEXT("linear"), Record.bLinear);
+        Object->SetNumberField(TEXT("precision"), static_cast<int32>(Record.Precision));
+        Object->SetNumberField(TEXT("type"), static_cast<int32>(Record.PixelDataType));
+
+        FString Line;
+        TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Line);
+        FJsonSerializer::Serialize(Object, Writer);
+        return Line;
+    }
+
+    bool ParseRecord(const FString& Line, FOmniCaptureRawDumpRecord& OutRecord)
+    {
+        TSharedPtr<FJsonObject> Object;
+        TSharedRef<TJsonReader<TCHAR>> Reader = TJsonReaderFactory<TCHAR>::Create(Line);
+        if (!FJsonSerializer::Deserialize(Reader, Object) || !Object.IsValid())
+        {
+            return false;
+        }
+
+        int32 Precision = 0;
+        int32 PixelDataType = 0;
+        const bool bParsed = Object->TryGetNumberField(TEXT("frame"), OutRecord.FrameIndex)
+            && Object->TryGetStringField(TEXT("name"), OutRecord.FrameName)
+            && Object->TryGetNumberField(TEXT("segment"), OutRecord.Segment)
+            && Object->TryGetNumberField(TEXT("offset"), OutRecord.Offset)
+            && Object->TryGetNumberField(TEXT("bytes"), OutRecord.Bytes)
+            && Object->TryGetNumberField(TEXT("width"), OutRecord.Size.X)
+            && Object->TryGetNumberField(TEXT("height"), OutRecord.Size.Y)
+            && Object->TryGetNumberField(TEXT("type"), PixelDataType);
+        if (!bParsed)
+        {
+            return false;
+        }
+
+        Object->TryGetNumberField(TEXT("timecode"), OutRecord.Timecode);
+        Object->TryGetStringField(TEXT("layer"), OutRecord.Layer);
+        Object->TryGetBoolField(TEXT("linear"), OutRecord.bLinear);
+        Object->TryGetNumberField(TEXT("precision"), Precision);
+        OutRecord.Precision = static_cast<EOmniCapturePixelPrecision>(Precision);
+        OutRecord.PixelDataType = static_cast<EOmniCapturePixelDataType>(PixelDataType);
+        return true;
+    }
+
+    template <typename PixelType>
+    TUniquePtr<FImagePixelData> ReadPixels(IFileHandle& Handle, const FOmniCaptureRawDumpRecord& Record)
+    {
+        const int64 NumPixels = static_cast<int64>(Record.Size.X) * Record.Size.Y;
+        if (NumPixels <= 0 || Record.Bytes != NumPixels * static_cast<int64>(sizeof(PixelType)))
+        {
+            return nullptr;
+        }
+
+        TUniquePtr<TImagePixelData<PixelType>> PixelData = MakeUnique<TImagePixelData<PixelType>>(Record.Size);
+        PixelData->Pixels.SetNumUninitialized(NumPixels);
+        if (!Handle.Seek(Record.Offset) || !Handle.Read(reinterpret_cast<uint8*>(PixelData->Pixels.GetData()), Record.Bytes))
+        {
+            return nullptr;
+        }
+        return PixelData;
+    }
+}
+
+FOmniCaptureRawDumpWriter::~FOmniCaptureRawDumpWriter()
+{
+    Close();
+}
+
+FString FOmniCaptureRawDumpWriter::GetIndexPath(const FString& Directory, const FString& BaseName)
+{
+    return Directory / (BaseName + GRawIndexSuffix);
+}
+
+FString FOmniCaptureRawDumpWriter::GetSegmentPath(const FString& Directory, const FString& BaseName, int32 Segment)
+{
+    return Directory / FString::Printf(TEXT("%s.%03d.omniraw"), *BaseName, Segment);
+}
+
+bool FOmniCaptureRawDumpWriter::Open(const FString& InDirectory, const FString& InBaseName, int64 InSegmentCapacityBytes)
+{
+    Close();
+
+    Directory = InDirectory;
+    BaseName = InBaseName;
+    SegmentCapacityBytes = FMath::Max<int64>(InSegmentCapacityBytes, GRawRecordAlignment);
+    BytesWritten.Store(0);
+    LastIndexFlushTime = FPlatformTime::Seconds();
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    PlatformFile.CreateDirectoryTree(*Directory);
+
+    IndexHandle.Reset(PlatformFile.OpenWrite(*GetIndexPath(Directory, BaseName)));
+    if (!IndexHandle.IsValid())
+    {
+        UE_LOG(LogOmniCaptureRawDump, Error, TEXT("Failed to create raw dump index %s"), *GetIndexPath(Directory, BaseName));
+        return false;
+    }
+
+    return OpenSegment(0);
+}
+
+bool FOmniCaptureRawDumpWriter::OpenSegment(int32 Segment)
+{
+    CloseSegment();
+
+    const FString SegmentPath = GetSegmentPath(Directory, BaseName, Segment);
+    SegmentHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*SegmentPath));
+    if (!SegmentHandle.IsValid())
+    {
+        UE_LOG(LogOmniCaptureRawDump, Error, TEXT("Failed to create raw dump segment %s"), *SegmentPath);
+        return false;
+    }
+
+    // Reserve the whole segment up front so the filesystem can lay it out contiguously; trimmed on close.
+    if (!SegmentHandle->Truncate(SegmentCapacityBytes) || !SegmentHandle->Seek(0))
+    {
+        UE_LOG(LogOmniCaptureRawDump, Warning, TEXT("Could not preallocate %lld bytes for %s"), SegmentCapacityBytes, *SegmentPath);
+    }
+
+    SegmentIndex = Segment;
+    SegmentOffset = 0;
+    return true;
+}
+
+void FOmniCaptureRawDumpWriter::CloseSegment()
+{
+    if (SegmentHandle.IsValid())
+    {
+        SegmentHandle->Truncate(SegmentOffset);
+        SegmentHandle->Flush();
+        SegmentHandle.Reset();
+    }
+
+    // Segment boundaries double as index checkpoints.
+    if (IndexHandle.IsValid())
+    {
+        IndexHandle->Flush();
+        LastIndexFlushTime = FPlatformTime::Seconds();
+    }
+}
+
+void FOmniCaptureRawDumpWriter::Close()
+{
+    FScopeLock Lock(&WriteCS);
+    CloseSegment();
+    IndexHandle.Reset();
+}
+
+bool FOmniCaptureRawDumpWriter::WriteFrame(const FOmniCaptureFrameMetadata& Metadata, const FString& FrameName, const FImagePixelData& PixelData, bool bLinear, EOmniCapturePixelPrecision Precision, EOmniCapturePixelDataType PixelDataType, const TMap<FName, FOmniCaptureLayerPayload>& AuxiliaryLayers)
+{
+    FScopeLock Lock(&WriteCS);
+    if (!IndexHandle.IsValid())
+    {
+        return false;
+    }
+
+    FOmniCaptureRawDumpRecord Record;
+    Record.FrameIndex = Metadata.FrameIndex;
+    Record.Timecode = Metadata.Timecode;
+    Record.FrameName = FrameName;
+    Record.bLinear = bLinear;
+    Record.Precision = Precision;
+    Record.PixelDataType = ResolvePixelDataType(PixelDataType, bLinear, Precision);
+    bool bSuccess = WriteRecord(Record, PixelData);
+
+    for (const TPair<FName, FOmniCaptureLayerPayload>& Pair : AuxiliaryLayers)
+    {
+        if (!Pair.Value.PixelData.IsValid())
+        {
+            continue;
+        }
+
+        FOmniCaptureRawDumpRecord LayerRecord;
+        LayerRecord.FrameIndex = Metadata.FrameIndex;
+        LayerRecord.Timecode = Metadata.Timecode;
+        LayerRecord.FrameName = FrameName;
+        LayerRecord.Layer = Pair.Key.ToString();
+        LayerRecord.bLinear = Pair.Value.bLinear;
+        LayerRecord.Precision = Pair.Value.Precision == EOmniCapturePixelPrecision::Unknown ? Precision : Pair.Value.Precision;
+        LayerRecord.PixelDataType = ResolvePixelDataType(Pair.Value.PixelDataType, Pair.Value.bLinear, LayerRecord.Precision);
+        bSuccess &= WriteRecord(LayerRecord, *Pair.Value.PixelData);
+    }
+
+    // Flushing every record would queue all write tasks behind one disk sync per frame.
+    const double Now = FPlatformTime::Seconds();
+    if (Now - LastIndexFlushTime >= GIndexFlushIntervalSeconds)
+    {
+        IndexHandle->Flush();
+        LastIndexFlushTime = Now;
+    }
+    return bSuccess;
+}
+
+bool FOmniCaptureRawDumpWriter::WriteRecord(FOmniCaptureRawDumpRecord& Record, const FImagePixelData& PixelData)
+{
+    const void* RawData = nullptr;
+    int64 RawSize = 0;
+    if (!PixelData.GetRawData(RawData, RawSize) || !RawData || RawSize <= 0)
+    {
+        return false;
+    }
+
+    // Oversized payloads get a segment of their own rather than failing.
+    if (SegmentOffset > 0 && SegmentOffset + RawSize > SegmentCapacityBytes)
+    {
+        if (!OpenSegment(SegmentIndex + 1))
+        {
+            return false;
+        }
+    }
+
+    if (!SegmentHandle.IsValid() || !SegmentHandle->Seek(SegmentOffset) || !SegmentHandle->Write(static_cast<const uint8*>(RawData), RawSize))
+    {
+        UE_LOG(LogOmniCaptureRawDump, Error, TEXT("Failed to write frame %d to raw dump segment %d"), Record.FrameIndex, SegmentIndex);
+        return false;
+    }
+
+    Record.Segment = SegmentIndex;
+    Record.Offset = SegmentOffset;
+    Record.Bytes = RawSize;
+    Record.Size = PixelData.GetSize();
+    SegmentOffset = Align(SegmentOffset + RawSize, GRawRecordAlignment);
+    BytesWritten.AddExchange(RawSize);
+
+    const FTCHARToUTF8 Line(*(SerializeRecord(Record) + TEXT("\n")));
+    return IndexHandle->Write(reinterpret_cast<const uint8*>(Line.Get()), Line.Length());
+}
+
+FString FOmniCaptureRawDumpReader::GetBaseName(const FString& IndexPath)
+{
+    FString CleanName = FPaths::GetCleanFilename(IndexPath);
+    CleanName.RemoveFromEnd(GRawIndexSuffix);
+    return CleanName;
+}
+
+bool FOmniCaptureRawDumpReader::ReadIndex(const FString& IndexPath, TArray<FOmniCaptureRawDumpRecord>& OutRecords)
+{
+    TArray<FString> Lines;
+    if (!FFileHelper::LoadFileToStringArray(Lines, *IndexPath))
+    {
+        UE_LOG(LogOmniCaptureRawDump, Error, TEXT("Failed to read raw dump index %s"), *IndexPath);
+        return false;
+    }
+
+    OutRecords.Reset(Lines.Num());
+    for (const FString& Line : Lines)
+    {
+        if (Line.IsEmpty())
+        {
+            continue;
+        }
+
+        FOmniCaptureRawDumpRecord Record;
+        if (!ParseRecord(Line, Record))
+        {
+            // A torn last line is expected after a crash; everything before it is still usable.
+            UE_LOG(LogOmniCaptureRawDump, Warning, TEXT("Skipping malformed raw dump index entry in %s"), *IndexPath);
+            continue;
+        }
+        OutRecords.Add(MoveTemp(Record));
+    }
+
+    // Write tasks finish out of order; frames are replayed in FrameIndex order with the main payload first.
+    OutRecords.StableSort([](const FOmniCaptureRawDumpRecord& A, const FOmniCaptureRawDumpRecord& B)
+    {
+        if (A.FrameIndex != B.FrameIndex)
+        {
+            return A.FrameIndex < B.FrameIndex;
+        }
+        return A.Layer.IsEmpty() && !B.Layer.IsEmpty();
+    });
+    return true;
+}
+
+TUniquePtr<FImagePixelData> FOmniCaptureRawDumpReader::ReadPayload(const FString& Directory, const FString& BaseName, const FOmniCaptureRawDumpRecord& Record)
+{
+    const FString SegmentPath = FOmniCaptureRawDumpWriter::GetSegmentPath(Directory, BaseName, Record.Segment);
+    TUniquePtr<IFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*SegmentPath));
+    if (!Handle.IsValid())
+    {
+        UE_LOG(LogOmniCaptureRawDump, Error, TEXT("Failed to open raw dump segment %s"), *SegmentPath);
+        return nullptr;
+    }
+
+    switch (Record.PixelDataType)
+    {
+    case EOmniCapturePixelDataType::Color8:
+        return ReadPixels<FColor>(*Handle, Record);
+    case EOmniCapturePixelDataType::LinearColorFloat16:
+        return ReadPixels<FFloat16Color>(*Handle, Record);
+    case EOmniCapturePixelDataType::LinearColorFloat32:
+        return ReadPixels<FLinearColor>(*Handle, Record);
+    case EOmniCapturePixelDataType::ScalarFloat32:
+        return ReadPixels<float>(*Handle, Record);
+    case EOmniCapturePixelDataType::Vector2Float32:
+        return ReadPixels<FVector2f>(*Handle, Record);
+    default:
+        return nullptr;
+    }
+}
+
+bool FOmniCaptureRawDumpReader::Transcode(const FString& IndexPath, const FOmniCaptureSettings& Settings, const FString& OutputDirectory, TArray<FOmniCaptureFrameMetadata>& OutFrames)
+{
+    OutFrames.Reset();
+    if (Settings.ImageFormat == EOmniCaptureImageFormat::RawDump)
+    {
+        UE_LOG(LogOmniCaptureRawDump, Error, TEXT("Raw dump transcode needs an encoded target image format"));
+        return false;
+    }
+
+    TArray<FOmniCaptureRawDumpRecord> Records;
+    if (!ReadIndex(IndexPath, Records))
+    {
+        return false;
+    }
+
+    const FString DumpDirectory = FPaths::GetPath(IndexPath);
+    const FString DumpBaseName = GetBaseName(IndexPath);
+
+    FOmniCaptureSettings TranscodeSettings = Settings;
+    TranscodeSettings.OutputFileName = DumpBaseName;
+
+    FOmniCaptureImageWriter Writer;
+    Writer.Initialize(TranscodeSettings, OutputDirectory);
+
+    bool bSuccess = true;
+    int32 RecordIndex = 0;
+    while (RecordIndex < Records.Num())
+    {
+        const FOmniCaptureRawDumpRecord& MainRecord = Records[RecordIndex];
+        TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
+        Frame->Metadata.FrameIndex = MainRecord.FrameIndex;
+        Frame->Metadata.Timecode = MainRecord.Timecode;
+
+        for (; RecordIndex < Records.Num() && Records[RecordIndex].FrameIndex == MainRecord.FrameIndex; ++RecordIndex)
+        {
+            const FOmniCaptureRawDumpRecord& Record = Records[RecordIndex];
+            TUniquePtr<FImagePixelData> PixelData = ReadPayload(DumpDirectory, DumpBaseName, Record);
+            if (!PixelData.IsValid())
+            {
+                UE_LOG(LogOmniCaptureRawDump, Warning, TEXT("Failed to read frame %d layer '%s' from %s"), Record.FrameIndex, *Record.Layer, *IndexPath);
+                bSuccess = false;
+                continue;
+            }
+
+            if (Record.Layer.IsEmpty())
+            {
+                Frame->PixelData = MoveTemp(PixelData);
+                Frame->bLinearColor = Record.bLinear;
+                Frame->PixelPrecision = Record.Precision;
+                Frame->PixelDataType = Record.PixelDataType;
+            }
+            else
+            {
+                FOmniCaptureLayerPayload& Layer = Frame->AuxiliaryLayers.FindOrAdd(FName(*Record.Layer));
+                Layer.PixelData = MoveTemp(PixelData);
+                Layer.bLinear = Record.bLinear;
+                Layer.Precision = Record.Precision;
+                Layer.PixelDataType = Record.PixelDataType;
+            }
+        }
+
+        if (Frame->PixelData.IsValid())
+        {
+            Writer.EnqueueFrame(MoveTemp(Frame), MainRecord.FrameName + TranscodeSettings.GetImageFileExtension());
+        }
+    }
+
+    Writer.WaitForPendingWrites();
+    OutFrames = Writer.ConsumeCapturedFrames();
+    Writer.Flush();
+
+    UE_LOG(LogOmniCaptureRawDump, Log, TEXT("Transcoded %d frames from %s"), OutFrames.Num(), *IndexPath);
+    return bSuccess;
+}
@@ -0,0 +1,108 @@
+#include "OmniCaptureReadbackQueue.h"
+
+#include "RenderingThread.h"
+#include "RenderCommandFence.h"
+
+FOmniCaptureReadbackQueue::FOmniCaptureReadbackQueue(int32 InMaxInFlight)
+    : MaxInFlight(FMath::Max(1, InMaxInFlight))
+{
+    InFlight.Reserve(MaxInFlight);
+}
+
+void FOmniCaptureReadbackQueue::Submit(const TSharedPtr<FOmniCaptureAsyncConversion, ESPMode::ThreadSafe>& Conversion, const FOmniCaptureFrameMetadata& Metadata)
+{
+    if (!Conversion.IsValid())
+    {
+        return;
+    }
+
+    FEntry& Entry = InFlight.AddDefaulted_GetRef();
+    Entry.Conversion = Conversion;
+    Entry.Metadata = Metadata;
+}
+
+void FOmniCaptureReadbackQueue::Poll()
+{
+    ResolveOnRenderThread(InFlight.Num(), false);
+}
+
+void FOmniCaptureReadbackQueue::WaitForOldest()
+{
+    if (InFlight.Num() == 0 || InFlight[0].Conversion->IsComplete())
+    {
+        return;
+    }
+
+    ++StallCount;
+    ResolveOnRenderThread(1, true);
+
+    FRenderCommandFence Fence;
+    Fence.BeginFence();
+    Fence.Wait();
+}
+
+void FOmniCaptureReadbackQueue::WaitForAll()
+{
+    if (InFlight.Num() == 0)
+    {
+        return;
+    }
+
+    ResolveOnRenderThread(InFlight.Num(), true);
+
+    FRenderCommandFence Fence;
+    Fence.BeginFence();
+    Fence.Wait();
+}
+
+void FOmniCaptureReadbackQueue::PopCompleted(TFunctionRef<void(FEntry&&)> Sink)
+{
+    int32 CompletedCount = 0;
+    while (CompletedCount < InFlight.Num() && InFlight[CompletedCount].Conversion->IsComplete())
+    {
+        ++CompletedCount;
+    }
+
+    if (CompletedCount == 0)
+    {
+        return;
+    }
+
+    TArray<FEntry> Completed;
+    Completed.Reserve(CompletedCount);
+    for (int32 Index = 0; Index < CompletedCount; ++Index)
+    {
+        Completed.Add(MoveTemp(InFlight[Index]));
+    }
+    InFlight.RemoveAt(0, CompletedCount, EAllowShrinking::No);
+
+    for (FEntry& Entry : Completed)
+    {
+        Sink(MoveTemp(Entry));
+    }
+}
+
+void FOmniCaptureReadbackQueue::ResolveOnRenderThread(int32 Count, bool bWait)
+{
+    TArray<TSharedPtr<FOmniCaptureAsyncConversion, ESPMode::ThreadSafe>> Pending;
+    for (int32 Index = 0; Index < Count && Index < InFlight.Num(); ++Index)
+    {
+        if (!InFlight[Index].Conversion->IsComplete())
+        {
+            Pending.Add(InFlight[Index].Conversion);
+        }
+    }
+
+    if (Pending.Num() == 0)
+    {
+        return;
+    }
+
+    ENQUEUE_RENDER_COMMAND(OmniCaptureResolveReadbacks)([Pending = MoveTemp(Pending), bWait](FRHICommandListImmediate&)
+    {
+        for (const TSharedPtr<FOmniCaptureAsyncConversion, ESPMode::ThreadSafe>& Conversion : Pending)
+        {
+            FOmniCaptureEquirectConverter::ResolveAsyncConversion_RenderThread(*Conversion, bWait);
+        }
+    });
+}
@@ -0,0 +1,549 @@
+#include "OmniCaptureReplay.h"
+
+#include "OmniCaptureCPUSampleMap.h"
+#include "OmniCaptureEquirectConverter.h"
+#include "OmniCaptureFFmpegPipe.h"
+#include "OmniCaptureImageWriter.h"
+#include "OmniCaptureMuxer.h"
+#include "OmniCaptureRingBuffer.h"
+#include "OmniCaptureStageProfiler.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "JsonObjectConverter.h"
+#include "Misc/Paths.h"
+#include "Serialization/Archive.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureReplay, Log, All);
+
+namespace
+{
+    constexpr uint64 GReplayMagic = 0x594C5052494E4D4FULL; // "OMNIRPLY" read as little-endian bytes
+    constexpr uint32 GReplayVersion = 1;
+    // Guard allocations against a corrupt file; well above anything the rig can produce.
+    constexpr int32 GMaxReplayFaceResolution = 16384;
+    constexpr int32 GMaxReplayLayers = 16;
+
+    bool WriteCubemap(FArchive& Archive, const FOmniCaptureCPUCubemap& Cubemap)
+    {
+        if (!Cubemap.IsValid())
+        {
+            return false;
+        }
+
+        uint8 Precision = static_cast<uint8>(Cubemap.Precision);
+        int32 Resolution = Cubemap.Faces[0].Resolution;
+        Archive << Precision << Resolution;
+
+        // Faces are written in their own storage, so half faces go to disk as the texels that were read back.
+        const bool bHalf = Cubemap.Faces[0].IsHalf();
+        for (const FOmniCaptureCPUFace& Face : Cubemap.Faces)
+        {
+            for (int32 Row = 0; Row < Resolution; ++Row)
+            {
+                if (bHalf)
+                {
+                    Archive.Serialize(const_cast<FFloat16Color*>(Face.GetHalfRow(Row)), Resolution * sizeof(FFloat16Color));
+                }
+                else
+                {
+                    Archive.Serialize(const_cast<FLinearColor*>(Face.GetRow(Row)), Resolution * sizeof(FLinearColor));
+                }
+            }
+        }
+        return !Archive.IsError();
+    }
+
+    bool ReadCubemap(FArchive& Archive, FOmniCaptureCPUCubemap& OutCubemap)
+    {
+        uint8 Precision = 0;
+        int32 Resolution = 0;
+        Archive << Precision << Resolution;
+        if (Archive.IsError() || Resolution <= 0 || Resolution > GMaxReplayFaceResolution)
+        {
+            return false;
+        }
+
+        OutCubemap.Precision = static_cast<EOmniCapturePixelPrecision>(Precision);
+        if (OutCubemap.Precision != EOmniCapturePixelPrecision::FullFloat && OutCubemap.Precision != EOmniCapturePixelPrecision::HalfFloat)
+        {
+            return false;
+        }
+
+        for (FOmniCaptureCPUFace& Face : OutCubemap.Faces)
+        {
+            Face.Precision = OutCubemap.Precision;
+            Face.Allocate(Resolution);
+            for (int32 Row = 0; Row < Resolution; ++Row)
+            {
+                if (Face.IsHalf())
+                {
+                    Archive.Serialize(Face.GetHalfRow(Row), Resolution * sizeof(FFloat16Color));
+                }
+                else
+                {
+                    Archive.Serialize(Face.GetRow(Row), Resolution * sizeof(FLinearColor));
+                }
+            }
+        }
+        return !Archive.IsError() && OutCubemap.IsValid();
+    }
+
+    bool ConvertLayer(const FOmniCaptureSettings& Settings, FOmniCaptureReplayLayer& Layer, FOmniCaptureEquirectResult& OutResult)
+    {
+        // Borders are not stored; bilinear taps need them rebuilt from the neighbouring faces.
+        if (Settings.CPUSampling == EOmniCaptureCPUSampling::Bilinear)
+        {
+            Layer.LeftEye.FillSeamBorders();
+            if (Layer.RightEye.IsValid())
+            {
+                Layer.RightEye.FillSeamBorders();
+            }
+        }
+        return FOmniCaptureEquirectConverter::ConvertCubemapsOnCPU(Settings, Layer.LeftEye, Layer.RightEye, OutResult) && OutResult.PixelData.IsValid();
+    }
+
+    FAutoConsoleCommand GReplayCommand(
+        TEXT("OmniCapture.Replay"),
+        TEXT("Replays a .omnireplay recording through conversion and output without rendering. Usage: OmniCapture.Replay <ReplayPath> [OutputDirectory] [Loops]"),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            if (Args.Num() == 0)
+            {
+                UE_LOG(LogOmniCaptureReplay, Warning, TEXT("Usage: OmniCapture.Replay <ReplayPath> [OutputDirectory] [Loops]"));
+                return;
+            }
+
+            FOmniCaptureReplayOptions Options;
+            Options.OutputDirectory = Args.IsValidIndex(1) ? Args[1] : FString();
+            Options.LoopCount = Args.IsValidIndex(2) ? FCString::Atoi(*Args[2]) : 1;
+            FOmniCaptureReplayStats Stats;
+            FOmniCaptureReplayDriver::Run(Args[0], Options, Stats);
+        }));
+}
+
+FOmniCaptureReplayWriter::~FOmniCaptureReplayWriter()
+{
+    Close();
+}
+
+bool FOmniCaptureReplayWriter::Open(const FString& InFilePath, const FOmniCaptureSettings& Settings)
+{
+    Close();
+
+    FString SettingsJson;
+    if (!FJsonObjectConverter::UStructToJsonObjectString(Settings, SettingsJson))
+    {
+        UE_LOG(LogOmniCaptureReplay, Error, TEXT("Failed to serialize capture settings for %s"), *InFilePath);
+        return false;
+    }
+
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(InFilePath), true);
+    Archive.Reset(IFileManager::Get().CreateFileWriter(*InFilePath));
+    if (!Archive.IsValid())
+    {
+        UE_LOG(LogOmniCaptureReplay, Error, TEXT("Failed to create replay file %s"), *InFilePath);
+        return false;
+    }
+
+    uint64 Magic = GReplayMagic;
+    uint32 Version = GReplayVersion;
+    *Archive << Magic << Version << SettingsJson;
+
+    FilePath = InFilePath;
+    FramesWritten = 0;
+    return !Archive->IsError();
+}
+
+bool FOmniCaptureReplayWriter::WriteFrame(const FOmniCaptureReplayFrame& Frame)
+{
+    if (!Archive.IsValid() || Frame.Layers.Num() == 0)
+    {
+        return false;
+    }
+
+    int32 FrameIndex = Frame.FrameIndex;
+    double Timecode = Frame.Timecode;
+    int32 NumLayers = Frame.Layers.Num();
+    *Archive << FrameIndex << Timecode << NumLayers;
+
+    bool bSuccess = true;
+    for (const FOmniCaptureReplayLayer& Layer : Frame.Layers)
+    {
+        uint8 PassType = static_cast<uint8>(Layer.PassType);
+        uint8 bHasRightEye = Layer.RightEye.IsValid() ? 1 : 0;
+        *Archive << PassType << bHasRightEye;
+        bSuccess &= WriteCubemap(*Archive, Layer.LeftEye);
+        if (bHasRightEye)
+        {
+            bSuccess &= WriteCubemap(*Archive, Layer.RightEye);
+        }
+    }
+
+    if (!bSuccess)
+    {
+        // A half-written frame would desynchronize every frame after it, so the recording stops here.
+        UE_LOG(LogOmniCaptureReplay, Error, TEXT("Failed to write frame %d to %s; recording stopped"), Frame.FrameIndex, *FilePath);
+        Close();
+        return false;
+    }
+
+    ++FramesWritten;
+    return true;
+}
+
+void FOmniCaptureReplayWriter::Close()
+{
+    if (Archive.IsValid())
+    {
+        Archive->Close();
+        Archive.Reset();
+        UE_LOG(LogOmniCaptureReplay, Log, TEXT("Replay recording with %d frames written to %s"), FramesWritten, *FilePath);
+    }
+}
+
+bool FOmniCaptureReplayReader::Open(const FString& InFilePath)
+{
+    Archive.Reset(IFileManager::Get().CreateFileReader(*InFilePath));
+    if (!Archive.IsValid())
+    {
+        UE_LOG(LogOmniCaptureReplay, Error, TEXT("Failed to open replay file %s"), *InFilePath);
+        return false;
+    }
+
+    uint64 Magic = 0;
+    uint32 Version = 0;
+    FString SettingsJson;
+    *Archive << Magic << Version;
+    if (Magic != GReplayMagic || Version != GReplayVersion)
+    {
+        UE_LOG(LogOmniCaptureReplay, Error, TEXT("%s is not a version %u OmniCapture replay"), *InFilePath, GReplayVersion);
+        Archive.Reset();
+        return false;
+    }
+
+    *Archive << SettingsJson;
+    Settings = FOmniCaptureSettings();
+    if (Archive->IsError() || !FJsonObjectConverter::JsonObjectStringToUStruct(SettingsJson, &Settings))
+    {
+        UE_LOG(LogOmniCaptureReplay, Error, TEXT("Failed to read the capture settings from %s"), *InFilePath);
+        Archive.Reset();
+        return false;
+    }
+
+    FirstFrameOffset = Archive->Tell();
+    return true;
+}
+
+bool FOmniCaptureReplayReader::ReadFrame(FOmniCaptureReplayFrame& OutFrame)
+{
+    if (!Archive.IsValid() || Archive->Tell() >= Archive->TotalSize())
+    {
+        return false;
+    }
+
+    int32 NumLayers = 0;
+    *Archive << OutFrame.FrameIndex << OutFrame.Timecode << NumLayers;
+    if (Archive->IsError() || NumLayers <= 0 || NumLayers > GMaxReplayLayers)
+    {
+        return false;
+    }
+
+    OutFrame.Layers.SetNum(NumLayers);
+    for (FOmniCaptureReplayLayer& Layer : OutFrame.Layers)
+    {
+        uint8 PassType = 0;
+        uint8 bHasRightEye = 0;
+        *Archive << PassType << bHasRightEye;
+        Layer.PassType = static_cast<EOmniCaptureAuxiliaryPassType>(PassType);
+        if (!ReadCubemap(*Archive, Layer.LeftEye))
+        {
+            return false;
+        }
+
+        Layer.RightEye = FOmniCaptureCPUCubemap();
+        if (bHasRightEye && !ReadCubemap(*Archive, Layer.RightEye))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FOmniCaptureReplayReader::Rewind()
+{
+    if (Archive.IsValid())
+    {
+        Archive->Seek(FirstFrameOffset);
+    }
+}
+
+FString FOmniCaptureReplayDriver::GetReplayPath(const FString& Directory, const FString& BaseName)
+{
+    return Directory / (BaseName + TEXT(".omnireplay"));
+}
+
+bool FOmniCaptureReplayDriver::Run(const FString& ReplayPath, const FOmniCaptureReplayOptions& Options, FOmniCaptureReplayStats& OutStats, const FOmniCaptureSettings* SettingsOverride)
+{
+    OutStats = FOmniCaptureReplayStats();
+
+    FOmniCaptureReplayReader Reader;
+    if (!Reader.Open(ReplayPath))
+    {
+        return false;
+    }
+
+    FOmniCaptureSettings Settings = SettingsOverride ? *SettingsOverride : Reader.GetSettings();
+    Settings.OutputDirectory = Options.OutputDirectory.IsEmpty() ? FPaths::GetPath(ReplayPath) / TEXT("Replay") : Options.OutputDirectory;
+    if (Settings.OutputFileName.IsEmpty())
+    {
+        Settings.OutputFileName = FPaths::GetBaseFilename(ReplayPath);
+    }
+    Settings.bRecordAudio = false;
+    Settings.ReplayRecordFrameCount = 0;
+
+    if (Settings.IsPlanar())
+    {
+        UE_LOG(LogOmniCaptureReplay, Error, TEXT("Planar captures have no cube faces to replay (%s)"), *ReplayPath);
+        return false;
+    }
+
+    if (Settings.OutputFormat == EOmniOutputFormat::NVENCHardware)
+    {
+        // NVENC needs the GPU textures the replay never creates; the CPU frames go to the image writer instead.
+        UE_LOG(LogOmniCaptureReplay, Log, TEXT("Replaying an NVENC take as an image sequence"));
+        Settings.OutputFormat = EOmniOutputFormat::ImageSequence;
+    }
+
+    TArray<FOmniCaptureReplayFrame> PreloadedFrames;
+    if (Options.bPreloadFrames)
+    {
+        FOmniCaptureReplayFrame Frame;
+        while (Reader.ReadFrame(Frame))
+        {
+            PreloadedFrames.Add(MoveTemp(Frame));
+        }
+    }
+
+    int32 PreloadedCursor = 0;
+    auto NextFrame = [&](FOmniCaptureReplayFrame& OutFrame)
+    {
+        if (!Options.bPreloadFrames)
+        {
+            return Reader.ReadFrame(OutFrame);
+        }
+        if (!PreloadedFrames.IsValidIndex(PreloadedCursor))
+        {
+            return false;
+        }
+        // Conversion fills face borders in place, so each loop works on a copy.
+        OutFrame = PreloadedFrames[PreloadedCursor++];
+        return true;
+    };
+
+    // Build the sample map before the clock starts, as BeginCapture does for live takes.
+    {
+        FOmniCaptureReplayFrame FirstFrame;
+        if (!NextFrame(FirstFrame))
+        {
+            UE_LOG(LogOmniCaptureReplay, Error, TEXT("%s holds no readable frames"), *ReplayPath);
+            return false;
+        }
+        if (Settings.Mode == EOmniCaptureMode::Stereo && !FirstFrame.Layers[0].RightEye.IsValid())
+        {
+            UE_LOG(LogOmniCaptureReplay, Error, TEXT("%s holds mono frames but the replay settings ask for stereo"), *ReplayPath);
+            return false;
+        }
+        FOmniCaptureCPUSampleMap::GetOrBuild(Settings, FirstFrame.Layers[0].LeftEye.Faces[0].Resolution);
+    }
+
+    const TSharedPtr<FOmniCaptureStageProfiler, ESPMode::ThreadSafe> Profiler = MakeShared<FOmniCaptureStageProfiler, ESPMode::ThreadSafe>(Settings.StageTraceFormat != EOmniCaptureTraceFormat::None);
+
+    TUniquePtr<FOmniCaptureImageWriter> ImageWriter;
+    TUniquePtr<FOmniCaptureFFmpegPipe> FFmpegPipe;
+    if (Settings.OutputFormat == EOmniOutputFormat::FFmpegPipe)
+    {
+        FFmpegPipe = MakeUnique<FOmniCaptureFFmpegPipe>();
+        if (!FFmpegPipe->Initialize(Settings, Settings.OutputDirectory, false))
+        {
+            UE_LOG(LogOmniCaptureReplay, Error, TEXT("FFmpeg pipe failed to start for the replay: %s"), *FFmpegPipe->GetLastError());
+            return false;
+        }
+    }
+    else
+    {
+        ImageWriter = MakeUnique<FOmniCaptureImageWriter>();
+        ImageWriter->Initialize(Settings, Settings.OutputDirectory);
+        ImageWriter->SetStageProfiler(Profiler);
+    }
+
+    FOmniCaptureMuxer Muxer;
+    Muxer.Initialize(Settings, Settings.OutputDirectory);
+    Muxer.BeginRealtimeSession(Settings);
+
+    const FString Extension = Settings.GetImageFileExtension();
+    FOmniCaptureRingBuffer RingBuffer;
+    RingBuffer.Initialize(Settings, [&](TUniquePtr<FOmniCaptureFrame>&& Frame)
+    {
+        if (!Frame.IsValid())
+        {
+            return;
+        }
+
+        const int32 FrameIndex = Frame->Metadata.FrameIndex;
+        const double PickupTime = FPlatformTime::Seconds();
+        Profiler->Record(FrameIndex, EOmniCaptureStage::RingBuffer, Frame->Metadata.StageTimestamps.GetBeginSeconds(EOmniCaptureStage::RingBuffer), PickupTime);
+
+        OMNICAPTURE_STAGE_SCOPE(Encode);
+        if (FFmpegPipe)
+        {
+            FFmpegPipe->EnqueueFrame(*Frame);
+        }
+        else
+        {
+            ImageWriter->EnqueueFrame(MoveTemp(Frame), FString::Printf(TEXT("%s_%06d%s"), *Settings.OutputFileName, FrameIndex, *Extension));
+        }
+        Profiler->Record(FrameIndex, EOmniCaptureStage::Encode, PickupTime, FPlatformTime::Seconds());
+    },
+    [&Muxer](const FOmniCaptureFrame& CommittedFrame)
+    {
+        Muxer.PushFrame(CommittedFrame);
+    });
+
+    const double FrameInterval = 1.0 / FMath::Max(1.0f, Settings.TargetFrameRate);
+    const int32 LoopCount = FMath::Max(1, Options.LoopCount);
+    TArray<FOmniCaptureFrameMetadata> SubmittedFrames;
+    int32 FrameCounter = 0;
+    double TimecodeOffset = 0.0;
+    const double StartTime = FPlatformTime::Seconds();
+
+    for (int32 Loop = 0; Loop < LoopCount; ++Loop)
+    {
+        Reader.Rewind();
+        PreloadedCursor = 0;
+        double LastTimecode = 0.0;
+
+        FOmniCaptureReplayFrame ReplayFrame;
+        double StageBegin = FPlatformTime::Seconds();
+        while (NextFrame(ReplayFrame))
+        {
+            FOmniCaptureStageTimestamps Timestamps;
+            const double ReadEnd = FPlatformTime::Seconds();
+            if (!Options.bPreloadFrames)
+            {
+                // The file read stands in for the GPU readback of a live capture.
+                Timestamps.Record(EOmniCaptureStage::Readback, StageBegin, ReadEnd);
+            }
+            StageBegin = ReadEnd;
+
+            FOmniCaptureReplayLayer& ColorLayer = ReplayFrame.Layers[0];
+            FOmniCaptureEquirectResult ConversionResult;
+            bool bConverted = false;
+            {
+                OMNICAPTURE_STAGE_SCOPE(Conversion);
+                bConverted = ConvertLayer(Settings, ColorLayer, ConversionResult);
+            }
+            const double ConversionEnd = FPlatformTime::Seconds();
+            Timestamps.Record(EOmniCaptureStage::Conversion, StageBegin, ConversionEnd);
+
+            TMap<FName, FOmniCaptureLayerPayload> AuxiliaryLayers;
+            if (ReplayFrame.Layers.Num() > 1)
+            {
+                OMNICAPTURE_STAGE_SCOPE(AuxiliaryPasses);
+                for (int32 LayerIndex = 1; LayerIndex < ReplayFrame.Layers.Num(); ++LayerIndex)
+                {
+                    FOmniCaptureReplayLayer& Layer = ReplayFrame.Layers[LayerIndex];
+                    FOmniCaptureEquirectResult AuxResult;
+                    if (Settings.AuxiliaryPasses.Contains(Layer.PassType) && ConvertLayer(Settings, Layer, AuxResult))
+                    {
+                        FOmniCaptureLayerPayload Payload;
+                        Payload.PixelData = MoveTemp(AuxResult.PixelData);
+                        Payload.bLinear = AuxResult.bIsLinear;
+                        Payload.Precision = AuxResult.PixelPrecision;
+                        Payload.PixelDataType = AuxResult.PixelDataType;
+                        AuxiliaryLayers.Add(GetAuxiliaryLayerName(Layer.PassType), MoveTemp(Payload));
+                    }
+                }
+                Timestamps.Record(EOmniCaptureStage::AuxiliaryPasses, ConversionEnd, FPlatformTime::Seconds());
+            }
+
+            LastTimecode = ReplayFrame.Timecode;
+            if (!bConverted)
+            {
+                ++OutStats.DroppedFrames;
+                StageBegin = FPlatformTime::Seconds();
+                continue;
+            }
+
+            TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
+            Frame->Metadata.FrameIndex = FrameCounter++;
+            Frame->Metadata.Timecode = TimecodeOffset + ReplayFrame.Timecode;
+            Frame->Metadata.bKeyFrame = (Frame->Metadata.FrameIndex % FMath::Max(1, Settings.Quality.GOPLength)) == 0;
+            Frame->Metadata.StageTimestamps = Timestamps;
+            Frame->PixelData = MoveTemp(ConversionResult.PixelData);
+            Frame->bLinearColor = ConversionResult.bIsLinear;
+            Frame->bUsedCPUFallback = true;
+            Frame->PixelPrecision = ConversionResult.PixelPrecision;
+            Frame->PixelDataType = ConversionResult.PixelDataType;
+            Frame->AuxiliaryLayers = MoveTemp(AuxiliaryLayers);
+            Profiler->RecordFrame(Frame->Metadata);
+            SubmittedFrames.Add(Frame->Metadata);
+
+            const double EnqueueTime = FPlatformTime::Seconds();
+            Frame->Metadata.StageTimestamps.Record(EOmniCaptureStage::RingBuffer, EnqueueTime, EnqueueTime);
+            {
+                OMNICAPTURE_STAGE_SCOPE(RingEnqueue);
+                RingBuffer.Enqueue(MoveTemp(Frame));
+            }
+
+            StageBegin = FPlatformTime::Seconds();
+        }
+
+        TimecodeOffset += LastTimecode + FrameInterval;
+    }
+
+    RingBuffer.Flush();
+    const int32 RingDroppedFrames = RingBuffer.GetStats().DroppedFrames;
+
+    bool bWritten = true;
+    FString VideoPath;
+    TArray<FOmniCaptureFrameMetadata> WrittenFrames;
+    if (ImageWriter)
+    {
+        ImageWriter->WaitForPendingWrites();
+        WrittenFrames = ImageWriter->ConsumeCapturedFrames();
+        ImageWriter->Flush();
+    }
+    else
+    {
+        bWritten = FFmpegPipe->Finalize();
+        VideoPath = FFmpegPipe->GetOutputFilePath();
+        WrittenFrames = MoveTemp(SubmittedFrames);
+    }
+
+    // Final muxing is an offline step after a live take too, so it is left out of the throughput figure.
+    OutStats.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+    OutStats.DroppedFrames += RingDroppedFrames;
+    OutStats.FramesReplayed = FrameCounter - RingDroppedFrames;
+    OutStats.FramesPerSecond = OutStats.FramesReplayed / FMath::Max(OutStats.ElapsedSeconds, KINDA_SMALL_NUMBER);
+    OutStats.StageLatencies = Profiler->GetLatencies();
+
+    Muxer.EndRealtimeSession();
+    OutStats.bMuxed = Muxer.FinalizeCapture(Settings, WrittenFrames, FString(), VideoPath, OutStats.DroppedFrames);
+
+    if (Settings.StageTraceFormat != EOmniCaptureTraceFormat::None)
+    {
+        const TCHAR* TraceSuffix = Settings.StageTraceFormat == EOmniCaptureTraceFormat::CSV ? TEXT("_StageTrace.csv") : TEXT("_StageTrace.json");
+        Profiler->ExportTrace(Settings.OutputDirectory / (Settings.OutputFileName + TraceSuffix), Settings.StageTraceFormat);
+    }
+
+    UE_LOG(LogOmniCaptureReplay, Log, TEXT("Replayed %d frames (%d dropped) from %s in %.3fs: %.2f fps"), OutStats.FramesReplayed, OutStats.DroppedFrames, *ReplayPath, OutStats.ElapsedSeconds, OutStats.FramesPerSecond);
+    for (const FOmniCaptureStageLatency& Latency : OutStats.StageLatencies)
+    {
+        if (Latency.SampleCount > 0)
+        {
+            UE_LOG(LogOmniCaptureReplay, Log, TEXT("  %-16s p50 %.2fms p95 %.2fms p99 %.2fms max %.2fms"), FOmniCaptureStageProfiler::GetStageName(Latency.Stage), Latency.P50Ms, Latency.P95Ms, Latency.P99Ms, Latency.MaxMs);
+        }
+    }
+
+    return bWritten && OutStats.FramesReplayed > 0;
+}
@@ -216,6 +216,12 @@ void AOmniCaptureRigActor::BuildEyeRig(EOmniCaptureEye Eye, float IPDHalfCm, int
     }
 }
 
+int32 AOmniCaptureRigActor::GetFaceResolution() const
+{
+    const USceneCaptureComponent2D* FirstFace = LeftEyeCaptures.Num() > 0 ? LeftEyeCaptures[0] : nullptr;
+    return FirstFace && FirstFace->TextureTarget ? FirstFace->TextureTarget->SizeX : 0;
+}
+
 void AOmniCaptureRigActor::UpdateStereoParameters(float NewIPDCm, float NewConvergenceDistanceCm)
 {
     if (CachedSettings.Mode != EOmniCaptureMode::Stereo)
@@ -3,74 +3,62 @@
 #include "HAL/PlatformProcess.h"
 #include "HAL/Runnable.h"
 #include "HAL/RunnableThread.h"
+#include "Misc/ScopeLock.h"
 #include "Math/UnrealMathUtility.h"
 
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureRingBuffer, Log, All);
+
+namespace
+{
+    // Slot count used when RingBufferCapacity is 0, which used to mean unbounded; the ring is always pre-allocated now.
+    constexpr int32 GDefaultRingSlotCount = 64;
+    constexpr uint32 GBlockedProducerWaitMs = 100;
+    constexpr uint32 GFlushWaitMs = 10;
+    constexpr int32 GMaxRingWorkers = 16;
+}
+
 class FOmniCaptureRingBufferWorker final : public FRunnable
 {
 public:
-    FOmniCaptureRingBufferWorker(TQueue<TUniquePtr<FOmniCaptureFrame>, EQueueMode::Mpsc>& InQueue, FEvent* InEvent, const TFunction<void(TUniquePtr<FOmniCaptureFrame>&&)>& InConsumer, FCriticalSection& InQueueCS, TAtomic<bool>& InRunning, TAtomic<int32>& InPending)
-        : Queue(InQueue)
-        , DataEvent(InEvent)
-        , Consumer(InConsumer)
-        , QueueCS(InQueueCS)
-        , bRunning(InRunning)
-        , Pending(InPending)
+    explicit FOmniCaptureRingBufferWorker(FOmniCaptureRingBuffer& InOwner)
+        : Owner(InOwner)
+        , DataEvent(FPlatformProcess::GetSynchEventFromPool())
     {
     }
 
+    virtual ~FOmniCaptureRingBufferWorker() override
+    {
+        FPlatformProcess::ReturnSynchEventToPool(DataEvent);
+        DataEvent = nullptr;
+    }
+
+    void Wake()
+    {
+        DataEvent->Trigger();
+    }
+
     virtual uint32 Run() override
     {
-        while (bRunning.Load())
+        while (Owner.bRunning.Load())
         {
             DataEvent->Wait();
 
-            if (!bRunning.Load())
+            if (!Owner.bRunning.Load())
             {
                 break;
             }
 
-            Drain();
+            Owner.Drain();
         }
 
-        Drain();
+        Owner.Drain();
 
         return 0;
     }
 
 private:
-    void Drain()
-    {
-        if (!Consumer)
-        {
-            return;
-        }
-
-        for (;;)
-        {
-            TUniquePtr<FOmniCaptureFrame> Frame;
-            {
-                FScopeLock Lock(&QueueCS);
-                if (!Queue.Dequeue(Frame))
-                {
-                    break;
-                }
-            }
-
-            if (Frame.IsValid())
-            {
-                Consumer(MoveTemp(Frame));
-                Pending.DecrementExchange();
-            }
-        }
-    }
-
-private:
-    TQueue<TUniquePtr<FOmniCaptureFrame>, EQueueMode::Mpsc>& Queue;
+    FOmniCaptureRingBuffer& Owner;
     FEvent* DataEvent = nullptr;
-    TFunction<void(TUniquePtr<FOmniCaptureFrame>&&)> Consumer;
-    FCriticalSection& QueueCS;
-    TAtomic<bool>& bRunning;
-    TAtomic<int32>& Pending;
 };
 
 FOmniCaptureRingBuffer::FOmniCaptureRingBuffer()
@@ -86,72 +74,152 @@ FOmniCaptureRingBuffer::~FOmniCaptureRingBuffer()
     StopWorker();
     Flush();
 
-    if (DataEvent)
+    if (SpaceEvent)
     {
-        FPlatformProcess::ReturnSynchEventToPool(DataEvent);
-        DataEvent = nullptr;
+        FPlatformProcess::ReturnSynchEventToPool(SpaceEvent);
+        SpaceEvent = nullptr;
+    }
+    if (IdleEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(IdleEvent);
+        IdleEvent = nullptr;
     }
 }
 
-void FOmniCaptureRingBuffer::Initialize(const FOmniCaptureSettings& Settings, const TFunction<void(TUniquePtr<FOmniCaptureFrame>&&)>& InConsumer)
+void FOmniCaptureRingBuffer::Initialize(const FOmniCaptureSettings& Settings, const TFunction<void(TUniquePtr<FOmniCaptureFrame>&&)>& InConsumer, const TFunction<void(const FOmniCaptureFrame&)>& InCommit)
 {
     Consumer = InConsumer;
+    Commit = InCommit;
     Capacity = FMath::Max(0, Settings.RingBufferCapacity);
     Policy = Settings.RingBufferPolicy;
+
+    // The encoders consume frames as a stream, so they keep a single worker regardless of the setting.
+    WorkerCount = (Settings.OutputFormat == EOmniOutputFormat::NVENCHardware || Settings.OutputFormat == EOmniOutputFormat::FFmpegPipe)
+        ? 1
+        : FMath::Clamp(Settings.RingBufferWorkerCount, 1, GMaxRingWorkers);
+
+    if (Capacity == 0)
+    {
+        UE_LOG(LogOmniCaptureRingBuffer, Warning, TEXT("RingBufferCapacity 0 no longer means unbounded; using %d slots with the %s policy."),
+            GDefaultRingSlotCount, Policy == EOmniCaptureRingBufferPolicy::DropOldest ? TEXT("DropOldest") : TEXT("BlockProducer"));
+    }
+    SlotCount = static_cast<uint64>(Capacity > 0 ? Capacity : GDefaultRingSlotCount);
+    Slots = MakeUnique<FSlot[]>(SlotCount);
+    for (uint64 Index = 0; Index < SlotCount; ++Index)
+    {
+        Slots[Index].Sequence.store(Index, std::memory_order_relaxed);
+    }
+    WriteIndex.store(0, std::memory_order_relaxed);
+    ReadIndex.store(0, std::memory_order_relaxed);
+
+    {
+        FScopeLock Lock(&CommitCS);
+        PendingCommits.Reset();
+        NextCommitPosition = 0;
+    }
+
     StartWorker();
 }
 
-void FOmniCaptureRingBuffer::Enqueue(TUniquePtr<FOmniCaptureFrame>&& Frame)
+bool FOmniCaptureRingBuffer::TryPush(TUniquePtr<FOmniCaptureFrame>& Frame)
 {
-    if (!Consumer)
+    // Only the capture thread pushes, so the write index needs no CAS.
+    const uint64 Position = WriteIndex.load(std::memory_order_relaxed);
+    FSlot& Slot = Slots[Position % SlotCount];
+    if (Slot.Sequence.load(std::memory_order_acquire) != Position)
     {
-        return;
+        return false;
     }
 
-    if (Capacity > 0)
+    Slot.Frame = MoveTemp(Frame);
+    Slot.Sequence.store(Position + 1, std::memory_order_release);
+    WriteIndex.store(Position + 1, std::memory_order_relaxed);
+    return true;
+}
+
+bool FOmniCaptureRingBuffer::TryPop(TUniquePtr<FOmniCaptureFrame>& OutFrame, uint64& OutPosition)
+{
+    if (!Slots.IsValid())
     {
-        for (;;)
+        return false;
+    }
+
+    uint64 Position = ReadIndex.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        FSlot& Slot = Slots[Position % SlotCount];
+        const uint64 Sequence = Slot.Sequence.load(std::memory_order_acquire);
+        const int64 Difference = static_cast<int64>(Sequence) - static_cast<int64>(Position + 1);
+
+        if (Difference == 0)
         {
-            const int32 Current = PendingCount.Load();
-            if (Current < Capacity)
+            if (ReadIndex.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
             {
-                break;
+                OutFrame = MoveTemp(Slot.Frame);
+                OutPosition = Position;
+                Slot.Sequence.store(Position + SlotCount, std::memory_order_release);
+                return true;
             }
+        }
+        else if (Difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            Position = ReadIndex.load(std::memory_order_relaxed);
+        }
+    }
+}
 
-            if (Policy == EOmniCaptureRingBufferPolicy::DropOldest)
+void FOmniCaptureRingBuffer::Enqueue(TUniquePtr<FOmniCaptureFrame>&& Frame)
+{
+    if (!Consumer || !Slots.IsValid())
+    {
+        return;
+    }
+
+    bool bCountedBlock = false;
+    while (!TryPush(Frame))
+    {
+        if (Policy == EOmniCaptureRingBufferPolicy::DropOldest)
+        {
+            TUniquePtr<FOmniCaptureFrame> Discarded;
+            uint64 DiscardedPosition = 0;
+            if (TryPop(Discarded, DiscardedPosition))
             {
-                TUniquePtr<FOmniCaptureFrame> Discarded;
-                {
-                    FScopeLock Lock(&QueueCriticalSection);
-                    if (Queue.Dequeue(Discarded))
-                    {
-                        PendingCount.DecrementExchange();
-                    }
-                }
+                CommitInOrder(DiscardedPosition, nullptr);
+                ReleasePending();
                 DroppedCount.IncrementExchange();
-                break;
-            }
-            else
-            {
-                BlockedCount.IncrementExchange();
-                FPlatformProcess::Sleep(0.001f);
             }
+            continue;
         }
-    }
 
-    {
-        FScopeLock Lock(&QueueCriticalSection);
-        Queue.Enqueue(MoveTemp(Frame));
-        PendingCount.IncrementExchange();
+        if (!bCountedBlock)
+        {
+            BlockedCount.IncrementExchange();
+            bCountedBlock = true;
+        }
+
+        if (!bRunning.Load())
+        {
+            Drain();
+            continue;
+        }
+
+        SpaceEvent->Wait(GBlockedProducerWaitMs);
     }
 
-    if (DataEvent)
+    PendingCount.IncrementExchange();
+
+    if (Workers.Num() > 0)
     {
-        DataEvent->Trigger();
+        // Round-robin wake-ups spread bursts across workers; whichever worker wakes drains everything available.
+        Workers[NextWorkerToWake++ % Workers.Num()]->Wake();
     }
 }
 
-void FOmniCaptureRingBuffer::Flush()
+void FOmniCaptureRingBuffer::Drain()
 {
     if (!Consumer)
     {
@@ -159,57 +227,132 @@ void FOmniCaptureRingBuffer::Flush()
     }
 
     TUniquePtr<FOmniCaptureFrame> Frame;
-    for (;;)
+    uint64 Position = 0;
+    while (TryPop(Frame, Position))
     {
+        if (SpaceEvent)
         {
-            FScopeLock Lock(&QueueCriticalSection);
-            if (!Queue.Dequeue(Frame))
-            {
-                break;
-            }
+            SpaceEvent->Trigger();
         }
 
+        TUniquePtr<FOmniCaptureFrame> CommitRecord;
         if (Frame.IsValid())
         {
+            if (Commit)
+            {
+                CommitRecord = MakeUnique<FOmniCaptureFrame>();
+                CommitRecord->Metadata = Frame->Metadata;
+                CommitRecord->AudioPackets = MoveTemp(Frame->AudioPackets);
+            }
             Consumer(MoveTemp(Frame));
-            PendingCount.DecrementExchange();
+        }
+
+        CommitInOrder(Position, MoveTemp(CommitRecord));
+        ReleasePending();
+    }
+}
+
+void FOmniCaptureRingBuffer::ReleasePending()
+{
+    if (PendingCount.DecrementExchange() == 1 && IdleEvent)
+    {
+        IdleEvent->Trigger();
+    }
+}
+
+void FOmniCaptureRingBuffer::CommitInOrder(uint64 Position, TUniquePtr<FOmniCaptureFrame>&& CommitRecord)
+{
+    if (!Commit)
+    {
+        return;
+    }
+
+    FScopeLock Lock(&CommitCS);
+    PendingCommits.Add(Position, MoveTemp(CommitRecord));
+
+    TUniquePtr<FOmniCaptureFrame> Ready;
+    while (PendingCommits.RemoveAndCopyValue(NextCommitPosition, Ready))
+    {
+        ++NextCommitPosition;
+        if (Ready.IsValid())
+        {
+            Commit(*Ready);
         }
     }
 }
 
+void FOmniCaptureRingBuffer::Flush()
+{
+    Drain();
+
+    // Workers may still be inside Consumer or CommitInOrder for frames they popped before the drain above; the
+    // caller is about to hand the writers those frames use to finalization, so wait them out. The timeout only
+    // covers a trigger that lands between the check and the wait.
+    while (PendingCount.Load() > 0)
+    {
+        if (IdleEvent)
+        {
+            IdleEvent->Wait(GFlushWaitMs);
+        }
+        else
+        {
+            FPlatformProcess::SleepNoStats(GFlushWaitMs / 1000.0f);
+        }
+        Drain();
+    }
+}
+
 void FOmniCaptureRingBuffer::StartWorker()
 {
-    if (WorkerThread.IsValid())
+    if (WorkerThreads.Num() > 0)
     {
         return;
     }
 
-    DataEvent = FPlatformProcess::GetSynchEventFromPool();
+    if (!SpaceEvent)
+    {
+        SpaceEvent = FPlatformProcess::GetSynchEventFromPool();
+        IdleEvent = FPlatformProcess::GetSynchEventFromPool();
+    }
     bRunning = true;
 
-    Worker = new FOmniCaptureRingBufferWorker(Queue, DataEvent, Consumer, QueueCriticalSection, bRunning, PendingCount);
-    WorkerThread.Reset(FRunnableThread::Create(Worker, TEXT("OmniCaptureRingBuffer")));
+    for (int32 WorkerIndex = 0; WorkerIndex < WorkerCount; ++WorkerIndex)
+    {
+        FOmniCaptureRingBufferWorker* Worker = new FOmniCaptureRingBufferWorker(*this);
+        const FString ThreadName = WorkerIndex == 0 ? FString(TEXT("OmniCaptureRingBuffer")) : FString::Printf(TEXT("OmniCaptureRingBuffer%d"), WorkerIndex);
+        Workers.Add(Worker);
+        WorkerThreads.Emplace(FRunnableThread::Create(Worker, *ThreadName));
+    }
 }
 
 void FOmniCaptureRingBuffer::StopWorker()
 {
-    if (!WorkerThread.IsValid())
+    if (WorkerThreads.Num() == 0)
     {
         return;
     }
 
     bRunning = false;
 
-    if (DataEvent)
+    for (FOmniCaptureRingBufferWorker* Worker : Workers)
     {
-        DataEvent->Trigger();
+        Worker->Wake();
     }
 
-    WorkerThread->WaitForCompletion();
-    WorkerThread.Reset();
+    for (TUniquePtr<FRunnableThread>& WorkerThread : WorkerThreads)
+    {
+        if (WorkerThread.IsValid())
+        {
+            WorkerThread->WaitForCompletion();
+        }
+    }
+    WorkerThreads.Reset();
 
-    delete Worker;
-    Worker = nullptr;
+    for (FOmniCaptureRingBufferWorker* Worker : Workers)
+    {
+        delete Worker;
+    }
+    Workers.Reset();
 }
 
 FOmniCaptureRingBufferStats FOmniCaptureRingBuffer::GetStats() const
@@ -220,4 +363,3 @@ FOmniCaptureRingBufferStats FOmniCaptureRingBuffer::GetStats() const
     Stats.BlockedPushes = BlockedCount.Load();
     return Stats;
 }
-
@@ -0,0 +1,213 @@
+#include "OmniCaptureStageProfiler.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTLS.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/Archive.h"
+
+DEFINE_STAT(STAT_OmniCapture_SceneCapture);
+DEFINE_STAT(STAT_OmniCapture_RenderFlush);
+DEFINE_STAT(STAT_OmniCapture_Conversion);
+DEFINE_STAT(STAT_OmniCapture_AuxiliaryPasses);
+DEFINE_STAT(STAT_OmniCapture_RingEnqueue);
+DEFINE_STAT(STAT_OmniCapture_Encode);
+DEFINE_STAT(STAT_OmniCapture_DiskWrite);
+
+UE_TRACE_CHANNEL_DEFINE(OmniCaptureChannel);
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureProfiler, Log, All);
+
+namespace
+{
+    // Export text is flushed to disk in pieces so an hour-long take never sits in memory twice.
+    constexpr int32 GExportFlushChars = 1 << 20;
+
+    float NearestRank(const TArray<float>& Sorted, float Percentile)
+    {
+        const int32 Rank = FMath::CeilToInt(Percentile * Sorted.Num());
+        return Sorted[FMath::Clamp(Rank - 1, 0, Sorted.Num() - 1)];
+    }
+
+    void FlushText(FArchive& Archive, FString& Text)
+    {
+        FTCHARToUTF8 Utf8(*Text, Text.Len());
+        Archive.Serialize(const_cast<void*>(static_cast<const void*>(Utf8.Get())), Utf8.Length());
+        Text.Reset();
+    }
+}
+
+FOmniCaptureStageProfiler::FOmniCaptureStageProfiler(bool bInKeepTrace, int32 InWindowSize)
+    : WindowSize(FMath::Max(1, InWindowSize))
+    , bKeepTrace(bInKeepTrace)
+{
+    for (FWindow& Window : Windows)
+    {
+        Window.DurationsMs.Reserve(WindowSize);
+    }
+}
+
+void FOmniCaptureStageProfiler::Record(int32 FrameIndex, EOmniCaptureStage Stage, double BeginSeconds, double EndSeconds)
+{
+    const uint32 ThreadId = FPlatformTLS::GetCurrentThreadId();
+    FScopeLock Lock(&CS);
+    RecordLocked(FrameIndex, Stage, BeginSeconds, EndSeconds, ThreadId);
+}
+
+void FOmniCaptureStageProfiler::RecordFrame(const FOmniCaptureFrameMetadata& Metadata)
+{
+    const FOmniCaptureStageTimestamps& Timestamps = Metadata.StageTimestamps;
+    FScopeLock Lock(&CS);
+    for (int32 Index = 0; Index < FOmniCaptureStageTimestamps::NumStages; ++Index)
+    {
+        const EOmniCaptureStage Stage = static_cast<EOmniCaptureStage>(Index);
+        if (Timestamps.HasStage(Stage))
+        {
+            RecordLocked(Metadata.FrameIndex, Stage, Timestamps.GetBeginSeconds(Stage), Timestamps.GetEndSeconds(Stage), Timestamps.GetThreadId(Stage));
+        }
+    }
+}
+
+void FOmniCaptureStageProfiler::RecordLocked(int32 FrameIndex, EOmniCaptureStage Stage, double BeginSeconds, double EndSeconds, uint32 ThreadId)
+{
+    FWindow& Window = Windows[static_cast<int32>(Stage)];
+    const float DurationMs = static_cast<float>(FMath::Max(0.0, EndSeconds - BeginSeconds) * 1000.0);
+    if (Window.DurationsMs.Num() < WindowSize)
+    {
+        Window.DurationsMs.Add(DurationMs);
+    }
+    else
+    {
+        Window.DurationsMs[Window.NextSlot] = DurationMs;
+    }
+    Window.NextSlot = (Window.NextSlot + 1) % WindowSize;
+
+    if (bKeepTrace)
+    {
+        FRecord& Entry = Records.AddDefaulted_GetRef();
+        Entry.BeginSeconds = BeginSeconds;
+        Entry.EndSeconds = EndSeconds;
+        Entry.FrameIndex = FrameIndex;
+        Entry.ThreadId = ThreadId;
+        Entry.Stage = Stage;
+    }
+}
+
+FOmniCaptureStageLatency FOmniCaptureStageProfiler::GetLatency(EOmniCaptureStage Stage) const
+{
+    FOmniCaptureStageLatency Latency;
+    Latency.Stage = Stage;
+
+    TArray<float> Sorted;
+    {
+        FScopeLock Lock(&CS);
+        Sorted = Windows[static_cast<int32>(Stage)].DurationsMs;
+    }
+
+    if (Sorted.Num() == 0)
+    {
+        return Latency;
+    }
+
+    Sorted.Sort();
+    Latency.SampleCount = Sorted.Num();
+    Latency.P50Ms = NearestRank(Sorted, 0.50f);
+    Latency.P95Ms = NearestRank(Sorted, 0.95f);
+    Latency.P99Ms = NearestRank(Sorted, 0.99f);
+    Latency.MaxMs = Sorted.Last();
+    return Latency;
+}
+
+TArray<FOmniCaptureStageLatency> FOmniCaptureStageProfiler::GetLatencies() const
+{
+    TArray<FOmniCaptureStageLatency> Latencies;
+    for (int32 Index = 0; Index < FOmniCaptureStageTimestamps::NumStages; ++Index)
+    {
+        Latencies.Add(GetLatency(static_cast<EOmniCaptureStage>(Index)));
+    }
+    return Latencies;
+}
+
+int32 FOmniCaptureStageProfiler::GetTraceRecordCount() const
+{
+    FScopeLock Lock(&CS);
+    return Records.Num();
+}
+
+bool FOmniCaptureStageProfiler::ExportTrace(const FString& FilePath, EOmniCaptureTraceFormat Format) const
+{
+    if (Format == EOmniCaptureTraceFormat::None)
+    {
+        return false;
+    }
+
+    TArray<FRecord> Snapshot;
+    {
+        FScopeLock Lock(&CS);
+        Snapshot = Records;
+    }
+
+    // Records arrive from several threads; sorting keeps the file in time order for readers that stream it.
+    Snapshot.Sort([](const FRecord& A, const FRecord& B) { return A.BeginSeconds < B.BeginSeconds; });
+    const double TraceOrigin = Snapshot.Num() > 0 ? Snapshot[0].BeginSeconds : 0.0;
+
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(FilePath), true);
+    TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileWriter(*FilePath));
+    if (!Archive)
+    {
+        UE_LOG(LogOmniCaptureProfiler, Warning, TEXT("Failed to open %s for the stage trace."), *FilePath);
+        return false;
+    }
+
+    FString Text;
+    Text.Reserve(GExportFlushChars + 256);
+    const bool bChrome = Format == EOmniCaptureTraceFormat::ChromeTrace;
+    Text += bChrome ? TEXT("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n") : TEXT("frame,stage,thread,begin_us,duration_us\n");
+
+    for (int32 Index = 0; Index < Snapshot.Num(); ++Index)
+    {
+        const FRecord& Entry = Snapshot[Index];
+        const double BeginUs = (Entry.BeginSeconds - TraceOrigin) * 1000000.0;
+        const double DurationUs = FMath::Max(0.0, Entry.EndSeconds - Entry.BeginSeconds) * 1000000.0;
+        if (bChrome)
+        {
+            Text += FString::Printf(TEXT("{\"name\":\"%s\",\"cat\":\"OmniCapture\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%d}}%s\n"),
+                GetStageName(Entry.Stage), Entry.ThreadId, BeginUs, DurationUs, Entry.FrameIndex, Index + 1 < Snapshot.Num() ? TEXT(",") : TEXT(""));
+        }
+        else
+        {
+            Text += FString::Printf(TEXT("%d,%s,%u,%.3f,%.3f\n"), Entry.FrameIndex, GetStageName(Entry.Stage), Entry.ThreadId, BeginUs, DurationUs);
+        }
+
+        if (Text.Len() >= GExportFlushChars)
+        {
+            FlushText(*Archive, Text);
+        }
+    }
+
+    if (bChrome)
+    {
+        Text += TEXT("]}\n");
+    }
+    FlushText(*Archive, Text);
+
+    const bool bSuccess = Archive->Close();
+    UE_LOG(LogOmniCaptureProfiler, Log, TEXT("Stage trace with %d records written to %s"), Snapshot.Num(), *FilePath);
+    return bSuccess;
+}
+
+const TCHAR* FOmniCaptureStageProfiler::GetStageName(EOmniCaptureStage Stage)
+{
+    switch (Stage)
+    {
+    case EOmniCaptureStage::SceneCapture: return TEXT("SceneCapture");
+    case EOmniCaptureStage::RenderFlush: return TEXT("RenderFlush");
+    case EOmniCaptureStage::Readback: return TEXT("Readback");
+    case EOmniCaptureStage::Conversion: return TEXT("Conversion");
+    case EOmniCaptureStage::AuxiliaryPasses: return TEXT("AuxiliaryPasses");
+    case EOmniCaptureStage::RingBuffer: return TEXT("RingBuffer");
+    case EOmniCaptureStage::Encode: return TEXT("Encode");
+    case EOmniCaptureStage::DiskWrite: return TEXT("DiskWrite");
+    default: return TEXT("Unknown");
+    }
+}
@@ -4,18 +4,23 @@
 #include "OmniCaptureDirectorActor.h"
 #include "OmniCaptureEquirectConverter.h"
 #include "OmniCaptureNVENCEncoder.h"
+#include "OmniCaptureFFmpegPipe.h"
 #include "OmniCaptureImageWriter.h"
 #include "OmniCaptureRigActor.h"
 #include "OmniCaptureRingBuffer.h"
 #include "OmniCapturePreviewActor.h"
 #include "OmniCaptureMuxer.h"
 #include "OmniCaptureSettingsValidator.h"
+#include "OmniCaptureRawDump.h"
+#include "OmniCaptureStageProfiler.h"
+#include "OmniCaptureReplay.h"
 
 #include "Curves/CurveFloat.h"
 #include "Engine/World.h"
 #include "GameFramework/Actor.h"
 #include "Misc/Paths.h"
 #include "Misc/DateTime.h"
+#include "Misc/ScopeExit.h"
 #include "HAL/FileManager.h"
 #include "HAL/PlatformFile.h"
 #include "HAL/IConsoleManager.h"
@@ -49,6 +54,26 @@ namespace
 {
     constexpr int32 GMaxOmniDiagnostics = 256;
 
+    /** Closes Stage at the current time and returns that time, which the next stage starts from. */
+    double RecordStage(FOmniCaptureStageTimestamps& Timestamps, EOmniCaptureStage Stage, double BeginSeconds)
+    {
+        const double Now = FPlatformTime::Seconds();
+        Timestamps.Record(Stage, BeginSeconds, Now);
+        return Now;
+    }
+
+    /** An eye whose faces are the given auxiliary pass's render targets, for the converters. */
+    FOmniEyeCapture MakeAuxiliaryEye(const FOmniEyeCapture& SourceEye, EOmniCaptureAuxiliaryPassType PassType)
+    {
+        FOmniEyeCapture AuxEye;
+        AuxEye.ActiveFaceCount = SourceEye.ActiveFaceCount;
+        for (int32 FaceIndex = 0; FaceIndex < AuxEye.ActiveFaceCount && FaceIndex < UE_ARRAY_COUNT(AuxEye.Faces); ++FaceIndex)
+        {
+            AuxEye.Faces[FaceIndex].RenderTarget = SourceEye.Faces[FaceIndex].GetAuxiliaryRenderTarget(PassType);
+        }
+        return AuxEye;
+    }
+
     EOmniCaptureDiagnosticLevel ConvertVerbosityToDiagnostic(ELogVerbosity::Type Verbosity)
     {
         switch (Verbosity)
@@ -176,7 +201,12 @@ void UOmniCaptureSubsystem::RecordCaptureCompletion(bool bFinalizeOutputs)
     FString OutputDetail;
     if (bFinalizeOutputs)
     {
-        if (!LastFinalizedOutput.IsEmpty())
+        const FOmniCaptureFinalizationProgress Progress = GetFinalizationProgress();
+        if (Progress.QueuedSegments + Progress.RunningSegments > 0)
+        {
+            OutputDetail = FString::Printf(TEXT("Finalizing %d segment(s) in the background."), Progress.QueuedSegments + Progress.RunningSegments);
+        }
+        else if (!LastFinalizedOutput.IsEmpty())
         {
             OutputDetail = FString::Printf(TEXT("Final output: %s"), *LastFinalizedOutput);
         }
@@ -246,6 +276,9 @@ void UOmniCaptureSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 void UOmniCaptureSubsystem::Deinitialize()
 {
     EndCapture(false);
+    WaitForFinalization();
+    Finalizer.Reset();
+    ExportPendingStageTrace();
     Super::Deinitialize();
 }
 
@@ -309,7 +342,6 @@ void UOmniCaptureSubsystem::BeginCapture(const FOmniCaptureSettings& InSettings)
     LastFpsSampleTime = 0.0;
     FramesSinceLastFpsSample = 0;
     LastRuntimeWarningCheckTime = FPlatformTime::Seconds();
-    LastSegmentSizeCheckTime = LastRuntimeWarningCheckTime;
 
     SetDiagnosticContext(TEXT("ValidateEnvironment"));
     AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, TEXT("Validating capture environment."), TEXT("ValidateEnvironment"));
@@ -395,9 +427,46 @@ void UOmniCaptureSubsystem::BeginCapture(const FOmniCaptureSettings& InSettings)
 
     SpawnPreviewActor();
 
+    // A previous take still finalizing in the background gets its trace written now, before its profiler is replaced.
+    ExportPendingStageTrace();
+    StageProfiler = MakeShared<FOmniCaptureStageProfiler, ESPMode::ThreadSafe>(ActiveSettings.StageTraceFormat != EOmniCaptureTraceFormat::None);
+    PendingStageTraceFormat = ActiveSettings.StageTraceFormat;
+    PendingStageTracePath = BaseOutputDirectory / (BaseOutputFileName + (PendingStageTraceFormat == EOmniCaptureTraceFormat::CSV ? TEXT("_StageTrace.csv") : TEXT("_StageTrace.json")));
+
+    ReplayWriter.Reset();
+    if (ActiveSettings.ReplayRecordFrameCount > 0)
+    {
+        if (ActiveSettings.IsPlanar())
+        {
+            LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("Replay"), TEXT("Planar captures have no cube faces; replay recording is disabled."));
+        }
+        else
+        {
+            ReplayWriter = MakeUnique<FOmniCaptureReplayWriter>();
+            if (!ReplayWriter->Open(FOmniCaptureReplayDriver::GetReplayPath(BaseOutputDirectory, BaseOutputFileName), ActiveSettings))
+            {
+                ReplayWriter.Reset();
+            }
+        }
+    }
+
     SetDiagnosticContext(TEXT("InitializeOutputs"));
     AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, TEXT("Initializing output writers."), TEXT("InitializeOutputs"));
     InitializeOutputWriters();
+    FOmniCaptureEquirectConverter::PrepareCPUConversion(ActiveSettings, RigActor.IsValid() ? RigActor->GetFaceResolution() : 0);
+
+    BufferPool = MakeShared<FOmniCaptureBufferPool, ESPMode::ThreadSafe>(static_cast<int64>(ActiveSettings.BufferPoolSizeMB) * 1024 * 1024);
+    FOmniCaptureEquirectConverter::SetBufferPool(BufferPool);
+
+    const bool bCanReadBackAsync = ActiveSettings.ReadbackQueueDepth > 0
+        && (ActiveSettings.OutputFormat == EOmniOutputFormat::ImageSequence || ActiveSettings.OutputFormat == EOmniOutputFormat::FFmpegPipe)
+        && !ActiveSettings.IsPlanar()
+        && ActiveSettings.AuxiliaryPasses.Num() == 0;
+    ReadbackQueue.Reset();
+    if (bCanReadBackAsync)
+    {
+        ReadbackQueue = MakeUnique<FOmniCaptureReadbackQueue>(ActiveSettings.ReadbackQueueDepth);
+    }
 
     OutputMuxer = MakeUnique<FOmniCaptureMuxer>();
     if (OutputMuxer)
@@ -414,16 +483,28 @@ void UOmniCaptureSubsystem::BeginCapture(const FOmniCaptureSettings& InSettings)
             return;
         }
 
-        if (OutputMuxer)
+        FOmniCaptureStageTimestamps& Timestamps = Frame->Metadata.StageTimestamps;
+        const int32 FrameIndex = Frame->Metadata.FrameIndex;
+        const double PickupTime = FPlatformTime::Seconds();
+        if (Timestamps.HasStage(EOmniCaptureStage::RingBuffer))
         {
-            OutputMuxer->PushFrame(*Frame);
-            AudioStats = OutputMuxer->GetAudioStats();
-            if (AudioRecorder)
+            const double EnqueueTime = Timestamps.GetBeginSeconds(EOmniCaptureStage::RingBuffer);
+            Timestamps.Record(EOmniCaptureStage::RingBuffer, EnqueueTime, PickupTime);
+            if (StageProfiler.IsValid())
             {
-                AudioStats.PendingPackets += AudioRecorder->GetPendingPacketCount();
+                StageProfiler->Record(FrameIndex, EOmniCaptureStage::RingBuffer, EnqueueTime, PickupTime);
             }
         }
 
+        OMNICAPTURE_STAGE_SCOPE(Encode);
+        ON_SCOPE_EXIT
+        {
+            if (StageProfiler.IsValid())
+            {
+                StageProfiler->Record(FrameIndex, EOmniCaptureStage::Encode, PickupTime, FPlatformTime::Seconds());
+            }
+        };
+
         switch (ActiveSettings.OutputFormat)
         {
         case EOmniOutputFormat::ImageSequence:
@@ -444,9 +525,32 @@ void UOmniCaptureSubsystem::BeginCapture(const FOmniCaptureSettings& InSettings)
                 ImageWriter->EnqueueFrame(MoveTemp(Frame), FileName);
             }
             break;
+        case EOmniOutputFormat::FFmpegPipe:
+            if (FFmpegPipe)
+            {
+                FFmpegPipe->EnqueueFrame(*Frame);
+            }
+            break;
         default:
             break;
         }
+    },
+    [this](const FOmniCaptureFrame& CommittedFrame)
+    {
+        if (NVENCEncoder && CommittedFrame.AudioPackets.Num() > 0)
+        {
+            NVENCEncoder->WriteAudio(CommittedFrame.AudioPackets);
+        }
+
+        if (OutputMuxer)
+        {
+            OutputMuxer->PushFrame(CommittedFrame);
+            AudioStats = OutputMuxer->GetAudioStats();
+            if (AudioRecorder)
+            {
+                AudioStats.PendingPackets += AudioRecorder->GetPendingPacketCount();
+            }
+        }
 
         if (RingBuffer.IsValid())
         {
@@ -467,7 +571,8 @@ void UOmniCaptureSubsystem::BeginCapture(const FOmniCaptureSettings& InSettings)
     FrameCounter = 0;
     CaptureStartTime = FPlatformTime::Seconds();
     CurrentSegmentStartTime = CaptureStartTime;
-    LastSegmentSizeCheckTime = CurrentSegmentStartTime;
+    LastPipeOutputSizeCheckTime = CurrentSegmentStartTime;
+    PipeOutputBytes = 0;
     LastRuntimeWarningCheckTime = CurrentSegmentStartTime;
     PreviewFrameInterval = (ActiveSettings.bEnablePreviewWindow && ActiveSettings.PreviewFrameRate > 0.f) ? (1.0 / FMath::Max(1.0f, ActiveSettings.PreviewFrameRate)) : 0.0;
     LastPreviewUpdateTime = CaptureStartTime;
@@ -493,7 +598,7 @@ void UOmniCaptureSubsystem::BeginCapture(const FOmniCaptureSettings& InSettings)
         OutputDimensions.Y,
         ProjectionLabel,
         LayoutLabel,
-        ActiveSettings.OutputFormat == EOmniOutputFormat::ImageSequence ? TEXT("Image") : TEXT("NVENC"),
+        ActiveSettings.OutputFormat == EOmniOutputFormat::ImageSequence ? TEXT("Image") : (ActiveSettings.OutputFormat == EOmniOutputFormat::FFmpegPipe ? TEXT("FFmpeg") : TEXT("NVENC")),
         ActiveSettings.Gamma == EOmniCaptureGamma::Linear ? TEXT("Linear") : TEXT("sRGB"),
         ActiveSettings.Codec == EOmniCaptureCodec::HEVC ? TEXT("HEVC") : TEXT("H.264"),
         *ActiveSettings.OutputDirectory);
@@ -521,9 +626,17 @@ void UOmniCaptureSubsystem::EndCapture(bool bFinalize)
     LastDynamicInterPupillaryDistance = -1.0f;
     LastDynamicConvergence = -1.0f;
 
+    DrainReadbackQueue();
+    if (ReadbackQueue && ReadbackQueue->GetStallCount() > 0)
+    {
+        UE_LOG(LogOmniCaptureSubsystem, Log, TEXT("Readback queue was full on %d frames; consider a deeper ReadbackQueueDepth."), ReadbackQueue->GetStallCount());
+    }
+    ReadbackQueue.Reset();
+
     DestroyTickActor();
     DestroyPreviewActor();
     DestroyRig();
+    ReplayWriter.Reset();
 
     ShutdownAudioRecording();
 
@@ -533,7 +646,19 @@ void UOmniCaptureSubsystem::EndCapture(bool bFinalize)
         RingBuffer.Reset();
     }
 
-    ShutdownOutputWriters(bFinalize);
+    // When finalizing, the writers are handed to the finalizer with the last segment instead of being drained here.
+    if (!bFinalize)
+    {
+        ShutdownOutputWriters(false);
+    }
+    FOmniCaptureEquirectConverter::ReleaseCPUConversionCache();
+    FOmniCaptureEquirectConverter::SetBufferPool(nullptr);
+    if (BufferPool.IsValid())
+    {
+        const FOmniCaptureBufferPoolStats PoolStats = BufferPool->GetStats();
+        UE_LOG(LogOmniCaptureSubsystem, Log, TEXT("Buffer pool high water %.1f MB, %lld hits / %lld misses"), PoolStats.HighWaterBytes / (1024.0 * 1024.0), PoolStats.Hits, PoolStats.Misses);
+        BufferPool.Reset();
+    }
     if (OutputMuxer)
     {
         OutputMuxer->EndRealtimeSession();
@@ -548,7 +673,11 @@ void UOmniCaptureSubsystem::EndCapture(bool bFinalize)
     CurrentDiagnosticAttemptId = 0;
     CaptureStartTime = 0.0;
 
-    State = EOmniCaptureState::Idle;
+    State = IsFinalizing() ? EOmniCaptureState::Finalizing : EOmniCaptureState::Idle;
+    if (!IsFinalizing())
+    {
+        ExportPendingStageTrace();
+    }
     LatestRingBufferStats = FOmniCaptureRingBufferStats();
     AudioStats = FOmniAudioSyncStats();
 }
@@ -565,6 +694,8 @@ void UOmniCaptureSubsystem::PauseCapture()
     SetDiagnosticContext(TEXT("Paused"));
     AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, TEXT("Capture paused."), TEXT("Paused"));
 
+    DrainReadbackQueue();
+
     if (RingBuffer)
     {
         RingBuffer->Flush();
@@ -636,6 +767,10 @@ bool UOmniCaptureSubsystem::CapturePanoramaStill(const FOmniCaptureSettings& InS
 
     FOmniCaptureSettings StillSettings = InSettings;
     StillSettings.OutputFormat = EOmniOutputFormat::ImageSequence;
+    if (StillSettings.ImageFormat == EOmniCaptureImageFormat::RawDump)
+    {
+        StillSettings.ImageFormat = EOmniCaptureImageFormat::PNG;
+    }
 
     {
         TArray<FString> CompatibilityWarnings;
@@ -692,17 +827,6 @@ bool UOmniCaptureSubsystem::CapturePanoramaStill(const FOmniCaptureSettings& InS
     TMap<FName, FOmniCaptureLayerPayload> AuxiliaryLayers;
     if (StillSettings.AuxiliaryPasses.Num() > 0)
     {
-        auto BuildAuxEye = [](const FOmniEyeCapture& SourceEye, EOmniCaptureAuxiliaryPassType PassType)
-        {
-            FOmniEyeCapture AuxEye;
-            AuxEye.ActiveFaceCount = SourceEye.ActiveFaceCount;
-            for (int32 FaceIndex = 0; FaceIndex < AuxEye.ActiveFaceCount && FaceIndex < UE_ARRAY_COUNT(AuxEye.Faces); ++FaceIndex)
-            {
-                AuxEye.Faces[FaceIndex].RenderTarget = SourceEye.Faces[FaceIndex].GetAuxiliaryRenderTarget(PassType);
-            }
-            return AuxEye;
-        };
-
         for (EOmniCaptureAuxiliaryPassType PassType : StillSettings.AuxiliaryPasses)
         {
             if (PassType == EOmniCaptureAuxiliaryPassType::None)
@@ -710,8 +834,8 @@ bool UOmniCaptureSubsystem::CapturePanoramaStill(const FOmniCaptureSettings& InS
                 continue;
             }
 
-            const FOmniEyeCapture AuxLeft = BuildAuxEye(LeftEye, PassType);
-            const FOmniEyeCapture AuxRight = BuildAuxEye(RightEye, PassType);
+            const FOmniEyeCapture AuxLeft = MakeAuxiliaryEye(LeftEye, PassType);
+            const FOmniEyeCapture AuxRight = MakeAuxiliaryEye(RightEye, PassType);
             FOmniCaptureEquirectResult AuxResult = ConvertFrame(StillSettings, AuxLeft, AuxRight);
             if (AuxResult.PixelData.IsValid())
             {
@@ -774,6 +898,58 @@ bool UOmniCaptureSubsystem::CapturePanoramaStill(const FOmniCaptureSettings& InS
     return true;
 }
 
+bool UOmniCaptureSubsystem::TranscodeRawDump(const FString& IndexPath, const FOmniCaptureSettings& Settings, bool bMuxWithFFmpeg)
+{
+    SetDiagnosticContext(TEXT("RawTranscode"));
+
+    const FString DumpDirectory = FPaths::GetPath(IndexPath);
+    TArray<FOmniCaptureFrameMetadata> Frames;
+    if (!FOmniCaptureRawDumpReader::Transcode(IndexPath, Settings, DumpDirectory, Frames))
+    {
+        LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("RawTranscode"), FString::Printf(TEXT("Raw dump %s was transcoded with errors."), *IndexPath));
+        if (Frames.Num() == 0)
+        {
+            return false;
+        }
+    }
+
+    if (!bMuxWithFFmpeg)
+    {
+        return true;
+    }
+
+    FOmniCaptureSettings MuxSettings = Settings;
+    MuxSettings.OutputFormat = EOmniOutputFormat::ImageSequence;
+    MuxSettings.OutputDirectory = DumpDirectory;
+    MuxSettings.OutputFileName = FOmniCaptureRawDumpReader::GetBaseName(IndexPath);
+
+    FOmniCaptureMuxer Muxer;
+    Muxer.Initialize(MuxSettings, DumpDirectory);
+    return Muxer.FinalizeCapture(MuxSettings, Frames, FString(), FString(), 0);
+}
+
+bool UOmniCaptureSubsystem::ReplayCapture(const FString& ReplayPath, const FString& OutputDirectory, int32 LoopCount, FOmniCaptureReplayStats& OutStats)
+{
+    SetDiagnosticContext(TEXT("Replay"));
+
+    // The converter's sample map cache and buffer pool belong to the live take while one is running.
+    if (bIsCapturing)
+    {
+        LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("Replay"), TEXT("Replay is unavailable while a capture is running."));
+        return false;
+    }
+
+    FOmniCaptureReplayOptions Options;
+    Options.OutputDirectory = OutputDirectory;
+    Options.LoopCount = LoopCount;
+    const bool bSuccess = FOmniCaptureReplayDriver::Run(ReplayPath, Options, OutStats);
+    FOmniCaptureEquirectConverter::ReleaseCPUConversionCache();
+
+    LogDiagnosticMessage(bSuccess ? ELogVerbosity::Log : ELogVerbosity::Warning, TEXT("Replay"),
+        FString::Printf(TEXT("Replayed %d frames from %s at %.2f fps (%d dropped)"), OutStats.FramesReplayed, *ReplayPath, OutStats.FramesPerSecond, OutStats.DroppedFrames));
+    return bSuccess;
+}
+
 bool UOmniCaptureSubsystem::CanPause() const
 {
     return bIsCapturing && !bIsPaused;
@@ -791,7 +967,8 @@ FString UOmniCaptureSubsystem::GetStatusString() const
         FString Status;
         if (State == EOmniCaptureState::Finalizing)
         {
-            Status = TEXT("Finalizing");
+            const FOmniCaptureFinalizationProgress Progress = GetFinalizationProgress();
+            Status = FString::Printf(TEXT("Finalizing (Queued:%d Running:%d Failed:%d)"), Progress.QueuedSegments, Progress.RunningSegments, Progress.FailedSegments);
         }
         else
         {
@@ -833,8 +1010,18 @@ FString UOmniCaptureSubsystem::GetStatusString() const
     }
 
     Status += FString::Printf(TEXT(" | Frames:%d Pending:%d Dropped:%d Blocked:%d"), FrameCounter, LatestRingBufferStats.PendingFrames, LatestRingBufferStats.DroppedFrames, LatestRingBufferStats.BlockedPushes);
+    if (ImageWriter)
+    {
+        const FOmniCaptureImageWriterStats WriterStats = ImageWriter->GetStats();
+        Status += FString::Printf(TEXT(" | Writes:%d %.0fMB"), WriterStats.PendingTasks, WriterStats.InFlightBytes / (1024.0 * 1024.0));
+    }
     Status += FString::Printf(TEXT(" | FPS:%.2f"), CurrentCaptureFPS);
     Status += FString::Printf(TEXT(" | Segment:%d"), CurrentSegmentIndex);
+    if (IsFinalizing())
+    {
+        const FOmniCaptureFinalizationProgress Progress = GetFinalizationProgress();
+        Status += FString::Printf(TEXT(" | Finalizing:%d"), Progress.QueuedSegments + Progress.RunningSegments);
+    }
 
     Status += FString::Printf(TEXT(" | Audio Drift:%.2fms (Max %.2fms) Pending:%d"), AudioStats.DriftMilliseconds, AudioStats.MaxObservedDriftMilliseconds, AudioStats.PendingPackets);
     if (AudioStats.bInError)
@@ -987,7 +1174,7 @@ void UOmniCaptureSubsystem::SpawnPreviewActor()
     if (AOmniCapturePreviewActor* Preview = World->SpawnActor<AOmniCapturePreviewActor>(SpawnParameters))
     {
         const FIntPoint OutputSize = ActiveSettings.GetOutputResolution();
-        Preview->Initialize(ActiveSettings.PreviewScreenScale, OutputSize);
+        Preview->Initialize(ActiveSettings.PreviewScreenScale, ActiveSettings.GetPreviewResolution());
         Preview->SetPreviewEnabled(true);
         Preview->SetPreviewView(ActiveSettings.PreviewVisualization);
         if (RigActor.IsValid())
@@ -1020,6 +1207,7 @@ void UOmniCaptureSubsystem::InitializeOutputWriters()
     case EOmniOutputFormat::ImageSequence:
         ImageWriter = MakeUnique<FOmniCaptureImageWriter>();
         ImageWriter->Initialize(ActiveSettings, ActiveSettings.OutputDirectory);
+        ImageWriter->SetStageProfiler(StageProfiler);
         AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, TEXT("Image sequence writer initialized."), TEXT("InitializeOutputs"));
         break;
     case EOmniOutputFormat::NVENCHardware:
@@ -1040,10 +1228,24 @@ void UOmniCaptureSubsystem::InitializeOutputWriters()
         {
             ImageWriter = MakeUnique<FOmniCaptureImageWriter>();
             ImageWriter->Initialize(ActiveSettings, ActiveSettings.OutputDirectory);
+            ImageWriter->SetStageProfiler(StageProfiler);
             bUsingNVENCImageFallback.Store(true);
             AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, TEXT("Image sequence writer initialized for NVENC fallback."), TEXT("InitializeOutputs"));
         }
         break;
+    case EOmniOutputFormat::FFmpegPipe:
+        // With audio, the pipe writes a video-only file and FinalizeCapture muxes the track in without re-encoding.
+        FFmpegPipe = MakeUnique<FOmniCaptureFFmpegPipe>();
+        if (FFmpegPipe->Initialize(ActiveSettings, ActiveSettings.OutputDirectory, ActiveSettings.bRecordAudio))
+        {
+            RecordedVideoPath = FFmpegPipe->GetOutputFilePath();
+            AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, FString::Printf(TEXT("FFmpeg pipe output will be written to %s"), *RecordedVideoPath), TEXT("InitializeOutputs"));
+        }
+        else
+        {
+            LogDiagnosticMessage(ELogVerbosity::Error, TEXT("InitializeOutputs"), FFmpegPipe->GetLastError());
+        }
+        break;
     default:
         break;
     }
@@ -1054,6 +1256,8 @@ void UOmniCaptureSubsystem::ShutdownOutputWriters(bool bFinalizeOutputs)
     if (ImageWriter)
     {
         ImageWriter->Flush();
+        const FOmniCaptureImageWriterStats WriterStats = ImageWriter->GetStats();
+        UE_LOG(LogOmniCaptureSubsystem, Log, TEXT("Image writer peak in-flight %.1f MB, %d memory budget stalls"), WriterStats.PeakInFlightBytes / (1024.0 * 1024.0), WriterStats.BudgetStalls);
         ImageWriter.Reset();
     }
 
@@ -1067,14 +1271,21 @@ void UOmniCaptureSubsystem::ShutdownOutputWriters(bool bFinalizeOutputs)
         }
         NVENCEncoder.Reset();
     }
+
+    if (FFmpegPipe)
+    {
+        if (bFinalizeOutputs && !FFmpegPipe->Finalize())
+        {
+            LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("ShutdownOutputs"), FString::Printf(TEXT("FFmpeg pipe did not produce %s: %s"), *FFmpegPipe->GetOutputFilePath(), *FFmpegPipe->GetLastError()));
+        }
+        FFmpegPipe.Reset();
+    }
 }
 
 void UOmniCaptureSubsystem::FinalizeOutputs(bool bFinalizeOutputs)
 {
     SetDiagnosticContext(TEXT("FinalizeOutputs"));
     AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, FString::Printf(TEXT("Finalize outputs requested (Finalize=%s)."), bFinalizeOutputs ? TEXT("true") : TEXT("false")), TEXT("FinalizeOutputs"));
-    bLastCaptureUsedImageSequenceFallback = false;
-    LastImageSequenceFallbackDirectory.Reset();
 
     if (!bFinalizeOutputs)
     {
@@ -1086,113 +1297,223 @@ void UOmniCaptureSubsystem::FinalizeOutputs(bool bFinalizeOutputs)
         LastStillImagePath.Empty();
         OutputMuxer.Reset();
         RecordedSegmentDroppedFrames = 0;
+        bLastCaptureUsedImageSequenceFallback = false;
+        LastImageSequenceFallbackDirectory.Reset();
         return;
     }
 
-    if (CapturedFrameMetadata.Num() > 0)
+    // Segments rotated out earlier are already on the finalizer; this hands over the last one.
+    if (CapturedFrameMetadata.Num() == 0 && CurrentSegmentIndex == 0)
+    {
+        LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("FinalizeOutputs"), TEXT("FinalizeOutputs called with no captured frames"));
+    }
+    SubmitActiveSegmentForFinalization();
+
+    CompletedSegments.Empty();
+    CapturedFrameMetadata.Reset();
+    RecordedAudioPath.Reset();
+    RecordedVideoPath.Reset();
+    OutputMuxer.Reset();
+    RecordedSegmentDroppedFrames = 0;
+}
+
+void UOmniCaptureSubsystem::SubmitActiveSegmentForFinalization()
+{
+    // NVENC holds RHI resources, so it is drained here; the image writer and FFmpeg pipe travel with the segment.
+    if (NVENCEncoder)
     {
-        CompleteActiveSegment(true);
+        NVENCEncoder->Finalize();
+        NVENCEncoder.Reset();
     }
+    bUsingNVENCImageFallback.Store(false);
 
-    if (CompletedSegments.Num() == 0)
+    const int32 PreviousSegmentCount = CompletedSegments.Num();
+    CompleteActiveSegment(true);
+    if (CompletedSegments.Num() == PreviousSegmentCount)
     {
-        LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("FinalizeOutputs"), TEXT("FinalizeOutputs called with no captured frames"));
-        OutputMuxer.Reset();
-        RecordedAudioPath.Reset();
-        RecordedVideoPath.Reset();
-        LastFinalizedOutput.Empty();
-        LastStillImagePath.Empty();
+        RecordedAudioClosed.Reset();
+        ShutdownOutputWriters(false);
         return;
     }
 
-    if (!OutputMuxer)
+    FOmniCaptureFinalizeJob Job;
+    Job.Settings = ActiveSettings;
+    Job.Segment = CompletedSegments.Pop();
+    Job.ImageWriter = MoveTemp(ImageWriter);
+    Job.FFmpegPipe = MoveTemp(FFmpegPipe);
+    Job.AudioFileClosed = MoveTemp(RecordedAudioClosed);
+    Job.bRequestedNVENC = OriginalSettings.OutputFormat == EOmniOutputFormat::NVENCHardware;
+
+    if (!Finalizer)
     {
-        OutputMuxer = MakeUnique<FOmniCaptureMuxer>();
+        Finalizer = MakeUnique<FOmniCaptureFinalizer>(ActiveSettings.MaxConcurrentFinalizeJobs);
+    }
+    else
+    {
+        Finalizer->SetMaxConcurrentJobs(ActiveSettings.MaxConcurrentFinalizeJobs);
     }
 
-    LastFinalizedOutput.Empty();
+    AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, FString::Printf(TEXT("Segment %d queued for background finalization."), Job.Segment.SegmentIndex), TEXT("FinalizeOutputs"));
+    Finalizer->Submit(MoveTemp(Job));
+
+    if (!FinalizationTickerHandle.IsValid())
+    {
+        FinalizationTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UOmniCaptureSubsystem::TickFinalization));
+    }
+}
 
-    for (const FOmniCaptureSegmentRecord& Segment : CompletedSegments)
+void UOmniCaptureSubsystem::ExportPendingStageTrace()
+{
+    if (PendingStageTraceFormat == EOmniCaptureTraceFormat::None || !StageProfiler.IsValid())
     {
-        if (!OutputMuxer)
+        return;
+    }
+
+    const EOmniCaptureTraceFormat Format = PendingStageTraceFormat;
+    PendingStageTraceFormat = EOmniCaptureTraceFormat::None;
+    if (StageProfiler->ExportTrace(PendingStageTracePath, Format))
+    {
+        AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, FString::Printf(TEXT("Stage trace written to %s"), *PendingStageTracePath), TEXT("FinalizeOutputs"));
+    }
+    else
+    {
+        AppendDiagnostic(EOmniCaptureDiagnosticLevel::Warning, FString::Printf(TEXT("Failed to write stage trace %s"), *PendingStageTracePath), TEXT("FinalizeOutputs"));
+    }
+}
+
+FOmniCaptureStageLatency UOmniCaptureSubsystem::GetStageLatency(EOmniCaptureStage Stage) const
+{
+    if (!StageProfiler.IsValid() || Stage == EOmniCaptureStage::Count)
+    {
+        FOmniCaptureStageLatency Empty;
+        Empty.Stage = Stage;
+        return Empty;
+    }
+    return StageProfiler->GetLatency(Stage);
+}
+
+TArray<FOmniCaptureStageLatency> UOmniCaptureSubsystem::GetStageLatencies() const
+{
+    return StageProfiler.IsValid() ? StageProfiler->GetLatencies() : TArray<FOmniCaptureStageLatency>();
+}
+
+bool UOmniCaptureSubsystem::TickFinalization(float DeltaTime)
+{
+    if (Finalizer)
+    {
+        TArray<FOmniCaptureFinalizeResult> Results;
+        Finalizer->ConsumeCompleted(Results);
+        for (const FOmniCaptureFinalizeResult& Result : Results)
         {
-            break;
+            HandleFinalizeResult(Result);
         }
 
-        FOmniCaptureSettings SegmentSettings = ActiveSettings;
-        SegmentSettings.OutputDirectory = Segment.Directory;
-        SegmentSettings.OutputFileName = Segment.BaseFileName;
+        if (!Finalizer->IsIdle())
+        {
+            return true;
+        }
+    }
+
+    if (!bIsCapturing && State == EOmniCaptureState::Finalizing)
+    {
+        State = EOmniCaptureState::Idle;
+        AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, TEXT("Background finalization finished."), TEXT("FinalizeOutputs"));
+    }
 
-        OutputMuxer->Initialize(SegmentSettings, Segment.Directory);
-        OutputMuxer->BeginRealtimeSession(SegmentSettings);
+    if (!bIsCapturing)
+    {
+        ExportPendingStageTrace();
+    }
 
-        const bool bMuxingExpected = SegmentSettings.OutputFormat != EOmniOutputFormat::ImageSequence;
-        const bool bFallbackFromNVENC = (OriginalSettings.OutputFormat == EOmniOutputFormat::NVENCHardware && SegmentSettings.OutputFormat == EOmniOutputFormat::ImageSequence);
-        const bool bSuccess = OutputMuxer->FinalizeCapture(SegmentSettings, Segment.Frames, Segment.AudioPath, Segment.VideoPath, Segment.DroppedFrames);
-        OutputMuxer->EndRealtimeSession();
+    FTSTicker::GetCoreTicker().RemoveTicker(FinalizationTickerHandle);
+    FinalizationTickerHandle.Reset();
+    return false;
+}
+
+void UOmniCaptureSubsystem::HandleFinalizeResult(const FOmniCaptureFinalizeResult& Result)
+{
+    const FOmniCaptureSegmentRecord& Segment = Result.Segment;
+    const bool bFallbackFromNVENC = Result.bRequestedNVENC && Result.Settings.OutputFormat == EOmniOutputFormat::ImageSequence;
 
-        const FString FinalVideoPath = Segment.Directory / (Segment.BaseFileName + TEXT(".mp4"));
-        const bool bFinalFileExists = bMuxingExpected ? FPaths::FileExists(FinalVideoPath) : true;
+    if (!Result.WriterError.IsEmpty())
+    {
+        LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("ShutdownOutputs"), Result.WriterError);
+    }
 
-        if (!bSuccess || (bMuxingExpected && !bFinalFileExists))
+    if (!Result.bSuccess)
+    {
+        LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("FinalizeOutputs"), FString::Printf(TEXT("Output muxing failed for segment %d. Check OmniCapture manifest for details."), Segment.SegmentIndex));
+        if (Segment.bHasImageSequence)
         {
-            LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("FinalizeOutputs"), FString::Printf(TEXT("Output muxing failed for segment %d. Check OmniCapture manifest for details."), Segment.SegmentIndex));
-            if (Segment.bHasImageSequence)
+            LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("FinalizeOutputs"), FString::Printf(TEXT("Image sequence frames saved to %s with base name %s."), *Segment.Directory, *Segment.BaseFileName));
+            if (LastImageSequenceFallbackDirectory.IsEmpty())
             {
-                LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("FinalizeOutputs"), FString::Printf(TEXT("Image sequence frames saved to %s with base name %s."), *Segment.Directory, *Segment.BaseFileName));
-                if (LastImageSequenceFallbackDirectory.IsEmpty())
-                {
-                    LastImageSequenceFallbackDirectory = Segment.Directory;
-                }
-                if (OriginalSettings.OutputFormat == EOmniOutputFormat::NVENCHardware)
-                {
-                    bLastCaptureUsedImageSequenceFallback = true;
-                }
+                LastImageSequenceFallbackDirectory = Segment.Directory;
             }
-            else
+            if (Result.bRequestedNVENC)
             {
-                LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("FinalizeOutputs"), TEXT("No image sequence fallback was recorded for this segment."));
+                bLastCaptureUsedImageSequenceFallback = true;
             }
         }
-        else if (Segment.bHasImageSequence)
+        else
+        {
+            LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("FinalizeOutputs"), TEXT("No image sequence fallback was recorded for this segment."));
+        }
+    }
+    else if (Segment.bHasImageSequence)
+    {
+        if (!Result.bMuxingExpected)
         {
-            if (!bMuxingExpected)
+            const ELogVerbosity::Type Verbosity = bFallbackFromNVENC ? ELogVerbosity::Warning : ELogVerbosity::Log;
+            LogDiagnosticMessage(Verbosity, TEXT("FinalizeOutputs"), FString::Printf(TEXT("Image sequence frames saved to %s with base name %s."), *Segment.Directory, *Segment.BaseFileName));
+            if (LastImageSequenceFallbackDirectory.IsEmpty())
             {
-                const ELogVerbosity::Type Verbosity = bFallbackFromNVENC ? ELogVerbosity::Warning : ELogVerbosity::Log;
-                LogDiagnosticMessage(Verbosity, TEXT("FinalizeOutputs"), FString::Printf(TEXT("Image sequence frames saved to %s with base name %s."), *Segment.Directory, *Segment.BaseFileName));
-                if (LastImageSequenceFallbackDirectory.IsEmpty())
-                {
-                    LastImageSequenceFallbackDirectory = Segment.Directory;
-                }
-                if (bFallbackFromNVENC)
-                {
-                    bLastCaptureUsedImageSequenceFallback = true;
-                }
+                LastImageSequenceFallbackDirectory = Segment.Directory;
             }
-            else if (SegmentSettings.OutputFormat == EOmniOutputFormat::NVENCHardware)
+            if (bFallbackFromNVENC)
             {
-                AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, FString::Printf(TEXT("Image sequence fallback saved alongside NVENC output in %s."), *Segment.Directory), TEXT("FinalizeOutputs"));
+                bLastCaptureUsedImageSequenceFallback = true;
             }
         }
-
-        LastFinalizedOutput = (bSuccess && bMuxingExpected && bFinalFileExists) ? FinalVideoPath : FString();
-        if (!LastFinalizedOutput.IsEmpty())
+        else if (Result.Settings.OutputFormat == EOmniOutputFormat::NVENCHardware)
         {
-            AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, FString::Printf(TEXT("Muxed output ready: %s"), *LastFinalizedOutput), TEXT("FinalizeOutputs"));
+            AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, FString::Printf(TEXT("Image sequence fallback saved alongside NVENC output in %s."), *Segment.Directory), TEXT("FinalizeOutputs"));
         }
+    }
 
-        if (SegmentSettings.bOpenPreviewOnFinalize && !LastFinalizedOutput.IsEmpty())
-        {
-            FPlatformProcess::LaunchFileInDefaultExternalApplication(*LastFinalizedOutput);
-        }
+    LastFinalizedOutput = (Result.bSuccess && Result.bMuxingExpected) ? Result.FinalVideoPath : FString();
+    if (!LastFinalizedOutput.IsEmpty())
+    {
+        AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, FString::Printf(TEXT("Muxed output ready: %s (finalized in %.2fs)"), *LastFinalizedOutput, Result.DurationSeconds), TEXT("FinalizeOutputs"));
     }
 
-    CompletedSegments.Empty();
-    CapturedFrameMetadata.Reset();
-    RecordedAudioPath.Reset();
-    RecordedVideoPath.Reset();
-    OutputMuxer.Reset();
-    RecordedSegmentDroppedFrames = 0;
+    if (Result.Settings.bOpenPreviewOnFinalize && !LastFinalizedOutput.IsEmpty())
+    {
+        FPlatformProcess::LaunchFileInDefaultExternalApplication(*LastFinalizedOutput);
+    }
+
+    SegmentFinalizedDelegate.Broadcast(Result);
+}
+
+FOmniCaptureFinalizationProgress UOmniCaptureSubsystem::GetFinalizationProgress() const
+{
+    return Finalizer ? Finalizer->GetProgress() : FOmniCaptureFinalizationProgress();
+}
+
+bool UOmniCaptureSubsystem::IsFinalizing() const
+{
+    return Finalizer && !Finalizer->IsIdle();
+}
+
+void UOmniCaptureSubsystem::WaitForFinalization()
+{
+    if (!Finalizer)
+    {
+        return;
+    }
+
+    Finalizer->WaitForAll();
+    TickFinalization(0.0f);
 }
 
 bool UOmniCaptureSubsystem::ValidateEnvironment()
@@ -1369,6 +1690,13 @@ bool UOmniCaptureSubsystem::ApplyFallbacks(FString* OutFailureReason)
         OutFailureReason->Reset();
     }
 
+    if (ActiveSettings.OutputFormat == EOmniOutputFormat::FFmpegPipe && !FOmniCaptureMuxer::IsFFmpegAvailable(ActiveSettings))
+    {
+        AddWarningUnique(TEXT("FFmpeg pipe output needs FFmpeg; switching to PNG sequence."));
+        ActiveSettings.OutputFormat = EOmniOutputFormat::ImageSequence;
+        return true;
+    }
+
     if (ActiveSettings.OutputFormat == EOmniOutputFormat::NVENCHardware)
     {
 #if !PLATFORM_WINDOWS
@@ -1474,7 +1802,7 @@ void UOmniCaptureSubsystem::InitializeAudioRecording()
     AudioRecorder = MakeUnique<FOmniCaptureAudioRecorder>();
     if (AudioRecorder->Initialize(World, ActiveSettings))
     {
-        AudioRecorder->Start();
+        AudioRecorder->Start(ActiveSettings.OutputDirectory, ActiveSettings.OutputFileName);
         AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, TEXT("Audio recorder started."), TEXT("Audio"));
     }
     else
@@ -1491,7 +1819,7 @@ void UOmniCaptureSubsystem::ShutdownAudioRecording()
         return;
     }
 
-    AudioRecorder->Stop(ActiveSettings.OutputDirectory, ActiveSettings.OutputFileName);
+    AudioRecorder->Stop();
     RecordedAudioPath = AudioRecorder->GetOutputFilePath();
     if (!RecordedAudioPath.IsEmpty())
     {
@@ -1525,11 +1853,56 @@ void UOmniCaptureSubsystem::CaptureFrame()
         return;
     }
 
+    if (ReadbackQueue)
+    {
+        ReadbackQueue->Poll();
+        SubmitCompletedReadbacks();
+    }
+
+    FOmniCaptureStageTimestamps Timestamps;
+    double StageBegin = FPlatformTime::Seconds();
+
     FOmniEyeCapture LeftEye;
     FOmniEyeCapture RightEye;
-    RigActor->Capture(LeftEye, RightEye);
+    {
+        OMNICAPTURE_STAGE_SCOPE(SceneCapture);
+        RigActor->Capture(LeftEye, RightEye);
+    }
+    StageBegin = RecordStage(Timestamps, EOmniCaptureStage::SceneCapture, StageBegin);
 
-    FlushRenderingCommands();
+    if (ReplayWriter)
+    {
+        RecordReplayFrame(LeftEye, RightEye);
+        // The face readback is recording overhead, not part of any stage.
+        StageBegin = FPlatformTime::Seconds();
+    }
+
+    if (ReadbackQueue)
+    {
+        if (ReadbackQueue->IsFull())
+        {
+            ReadbackQueue->WaitForOldest();
+            SubmitCompletedReadbacks();
+        }
+
+        // The conversion is enqueued behind the scene captures on the render thread, so no flush is needed here.
+        if (TSharedPtr<FOmniCaptureAsyncConversion, ESPMode::ThreadSafe> Conversion = FOmniCaptureEquirectConverter::BeginAsyncConversion(ActiveSettings, LeftEye, RightEye))
+        {
+            // The readback stage is closed with its real end time when SubmitCompletedReadbacks collects the frame.
+            const double SubmitTime = FPlatformTime::Seconds();
+            Timestamps.Record(EOmniCaptureStage::Readback, SubmitTime, SubmitTime);
+            FOmniCaptureFrameMetadata Metadata = MakeFrameMetadata();
+            Metadata.StageTimestamps = Timestamps;
+            ReadbackQueue->Submit(Conversion, Metadata);
+            return;
+        }
+    }
+
+    {
+        OMNICAPTURE_STAGE_SCOPE(RenderFlush);
+        FlushRenderingCommands();
+    }
+    StageBegin = RecordStage(Timestamps, EOmniCaptureStage::RenderFlush, StageBegin);
 
     auto ConvertActiveFrame = [](const FOmniCaptureSettings& CaptureSettings, const FOmniEyeCapture& Left, const FOmniEyeCapture& Right)
     {
@@ -1546,22 +1919,17 @@ void UOmniCaptureSubsystem::CaptureFrame()
         return FOmniCaptureEquirectConverter::ConvertToEquirectangular(CaptureSettings, Left, Right);
     };
 
-    FOmniCaptureEquirectResult ConversionResult = ConvertActiveFrame(ActiveSettings, LeftEye, RightEye);
+    FOmniCaptureEquirectResult ConversionResult;
+    {
+        OMNICAPTURE_STAGE_SCOPE(Conversion);
+        ConversionResult = ConvertActiveFrame(ActiveSettings, LeftEye, RightEye);
+    }
+    StageBegin = RecordStage(Timestamps, EOmniCaptureStage::Conversion, StageBegin);
 
     TMap<FName, FOmniCaptureLayerPayload> AuxiliaryLayers;
     if (ActiveSettings.AuxiliaryPasses.Num() > 0)
     {
-        auto BuildAuxiliaryEye = [](const FOmniEyeCapture& SourceEye, EOmniCaptureAuxiliaryPassType PassType)
-        {
-            FOmniEyeCapture AuxEye;
-            AuxEye.ActiveFaceCount = SourceEye.ActiveFaceCount;
-            for (int32 FaceIndex = 0; FaceIndex < AuxEye.ActiveFaceCount && FaceIndex < UE_ARRAY_COUNT(AuxEye.Faces); ++FaceIndex)
-            {
-                AuxEye.Faces[FaceIndex].RenderTarget = SourceEye.Faces[FaceIndex].GetAuxiliaryRenderTarget(PassType);
-            }
-            return AuxEye;
-        };
-
+        OMNICAPTURE_STAGE_SCOPE(AuxiliaryPasses);
         for (EOmniCaptureAuxiliaryPassType PassType : ActiveSettings.AuxiliaryPasses)
         {
             if (PassType == EOmniCaptureAuxiliaryPassType::None)
@@ -1569,8 +1937,8 @@ void UOmniCaptureSubsystem::CaptureFrame()
                 continue;
             }
 
-            const FOmniEyeCapture AuxLeft = BuildAuxiliaryEye(LeftEye, PassType);
-            const FOmniEyeCapture AuxRight = BuildAuxiliaryEye(RightEye, PassType);
+            const FOmniEyeCapture AuxLeft = MakeAuxiliaryEye(LeftEye, PassType);
+            const FOmniEyeCapture AuxRight = MakeAuxiliaryEye(RightEye, PassType);
             FOmniCaptureEquirectResult AuxResult = ConvertActiveFrame(ActiveSettings, AuxLeft, AuxRight);
             if (AuxResult.PixelData.IsValid())
             {
@@ -1581,7 +1949,12 @@ void UOmniCaptureSubsystem::CaptureFrame()
                 Payload.PixelDataType = AuxResult.PixelDataType;
                 AuxiliaryLayers.Add(GetAuxiliaryLayerName(PassType), MoveTemp(Payload));
             }
+            if (BufferPool.IsValid())
+            {
+                BufferPool->ReleasePreviewPixels(MoveTemp(AuxResult.PreviewPixels));
+            }
         }
+        RecordStage(Timestamps, EOmniCaptureStage::AuxiliaryPasses, StageBegin);
     }
     const bool bRequiresGPU = ActiveSettings.OutputFormat == EOmniOutputFormat::NVENCHardware;
     if (!ConversionResult.PixelData.IsValid())
@@ -1596,10 +1969,93 @@ void UOmniCaptureSubsystem::CaptureFrame()
         return;
     }
 
+    FOmniCaptureFrameMetadata Metadata = MakeFrameMetadata();
+    Metadata.StageTimestamps = Timestamps;
+    SubmitConvertedFrame(ConversionResult, MoveTemp(AuxiliaryLayers), Metadata);
+}
+
+void UOmniCaptureSubsystem::RecordReplayFrame(const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye)
+{
+    FOmniCaptureReplayFrame Frame;
+    Frame.FrameIndex = FrameCounter;
+    Frame.Timecode = FPlatformTime::Seconds() - CaptureStartTime;
+
+    const bool bStereo = ActiveSettings.Mode == EOmniCaptureMode::Stereo;
+    auto ReadLayer = [&Frame, bStereo](EOmniCaptureAuxiliaryPassType PassType, const FOmniEyeCapture& Left, const FOmniEyeCapture& Right)
+    {
+        FOmniCaptureReplayLayer& Layer = Frame.Layers.AddDefaulted_GetRef();
+        Layer.PassType = PassType;
+        return FOmniCaptureEquirectConverter::ReadCubemapOnCPU(Left, Layer.LeftEye)
+            && (!bStereo || FOmniCaptureEquirectConverter::ReadCubemapOnCPU(Right, Layer.RightEye));
+    };
+
+    bool bRead = ReadLayer(EOmniCaptureAuxiliaryPassType::None, LeftEye, RightEye);
+    for (EOmniCaptureAuxiliaryPassType PassType : ActiveSettings.AuxiliaryPasses)
+    {
+        if (bRead && PassType != EOmniCaptureAuxiliaryPassType::None)
+        {
+            bRead = ReadLayer(PassType, MakeAuxiliaryEye(LeftEye, PassType), MakeAuxiliaryEye(RightEye, PassType));
+        }
+    }
+
+    if (!bRead || !ReplayWriter->WriteFrame(Frame))
+    {
+        LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("Replay"), FString::Printf(TEXT("Replay recording stopped at frame %d: the cube faces could not be read back or written."), Frame.FrameIndex));
+        ReplayWriter.Reset();
+        return;
+    }
+
+    if (ReplayWriter->GetFramesWritten() >= ActiveSettings.ReplayRecordFrameCount)
+    {
+        LogDiagnosticMessage(ELogVerbosity::Log, TEXT("Replay"), FString::Printf(TEXT("Recorded %d replay frames to %s"), ReplayWriter->GetFramesWritten(), *ReplayWriter->GetFilePath()));
+        ReplayWriter.Reset();
+    }
+}
+
+FOmniCaptureFrameMetadata UOmniCaptureSubsystem::MakeFrameMetadata()
+{
+    FOmniCaptureFrameMetadata Metadata;
+    Metadata.FrameIndex = FrameCounter++;
+    Metadata.Timecode = FPlatformTime::Seconds() - CaptureStartTime;
+    Metadata.bKeyFrame = (Metadata.FrameIndex % ActiveSettings.Quality.GOPLength) == 0;
+    return Metadata;
+}
+
+void UOmniCaptureSubsystem::SubmitCompletedReadbacks()
+{
+    if (!ReadbackQueue)
+    {
+        return;
+    }
+
+    ReadbackQueue->PopCompleted([this](FOmniCaptureReadbackQueue::FEntry&& Entry)
+    {
+        FOmniCaptureEquirectResult& ConversionResult = Entry.Conversion->Result;
+        if (!ConversionResult.PixelData.IsValid() || !RingBuffer)
+        {
+            HandleDroppedFrame();
+            return;
+        }
+
+        FOmniCaptureStageTimestamps& Timestamps = Entry.Metadata.StageTimestamps;
+        Timestamps.Record(EOmniCaptureStage::Readback, Timestamps.GetBeginSeconds(EOmniCaptureStage::Readback), FPlatformTime::Seconds());
+        SubmitConvertedFrame(ConversionResult, TMap<FName, FOmniCaptureLayerPayload>(), Entry.Metadata);
+    });
+}
+
+void UOmniCaptureSubsystem::DrainReadbackQueue()
+{
+    if (ReadbackQueue)
+    {
+        ReadbackQueue->WaitForAll();
+        SubmitCompletedReadbacks();
+    }
+}
+
+void UOmniCaptureSubsystem::SubmitConvertedFrame(FOmniCaptureEquirectResult& ConversionResult, TMap<FName, FOmniCaptureLayerPayload>&& AuxiliaryLayers, const FOmniCaptureFrameMetadata& Metadata)
+{
     TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
-    Frame->Metadata.FrameIndex = FrameCounter++;
-    Frame->Metadata.Timecode = FPlatformTime::Seconds() - CaptureStartTime;
-    Frame->Metadata.bKeyFrame = (Frame->Metadata.FrameIndex % ActiveSettings.Quality.GOPLength) == 0;
+    Frame->Metadata = Metadata;
 
     ++FramesSinceLastFpsSample;
     const double NowSeconds = FPlatformTime::Seconds();
@@ -1616,6 +2072,19 @@ void UOmniCaptureSubsystem::CaptureFrame()
         LastFpsSampleTime = NowSeconds;
     }
 
+    // The preview is downsampled straight from the converted pixels, and only on frames the preview will show, before
+    // the ring takes ownership of them.
+    bool bUpdatePreview = false;
+    if (PreviewActor.IsValid())
+    {
+        const double Now = FPlatformTime::Seconds();
+        if (PreviewFrameInterval <= 0.0 || (Now - LastPreviewUpdateTime) >= PreviewFrameInterval)
+        {
+            bUpdatePreview = FOmniCaptureEquirectConverter::BuildPreview(ActiveSettings, ConversionResult);
+            LastPreviewUpdateTime = Now;
+        }
+    }
+
     Frame->PixelData = MoveTemp(ConversionResult.PixelData);
     Frame->GPUSource = ConversionResult.OutputTarget;
     Frame->Texture = ConversionResult.Texture;
@@ -1655,26 +2124,41 @@ void UOmniCaptureSubsystem::CaptureFrame()
         bCapturedImageSequenceThisSegment = true;
     }
 
-    RingBuffer->Enqueue(MoveTemp(Frame));
+    if (StageProfiler.IsValid())
+    {
+        StageProfiler->RecordFrame(Frame->Metadata);
+    }
+
+    // Only the start is stamped here: the frame belongs to the ring once Enqueue publishes it, and the worker that
+    // picks it up closes the stage.
+    const double EnqueueTime = FPlatformTime::Seconds();
+    Frame->Metadata.StageTimestamps.Record(EOmniCaptureStage::RingBuffer, EnqueueTime, EnqueueTime);
+    {
+        OMNICAPTURE_STAGE_SCOPE(RingEnqueue);
+        RingBuffer->Enqueue(MoveTemp(Frame));
+    }
 
     if (RingBuffer)
     {
         LatestRingBufferStats = RingBuffer->GetStats();
     }
 
-    if (PreviewActor.IsValid())
+    if (bUpdatePreview && PreviewActor.IsValid())
     {
-        const double Now = FPlatformTime::Seconds();
-        if (PreviewFrameInterval <= 0.0 || (Now - LastPreviewUpdateTime) >= PreviewFrameInterval)
-        {
-            PreviewActor->UpdatePreviewTexture(ConversionResult, ActiveSettings);
-            LastPreviewUpdateTime = Now;
-        }
+        PreviewActor->UpdatePreviewTexture(ConversionResult, ActiveSettings);
+    }
+
+    // After a preview update this is the upload buffer the actor retired, not the pixels just built.
+    if (BufferPool.IsValid())
+    {
+        BufferPool->ReleasePreviewPixels(MoveTemp(ConversionResult.PreviewPixels));
     }
 }
 
 void UOmniCaptureSubsystem::FlushRingBuffer()
 {
+    DrainReadbackQueue();
+
     if (RingBuffer)
     {
         RingBuffer->Flush();
@@ -1957,20 +2441,23 @@ void UOmniCaptureSubsystem::HandleDroppedFrame()
     LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("CaptureLoop"), TEXT("OmniCapture frame dropped"));
 }
 
-void UOmniCaptureSubsystem::ConfigureActiveSegment()
+void UOmniCaptureSubsystem::GetSegmentOutputLocation(int32 SegmentIndex, FString& OutDirectory, FString& OutFileName) const
 {
-    const FString SegmentSuffix = (CurrentSegmentIndex == 0)
+    const FString SegmentSuffix = (SegmentIndex == 0)
         ? FString()
-        : FString::Printf(TEXT("_seg%02d"), CurrentSegmentIndex);
+        : FString::Printf(TEXT("_seg%02d"), SegmentIndex);
 
-    FString SegmentDirectory = BaseOutputDirectory;
+    OutDirectory = BaseOutputDirectory;
     if (ActiveSettings.bCreateSegmentSubfolders)
     {
-        SegmentDirectory = BaseOutputDirectory / FString::Printf(TEXT("Segment_%02d"), CurrentSegmentIndex);
+        OutDirectory = BaseOutputDirectory / FString::Printf(TEXT("Segment_%02d"), SegmentIndex);
     }
+    OutFileName = BaseOutputFileName + SegmentSuffix;
+}
 
-    ActiveSettings.OutputDirectory = SegmentDirectory;
-    ActiveSettings.OutputFileName = BaseOutputFileName + SegmentSuffix;
+void UOmniCaptureSubsystem::ConfigureActiveSegment()
+{
+    GetSegmentOutputLocation(CurrentSegmentIndex, ActiveSettings.OutputDirectory, ActiveSettings.OutputFileName);
 
     IFileManager::Get().MakeDirectory(*ActiveSettings.OutputDirectory, true);
 
@@ -1980,7 +2467,8 @@ void UOmniCaptureSubsystem::ConfigureActiveSegment()
     bCapturedImageSequenceThisSegment = false;
 
     CurrentSegmentStartTime = FPlatformTime::Seconds();
-    LastSegmentSizeCheckTime = CurrentSegmentStartTime;
+    LastPipeOutputSizeCheckTime = CurrentSegmentStartTime;
+    PipeOutputBytes = 0;
 }
 
 void UOmniCaptureSubsystem::RotateSegmentIfNeeded()
@@ -2012,15 +2500,17 @@ void UOmniCaptureSubsystem::RotateSegmentIfNeeded()
 
     if (!bShouldRotate && ActiveSettings.SegmentSizeLimitMB > 0)
     {
-        if ((Now - LastSegmentSizeCheckTime) >= 1.0)
+        // The FFmpeg output file is the only size that still needs a stat, so it keeps the once per second poll.
+        if (FFmpegPipe && !RecordedVideoPath.IsEmpty() && (Now - LastPipeOutputSizeCheckTime) >= 1.0)
         {
-            LastSegmentSizeCheckTime = Now;
-            const int64 SegmentBytes = CalculateActiveSegmentSizeBytes();
-            const int64 LimitBytes = static_cast<int64>(ActiveSettings.SegmentSizeLimitMB) * 1024 * 1024;
-            if (LimitBytes > 0 && SegmentBytes >= LimitBytes)
-            {
-                bShouldRotate = true;
-            }
+            LastPipeOutputSizeCheckTime = Now;
+            PipeOutputBytes = FMath::Max<int64>(0, IFileManager::Get().FileSize(*RecordedVideoPath));
+        }
+
+        const int64 LimitBytes = static_cast<int64>(ActiveSettings.SegmentSizeLimitMB) * 1024 * 1024;
+        if (CalculateActiveSegmentSizeBytes() >= LimitBytes)
+        {
+            bShouldRotate = true;
         }
     }
 
@@ -2031,6 +2521,8 @@ void UOmniCaptureSubsystem::RotateSegmentIfNeeded()
 
     LogDiagnosticMessage(ELogVerbosity::Log, TEXT("SegmentRotation"), FString::Printf(TEXT("Rotating capture segment -> %d"), CurrentSegmentIndex + 1));
 
+    DrainReadbackQueue();
+
     if (RingBuffer)
     {
         RingBuffer->Flush();
@@ -2041,9 +2533,16 @@ void UOmniCaptureSubsystem::RotateSegmentIfNeeded()
         OutputMuxer->EndRealtimeSession();
     }
 
-    ShutdownAudioRecording();
-    ShutdownOutputWriters(true);
-    CompleteActiveSegment(true);
+    // The recorder keeps running across segments; its WAV is cut at the latest submix buffer so segments join gaplessly.
+    if (AudioRecorder)
+    {
+        FString NextDirectory;
+        FString NextFileName;
+        GetSegmentOutputLocation(CurrentSegmentIndex + 1, NextDirectory, NextFileName);
+        RecordedAudioPath = AudioRecorder->GetOutputFilePath();
+        RecordedAudioClosed = AudioRecorder->SplitOutput(NextDirectory, NextFileName);
+    }
+    SubmitActiveSegmentForFinalization();
 
     ++CurrentSegmentIndex;
     ConfigureActiveSegment();
@@ -2062,10 +2561,14 @@ void UOmniCaptureSubsystem::RotateSegmentIfNeeded()
         AudioStats = FOmniAudioSyncStats();
     }
 
-    InitializeAudioRecording();
+    if (!AudioRecorder)
+    {
+        InitializeAudioRecording();
+    }
 
     CurrentSegmentStartTime = FPlatformTime::Seconds();
-    LastSegmentSizeCheckTime = CurrentSegmentStartTime;
+    LastPipeOutputSizeCheckTime = CurrentSegmentStartTime;
+    PipeOutputBytes = 0;
     LastFpsSampleTime = 0.0;
     FramesSinceLastFpsSample = 0;
 }
@@ -2113,64 +2616,26 @@ void UOmniCaptureSubsystem::CompleteActiveSegment(bool bStoreResults)
 
 int64 UOmniCaptureSubsystem::CalculateActiveSegmentSizeBytes() const
 {
+    // Writers publish their own byte counters, so this no longer walks the output directory.
     int64 TotalBytes = 0;
-    IFileManager& FileManager = IFileManager::Get();
-
-    if (ActiveSettings.OutputFormat == EOmniOutputFormat::NVENCHardware)
+    if (ImageWriter)
     {
-        if (!RecordedVideoPath.IsEmpty())
-        {
-            const int64 BitstreamSize = FileManager.FileSize(*RecordedVideoPath);
-            if (BitstreamSize > 0)
-            {
-                TotalBytes += BitstreamSize;
-            }
-        }
+        TotalBytes += ImageWriter->GetBytesWritten();
     }
-    else
+    if (NVENCEncoder)
     {
-        class FSegmentStatVisitor final : public IPlatformFile::FDirectoryStatVisitor
-        {
-        public:
-            FSegmentStatVisitor(const FString& InPrefix, int64& InTotal)
-                : Prefix(InPrefix)
-                , Total(InTotal)
-            {
-            }
-
-            virtual bool Visit(const TCHAR* FilenameOrDirectory, const FFileStatData& StatData) override
-            {
-                if (StatData.bIsDirectory)
-                {
-                    return true;
-                }
-
-                const FString FileName = FPaths::GetCleanFilename(FilenameOrDirectory);
-                if (Prefix.IsEmpty() || FileName.StartsWith(Prefix))
-                {
-                    Total += StatData.FileSize;
-                }
-                return true;
-            }
-
-        private:
-            FString Prefix;
-            int64& Total;
-        };
-
-        FSegmentStatVisitor Visitor(ActiveSettings.OutputFileName, TotalBytes);
-        FileManager.IterateDirectoryStat(*ActiveSettings.OutputDirectory, Visitor);
+        TotalBytes += NVENCEncoder->GetBytesWritten();
     }
-
-    if (!RecordedAudioPath.IsEmpty())
+    if (FFmpegPipe)
     {
-        const int64 AudioSize = FileManager.FileSize(*RecordedAudioPath);
-        if (AudioSize > 0)
-        {
-            TotalBytes += AudioSize;
-        }
+        // The encoded file is written by the FFmpeg process; the raw frames piped into it say nothing about its size,
+        // so this is the size last polled by RotateSegmentIfNeeded.
+        TotalBytes += PipeOutputBytes;
+    }
+    if (AudioRecorder)
+    {
+        TotalBytes += AudioRecorder->GetBytesWritten();
     }
-
     return TotalBytes;
 }
 
@@ -5,6 +5,9 @@
 
 namespace
 {
+    constexpr int32 GPreviewBaseLongEdge = 1024;
+    constexpr int32 GPreviewMinLongEdge = 64;
+
     FORCEINLINE int32 AlignDimension(int32 Value, int32 Alignment)
     {
         if (Value <= 0)
@@ -141,6 +144,21 @@ FIntPoint FOmniCaptureSettings::GetOutputResolution() const
     return GetEquirectResolution();
 }
 
+FIntPoint FOmniCaptureSettings::GetPreviewResolution() const
+{
+    const FIntPoint OutputSize = GetOutputResolution();
+    const int32 LongEdge = FMath::Max(OutputSize.X, OutputSize.Y);
+    if (LongEdge <= 0)
+    {
+        return OutputSize;
+    }
+
+    const int32 PreviewEdge = FMath::Clamp(FMath::RoundToInt(GPreviewBaseLongEdge * PreviewScreenScale), FMath::Min(GPreviewMinLongEdge, LongEdge), LongEdge);
+    return FIntPoint(
+        FMath::Max(1, static_cast<int32>(static_cast<int64>(OutputSize.X) * PreviewEdge / LongEdge)),
+        FMath::Max(1, static_cast<int32>(static_cast<int64>(OutputSize.Y) * PreviewEdge / LongEdge)));
+}
+
 FIntPoint FOmniCaptureSettings::GetPerEyeOutputResolution() const
 {
     if (IsPlanar())
@@ -392,6 +410,8 @@ FString FOmniCaptureSettings::GetImageFileExtension() const
         return TEXT(".exr");
     case EOmniCaptureImageFormat::BMP:
         return TEXT(".bmp");
+    case EOmniCaptureImageFormat::RawDump:
+        return TEXT(".omniraw");
     case EOmniCaptureImageFormat::PNG:
     default:
         return TEXT(".png");
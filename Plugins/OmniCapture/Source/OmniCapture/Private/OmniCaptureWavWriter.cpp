@@ -0,0 +1,304 @@
+#include "OmniCaptureWavWriter.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/Archive.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureWav, Log, All);
+
+namespace
+{
+    constexpr uint32 GWriterWaitMs = 20;
+    constexpr double GHeaderPatchIntervalSeconds = 1.0;
+    constexpr int32 GWavHeaderBytes = 44;
+    constexpr int32 GDefaultSampleRate = 48000;
+    constexpr int32 GDefaultChannels = 2;
+
+    void PutLE32(uint8* Destination, uint32 Value)
+    {
+        Destination[0] = static_cast<uint8>(Value);
+        Destination[1] = static_cast<uint8>(Value >> 8);
+        Destination[2] = static_cast<uint8>(Value >> 16);
+        Destination[3] = static_cast<uint8>(Value >> 24);
+    }
+
+    void PutLE16(uint8* Destination, uint16 Value)
+    {
+        Destination[0] = static_cast<uint8>(Value);
+        Destination[1] = static_cast<uint8>(Value >> 8);
+    }
+}
+
+class FOmniCaptureWavWriterThread final : public FRunnable
+{
+public:
+    explicit FOmniCaptureWavWriterThread(FOmniCaptureWavWriter& InOwner)
+        : Owner(InOwner)
+    {
+    }
+
+    virtual uint32 Run() override
+    {
+        Owner.RunWriter();
+        return 0;
+    }
+
+private:
+    FOmniCaptureWavWriter& Owner;
+};
+
+FOmniCaptureWavWriter::FOmniCaptureWavWriter() = default;
+
+FOmniCaptureWavWriter::~FOmniCaptureWavWriter()
+{
+    Close();
+
+    if (WakeEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        WakeEvent = nullptr;
+    }
+}
+
+bool FOmniCaptureWavWriter::Open(const FString& InFilePath)
+{
+    if (Thread.IsValid())
+    {
+        return false;
+    }
+
+    Ring.Reset();
+    DroppedBuffers = 0;
+    FilePath = InFilePath;
+    if (!OpenFile(InFilePath))
+    {
+        return false;
+    }
+
+    if (!WakeEvent)
+    {
+        WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+    }
+
+    bRunning = true;
+    Runnable = new FOmniCaptureWavWriterThread(*this);
+    Thread.Reset(FRunnableThread::Create(Runnable, TEXT("OmniCaptureWavWriter")));
+    return Thread.IsValid();
+}
+
+bool FOmniCaptureWavWriter::Push(const float* Samples, int32 NumSamples, int32 NumChannels, int32 SampleRate, double Timestamp, float Gain)
+{
+    if (!Ring.Write(Samples, NumSamples, NumChannels, SampleRate, Timestamp, Gain))
+    {
+        DroppedBuffers.IncrementExchange();
+        return false;
+    }
+    return true;
+}
+
+TFuture<FString> FOmniCaptureWavWriter::Split(const FString& NewFilePath)
+{
+    if (!Thread.IsValid())
+    {
+        return TFuture<FString>();
+    }
+
+    TFuture<FString> Closed;
+    {
+        FScopeLock Lock(&SplitCS);
+        FSplitRequest& Request = PendingSplits.AddDefaulted_GetRef();
+        Request.BoundaryChunk = Ring.GetWrittenChunkCount();
+        Request.FilePath = NewFilePath;
+        Closed = Request.Closed.GetFuture();
+    }
+    FilePath = NewFilePath;
+    WakeEvent->Trigger();
+    return Closed;
+}
+
+FString FOmniCaptureWavWriter::Close()
+{
+    if (Thread.IsValid())
+    {
+        bRunning = false;
+        WakeEvent->Trigger();
+        Thread->WaitForCompletion();
+        Thread.Reset();
+
+        delete Runnable;
+        Runnable = nullptr;
+    }
+
+    // Covers Open failing after the file was created, when no writer thread ever ran.
+    CloseFile();
+    return FilePath;
+}
+
+void FOmniCaptureWavWriter::RunWriter()
+{
+    LastPatchTime = FPlatformTime::Seconds();
+    for (;;)
+    {
+        const bool bStopping = !bRunning.Load();
+
+        ProcessSplits();
+
+        // A split queued since ProcessSplits must not have later buffers drained into the file it closes.
+        int32 MaxChunks = MAX_int32;
+        {
+            FScopeLock Lock(&SplitCS);
+            if (PendingSplits.Num() > 0)
+            {
+                MaxChunks = static_cast<int32>(PendingSplits[0].BoundaryChunk - Ring.GetReadChunkCount());
+            }
+        }
+        DrainChunks(MaxChunks);
+
+        if (FPlatformTime::Seconds() - LastPatchTime >= GHeaderPatchIntervalSeconds)
+        {
+            PatchHeader();
+        }
+
+        // The producer is unregistered and every split queued before Close, so the pass above was the last one.
+        if (bStopping)
+        {
+            break;
+        }
+
+        WakeEvent->Wait(GWriterWaitMs);
+    }
+
+    CloseFile();
+}
+
+void FOmniCaptureWavWriter::ProcessSplits()
+{
+    for (;;)
+    {
+        FSplitRequest Request;
+        {
+            FScopeLock Lock(&SplitCS);
+            if (PendingSplits.Num() == 0)
+            {
+                return;
+            }
+            Request = MoveTemp(PendingSplits[0]);
+            PendingSplits.RemoveAt(0);
+        }
+
+        DrainChunks(static_cast<int32>(Request.BoundaryChunk - Ring.GetReadChunkCount()));
+        const FString CompletedPath = WriterFilePath;
+        CloseFile();
+        OpenFile(Request.FilePath);
+        Request.Closed.SetValue(CompletedPath);
+    }
+}
+
+void FOmniCaptureWavWriter::DrainChunks(int32 MaxChunks)
+{
+    Ring.Consume(MaxChunks, [this](const FOmniCaptureAudioRing::FChunkView& View)
+    {
+        if (!Archive)
+        {
+            return;
+        }
+
+        if (FileSampleRate == 0)
+        {
+            FileSampleRate = View.SampleRate;
+            FileChannels = View.NumChannels;
+            PatchHeader();
+        }
+        else if (View.SampleRate != FileSampleRate || View.NumChannels != FileChannels)
+        {
+            if (DroppedBuffers.IncrementExchange() == 0)
+            {
+                UE_LOG(LogOmniCaptureWav, Warning, TEXT("Dropping %d Hz x%d audio: %s was started at %d Hz x%d."), View.SampleRate, View.NumChannels, *WriterFilePath, FileSampleRate, FileChannels);
+            }
+            return;
+        }
+
+        Archive->Serialize(const_cast<int16*>(View.First.GetData()), View.First.Num() * sizeof(int16));
+        if (View.Second.Num() > 0)
+        {
+            Archive->Serialize(const_cast<int16*>(View.Second.GetData()), View.Second.Num() * sizeof(int16));
+        }
+        DataBytesWritten.AddExchange(static_cast<int64>(View.First.Num() + View.Second.Num()) * sizeof(int16));
+    });
+}
+
+bool FOmniCaptureWavWriter::OpenFile(const FString& InFilePath)
+{
+    WriterFilePath = InFilePath;
+    FileSampleRate = 0;
+    FileChannels = 0;
+    DataBytesWritten = 0;
+
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(WriterFilePath), true);
+    Archive.Reset(IFileManager::Get().CreateFileWriter(*WriterFilePath));
+    if (!Archive)
+    {
+        UE_LOG(LogOmniCaptureWav, Error, TEXT("Failed to open %s for writing."), *WriterFilePath);
+        return false;
+    }
+
+    // Provisional header; rewritten with the real format once the first buffer arrives.
+    WriteHeader(*Archive, GDefaultSampleRate, GDefaultChannels, 0);
+    return true;
+}
+
+void FOmniCaptureWavWriter::CloseFile()
+{
+    if (!Archive)
+    {
+        return;
+    }
+
+    PatchHeader();
+    Archive->Close();
+    Archive.Reset();
+    UE_LOG(LogOmniCaptureWav, Log, TEXT("Audio written to %s (%.1f MB)."), *WriterFilePath, DataBytesWritten.Load() / (1024.0 * 1024.0));
+}
+
+void FOmniCaptureWavWriter::PatchHeader()
+{
+    LastPatchTime = FPlatformTime::Seconds();
+    if (!Archive)
+    {
+        return;
+    }
+
+    const int64 EndOffset = Archive->Tell();
+    Archive->Seek(0);
+    WriteHeader(*Archive, FileSampleRate > 0 ? FileSampleRate : GDefaultSampleRate, FileChannels > 0 ? FileChannels : GDefaultChannels, DataBytesWritten.Load());
+    Archive->Seek(EndOffset);
+    Archive->Flush();
+}
+
+void FOmniCaptureWavWriter::WriteHeader(FArchive& Archive, int32 SampleRate, int32 NumChannels, int64 DataBytes)
+{
+    // RIFF sizes are 32-bit; a take past 4 GB keeps growing on disk but its header saturates.
+    const uint32 DataSize = static_cast<uint32>(FMath::Min<int64>(DataBytes, MAX_uint32 - (GWavHeaderBytes - 8)));
+    const uint16 BlockAlign = static_cast<uint16>(NumChannels * sizeof(int16));
+
+    uint8 Header[GWavHeaderBytes];
+    FMemory::Memcpy(Header + 0, "RIFF", 4);
+    PutLE32(Header + 4, DataSize + (GWavHeaderBytes - 8));
+    FMemory::Memcpy(Header + 8, "WAVE", 4);
+    FMemory::Memcpy(Header + 12, "fmt ", 4);
+    PutLE32(Header + 16, 16);
+    PutLE16(Header + 20, 1);
+    PutLE16(Header + 22, static_cast<uint16>(NumChannels));
+    PutLE32(Header + 24, static_cast<uint32>(SampleRate));
+    PutLE32(Header + 28, static_cast<uint32>(SampleRate) * BlockAlign);
+    PutLE16(Header + 32, BlockAlign);
+    PutLE16(Header + 34, 16);
+    FMemory::Memcpy(Header + 36, "data", 4);
+    PutLE32(Header + 40, DataSize);
+    Archive.Serialize(Header, GWavHeaderBytes);
+}
@@ -0,0 +1,73 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCaptureAudioRing.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureAudioRingConvertTest, "OmniCapture.AudioRing.Convert", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureAudioRingConvertTest::RunTest(const FString& Parameters)
+{
+    // Nine samples so both the vector body and the scalar tail are exercised.
+    const float Source[] = { 0.0f, 1.0f, -1.0f, 2.0f, -2.0f, 0.25f, -0.25f, 0.5f, 1.5f };
+    int16 Destination[UE_ARRAY_COUNT(Source)] = {};
+
+    FOmniCaptureAudioRing::ConvertToPCM16(Source, Destination, UE_ARRAY_COUNT(Source), 1.0f);
+    TestEqual(TEXT("Silence"), Destination[0], static_cast<int16>(0));
+    TestEqual(TEXT("Full scale"), Destination[1], static_cast<int16>(32767));
+    TestEqual(TEXT("Negative full scale"), Destination[2], static_cast<int16>(-32767));
+    TestEqual(TEXT("Positive overload clamps"), Destination[3], static_cast<int16>(32767));
+    TestEqual(TEXT("Negative overload clamps"), Destination[4], static_cast<int16>(-32768));
+    TestEqual(TEXT("Quarter scale"), Destination[5], static_cast<int16>(8192));
+    TestEqual(TEXT("Tail sample clamps"), Destination[8], static_cast<int16>(32767));
+
+    FOmniCaptureAudioRing::ConvertToPCM16(Source, Destination, UE_ARRAY_COUNT(Source), 0.5f);
+    TestEqual(TEXT("Gain is applied before clamping"), Destination[3], static_cast<int16>(32767));
+    TestEqual(TEXT("Gain halves the signal"), Destination[1], static_cast<int16>(16384));
+    TestEqual(TEXT("Gain applies to the tail"), Destination[8], static_cast<int16>(24575));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureAudioRingReadWriteTest, "OmniCapture.AudioRing.ReadWrite", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureAudioRingReadWriteTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 SampleRate = 100;
+    constexpr int32 NumChannels = 2;
+    constexpr int32 ChunkSamples = 20;
+    const double ChunkDuration = static_cast<double>(ChunkSamples) / (SampleRate * NumChannels);
+
+    TArray<float> Chunk;
+    Chunk.Init(0.5f, ChunkSamples);
+
+    FOmniCaptureAudioRing Ring;
+    Ring.Reset(64, 4);
+    TestEqual(TEXT("Capacity rounds up to a power of two"), Ring.GetSampleCapacity(), 64);
+
+    TestTrue(TEXT("First chunk fits"), Ring.Write(Chunk.GetData(), ChunkSamples, NumChannels, SampleRate, 0.0, 1.0f));
+    TestTrue(TEXT("Second chunk fits"), Ring.Write(Chunk.GetData(), ChunkSamples, NumChannels, SampleRate, ChunkDuration, 1.0f));
+    TestTrue(TEXT("Third chunk fits"), Ring.Write(Chunk.GetData(), ChunkSamples, NumChannels, SampleRate, 2.0 * ChunkDuration, 1.0f));
+    TestFalse(TEXT("Fourth chunk exceeds the sample capacity"), Ring.Write(Chunk.GetData(), ChunkSamples, NumChannels, SampleRate, 3.0 * ChunkDuration, 1.0f));
+    TestEqual(TEXT("Rejected chunk is not queued"), Ring.GetPendingChunkCount(), 3);
+
+    TArray<FOmniAudioPacket> Packets;
+    TestEqual(TEXT("Chunks after the threshold stay queued"), Ring.Read(ChunkDuration, Packets), 2);
+    if (TestEqual(TEXT("Continuous chunks merge into one packet"), Packets.Num(), 1))
+    {
+        TestEqual(TEXT("Merged packet holds both chunks"), Packets[0].PCM16.Num(), 2 * ChunkSamples);
+        TestEqual(TEXT("Merged packet keeps the first timestamp"), Packets[0].Timestamp, 0.0);
+        TestEqual(TEXT("Samples are converted"), Packets[0].PCM16[0], static_cast<int16>(16384));
+    }
+
+    // The next chunk wraps around the end of the sample storage; after a gap it must start a new packet.
+    TestTrue(TEXT("Wrapping chunk fits once space is released"), Ring.Write(Chunk.GetData(), ChunkSamples, NumChannels, SampleRate, 10.0, 1.0f));
+    Packets.Reset();
+    TestEqual(TEXT("Remaining chunks are read"), Ring.Read(100.0, Packets), 2);
+    if (TestEqual(TEXT("A timestamp gap splits packets"), Packets.Num(), 2))
+    {
+        TestEqual(TEXT("Wrapped packet size"), Packets[1].PCM16.Num(), ChunkSamples);
+        TestEqual(TEXT("Wrapped packet timestamp"), Packets[1].Timestamp, 10.0);
+        TestTrue(TEXT("Wrapped samples survive"), Packets[1].PCM16[0] == 16384 && Packets[1].PCM16.Last() == 16384);
+    }
+
+    TestTrue(TEXT("Write after drain"), Ring.Write(Chunk.GetData(), ChunkSamples, NumChannels, SampleRate, 11.0, 1.0f));
+    Ring.Discard();
+    TestEqual(TEXT("Discard empties the ring"), Ring.GetPendingChunkCount(), 0);
+    return true;
+}
@@ -0,0 +1,425 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCaptureCPUSampler.h"
+#include "OmniCaptureEquirectConverter.h"
+#include "OmniCaptureImageWriter.h"
+#include "OmniCaptureRingBuffer.h"
+#include "OmniCaptureTestCubemaps.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Interfaces/IPluginManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+// Perf-filter tests: run with -ExecCmds="Automation RunFilter Perf" (or RunTests OmniCapture.Benchmark) under -nullrhi.
+// Results are merged into one JSON report, by default Saved/OmniCapture/Benchmarks/OmniCaptureBenchmark.json, or the
+// path given with -OmniCaptureBenchmarkReport=.
+namespace
+{
+    constexpr int32 GBenchmarkMaxFaceResolution = 2048;
+    constexpr int32 GRingBenchmarkFrames = 2000;
+    constexpr double GRingConsumerWorkSeconds = 0.0002;
+
+    /** Samples process memory between iterations; the peak is reported relative to the start of the case. */
+    struct FBenchmarkMemory
+    {
+        uint64 Baseline = FPlatformMemory::GetStats().UsedPhysical;
+        uint64 Peak = Baseline;
+
+        void Sample()
+        {
+            Peak = FMath::Max<uint64>(Peak, FPlatformMemory::GetStats().UsedPhysical);
+        }
+
+        double GetPeakMB() const
+        {
+            return (Peak - Baseline) / (1024.0 * 1024.0);
+        }
+    };
+
+    TSharedPtr<FJsonObject> MakeCase(const FString& Name, int32 Frames, double Seconds, double Bytes, const FBenchmarkMemory& Memory)
+    {
+        const double SafeSeconds = FMath::Max(Seconds, 1e-9);
+        TSharedPtr<FJsonObject> Case = MakeShared<FJsonObject>();
+        Case->SetStringField(TEXT("name"), Name);
+        Case->SetNumberField(TEXT("frames"), Frames);
+        Case->SetNumberField(TEXT("msPerFrame"), Frames > 0 ? Seconds * 1000.0 / Frames : 0.0);
+        Case->SetNumberField(TEXT("mbPerSecond"), Bytes / (1024.0 * 1024.0) / SafeSeconds);
+        Case->SetNumberField(TEXT("peakMemoryMB"), Memory.GetPeakMB());
+        return Case;
+    }
+
+    FString GetReportPath()
+    {
+        FString Path;
+        if (FParse::Value(FCommandLine::Get(), TEXT("OmniCaptureBenchmarkReport="), Path) && !Path.IsEmpty())
+        {
+            return Path;
+        }
+        return FPaths::ProjectSavedDir() / TEXT("OmniCapture/Benchmarks/OmniCaptureBenchmark.json");
+    }
+
+    /** Replaces Group in the shared report, so each benchmark can run on its own without losing the others' numbers. */
+    bool WriteReport(const FString& Group, const TArray<TSharedPtr<FJsonValue>>& Cases)
+    {
+        const FString ReportPath = GetReportPath();
+
+        TSharedPtr<FJsonObject> Root;
+        FString Existing;
+        if (FFileHelper::LoadFileToString(Existing, *ReportPath))
+        {
+            const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Existing);
+            FJsonSerializer::Deserialize(Reader, Root);
+        }
+        if (!Root.IsValid())
+        {
+            Root = MakeShared<FJsonObject>();
+        }
+
+        const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("OmniCapture"));
+        Root->SetStringField(TEXT("pluginVersion"), Plugin.IsValid() ? Plugin->GetDescriptor().VersionName : FString());
+        Root->SetStringField(TEXT("engineVersion"), FEngineVersion::Current().ToString());
+        Root->SetStringField(TEXT("cpu"), FPlatformMisc::GetCPUBrand().TrimStartAndEnd());
+        Root->SetNumberField(TEXT("logicalCores"), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+        Root->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+        Root->SetArrayField(Group, Cases);
+
+        FString Output;
+        const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+        IFileManager::Get().MakeDirectory(*FPaths::GetPath(ReportPath), true);
+        return FJsonSerializer::Serialize(Root.ToSharedRef(), Writer) && FFileHelper::SaveStringToFile(Output, *ReportPath);
+    }
+
+    struct FWriterInput
+    {
+        const TCHAR* Label;
+        EOmniCapturePixelDataType PixelDataType;
+        EOmniCapturePixelPrecision Precision;
+        bool bLinear;
+    };
+
+    TUniquePtr<FOmniCaptureFrame> MakeWriterFrame(const FWriterInput& Input, const FIntPoint& Size, int32 FrameIndex)
+    {
+        TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
+        Frame->Metadata.FrameIndex = FrameIndex;
+        Frame->bLinearColor = Input.bLinear;
+        Frame->PixelDataType = Input.PixelDataType;
+        Frame->PixelPrecision = Input.Precision;
+
+        // Noise on top of a gradient so the encoders cannot collapse the image into a few runs.
+        FRandomStream Random(FrameIndex + 1);
+        const int32 PixelCount = Size.X * Size.Y;
+        auto Value = [&Random, &Size](int32 Index) { return FMath::Clamp(static_cast<float>(Index % Size.X) / Size.X + Random.FRandRange(-0.05f, 0.05f), 0.0f, 1.0f); };
+
+        switch (Input.PixelDataType)
+        {
+        case EOmniCapturePixelDataType::LinearColorFloat32:
+        {
+            TUniquePtr<TImagePixelData<FLinearColor>> Pixels = MakeUnique<TImagePixelData<FLinearColor>>(Size);
+            Pixels->Pixels.SetNumUninitialized(PixelCount);
+            for (int32 Index = 0; Index < PixelCount; ++Index)
+            {
+                const float V = Value(Index);
+                Pixels->Pixels[Index] = FLinearColor(V, 1.0f - V, V * 0.5f, 1.0f);
+            }
+            Frame->PixelData = MoveTemp(Pixels);
+            break;
+        }
+        case EOmniCapturePixelDataType::LinearColorFloat16:
+        {
+            TUniquePtr<TImagePixelData<FFloat16Color>> Pixels = MakeUnique<TImagePixelData<FFloat16Color>>(Size);
+            Pixels->Pixels.SetNumUninitialized(PixelCount);
+            for (int32 Index = 0; Index < PixelCount; ++Index)
+            {
+                const float V = Value(Index);
+                Pixels->Pixels[Index] = FFloat16Color(FLinearColor(V, 1.0f - V, V * 0.5f, 1.0f));
+            }
+            Frame->PixelData = MoveTemp(Pixels);
+            break;
+        }
+        default:
+        {
+            TUniquePtr<TImagePixelData<FColor>> Pixels = MakeUnique<TImagePixelData<FColor>>(Size);
+            Pixels->Pixels.SetNumUninitialized(PixelCount);
+            for (int32 Index = 0; Index < PixelCount; ++Index)
+            {
+                const uint8 V = static_cast<uint8>(Value(Index) * 255.0f);
+                Pixels->Pixels[Index] = FColor(V, 255 - V, V / 2, 255);
+            }
+            Frame->PixelData = MoveTemp(Pixels);
+            break;
+        }
+        }
+        return Frame;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureConverterBenchmark, "OmniCapture.Benchmark.CPUConversion", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FOmniCaptureConverterBenchmark::RunTest(const FString& Parameters)
+{
+    // Faces are capped so the 8K cases fit on build machines; the output size, which dominates the cost, is not.
+    // Both eyes sample the same cubemap, which only halves the source memory.
+    struct FResolutionCase { const TCHAR* Label; int32 OutputWidth; int32 Iterations; };
+    const FResolutionCase Resolutions[] = { { TEXT("2K"), 2048, 8 }, { TEXT("4K"), 4096, 4 }, { TEXT("8K"), 8192, 2 } };
+
+    TArray<TSharedPtr<FJsonValue>> Cases;
+    for (const EOmniCaptureProjection Projection : { EOmniCaptureProjection::Equirectangular, EOmniCaptureProjection::Fisheye })
+    {
+        for (const FResolutionCase& Resolution : Resolutions)
+        {
+            for (const EOmniCaptureMode Mode : { EOmniCaptureMode::Mono, EOmniCaptureMode::Stereo })
+            {
+                for (const EOmniCaptureCPUSampling Sampling : { EOmniCaptureCPUSampling::Nearest, EOmniCaptureCPUSampling::Bilinear })
+                {
+                    FOmniCaptureSettings Settings;
+                    Settings.Projection = Projection;
+                    Settings.Mode = Mode;
+                    Settings.Resolution = Resolution.OutputWidth / 2;
+                    Settings.FisheyeResolution = FIntPoint(Resolution.OutputWidth / 2, Resolution.OutputWidth / 2);
+                    Settings.OutputFormat = EOmniOutputFormat::ImageSequence;
+                    Settings.Gamma = EOmniCaptureGamma::SRGB;
+                    Settings.CPUSampling = Sampling;
+
+                    const int32 FaceResolution = FMath::Min(Settings.Resolution, GBenchmarkMaxFaceResolution);
+                    const FString Name = FString::Printf(TEXT("%s %s %s %s"), Projection == EOmniCaptureProjection::Fisheye ? TEXT("Fisheye") : TEXT("Equirect"), Resolution.Label, Mode == EOmniCaptureMode::Stereo ? TEXT("Stereo") : TEXT("Mono"), Sampling == EOmniCaptureCPUSampling::Bilinear ? TEXT("Bilinear") : TEXT("Nearest"));
+
+                    FBenchmarkMemory Memory;
+                    FOmniCaptureCPUCubemap Cubemap;
+                    FillTestCubemap(Cubemap, FaceResolution, EOmniCapturePixelPrecision::FullFloat, [FaceResolution](int32 FaceIndex, int32 X, int32 Y)
+                    {
+                        return FLinearColor(static_cast<float>(X) / FaceResolution, static_cast<float>(Y) / FaceResolution, FaceIndex / 5.0f, 1.0f);
+                    });
+
+                    // The first frame builds the cached sample map; it is reported on its own and not in the average.
+                    const double BuildStart = FPlatformTime::Seconds();
+                    FOmniCaptureEquirectResult WarmUp;
+                    const bool bConverted = FOmniCaptureEquirectConverter::ConvertCubemapsOnCPU(Settings, Cubemap, Cubemap, WarmUp);
+                    const double FirstFrameSeconds = FPlatformTime::Seconds() - BuildStart;
+                    Memory.Sample();
+                    if (!TestTrue(FString::Printf(TEXT("%s converts"), *Name), bConverted && WarmUp.PixelData.IsValid()))
+                    {
+                        FOmniCaptureEquirectConverter::ReleaseCPUConversionCache();
+                        continue;
+                    }
+                    const FIntPoint OutputSize = WarmUp.Size;
+                    WarmUp = FOmniCaptureEquirectResult();
+
+                    double Seconds = 0.0;
+                    for (int32 Iteration = 0; Iteration < Resolution.Iterations; ++Iteration)
+                    {
+                        FOmniCaptureEquirectResult Result;
+                        const double Start = FPlatformTime::Seconds();
+                        FOmniCaptureEquirectConverter::ConvertCubemapsOnCPU(Settings, Cubemap, Cubemap, Result);
+                        Seconds += FPlatformTime::Seconds() - Start;
+                        Memory.Sample();
+                    }
+
+                    const double OutputBytes = static_cast<double>(OutputSize.X) * OutputSize.Y * sizeof(FColor) * Resolution.Iterations;
+                    TSharedPtr<FJsonObject> Case = MakeCase(Name, Resolution.Iterations, Seconds, OutputBytes, Memory);
+                    Case->SetStringField(TEXT("outputSize"), FString::Printf(TEXT("%dx%d"), OutputSize.X, OutputSize.Y));
+                    Case->SetNumberField(TEXT("faceResolution"), FaceResolution);
+                    Case->SetNumberField(TEXT("firstFrameMs"), FirstFrameSeconds * 1000.0);
+                    Cases.Add(MakeShared<FJsonValueObject>(Case));
+                    AddInfo(FString::Printf(TEXT("%s: %.2f ms/frame"), *Name, Seconds * 1000.0 / Resolution.Iterations));
+
+                    FOmniCaptureEquirectConverter::ReleaseCPUConversionCache();
+                }
+            }
+        }
+    }
+
+    TestTrue(TEXT("Report written"), WriteReport(TEXT("conversion"), Cases));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureImageWriterBenchmark, "OmniCapture.Benchmark.ImageWriter", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FOmniCaptureImageWriterBenchmark::RunTest(const FString& Parameters)
+{
+    const FString Directory = FPaths::AutomationTransientDir() / TEXT("OmniCaptureBenchmark");
+    const FIntPoint Size(2048, 1024);
+    constexpr int32 FramesPerCase = 8;
+
+    const FWriterInput Color8 = { TEXT("8-bit sRGB"), EOmniCapturePixelDataType::Color8, EOmniCapturePixelPrecision::Unknown, false };
+    const FWriterInput Half = { TEXT("Half float"), EOmniCapturePixelDataType::LinearColorFloat16, EOmniCapturePixelPrecision::HalfFloat, true };
+    const FWriterInput Full = { TEXT("Float"), EOmniCapturePixelDataType::LinearColorFloat32, EOmniCapturePixelPrecision::FullFloat, true };
+
+    struct FWriterCase
+    {
+        EOmniCaptureImageFormat Format;
+        EOmniCapturePNGBitDepth PNGBitDepth;
+        FWriterInput Input;
+    };
+    TArray<FWriterCase> WriterCases;
+    for (const EOmniCapturePNGBitDepth BitDepth : { EOmniCapturePNGBitDepth::BitDepth8, EOmniCapturePNGBitDepth::BitDepth16, EOmniCapturePNGBitDepth::BitDepth32 })
+    {
+        for (const FWriterInput& Input : { Color8, Half, Full })
+        {
+            WriterCases.Add({ EOmniCaptureImageFormat::PNG, BitDepth, Input });
+        }
+    }
+    for (const EOmniCaptureImageFormat Format : { EOmniCaptureImageFormat::JPG, EOmniCaptureImageFormat::BMP, EOmniCaptureImageFormat::EXR, EOmniCaptureImageFormat::RawDump })
+    {
+        for (const FWriterInput& Input : { Color8, Half, Full })
+        {
+            WriterCases.Add({ Format, EOmniCapturePNGBitDepth::BitDepth32, Input });
+        }
+    }
+
+    const UEnum* FormatEnum = StaticEnum<EOmniCaptureImageFormat>();
+    const UEnum* BitDepthEnum = StaticEnum<EOmniCapturePNGBitDepth>();
+
+    TArray<TSharedPtr<FJsonValue>> Cases;
+    for (const FWriterCase& WriterCase : WriterCases)
+    {
+        IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+        FOmniCaptureSettings Settings;
+        Settings.OutputFormat = EOmniOutputFormat::ImageSequence;
+        Settings.ImageFormat = WriterCase.Format;
+        Settings.PNGBitDepth = WriterCase.PNGBitDepth;
+        Settings.OutputFileName = TEXT("Benchmark");
+        Settings.HDRPrecision = WriterCase.Input.Precision == EOmniCapturePixelPrecision::FullFloat ? EOmniCaptureHDRPrecision::FullFloat : EOmniCaptureHDRPrecision::HalfFloat;
+
+        FString Name = FormatEnum->GetDisplayNameTextByValue(static_cast<int64>(WriterCase.Format)).ToString();
+        if (WriterCase.Format == EOmniCaptureImageFormat::PNG)
+        {
+            Name += TEXT(" ") + BitDepthEnum->GetDisplayNameTextByValue(static_cast<int64>(WriterCase.PNGBitDepth)).ToString();
+        }
+        Name += FString::Printf(TEXT(" from %s"), WriterCase.Input.Label);
+
+        // Frames are generated up front so only encoding and disk time is measured.
+        TArray<TUniquePtr<FOmniCaptureFrame>> Frames;
+        double InputBytes = 0.0;
+        for (int32 FrameIndex = 0; FrameIndex < FramesPerCase; ++FrameIndex)
+        {
+            Frames.Add(MakeWriterFrame(WriterCase.Input, Size, FrameIndex));
+            const void* RawData = nullptr;
+            int64 RawBytes = 0;
+            Frames.Last()->PixelData->GetRawData(RawData, RawBytes);
+            InputBytes += RawBytes;
+        }
+
+        FBenchmarkMemory Memory;
+        FOmniCaptureImageWriter Writer;
+        Writer.Initialize(Settings, Directory);
+
+        const double Start = FPlatformTime::Seconds();
+        for (int32 FrameIndex = 0; FrameIndex < FramesPerCase; ++FrameIndex)
+        {
+            Writer.EnqueueFrame(MoveTemp(Frames[FrameIndex]), FString::Printf(TEXT("Benchmark_%05d%s"), FrameIndex, *Settings.GetImageFileExtension()));
+            Memory.Sample();
+        }
+        Writer.WaitForPendingWrites();
+        const double Seconds = FPlatformTime::Seconds() - Start;
+        Memory.Sample();
+
+        const FOmniCaptureImageWriterStats Stats = Writer.GetStats();
+        const int64 BytesWritten = Writer.GetBytesWritten();
+        Writer.Flush();
+
+        TestTrue(FString::Printf(TEXT("%s writes output"), *Name), BytesWritten > 0);
+
+        TSharedPtr<FJsonObject> Case = MakeCase(Name, FramesPerCase, Seconds, InputBytes, Memory);
+        Case->SetStringField(TEXT("size"), FString::Printf(TEXT("%dx%d"), Size.X, Size.Y));
+        Case->SetNumberField(TEXT("outputMB"), BytesWritten / (1024.0 * 1024.0));
+        Case->SetNumberField(TEXT("peakInFlightMB"), Stats.PeakInFlightBytes / (1024.0 * 1024.0));
+        Cases.Add(MakeShared<FJsonValueObject>(Case));
+        AddInfo(FString::Printf(TEXT("%s: %.2f ms/frame"), *Name, Seconds * 1000.0 / FramesPerCase));
+    }
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    TestTrue(TEXT("Report written"), WriteReport(TEXT("imageWriter"), Cases));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureRingBufferBenchmark, "OmniCapture.Benchmark.RingBuffer", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FOmniCaptureRingBufferBenchmark::RunTest(const FString& Parameters)
+{
+    // Each frame carries a small payload and costs the consumer a fixed busy wait, standing in for an encoder hand-off.
+    const FIntPoint PayloadSize(256, 256);
+    const double PayloadBytes = static_cast<double>(PayloadSize.X) * PayloadSize.Y * sizeof(FColor);
+
+    TArray<TSharedPtr<FJsonValue>> Cases;
+    for (const EOmniCaptureRingBufferPolicy Policy : { EOmniCaptureRingBufferPolicy::DropOldest, EOmniCaptureRingBufferPolicy::BlockProducer })
+    {
+        for (const int32 WorkerCount : { 1, 4 })
+        {
+            FOmniCaptureSettings Settings;
+            Settings.OutputFormat = EOmniOutputFormat::ImageSequence;
+            Settings.RingBufferCapacity = 8;
+            Settings.RingBufferPolicy = Policy;
+            Settings.RingBufferWorkerCount = WorkerCount;
+
+            const FString Name = FString::Printf(TEXT("%s x%d workers"), Policy == EOmniCaptureRingBufferPolicy::DropOldest ? TEXT("DropOldest") : TEXT("BlockProducer"), WorkerCount);
+
+            FBenchmarkMemory Memory;
+            TAtomic<int32> ConsumedCount(0);
+            int32 CommittedCount = 0;
+            FOmniCaptureRingBufferStats Stats;
+            double ProducerSeconds = 0.0;
+            double Seconds = 0.0;
+            {
+                FOmniCaptureRingBuffer RingBuffer;
+                RingBuffer.Initialize(Settings,
+                    [&ConsumedCount](TUniquePtr<FOmniCaptureFrame>&& Frame)
+                    {
+                        const double WorkEnd = FPlatformTime::Seconds() + GRingConsumerWorkSeconds;
+                        while (FPlatformTime::Seconds() < WorkEnd)
+                        {
+                            FPlatformProcess::Yield();
+                        }
+                        ConsumedCount.IncrementExchange();
+                    },
+                    [&CommittedCount](const FOmniCaptureFrame&)
+                    {
+                        ++CommittedCount;
+                    });
+
+                const double Start = FPlatformTime::Seconds();
+                for (int32 FrameIndex = 0; FrameIndex < GRingBenchmarkFrames; ++FrameIndex)
+                {
+                    TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
+                    Frame->Metadata.FrameIndex = FrameIndex;
+                    TUniquePtr<TImagePixelData<FColor>> Pixels = MakeUnique<TImagePixelData<FColor>>(PayloadSize);
+                    Pixels->Pixels.SetNumUninitialized(PayloadSize.X * PayloadSize.Y);
+                    Frame->PixelData = MoveTemp(Pixels);
+                    RingBuffer.Enqueue(MoveTemp(Frame));
+                    if ((FrameIndex & 63) == 0)
+                    {
+                        Memory.Sample();
+                    }
+                }
+                ProducerSeconds = FPlatformTime::Seconds() - Start;
+                RingBuffer.Flush();
+                Seconds = FPlatformTime::Seconds() - Start;
+                Memory.Sample();
+                Stats = RingBuffer.GetStats();
+            }
+
+            TestEqual(FString::Printf(TEXT("%s accounts for every frame"), *Name), ConsumedCount.Load() + Stats.DroppedFrames, GRingBenchmarkFrames);
+
+            TSharedPtr<FJsonObject> Case = MakeCase(Name, ConsumedCount.Load(), Seconds, ConsumedCount.Load() * PayloadBytes, Memory);
+            Case->SetNumberField(TEXT("producerMsPerFrame"), ProducerSeconds * 1000.0 / GRingBenchmarkFrames);
+            Case->SetNumberField(TEXT("droppedFrames"), Stats.DroppedFrames);
+            Case->SetNumberField(TEXT("blockedPushes"), Stats.BlockedPushes);
+            Case->SetNumberField(TEXT("committedFrames"), CommittedCount);
+            Cases.Add(MakeShared<FJsonValueObject>(Case));
+            AddInfo(FString::Printf(TEXT("%s: %.3f ms/frame, %d dropped, %d blocked"), *Name, Seconds * 1000.0 / FMath::Max(1, ConsumedCount.Load()), Stats.DroppedFrames, Stats.BlockedPushes));
+        }
+    }
+
+    TestTrue(TEXT("Report written"), WriteReport(TEXT("ringBuffer"), Cases));
+    return true;
+}
@@ -0,0 +1,75 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCaptureBufferPool.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureBufferPoolRecycleTest, "OmniCapture.BufferPool.Recycle", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureBufferPoolRecycleTest::RunTest(const FString& Parameters)
+{
+    const FIntPoint Size(512, 256);
+    const int64 FrameBytes = static_cast<int64>(Size.X) * Size.Y * sizeof(FColor);
+
+    TSharedRef<FOmniCaptureBufferPool, ESPMode::ThreadSafe> Pool = MakeShared<FOmniCaptureBufferPool, ESPMode::ThreadSafe>(FrameBytes * 4);
+
+    const FColor* FirstAllocation = nullptr;
+    {
+        TUniquePtr<TImagePixelData<FColor>> PixelData = Pool->AcquirePixelData<FColor>(Size);
+        TestEqual(TEXT("Pixel count matches the requested size"), PixelData->Pixels.Num(), static_cast<int64>(Size.X) * Size.Y);
+        FirstAllocation = PixelData->Pixels.GetData();
+    }
+
+    FOmniCaptureBufferPoolStats Stats = Pool->GetStats();
+    TestEqual(TEXT("Nothing is in use once the frame is destroyed"), Stats.InUseBytes, static_cast<int64>(0));
+    TestTrue(TEXT("The released buffer is kept"), Stats.PooledBytes >= FrameBytes);
+
+    {
+        TUniquePtr<TImagePixelData<FColor>> PixelData = Pool->AcquirePixelData<FColor>(Size);
+        TestTrue(TEXT("The next frame reuses the allocation"), PixelData->Pixels.GetData() == FirstAllocation);
+    }
+
+    Stats = Pool->GetStats();
+    TestEqual(TEXT("One miss, one hit"), Stats.Misses, static_cast<int64>(1));
+    TestEqual(TEXT("One miss, one hit"), Stats.Hits, static_cast<int64>(1));
+    TestTrue(TEXT("High water covers one frame"), Stats.HighWaterBytes >= FrameBytes);
+
+    Pool->Trim();
+    TestEqual(TEXT("Trim drops idle buffers"), Pool->GetStats().PooledBytes, static_cast<int64>(0));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureBufferPoolMoveTest, "OmniCapture.BufferPool.Move", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureBufferPoolMoveTest::RunTest(const FString& Parameters)
+{
+    const FIntPoint Size(512, 256);
+    const int64 FrameBytes = static_cast<int64>(Size.X) * Size.Y * sizeof(FFloat16Color);
+
+    TSharedRef<FOmniCaptureBufferPool, ESPMode::ThreadSafe> Pool = MakeShared<FOmniCaptureBufferPool, ESPMode::ThreadSafe>(FrameBytes * 4);
+
+    // The image write queue and the frame ring hand pixel data on with MoveImageDataToNew.
+    const FFloat16Color* FirstAllocation = nullptr;
+    {
+        TUniquePtr<TImagePixelData<FFloat16Color>> PixelData = Pool->AcquirePixelData<FFloat16Color>(Size);
+        FirstAllocation = PixelData->Pixels.GetData();
+
+        TUniquePtr<FImagePixelData> Moved = PixelData->MoveImageDataToNew();
+        PixelData.Reset();
+        TestEqual(TEXT("Destroying the moved-from wrapper releases nothing"), Pool->GetStats().PooledBytes, static_cast<int64>(0));
+        TestTrue(TEXT("The moved wrapper owns the buffer"), static_cast<TImagePixelData<FFloat16Color>*>(Moved.Get())->Pixels.GetData() == FirstAllocation);
+    }
+
+    FOmniCaptureBufferPoolStats Stats = Pool->GetStats();
+    TestEqual(TEXT("Nothing is in use once the moved frame is destroyed"), Stats.InUseBytes, static_cast<int64>(0));
+    TestTrue(TEXT("The moved buffer is returned to the pool"), Stats.PooledBytes >= FrameBytes);
+
+    {
+        TUniquePtr<TImagePixelData<FFloat16Color>> PixelData = Pool->AcquirePixelData<FFloat16Color>(Size);
+        TestTrue(TEXT("The next frame reuses the moved allocation"), PixelData->Pixels.GetData() == FirstAllocation);
+
+        TUniquePtr<FImagePixelData> Copied = PixelData->CopyImageData();
+        TestTrue(TEXT("Copies draw their own buffer"), static_cast<TImagePixelData<FFloat16Color>*>(Copied.Get())->Pixels.GetData() != FirstAllocation);
+    }
+
+    Stats = Pool->GetStats();
+    TestEqual(TEXT("One hit for the reused frame"), Stats.Hits, static_cast<int64>(1));
+    TestEqual(TEXT("Both buffers are back in the pool"), Stats.InUseBytes, static_cast<int64>(0));
+    return true;
+}
@@ -0,0 +1,28 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCaptureCPUSampleMap.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureCPUSampleMapRebuildTest, "OmniCapture.CPUSampleMap.RebuildOnSettingsChange", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureCPUSampleMapRebuildTest::RunTest(const FString& Parameters)
+{
+    FOmniCaptureSettings Settings;
+    Settings.Resolution = 64;
+    Settings.Coverage = EOmniCaptureCoverage::HalfSphere;
+
+    const TSharedPtr<const FOmniCaptureCPUSampleMap, ESPMode::ThreadSafe> First = FOmniCaptureCPUSampleMap::GetOrBuild(Settings, Settings.Resolution);
+    TestTrue(TEXT("Sample map built"), First.IsValid());
+    if (!First.IsValid())
+    {
+        return false;
+    }
+
+    const FIntPoint Size = Settings.GetEquirectResolution();
+    TestEqual(TEXT("Sample map covers output"), First->GetSamples().Num(), static_cast<int64>(Size.X) * Size.Y);
+    TestTrue(TEXT("Cached map reused for identical settings"), FOmniCaptureCPUSampleMap::GetOrBuild(Settings, Settings.Resolution) == First);
+
+    Settings.SeamBlend = 0.75f;
+    TestTrue(TEXT("Map rebuilt when seam blend changes"), FOmniCaptureCPUSampleMap::GetOrBuild(Settings, Settings.Resolution) != First);
+
+    FOmniCaptureCPUSampleMap::ReleaseCached();
+    return true;
+}
@@ -0,0 +1,109 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCaptureCPUSampler.h"
+#include "OmniCaptureTestCubemaps.h"
+
+namespace
+{
+    FLinearColor DirectionColor(const FVector& Direction)
+    {
+        const FVector Normal = Direction.GetSafeNormal();
+        return FLinearColor(0.5f + 0.5f * Normal.X, 0.5f + 0.5f * Normal.Y, 0.5f + 0.5f * Normal.Z, 1.0f);
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureCPUSamplerBilinearTest, "OmniCapture.CPUSampler.BilinearSeams", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureCPUSamplerBilinearTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 Resolution = 64;
+    // Every texel holds its own view direction, so a correct seam lookup is smooth across faces.
+    FOmniCaptureCPUCubemap Cubemap;
+    FillTestCubemap(Cubemap, Resolution, EOmniCapturePixelPrecision::FullFloat, [](int32 FaceIndex, int32 X, int32 Y)
+    {
+        const FVector2D UV((X + 0.5) / Resolution, (Y + 0.5) / Resolution);
+        return DirectionColor(FOmniCaptureCPUSampleMap::FaceUVToDirection(FaceIndex, UV));
+    });
+
+    // Samples walk every face edge at a few distances inside it, so each tap reaches into the seam border. The border
+    // texels come from the neighbouring faces; a wrong neighbour, a flipped edge or an unfilled border is off by far
+    // more than the interpolation error of one texel.
+    TArray<FOmniCaptureCPUSample> Samples;
+    for (int32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
+    {
+        for (const double Inset : { 0.0, 0.25 / Resolution, 0.5 / Resolution, 1.0 / Resolution })
+        {
+            for (int32 Step = 0; Step <= Resolution; ++Step)
+            {
+                const double Along = static_cast<double>(Step) / Resolution;
+                for (const FVector2D& UV : { FVector2D(Inset, Along), FVector2D(1.0 - Inset, Along), FVector2D(Along, Inset), FVector2D(Along, 1.0 - Inset) })
+                {
+                    FOmniCaptureCPUSample& Sample = Samples.AddDefaulted_GetRef();
+                    Sample.FaceAndFlags = static_cast<uint16>(FaceIndex);
+                    Sample.U = static_cast<uint16>(FMath::RoundToInt(UV.X * 65535.0));
+                    Sample.V = static_cast<uint16>(FMath::RoundToInt(UV.Y * 65535.0));
+                }
+            }
+        }
+    }
+
+    // An odd count runs both the four-wide path and the per-sample tail.
+    Samples.Add(Samples[0]);
+    TArray<FLinearColor> Colors;
+    Colors.SetNumUninitialized(Samples.Num());
+    FOmniCaptureCPUSampler::SampleRun(Cubemap, Cubemap, Samples.GetData(), Samples.Num(), EOmniCaptureCPUSampling::Bilinear, Colors.GetData());
+
+    float MaxError = 0.0f;
+    bool bMatchesSingleTaps = true;
+    for (int32 Index = 0; Index < Samples.Num(); ++Index)
+    {
+        const FOmniCaptureCPUSample& Sample = Samples[Index];
+        const FVector2D UV(Sample.U / 65535.0, Sample.V / 65535.0);
+        const FLinearColor Expected = DirectionColor(FOmniCaptureCPUSampleMap::FaceUVToDirection(Sample.GetFace(), UV));
+        MaxError = FMath::Max(MaxError, FMath::Max3(FMath::Abs(Colors[Index].R - Expected.R), FMath::Abs(Colors[Index].G - Expected.G), FMath::Abs(Colors[Index].B - Expected.B)));
+
+        FLinearColor Single;
+        FOmniCaptureCPUSampler::SampleRun(Cubemap, Cubemap, &Sample, 1, EOmniCaptureCPUSampling::Bilinear, &Single);
+        bMatchesSingleTaps &= Single == Colors[Index];
+    }
+    TestTrue(FString::Printf(TEXT("Bilinear taps next to face seams follow the view direction (max error %f)"), MaxError), MaxError < 0.01f);
+    TestTrue(TEXT("Four-wide taps match single taps"), bMatchesSingleTaps);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureCPUSamplerHalfStorageTest, "OmniCapture.CPUSampler.HalfStorage", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureCPUSamplerHalfStorageTest::RunTest(const FString& Parameters)
+{
+    FOmniCaptureSettings Settings;
+    Settings.Resolution = 64;
+
+    // A gradient whose values are exact in half precision, stored either way.
+    const auto Gradient = [](int32 FaceIndex, int32 X, int32 Y) { return FLinearColor(X / 64.0f, Y / 64.0f, FaceIndex / 8.0f, 1.0f); };
+    FOmniCaptureCPUCubemap FloatCubemap;
+    FillTestCubemap(FloatCubemap, Settings.Resolution, EOmniCapturePixelPrecision::FullFloat, Gradient);
+    FOmniCaptureCPUCubemap HalfCubemap;
+    FillTestCubemap(HalfCubemap, Settings.Resolution, EOmniCapturePixelPrecision::HalfFloat, Gradient);
+    TestTrue(TEXT("Half faces are stored as half"), HalfCubemap.IsValid() && HalfCubemap.Faces[0].Pixels.Num() == 0);
+
+    FOmniCaptureCPUSampleMap Map;
+    TestTrue(TEXT("Sample map built"), Map.Build(FOmniCaptureCPUSampleMap::MakeKey(Settings, Settings.Resolution)));
+    const int32 NumSamples = static_cast<int32>(Map.GetSamples().Num());
+
+    for (EOmniCaptureCPUSampling Sampling : { EOmniCaptureCPUSampling::Nearest, EOmniCaptureCPUSampling::Bilinear })
+    {
+        TArray<FLinearColor> FloatColors;
+        FloatColors.SetNumUninitialized(NumSamples);
+        FOmniCaptureCPUSampler::SampleRun(FloatCubemap, FloatCubemap, Map.GetSamples().GetData(), NumSamples, Sampling, FloatColors.GetData());
+
+        TArray<FLinearColor> HalfColors;
+        HalfColors.SetNumUninitialized(NumSamples);
+        FOmniCaptureCPUSampler::SampleRun(HalfCubemap, HalfCubemap, Map.GetSamples().GetData(), NumSamples, Sampling, HalfColors.GetData());
+
+        bool bAllMatch = true;
+        for (int32 Index = 0; Index < NumSamples; ++Index)
+        {
+            bAllMatch &= FloatColors[Index].Equals(HalfColors[Index], 1.0e-5f);
+        }
+        TestTrue(TEXT("Half storage samples like float storage"), bAllMatch);
+    }
+    return true;
+}
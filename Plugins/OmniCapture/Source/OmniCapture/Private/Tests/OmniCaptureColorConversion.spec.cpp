@@ -0,0 +1,92 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCaptureColorConversion.h"
+
+namespace
+{
+    uint8 ReferenceSRGB8(float Linear)
+    {
+        const double Clamped = FMath::Clamp<double>(Linear, 0.0, 1.0);
+        const double Encoded = Clamped <= 0.0031308 ? Clamped * 12.92 : 1.055 * FMath::Pow(Clamped, 1.0 / 2.4) - 0.055;
+        return static_cast<uint8>(FMath::FloorToInt(Encoded * 255.0 + 0.5));
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureColorConversionSRGBTest, "OmniCapture.ColorConversion.SRGB8", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureColorConversionSRGBTest::RunTest(const FString& Parameters)
+{
+    int32 Mismatches = 0;
+    for (int32 Step = 0; Step <= 1 << 20; ++Step)
+    {
+        // Squaring the sweep spends most steps in the dark range where the curve is steepest.
+        const float Linear = FMath::Square(Step / static_cast<float>(1 << 20));
+        Mismatches += FOmniCaptureColorConversion::LinearToSRGB8(Linear) != ReferenceSRGB8(Linear) ? 1 : 0;
+    }
+    TestEqual(TEXT("Table lookup is correctly rounded"), Mismatches, 0);
+    TestEqual(TEXT("Negative input"), FOmniCaptureColorConversion::LinearToSRGB8(-1.0f), static_cast<uint8>(0));
+    TestEqual(TEXT("Overbright input"), FOmniCaptureColorConversion::LinearToSRGB8(4.0f), static_cast<uint8>(255));
+
+    const FLinearColor Source[2] = { FLinearColor(0.5f, 0.25f, 0.125f, 1.0f), FLinearColor(1.0f, 0.0f, 0.0f, 0.0f) };
+    FColor Dest[2];
+    FOmniCaptureColorConversion::ConvertRow(Source, Dest, 2, 0, FOmniCaptureQuantizeOptions());
+    TestTrue(TEXT("Row matches the scalar encoding"), Dest[0] == FColor(ReferenceSRGB8(0.5f), ReferenceSRGB8(0.25f), ReferenceSRGB8(0.125f), 255));
+    TestTrue(TEXT("Alpha is linear"), Dest[1] == FColor(255, 0, 0, 0));
+
+    // The row kernel has its own vector path; it has to agree with the scalar lookup on every channel.
+    constexpr int32 SweepCount = 4096;
+    TArray<FLinearColor> Sweep;
+    Sweep.SetNumUninitialized(SweepCount);
+    for (int32 Index = 0; Index < SweepCount; ++Index)
+    {
+        const float Linear = FMath::Square(Index / static_cast<float>(SweepCount - 1));
+        Sweep[Index] = FLinearColor(Linear, 1.0f - Linear, Linear * 1.5f - 0.25f, Linear);
+    }
+    TArray<FColor> SweepDest;
+    SweepDest.SetNumUninitialized(SweepCount);
+    FOmniCaptureColorConversion::ConvertRow(Sweep.GetData(), SweepDest.GetData(), SweepCount, 0, FOmniCaptureQuantizeOptions());
+    int32 RowMismatches = 0;
+    for (int32 Index = 0; Index < SweepCount; ++Index)
+    {
+        const FLinearColor& Linear = Sweep[Index];
+        const FColor Expected(ReferenceSRGB8(Linear.R), ReferenceSRGB8(Linear.G), ReferenceSRGB8(Linear.B), Linear.ToFColor(false).A);
+        RowMismatches += SweepDest[Index] == Expected ? 0 : 1;
+    }
+    TestEqual(TEXT("Row kernel matches the scalar encoding"), RowMismatches, 0);
+
+    FOmniCaptureQuantizeOptions VectorOptions;
+    VectorOptions.bDither = true;
+    FFloat16Color HalfSource[16];
+    for (FFloat16Color& Pixel : HalfSource)
+    {
+        Pixel = FFloat16Color(FLinearColor(0.5f, 0.5f, 0.5f, 1.0f));
+    }
+    FColor Dithered[16];
+    FOmniCaptureColorConversion::ConvertRow(HalfSource, Dithered, 16, 0, VectorOptions);
+    bool bWithinOneCode = true;
+    for (const FColor& Pixel : Dithered)
+    {
+        bWithinOneCode &= FMath::Abs(static_cast<int32>(Pixel.R) - static_cast<int32>(ReferenceSRGB8(0.5f))) <= 1 && Pixel.A == 255;
+    }
+    TestTrue(TEXT("Dithered half pixels stay within one code"), bWithinOneCode);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureColorConversionSixteenBitTest, "OmniCapture.ColorConversion.SixteenBit", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureColorConversionSixteenBitTest::RunTest(const FString& Parameters)
+{
+    const FLinearColor Source(0.25f, 0.5f, 2.0f, -1.0f);
+    uint16 Dest[4];
+
+    FOmniCaptureQuantizeOptions LinearOptions;
+    LinearOptions.bEncodeSRGB = false;
+    FOmniCaptureColorConversion::ConvertRow(&Source, Dest, 1, 0, LinearOptions);
+    TestEqual(TEXT("Blue first, clamped"), static_cast<int32>(Dest[0]), 65535);
+    TestEqual(TEXT("Green"), static_cast<int32>(Dest[1]), 32768);
+    TestEqual(TEXT("Red"), static_cast<int32>(Dest[2]), 16384);
+    TestEqual(TEXT("Alpha clamped"), static_cast<int32>(Dest[3]), 0);
+
+    FOmniCaptureColorConversion::ConvertRow(&Source, Dest, 1, 0, FOmniCaptureQuantizeOptions());
+    const double ExpectedRed = (1.055 * FMath::Pow(0.25, 1.0 / 2.4) - 0.055) * 65535.0;
+    TestTrue(TEXT("sRGB red within two codes"), FMath::Abs(Dest[2] - ExpectedRed) <= 2.0);
+    return true;
+}
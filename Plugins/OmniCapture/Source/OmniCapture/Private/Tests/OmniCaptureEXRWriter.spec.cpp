@@ -0,0 +1,190 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCaptureImageWriter.h"
+#include "HAL/FileManager.h"
+#include "ImagePixelData.h"
+#include "Misc/Paths.h"
+
+#ifndef WITH_OMNICAPTURE_OPENEXR
+#define WITH_OMNICAPTURE_OPENEXR 0
+#endif
+
+#if WITH_OMNICAPTURE_OPENEXR
+THIRD_PARTY_INCLUDES_START
+#include "OpenEXR/ImfChannelList.h"
+#include "OpenEXR/ImfFrameBuffer.h"
+#include "OpenEXR/ImfHeader.h"
+#include "OpenEXR/ImfInputFile.h"
+#include "OpenEXR/ImfInputPart.h"
+#include "OpenEXR/ImfMultiPartInputFile.h"
+#include "OpenEXR/ImfNamespace.h"
+THIRD_PARTY_INCLUDES_END
+
+#include <exception>
+
+namespace
+{
+    // Not a multiple of the tile size, so the last row and column of tiles are partial.
+    const FIntPoint GEXRTestSize(70, 37);
+    constexpr int32 GEXRTestTileSize = 16;
+
+    FLinearColor MakeTestTexel(int32 X, int32 Y, float Layer)
+    {
+        // Multiples of 1/64 below 2 are exact in half precision, so both layers must come back bit for bit.
+        return FLinearColor(X / 64.0f, Y / 64.0f, Layer, (X + Y) % 2 ? 1.0f : 0.5f);
+    }
+
+    TUniquePtr<FOmniCaptureFrame> MakeLayeredFrame()
+    {
+        TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
+        Frame->bLinearColor = true;
+        Frame->PixelPrecision = EOmniCapturePixelPrecision::HalfFloat;
+        Frame->PixelDataType = EOmniCapturePixelDataType::LinearColorFloat16;
+
+        TUniquePtr<TImagePixelData<FFloat16Color>> Beauty = MakeUnique<TImagePixelData<FFloat16Color>>(GEXRTestSize);
+        TUniquePtr<TImagePixelData<FLinearColor>> Depth = MakeUnique<TImagePixelData<FLinearColor>>(GEXRTestSize);
+        for (int32 Y = 0; Y < GEXRTestSize.Y; ++Y)
+        {
+            for (int32 X = 0; X < GEXRTestSize.X; ++X)
+            {
+                Beauty->Pixels.Add(FFloat16Color(MakeTestTexel(X, Y, 0.25f)));
+                // Depth is not limited to half precision; the 1/3 offset only survives a float channel.
+                Depth->Pixels.Add(MakeTestTexel(X, Y, 1000.0f + 1.0f / 3.0f));
+            }
+        }
+        Frame->PixelData = MoveTemp(Beauty);
+
+        FOmniCaptureLayerPayload& DepthLayer = Frame->AuxiliaryLayers.Add(TEXT("SceneDepth"));
+        DepthLayer.PixelData = MoveTemp(Depth);
+        DepthLayer.bLinear = true;
+        DepthLayer.Precision = EOmniCapturePixelPrecision::FullFloat;
+        DepthLayer.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat32;
+        return Frame;
+    }
+
+    /** Adds RGBA slices that read a layer back into the same packed layout the writer exports from. */
+    template <typename PixelType>
+    void InsertReadSlices(OPENEXR_IMF_NAMESPACE::FrameBuffer& FrameBuffer, const std::string& Prefix, TArray<PixelType>& Pixels)
+    {
+        const OPENEXR_IMF_NAMESPACE::PixelType ExrType = sizeof(PixelType) == sizeof(FLinearColor) ? OPENEXR_IMF_NAMESPACE::FLOAT : OPENEXR_IMF_NAMESPACE::HALF;
+        const size_t ComponentSize = sizeof(PixelType) / 4;
+        Pixels.SetNumZeroed(GEXRTestSize.X * GEXRTestSize.Y);
+        const char* const Suffixes[4] = { "R", "G", "B", "A" };
+        for (int32 Channel = 0; Channel < 4; ++Channel)
+        {
+            char* Base = reinterpret_cast<char*>(Pixels.GetData()) + ComponentSize * Channel;
+            FrameBuffer.insert((Prefix + Suffixes[Channel]).c_str(), OPENEXR_IMF_NAMESPACE::Slice(ExrType, Base, sizeof(PixelType), sizeof(PixelType) * GEXRTestSize.X));
+        }
+    }
+
+    bool ReadLayeredFile(const FString& FilePath, bool bMultiPart, TArray<FFloat16Color>& OutBeauty, TArray<FLinearColor>& OutDepth, bool& bOutTiled)
+    {
+        try
+        {
+            if (bMultiPart)
+            {
+                OPENEXR_IMF_NAMESPACE::MultiPartInputFile File(TCHAR_TO_UTF8(*FilePath));
+                if (File.parts() != 2)
+                {
+                    return false;
+                }
+
+                bOutTiled = File.header(0).hasTileDescription() && File.header(1).hasTileDescription();
+                for (int32 PartIndex = 0; PartIndex < File.parts(); ++PartIndex)
+                {
+                    OPENEXR_IMF_NAMESPACE::InputPart Part(File, PartIndex);
+                    OPENEXR_IMF_NAMESPACE::FrameBuffer FrameBuffer;
+                    const std::string PartName = Part.header().name();
+                    if (PartName == "Beauty")
+                    {
+                        InsertReadSlices(FrameBuffer, std::string(), OutBeauty);
+                    }
+                    else if (PartName == "SceneDepth")
+                    {
+                        InsertReadSlices(FrameBuffer, std::string(), OutDepth);
+                    }
+                    else
+                    {
+                        return false;
+                    }
+                    Part.setFrameBuffer(FrameBuffer);
+                    Part.readPixels(0, GEXRTestSize.Y - 1);
+                }
+                return true;
+            }
+
+            OPENEXR_IMF_NAMESPACE::InputFile File(TCHAR_TO_UTF8(*FilePath));
+            bOutTiled = File.header().hasTileDescription();
+            OPENEXR_IMF_NAMESPACE::FrameBuffer FrameBuffer;
+            InsertReadSlices(FrameBuffer, "Beauty.", OutBeauty);
+            InsertReadSlices(FrameBuffer, "SceneDepth.", OutDepth);
+            File.setFrameBuffer(FrameBuffer);
+            File.readPixels(0, GEXRTestSize.Y - 1);
+            return File.header().channels().findChannel("Beauty.R") && File.header().channels().findChannel("SceneDepth.R");
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureEXRWriterLayersTest, "OmniCapture.ImageWriter.EXRLayers", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureEXRWriterLayersTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = FPaths::AutomationTransientDir() / TEXT("OmniCaptureEXRWriter");
+
+    for (const EOmniCaptureEXRLayout Layout : { EOmniCaptureEXRLayout::Scanline, EOmniCaptureEXRLayout::Tiled })
+    {
+        for (const bool bMultiPart : { false, true })
+        {
+            const FString Label = FString::Printf(TEXT("%s %s"), Layout == EOmniCaptureEXRLayout::Tiled ? TEXT("Tiled") : TEXT("Scanline"), bMultiPart ? TEXT("multipart") : TEXT("single part"));
+            IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+            FOmniCaptureSettings Settings;
+            Settings.OutputFormat = EOmniOutputFormat::ImageSequence;
+            Settings.ImageFormat = EOmniCaptureImageFormat::EXR;
+            Settings.HDRPrecision = EOmniCaptureHDRPrecision::HalfFloat;
+            Settings.bPackEXRAuxiliaryLayers = true;
+            Settings.bUseEXRMultiPart = bMultiPart;
+            Settings.EXRLayout = Layout;
+            Settings.EXRTileSize = GEXRTestTileSize;
+
+            {
+                FOmniCaptureImageWriter Writer;
+                Writer.Initialize(Settings, Directory);
+                Writer.EnqueueFrame(MakeLayeredFrame(), TEXT("Layers.exr"));
+                Writer.WaitForPendingWrites();
+                Writer.Flush();
+            }
+
+            TArray<FFloat16Color> Beauty;
+            TArray<FLinearColor> Depth;
+            bool bTiled = false;
+            if (!TestTrue(FString::Printf(TEXT("%s file reads back"), *Label), ReadLayeredFile(Directory / TEXT("Layers.exr"), bMultiPart, Beauty, Depth, bTiled)))
+            {
+                continue;
+            }
+            TestEqual(FString::Printf(TEXT("%s layout"), *Label), bTiled, Layout == EOmniCaptureEXRLayout::Tiled);
+
+            bool bBeautyMatches = true;
+            bool bDepthMatches = true;
+            for (int32 Y = 0; Y < GEXRTestSize.Y; ++Y)
+            {
+                for (int32 X = 0; X < GEXRTestSize.X; ++X)
+                {
+                    const int32 Index = Y * GEXRTestSize.X + X;
+                    const FFloat16Color ExpectedBeauty(MakeTestTexel(X, Y, 0.25f));
+                    bBeautyMatches &= FMemory::Memcmp(&Beauty[Index], &ExpectedBeauty, sizeof(FFloat16Color)) == 0;
+                    bDepthMatches &= Depth[Index] == MakeTestTexel(X, Y, 1000.0f + 1.0f / 3.0f);
+                }
+            }
+            TestTrue(FString::Printf(TEXT("%s half layer matches"), *Label), bBeautyMatches);
+            TestTrue(FString::Printf(TEXT("%s float layer matches"), *Label), bDepthMatches);
+        }
+    }
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
+#endif // WITH_OMNICAPTURE_OPENEXR
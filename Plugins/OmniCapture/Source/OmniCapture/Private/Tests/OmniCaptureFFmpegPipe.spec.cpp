@@ -0,0 +1,48 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCaptureFFmpegPipe.h"
+#include "ImagePixelData.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureFFmpegPipePackTest, "OmniCapture.FFmpegPipe.PackFrame", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureFFmpegPipePackTest::RunTest(const FString& Parameters)
+{
+    const FIntPoint Size(2, 1);
+    TArray64<uint8> Bytes;
+
+    TImagePixelData<FColor> Color(Size);
+    Color.Pixels = { FColor(10, 20, 30, 40), FColor(50, 60, 70, 80) };
+    TestTrue(TEXT("8-bit frame packs"), FOmniCaptureFFmpegPipe::PackFrame(Color, Bytes));
+    TestEqual(TEXT("8-bit frame is piped as bgra"), FString(FOmniCaptureFFmpegPipe::GetRawPixelFormat(EImagePixelType::Color)), FString(TEXT("bgra")));
+    TestEqual(TEXT("bgra byte order"), Bytes[0], static_cast<uint8>(30));
+    TestEqual(TEXT("bgra byte order"), Bytes[2], static_cast<uint8>(10));
+
+    // Linear 0.5 is sRGB 0.7354, so a linear quantization (32768) would show up as far too dark.
+    const int32 SRGBHalf = 48192;
+
+    TImagePixelData<FFloat16Color> Half(Size);
+    Half.Pixels = { FFloat16Color(FLinearColor(1.0f, 0.0f, 2.0f, -1.0f)), FFloat16Color(FLinearColor(0.5f, 0.5f, 0.5f, 1.0f)) };
+    TestTrue(TEXT("Half frame packs"), FOmniCaptureFFmpegPipe::PackFrame(Half, Bytes));
+    TestEqual(TEXT("Half frame is piped as bgra64le"), FString(FOmniCaptureFFmpegPipe::GetRawPixelFormat(EImagePixelType::Float16)), FString(TEXT("bgra64le")));
+    TestEqual(TEXT("bgra64le size"), Bytes.Num(), static_cast<int64>(2 * 4 * sizeof(uint16)));
+    const uint16* Words = reinterpret_cast<const uint16*>(Bytes.GetData());
+    TestEqual(TEXT("Out of range values clamp high"), Words[0], static_cast<uint16>(65535));
+    TestEqual(TEXT("Red is full scale"), Words[2], static_cast<uint16>(65535));
+    TestEqual(TEXT("Out of range values clamp low"), Words[3], static_cast<uint16>(0));
+    TestTrue(TEXT("Half frame is sRGB encoded"), FMath::Abs(Words[4] - SRGBHalf) <= 2);
+    TestEqual(TEXT("Alpha stays linear"), Words[7], static_cast<uint16>(65535));
+
+    TImagePixelData<FLinearColor> Full(Size);
+    Full.Pixels = { FLinearColor(1.0f, 0.0f, 0.5f, 1.0f), FLinearColor(0.5f, 2.0f, -1.0f, 0.5f) };
+    TestTrue(TEXT("Float frame packs"), FOmniCaptureFFmpegPipe::PackFrame(Full, Bytes));
+    TestEqual(TEXT("Float frame is piped as bgra64le"), FString(FOmniCaptureFFmpegPipe::GetRawPixelFormat(EImagePixelType::Float32)), FString(TEXT("bgra64le")));
+    TestEqual(TEXT("bgra64le size"), Bytes.Num(), static_cast<int64>(2 * 4 * sizeof(uint16)));
+    Words = reinterpret_cast<const uint16*>(Bytes.GetData());
+    TestTrue(TEXT("Float frame is sRGB encoded"), FMath::Abs(Words[0] - SRGBHalf) <= 2);
+    TestEqual(TEXT("Green is black"), Words[1], static_cast<uint16>(0));
+    TestEqual(TEXT("Red is full scale"), Words[2], static_cast<uint16>(65535));
+    TestEqual(TEXT("Out of range values clamp low"), Words[4], static_cast<uint16>(0));
+    TestEqual(TEXT("Out of range values clamp high"), Words[5], static_cast<uint16>(65535));
+    TestEqual(TEXT("Alpha stays linear"), Words[7], static_cast<uint16>(32768));
+
+    return true;
+}
@@ -0,0 +1,63 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCaptureFinalizer.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureFinalizerTest, "OmniCapture.Finalizer.BoundedConcurrency", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureFinalizerTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = FPaths::AutomationTransientDir() / TEXT("OmniCaptureFinalizer");
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+    // Raw dump segments only need a manifest and spatial metadata, so no FFmpeg binary is involved.
+    constexpr int32 SegmentCount = 4;
+    FOmniCaptureFinalizer Finalizer(2);
+    for (int32 SegmentIndex = 0; SegmentIndex < SegmentCount; ++SegmentIndex)
+    {
+        FOmniCaptureFinalizeJob Job;
+        Job.Settings.OutputFormat = EOmniOutputFormat::ImageSequence;
+        Job.Settings.ImageFormat = EOmniCaptureImageFormat::RawDump;
+        Job.Settings.bGenerateManifest = true;
+        Job.Settings.OutputFileName = FString::Printf(TEXT("Capture_seg%02d"), SegmentIndex);
+        Job.Segment.SegmentIndex = SegmentIndex;
+        Job.Segment.Directory = Directory;
+        Job.Segment.BaseFileName = Job.Settings.OutputFileName;
+        Job.Segment.bHasImageSequence = true;
+        for (int32 FrameIndex = 0; FrameIndex < 3; ++FrameIndex)
+        {
+            FOmniCaptureFrameMetadata& Frame = Job.Segment.Frames.AddDefaulted_GetRef();
+            Frame.FrameIndex = FrameIndex;
+            Frame.Timecode = FrameIndex / 30.0;
+        }
+        Finalizer.Submit(MoveTemp(Job));
+    }
+
+    const FOmniCaptureFinalizationProgress Submitted = Finalizer.GetProgress();
+    TestTrue(TEXT("No more than two segments run at once"), Submitted.RunningSegments <= 2);
+    TestEqual(TEXT("Every segment is accounted for"), Submitted.QueuedSegments + Submitted.RunningSegments + Submitted.CompletedSegments + Submitted.FailedSegments, SegmentCount);
+
+    Finalizer.WaitForAll();
+    TestFalse(TEXT("Unconsumed results keep the finalizer busy"), Finalizer.IsIdle());
+
+    TArray<FOmniCaptureFinalizeResult> Results;
+    Finalizer.ConsumeCompleted(Results);
+    TestTrue(TEXT("Finalizer is idle once results are consumed"), Finalizer.IsIdle());
+
+    if (TestEqual(TEXT("One result per segment"), Results.Num(), SegmentCount))
+    {
+        for (const FOmniCaptureFinalizeResult& Result : Results)
+        {
+            TestTrue(FString::Printf(TEXT("Segment %d succeeded"), Result.Segment.SegmentIndex), Result.bSuccess && !Result.bMuxingExpected);
+            TestEqual(TEXT("Frame count survives the move"), Result.FrameCount, 3);
+            TestTrue(TEXT("Manifest is written"), FPaths::FileExists(Directory / (Result.Segment.BaseFileName + TEXT("_Manifest.json"))));
+        }
+    }
+
+    const FOmniCaptureFinalizationProgress Finished = Finalizer.GetProgress();
+    TestEqual(TEXT("Completed count"), Finished.CompletedSegments, SegmentCount);
+    TestEqual(TEXT("Nothing failed"), Finished.FailedSegments, 0);
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
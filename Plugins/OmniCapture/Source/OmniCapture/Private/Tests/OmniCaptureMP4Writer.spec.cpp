@@ -0,0 +1,140 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCaptureMP4Writer.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    uint32 ReadU32(const TArray<uint8>& Data, int64 Offset)
+    {
+        return (uint32(Data[Offset]) << 24) | (uint32(Data[Offset + 1]) << 16) | (uint32(Data[Offset + 2]) << 8) | uint32(Data[Offset + 3]);
+    }
+
+    /** Offset of the box reached by following Path from [Begin, End), taking the first match at each level; INDEX_NONE if absent. */
+    int64 FindBox(const TArray<uint8>& Data, int64 Begin, int64 End, const TArray<const char*>& Path)
+    {
+        int64 Offset = Begin;
+        int32 Depth = 0;
+        while (Offset + 8 <= End && Depth < Path.Num())
+        {
+            int64 Size = ReadU32(Data, Offset);
+            if (Size == 1 && Offset + 16 <= End)
+            {
+                Size = (int64(ReadU32(Data, Offset + 8)) << 32) | ReadU32(Data, Offset + 12);
+            }
+            if (Size < 8)
+            {
+                return INDEX_NONE;
+            }
+            if (FMemory::Memcmp(&Data[Offset + 4], Path[Depth], 4) == 0)
+            {
+                if (++Depth == Path.Num())
+                {
+                    return Offset;
+                }
+                End = Offset + Size;
+                Offset += 8;
+                continue;
+            }
+            Offset += Size;
+        }
+        return INDEX_NONE;
+    }
+
+    bool WriteSyntheticStream(const FString& Path, int64 MoovReserveBytes)
+    {
+        FOmniCaptureSettings Settings;
+        Settings.Codec = EOmniCaptureCodec::H264;
+
+        FOmniCaptureMP4Writer Writer;
+        if (!Writer.Open(Path, Settings, FIntPoint(64, 32), 30.0, MoovReserveBytes))
+        {
+            return false;
+        }
+
+        // Baseline SPS/PPS delivered in-band with the IDR, the way NVENC emits them when repeating headers.
+        const TArray<uint8> Idr = { 0, 0, 0, 1, 0x67, 0x42, 0xC0, 0x1E, 0xAA, 0, 0, 0, 1, 0x68, 0xCE, 0x3C, 0x80, 0, 0, 1, 0x65, 0x88, 0x84, 0x21 };
+        const TArray<uint8> P = { 0, 0, 0, 1, 0x09, 0xF0, 0, 0, 0, 1, 0x41, 0x9A, 0x02 };
+
+        FOmniAudioPacket Audio;
+        Audio.SampleRate = 48000;
+        Audio.NumChannels = 2;
+        Audio.PCM16.Init(0, 1600 * 2);
+
+        bool bOk = Writer.WriteVideoSample(Idr, true);
+        bOk &= Writer.WriteAudio(Audio);
+        bOk &= Writer.WriteVideoSample(P, false);
+        bOk &= Writer.WriteAudio(Audio);
+        bOk &= Writer.WriteVideoSample(P, false);
+        return Writer.Finalize() && bOk;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureMP4WriterTest, "OmniCapture.MP4Writer.SyntheticAnnexB", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureMP4WriterTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = FPaths::AutomationTransientDir() / TEXT("OmniCaptureMP4");
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+    // The default reservation is patched in place; an 8 byte one forces the moov-to-front rewrite.
+    const int64 Reservations[] = { 1024 * 1024, 8 };
+    for (int64 Reserve : Reservations)
+    {
+        const FString Path = Directory / FString::Printf(TEXT("Synthetic_%lld.mp4"), Reserve);
+        if (!TestTrue(TEXT("Stream is written"), WriteSyntheticStream(Path, Reserve)))
+        {
+            continue;
+        }
+
+        TArray<uint8> File;
+        TestTrue(TEXT("File reads back"), FFileHelper::LoadFileToArray(File, *Path));
+
+        const int64 Moov = FindBox(File, 0, File.Num(), { "moov" });
+        const int64 Mdat = FindBox(File, 0, File.Num(), { "mdat" });
+        TestTrue(TEXT("moov precedes mdat"), Moov != INDEX_NONE && Mdat != INDEX_NONE && Moov < Mdat);
+
+        const TArray<const char*> VideoStbl = { "moov", "trak", "mdia", "minf", "stbl" };
+        const int64 Stsd = FindBox(File, 0, File.Num(), { "moov", "trak", "mdia", "minf", "stbl", "stsd" });
+        TestTrue(TEXT("Sample description is present"), Stsd != INDEX_NONE);
+
+        TArray<const char*> StszPath = VideoStbl;
+        StszPath.Add("stsz");
+        const int64 Stsz = FindBox(File, 0, File.Num(), StszPath);
+        TArray<const char*> StssPath = VideoStbl;
+        StssPath.Add("stss");
+        const int64 Stss = FindBox(File, 0, File.Num(), StssPath);
+        TArray<const char*> StcoPath = VideoStbl;
+        StcoPath.Add("stco");
+        const int64 Stco = FindBox(File, 0, File.Num(), StcoPath);
+        if (!TestTrue(TEXT("Sample tables are present"), Stsz != INDEX_NONE && Stss != INDEX_NONE && Stco != INDEX_NONE))
+        {
+            continue;
+        }
+
+        TestEqual(TEXT("Three video samples"), ReadU32(File, Stsz + 16), 3u);
+        TestEqual(TEXT("One sync sample"), ReadU32(File, Stss + 12), 1u);
+        TestEqual(TEXT("Sync sample is the IDR"), ReadU32(File, Stss + 16), 1u);
+
+        // Parameter sets are moved to avcC, leaving the IDR slice as the first sample's only NAL unit.
+        const uint32 FirstSampleSize = ReadU32(File, Stsz + 20);
+        const uint32 FirstChunk = ReadU32(File, Stco + 16);
+        TestEqual(TEXT("IDR sample is length prefixed"), FirstSampleSize, 4u + 4u);
+        TestEqual(TEXT("Chunk offset points at the NAL length"), ReadU32(File, FirstChunk), 4u);
+        TestEqual(TEXT("Chunk offset points at the IDR slice"), File[FirstChunk + 4], static_cast<uint8>(0x65));
+
+        // The access unit delimiter is dropped from P frames.
+        TestEqual(TEXT("P sample drops the AUD"), ReadU32(File, Stsz + 24), 4u + 3u);
+
+        int32 TrackCount = 0;
+        for (int64 Child = Moov + 8; Child < Moov + ReadU32(File, Moov); Child += ReadU32(File, Child))
+        {
+            TrackCount += FMemory::Memcmp(&File[Child + 4], "trak", 4) == 0 ? 1 : 0;
+        }
+        TestEqual(TEXT("Video and audio tracks"), TrackCount, 2);
+    }
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
@@ -0,0 +1,105 @@
+#include "Misc/AutomationTest.h"
+
+#include "NVENC/NVENCNalScanner.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+using namespace OmniNVENC;
+
+namespace
+{
+    // Hand-built Annex B access units: mixed 3- and 4-byte start codes, an emulation prevention byte
+    // (00 00 03) inside the IDR slice and trailing zero padding after it.
+    const TArray<uint8> H264Idr = {
+        0, 0, 0, 1, 0x09, 0x10,
+        0, 0, 0, 1, 0x67, 0x64, 0x00, 0x28, 0xAC,
+        0, 0, 1, 0x68, 0xEE, 0x3C, 0x80,
+        0, 0, 1, 0x65, 0x88, 0x00, 0x00, 0x03, 0x01, 0x84, 0x00, 0x00 };
+    const TArray<uint8> H264P = { 0, 0, 0, 1, 0x09, 0x30, 0, 0, 1, 0x41, 0x9A, 0x02, 0x01 };
+
+    const TArray<uint8> HevcIdr = {
+        0, 0, 0, 1, 0x40, 0x01, 0x0C, 0x01,
+        0, 0, 0, 1, 0x42, 0x01, 0x01, 0x01,
+        0, 0, 0, 1, 0x44, 0x01, 0xC1, 0x72,
+        0, 0, 1, 0x4E, 0x01, 0x05, 0xFF,
+        0, 0, 0, 1, 0x26, 0x01, 0xAF, 0x00, 0x00, 0x03, 0x02, 0x11 };
+    const TArray<uint8> HevcTrail = { 0, 0, 1, 0x02, 0x01, 0xD0, 0x01 };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureNalScannerTest, "OmniCapture.NVENC.NalScanner", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureNalScannerTest::RunTest(const FString& Parameters)
+{
+    TArray<FNVENCNalUnit> Units;
+    if (TestEqual(TEXT("H.264 IDR NAL count"), FNVENCNalScanner::Scan(H264Idr, ENVENCCodec::H264, Units), 4))
+    {
+        TestTrue(TEXT("H.264 AUD"), Units[0].Kind == ENVENCNalKind::AccessUnitDelimiter);
+        TestTrue(TEXT("H.264 SPS"), Units[1].Kind == ENVENCNalKind::SPS && Units[1].Payload.Num() == 5);
+        TestTrue(TEXT("H.264 PPS after a 3-byte start code"), Units[2].Kind == ENVENCNalKind::PPS && Units[2].Offset == 18);
+        TestTrue(TEXT("H.264 IDR"), Units[3].Kind == ENVENCNalKind::KeySlice && Units[3].Type == 5);
+        TestEqual(TEXT("Emulation prevention kept, padding trimmed"), Units[3].Payload.Num(), 7);
+        TestTrue(TEXT("Payload views the input"), Units[3].Payload.GetData() == H264Idr.GetData() + 25);
+    }
+
+    if (TestEqual(TEXT("HEVC IDR NAL count"), FNVENCNalScanner::Scan(HevcIdr, ENVENCCodec::HEVC, Units), 5))
+    {
+        TestTrue(TEXT("HEVC VPS"), Units[0].Kind == ENVENCNalKind::VPS && Units[0].Type == 32);
+        TestTrue(TEXT("HEVC SPS"), Units[1].Kind == ENVENCNalKind::SPS);
+        TestTrue(TEXT("HEVC PPS"), Units[2].Kind == ENVENCNalKind::PPS);
+        TestTrue(TEXT("HEVC prefix SEI"), Units[3].Kind == ENVENCNalKind::SEI && Units[3].Type == 39);
+        TestTrue(TEXT("HEVC IDR_W_RADL"), Units[4].Kind == ENVENCNalKind::KeySlice && Units[4].Type == 19);
+    }
+    TestTrue(TEXT("HEVC TRAIL_R"), FNVENCNalScanner::Scan(HevcTrail, ENVENCCodec::HEVC, Units) == 1 && Units[0].Kind == ENVENCNalKind::Slice && Units[0].Type == 1);
+    TestEqual(TEXT("No start code, no units"), FNVENCNalScanner::Scan(TConstArrayView<uint8>(H264Idr.GetData() + 10, 5), ENVENCCodec::H264, Units), 0);
+
+    FNVENCParameterSets Sets;
+    FNVENCNalScanner::ForEachNalUnit(HevcIdr, ENVENCCodec::HEVC, [&Sets](const FNVENCNalUnit& Unit) { Sets.Add(Unit); });
+    FNVENCNalScanner::ForEachNalUnit(HevcIdr, ENVENCCodec::HEVC, [&Sets](const FNVENCNalUnit& Unit) { Sets.Add(Unit); });
+    TestTrue(TEXT("HEVC parameter sets complete"), Sets.IsComplete(ENVENCCodec::HEVC));
+    TestEqual(TEXT("Repeated parameter sets are deduplicated"), Sets.VPS.Num() + Sets.SPS.Num() + Sets.PPS.Num(), 3);
+
+    // Build an index over IDR P P IDR P, the way the raw NVENC path appends packets.
+    const FString Directory = FPaths::AutomationTransientDir() / TEXT("OmniCaptureNalScanner");
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    const FString StreamPath = Directory / TEXT("Stream.h264");
+
+    FNVENCBitstreamIndex Index;
+    Index.Reset(ENVENCCodec::H264);
+    TArray<uint8> Stream;
+    for (const TArray<uint8>* AccessUnit : { &H264Idr, &H264P, &H264P, &H264Idr, &H264P })
+    {
+        Index.AddAccessUnit(*AccessUnit, Stream.Num());
+        Stream.Append(*AccessUnit);
+    }
+    TestTrue(TEXT("Stream is written"), FFileHelper::SaveArrayToFile(Stream, *StreamPath));
+
+    if (TestEqual(TEXT("Two keyframes"), Index.GetKeyframes().Num(), 2))
+    {
+        const int64 SecondIdrOffset = H264Idr.Num() + 2 * H264P.Num();
+        TestEqual(TEXT("Second keyframe offset"), Index.GetKeyframes()[1].ByteOffset, SecondIdrOffset);
+        TestEqual(TEXT("Seek inside the first GOP"), Index.FindKeyframeAtOrBefore(2)->AccessUnit, 0ll);
+        TestEqual(TEXT("Seek onto the second IDR"), Index.FindKeyframeAtOrBefore(3)->AccessUnit, 3ll);
+        TestEqual(TEXT("Seek past the end"), Index.FindKeyframeAtOrBefore(100)->AccessUnit, 3ll);
+
+        const FString IndexPath = FNVENCBitstreamIndex::GetIndexPath(StreamPath);
+        FNVENCBitstreamIndex Loaded;
+        TestTrue(TEXT("Index round trips"), Index.SaveToFile(IndexPath) && Loaded.LoadFromFile(IndexPath));
+        TestEqual(TEXT("Loaded access units"), Loaded.GetAccessUnitCount(), 5ll);
+        TestEqual(TEXT("Loaded keyframes"), Loaded.GetKeyframes().Num(), 2);
+        TestTrue(TEXT("Loaded parameter sets"), Loaded.GetParameterSets().IsComplete(ENVENCCodec::H264));
+
+        // Cutting the second GOP yields parameter sets followed by the exact tail of the stream.
+        const FString SegmentPath = Directory / TEXT("Segment.h264");
+        TArray<uint8> Segment;
+        TestTrue(TEXT("Segment is cut"), Loaded.ExtractSegment(StreamPath, 1, 1, SegmentPath) && FFileHelper::LoadFileToArray(Segment, *SegmentPath));
+
+        const TArray<uint8> Header = Loaded.GetParameterSets().ToAnnexB();
+        const int64 Tail = Stream.Num() - SecondIdrOffset;
+        TestEqual(TEXT("Segment size"), static_cast<int64>(Segment.Num()), Header.Num() + Tail);
+        TestTrue(TEXT("Segment payload"), Segment.Num() == Header.Num() + Tail
+            && FMemory::Memcmp(Segment.GetData() + Header.Num(), Stream.GetData() + SecondIdrOffset, Tail) == 0);
+    }
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
@@ -0,0 +1,53 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCapturePNGEncoder.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Modules/ModuleManager.h"
+#include "Serialization/MemoryWriter.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCapturePNGEncoderRoundTripTest, "OmniCapture.PNGEncoder.RoundTrip", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCapturePNGEncoderRoundTripTest::RunTest(const FString& Parameters)
+{
+    // Odd sizes and short strips so rows straddle strip boundaries and every strip reuses its predecessor's window.
+    const FIntPoint Size(97, 61);
+    TArray64<uint8> Source;
+    Source.SetNumUninitialized(static_cast<int64>(Size.X) * Size.Y * 4);
+    for (int64 Index = 0; Index < Source.Num(); ++Index)
+    {
+        Source[Index] = static_cast<uint8>((Index * 31) ^ (Index >> 7));
+    }
+
+    IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+    const int64 BytesPerRowSource = static_cast<int64>(Size.X) * 4;
+
+    for (const EOmniCapturePNGFilter Filter : { EOmniCapturePNGFilter::None, EOmniCapturePNGFilter::Sub, EOmniCapturePNGFilter::Up, EOmniCapturePNGFilter::Adaptive })
+    {
+        FOmniCapturePNGEncodeOptions Options;
+        Options.Filter = Filter;
+        Options.StripRows = 7;
+
+        TArray64<uint8> Encoded;
+        FMemoryWriter64 Writer(Encoded);
+        const bool bEncoded = FOmniCaptureParallelPNGEncoder::Encode(Writer, Size, 4, 8, true, Options,
+            [&Source, BytesPerRowSource](int32 RowStart, int32 RowCount, int64, TArray64<uint8>&, TArray<uint8*>& RowPointers)
+            {
+                for (int32 Row = 0; Row < RowCount; ++Row)
+                {
+                    RowPointers[Row] = Source.GetData() + BytesPerRowSource * (RowStart + Row);
+                }
+            },
+            []() { return false; });
+        TestTrue(FString::Printf(TEXT("Encodes with filter %d"), static_cast<int32>(Filter)), bEncoded);
+
+        const TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+        TArray64<uint8> Decoded;
+        const bool bDecoded = ImageWrapper.IsValid()
+            && ImageWrapper->SetCompressed(Encoded.GetData(), Encoded.Num())
+            && ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, Decoded);
+        TestTrue(FString::Printf(TEXT("Decodes with filter %d"), static_cast<int32>(Filter)), bDecoded);
+        TestTrue(FString::Printf(TEXT("Pixels round-trip with filter %d"), static_cast<int32>(Filter)), Decoded == Source);
+    }
+
+    return true;
+}
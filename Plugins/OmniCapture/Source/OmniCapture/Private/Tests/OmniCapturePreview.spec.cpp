@@ -0,0 +1,71 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCaptureEquirectConverter.h"
+#include "ImagePixelData.h"
+
+namespace
+{
+    FOmniCaptureSettings MakePreviewSettings(float PreviewScreenScale)
+    {
+        FOmniCaptureSettings Settings;
+        Settings.Mode = EOmniCaptureMode::Mono;
+        Settings.Resolution = 1024;
+        Settings.PreviewScreenScale = PreviewScreenScale;
+        return Settings;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCapturePreviewResolutionTest, "OmniCapture.Preview.Resolution", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCapturePreviewResolutionTest::RunTest(const FString& Parameters)
+{
+    const FOmniCaptureSettings Settings = MakePreviewSettings(0.25f);
+    const FIntPoint OutputSize = Settings.GetOutputResolution();
+    const FIntPoint PreviewSize = Settings.GetPreviewResolution();
+    TestEqual(TEXT("Long edge follows the screen scale"), FMath::Max(PreviewSize.X, PreviewSize.Y), 256);
+    TestEqual(TEXT("Aspect ratio is kept"), PreviewSize.X * OutputSize.Y, PreviewSize.Y * OutputSize.X);
+
+    const FIntPoint LargePreview = MakePreviewSettings(100.0f).GetPreviewResolution();
+    TestTrue(TEXT("Never larger than the output"), LargePreview == OutputSize);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCapturePreviewDownsampleTest, "OmniCapture.Preview.Downsample", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCapturePreviewDownsampleTest::RunTest(const FString& Parameters)
+{
+    const FOmniCaptureSettings Settings = MakePreviewSettings(0.25f);
+    const FIntPoint OutputSize = Settings.GetOutputResolution();
+
+    // Alternating black and white columns average to mid grey in every 2x2 or larger box.
+    FOmniCaptureEquirectResult ColorResult;
+    ColorResult.Size = OutputSize;
+    TUniquePtr<TImagePixelData<FColor>> ColorData = MakeUnique<TImagePixelData<FColor>>(OutputSize);
+    ColorData->Pixels.SetNumUninitialized(OutputSize.X * OutputSize.Y);
+    for (int32 Index = 0; Index < ColorData->Pixels.Num(); ++Index)
+    {
+        ColorData->Pixels[Index] = (Index % 2) ? FColor(255, 255, 255, 255) : FColor(0, 0, 0, 255);
+    }
+    ColorResult.PixelData = MoveTemp(ColorData);
+
+    if (TestTrue(TEXT("8-bit preview"), FOmniCaptureEquirectConverter::BuildPreview(Settings, ColorResult)))
+    {
+        TestTrue(TEXT("Fits the preview resolution"), ColorResult.PreviewSize.X <= Settings.GetPreviewResolution().X && ColorResult.PreviewSize.Y <= Settings.GetPreviewResolution().Y);
+        TestEqual(TEXT("One pixel per preview texel"), ColorResult.PreviewPixels.Num(), ColorResult.PreviewSize.X * ColorResult.PreviewSize.Y);
+        TestTrue(TEXT("Boxes are averaged"), ColorResult.PreviewPixels[0] == FColor(128, 128, 128, 255));
+        TestTrue(TEXT("Source pixels are kept"), ColorResult.PixelData.IsValid());
+    }
+
+    FOmniCaptureEquirectResult HalfResult;
+    HalfResult.Size = OutputSize;
+    TUniquePtr<TImagePixelData<FFloat16Color>> HalfData = MakeUnique<TImagePixelData<FFloat16Color>>(OutputSize);
+    HalfData->Pixels.Init(FFloat16Color(FLinearColor(1.0f, 0.0f, 0.0f, 1.0f)), OutputSize.X * OutputSize.Y);
+    HalfResult.PixelData = MoveTemp(HalfData);
+
+    if (TestTrue(TEXT("Half float preview"), FOmniCaptureEquirectConverter::BuildPreview(Settings, HalfResult)))
+    {
+        TestTrue(TEXT("Linear pixels are encoded to sRGB"), HalfResult.PreviewPixels.Last() == FColor(255, 0, 0, 255));
+    }
+
+    FOmniCaptureEquirectResult EmptyResult;
+    TestFalse(TEXT("Nothing to preview without pixels"), FOmniCaptureEquirectConverter::BuildPreview(Settings, EmptyResult));
+    return true;
+}
@@ -0,0 +1,78 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCaptureRawDump.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureRawDumpRoundTripTest, "OmniCapture.RawDump.RoundTrip", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureRawDumpRoundTripTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = FPaths::AutomationTransientDir() / TEXT("OmniCaptureRawDump");
+    const FString BaseName = TEXT("RawDumpTest");
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+    const FIntPoint Size(8, 4);
+    constexpr int32 NumFrames = 2;
+
+    {
+        // The smallest segment size forces a new segment for every record.
+        FOmniCaptureRawDumpWriter Writer;
+        TestTrue(TEXT("Dump opens"), Writer.Open(Directory, BaseName, 4096));
+
+        // Written newest first, as parallel write tasks may do.
+        for (int32 FrameIndex = NumFrames - 1; FrameIndex >= 0; --FrameIndex)
+        {
+            TImagePixelData<FColor> Color(Size);
+            Color.Pixels.Init(FColor(FrameIndex, 1, 2, 255), Size.X * Size.Y);
+
+            TMap<FName, FOmniCaptureLayerPayload> Layers;
+            FOmniCaptureLayerPayload& Depth = Layers.Add(TEXT("Depth"));
+            TUniquePtr<TImagePixelData<FLinearColor>> DepthPixels = MakeUnique<TImagePixelData<FLinearColor>>(Size);
+            DepthPixels->Pixels.Init(FLinearColor(FrameIndex + 0.5f, 0.0f, 0.0f, 1.0f), Size.X * Size.Y);
+            Depth.PixelData = MoveTemp(DepthPixels);
+            Depth.bLinear = true;
+            Depth.Precision = EOmniCapturePixelPrecision::FullFloat;
+
+            FOmniCaptureFrameMetadata Metadata;
+            Metadata.FrameIndex = FrameIndex;
+            const FString FrameName = FString::Printf(TEXT("%s_%06d"), *BaseName, FrameIndex);
+            TestTrue(TEXT("Frame is written"), Writer.WriteFrame(Metadata, FrameName, Color, false, EOmniCapturePixelPrecision::Unknown, EOmniCapturePixelDataType::Color8, Layers));
+        }
+    }
+
+    TArray<FOmniCaptureRawDumpRecord> Records;
+    TestTrue(TEXT("Index reads back"), FOmniCaptureRawDumpReader::ReadIndex(FOmniCaptureRawDumpWriter::GetIndexPath(Directory, BaseName), Records));
+    TestEqual(TEXT("One record per payload"), Records.Num(), NumFrames * 2);
+    TestEqual(TEXT("Base name is recovered from the index path"), FOmniCaptureRawDumpReader::GetBaseName(FOmniCaptureRawDumpWriter::GetIndexPath(Directory, BaseName)), BaseName);
+
+    for (int32 RecordIndex = 0; RecordIndex < Records.Num(); ++RecordIndex)
+    {
+        const FOmniCaptureRawDumpRecord& Record = Records[RecordIndex];
+        const int32 ExpectedFrame = RecordIndex / 2;
+        const bool bExpectMain = (RecordIndex % 2) == 0;
+        TestEqual(TEXT("Records are ordered by frame"), Record.FrameIndex, ExpectedFrame);
+        TestEqual(TEXT("Main payload precedes its layers"), Record.Layer.IsEmpty(), bExpectMain);
+        TestEqual(TEXT("Records start on a 4KB boundary"), Record.Offset % 4096, static_cast<int64>(0));
+
+        TUniquePtr<FImagePixelData> PixelData = FOmniCaptureRawDumpReader::ReadPayload(Directory, BaseName, Record);
+        if (!TestTrue(TEXT("Payload reads back"), PixelData.IsValid()))
+        {
+            continue;
+        }
+
+        if (bExpectMain)
+        {
+            const TImagePixelData<FColor>* Color = static_cast<const TImagePixelData<FColor>*>(PixelData.Get());
+            TestTrue(TEXT("Main pixels round-trip"), Color->Pixels[Size.X * Size.Y - 1] == FColor(ExpectedFrame, 1, 2, 255));
+        }
+        else
+        {
+            TestTrue(TEXT("Layer type is resolved from precision"), Record.PixelDataType == EOmniCapturePixelDataType::LinearColorFloat32);
+            const TImagePixelData<FLinearColor>* Depth = static_cast<const TImagePixelData<FLinearColor>*>(PixelData.Get());
+            TestEqual(TEXT("Layer pixels round-trip"), Depth->Pixels[0].R, ExpectedFrame + 0.5f);
+        }
+    }
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
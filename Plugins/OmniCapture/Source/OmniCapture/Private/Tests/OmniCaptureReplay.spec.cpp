@@ -0,0 +1,141 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCaptureReplay.h"
+#include "OmniCaptureTestCubemaps.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    // Multiples of 1/8 survive the half precision faces exactly.
+    void FillCubemap(FOmniCaptureCPUCubemap& Cubemap, int32 Resolution, float Seed)
+    {
+        FillTestCubemap(Cubemap, Resolution, EOmniCapturePixelPrecision::HalfFloat, [Seed](int32 FaceIndex, int32 X, int32 Y)
+        {
+            return FLinearColor(X / 8.0f, Y / 8.0f, FaceIndex / 8.0f, Seed);
+        });
+    }
+
+    FOmniCaptureSettings MakeReplaySettings()
+    {
+        FOmniCaptureSettings Settings;
+        Settings.Mode = EOmniCaptureMode::Mono;
+        Settings.Resolution = 32;
+        Settings.OutputFormat = EOmniOutputFormat::ImageSequence;
+        Settings.ImageFormat = EOmniCaptureImageFormat::PNG;
+        Settings.OutputFileName = TEXT("Replay");
+        Settings.RingBufferPolicy = EOmniCaptureRingBufferPolicy::BlockProducer;
+        Settings.CPUSampling = EOmniCaptureCPUSampling::Bilinear;
+        return Settings;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureReplayRoundTripTest, "OmniCapture.Replay.RoundTrip", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureReplayRoundTripTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = FPaths::AutomationTransientDir() / TEXT("OmniCaptureReplayRoundTrip");
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    const FString ReplayPath = FOmniCaptureReplayDriver::GetReplayPath(Directory, TEXT("Take"));
+
+    FOmniCaptureSettings Settings = MakeReplaySettings();
+    Settings.Mode = EOmniCaptureMode::Stereo;
+    Settings.AuxiliaryPasses.Add(EOmniCaptureAuxiliaryPassType::SceneDepth);
+
+    {
+        FOmniCaptureReplayWriter Writer;
+        if (!TestTrue(TEXT("Writer opens"), Writer.Open(ReplayPath, Settings)))
+        {
+            return false;
+        }
+
+        for (int32 FrameIndex = 0; FrameIndex < 2; ++FrameIndex)
+        {
+            FOmniCaptureReplayFrame Frame;
+            Frame.FrameIndex = FrameIndex;
+            Frame.Timecode = FrameIndex / 30.0;
+            FOmniCaptureReplayLayer& Color = Frame.Layers.AddDefaulted_GetRef();
+            FillCubemap(Color.LeftEye, 8, FrameIndex);
+            FillCubemap(Color.RightEye, 8, FrameIndex + 0.5f);
+            FOmniCaptureReplayLayer& Depth = Frame.Layers.AddDefaulted_GetRef();
+            Depth.PassType = EOmniCaptureAuxiliaryPassType::SceneDepth;
+            FillCubemap(Depth.LeftEye, 8, 0.25f);
+            FillCubemap(Depth.RightEye, 8, 0.75f);
+            TestTrue(TEXT("Frame written"), Writer.WriteFrame(Frame));
+        }
+        TestEqual(TEXT("Frames written"), Writer.GetFramesWritten(), 2);
+    }
+
+    FOmniCaptureReplayReader Reader;
+    if (!TestTrue(TEXT("Reader opens"), Reader.Open(ReplayPath)))
+    {
+        return false;
+    }
+    TestTrue(TEXT("Settings come back"), Reader.GetSettings().Mode == EOmniCaptureMode::Stereo);
+    TestEqual(TEXT("Auxiliary passes come back"), Reader.GetSettings().AuxiliaryPasses.Num(), 1);
+
+    for (int32 Pass = 0; Pass < 2; ++Pass)
+    {
+        FOmniCaptureReplayFrame Frame;
+        TestTrue(TEXT("First frame"), Reader.ReadFrame(Frame));
+        TestTrue(TEXT("Second frame"), Reader.ReadFrame(Frame));
+        TestFalse(TEXT("End of file"), Reader.ReadFrame(Frame));
+        if (TestEqual(TEXT("Layers"), Frame.Layers.Num(), 2))
+        {
+            TestEqual(TEXT("Frame index"), Frame.FrameIndex, 1);
+            TestTrue(TEXT("Aux pass type"), Frame.Layers[1].PassType == EOmniCaptureAuxiliaryPassType::SceneDepth);
+            TestTrue(TEXT("Both eyes"), Frame.Layers[0].LeftEye.IsValid() && Frame.Layers[0].RightEye.IsValid());
+            TestTrue(TEXT("Face precision"), Frame.Layers[0].LeftEye.Faces[3].Precision == EOmniCapturePixelPrecision::HalfFloat);
+            TestTrue(TEXT("Texel"), FLinearColor(Frame.Layers[0].RightEye.Faces[3].GetHalfRow(5)[2]) == FLinearColor(2 / 8.0f, 5 / 8.0f, 3 / 8.0f, 1.5f));
+            TestEqual(TEXT("Aux texel"), Frame.Layers[1].LeftEye.Faces[0].GetHalfRow(7)[7].A.GetFloat(), 0.25f);
+        }
+        Reader.Rewind();
+    }
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureReplayDriverTest, "OmniCapture.Replay.Driver", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureReplayDriverTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = FPaths::AutomationTransientDir() / TEXT("OmniCaptureReplayDriver");
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    const FString ReplayPath = FOmniCaptureReplayDriver::GetReplayPath(Directory, TEXT("Take"));
+
+    {
+        FOmniCaptureReplayWriter Writer;
+        if (!TestTrue(TEXT("Writer opens"), Writer.Open(ReplayPath, MakeReplaySettings())))
+        {
+            return false;
+        }
+        for (int32 FrameIndex = 0; FrameIndex < 3; ++FrameIndex)
+        {
+            FOmniCaptureReplayFrame Frame;
+            Frame.FrameIndex = FrameIndex;
+            Frame.Timecode = FrameIndex / 60.0;
+            FillCubemap(Frame.Layers.AddDefaulted_GetRef().LeftEye, 16, 1.0f);
+            Writer.WriteFrame(Frame);
+        }
+    }
+
+    FOmniCaptureReplayOptions Options;
+    Options.OutputDirectory = Directory / TEXT("Output");
+    Options.LoopCount = 2;
+    FOmniCaptureReplayStats Stats;
+    TestTrue(TEXT("Replay succeeds"), FOmniCaptureReplayDriver::Run(ReplayPath, Options, Stats));
+    TestEqual(TEXT("Every loop is replayed"), Stats.FramesReplayed, 6);
+    TestEqual(TEXT("No drops with a blocking ring"), Stats.DroppedFrames, 0);
+    TestTrue(TEXT("Throughput is measured"), Stats.FramesPerSecond > 0.0);
+
+    for (int32 FrameIndex = 0; FrameIndex < 6; ++FrameIndex)
+    {
+        const FString FramePath = Options.OutputDirectory / FString::Printf(TEXT("Replay_%06d.png"), FrameIndex);
+        TestTrue(FString::Printf(TEXT("%s exists"), *FramePath), IFileManager::Get().FileExists(*FramePath));
+    }
+
+    const FOmniCaptureStageLatency* Conversion = Stats.StageLatencies.FindByPredicate([](const FOmniCaptureStageLatency& Latency) { return Latency.Stage == EOmniCaptureStage::Conversion; });
+    TestTrue(TEXT("Conversion is timed per frame"), Conversion && Conversion->SampleCount == 6);
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
@@ -0,0 +1,93 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCaptureRingBuffer.h"
+#include "HAL/PlatformProcess.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureRingBufferOrderedCommitTest, "OmniCapture.RingBuffer.OrderedCommit", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureRingBufferOrderedCommitTest::RunTest(const FString& Parameters)
+{
+    FOmniCaptureSettings Settings;
+    Settings.OutputFormat = EOmniOutputFormat::ImageSequence;
+    Settings.RingBufferCapacity = 8;
+    Settings.RingBufferPolicy = EOmniCaptureRingBufferPolicy::BlockProducer;
+    Settings.RingBufferWorkerCount = 4;
+
+    constexpr int32 NumFrames = 64;
+    TAtomic<int32> ConsumedCount(0);
+    TArray<int32> CommittedIndices;
+
+    {
+        FOmniCaptureRingBuffer RingBuffer;
+        RingBuffer.Initialize(Settings,
+            [&ConsumedCount](TUniquePtr<FOmniCaptureFrame>&& Frame)
+            {
+                // Uneven work so later frames regularly finish before earlier ones.
+                FPlatformProcess::Sleep(((Frame->Metadata.FrameIndex * 7) % 5) * 0.001f);
+                ConsumedCount.IncrementExchange();
+            },
+            [&CommittedIndices](const FOmniCaptureFrame& Frame)
+            {
+                CommittedIndices.Add(Frame.Metadata.FrameIndex);
+            });
+
+        for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+        {
+            TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
+            Frame->Metadata.FrameIndex = FrameIndex;
+            RingBuffer.Enqueue(MoveTemp(Frame));
+        }
+    }
+
+    TestEqual(TEXT("Every frame reaches the consumer"), ConsumedCount.Load(), NumFrames);
+    TestEqual(TEXT("Every frame is committed"), CommittedIndices.Num(), NumFrames);
+
+    bool bInOrder = true;
+    for (int32 Index = 0; Index < CommittedIndices.Num(); ++Index)
+    {
+        bInOrder &= CommittedIndices[Index] == Index;
+    }
+    TestTrue(TEXT("Commits follow FrameIndex order across workers"), bInOrder);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureRingBufferFlushTest, "OmniCapture.RingBuffer.FlushWaitsForWorkers", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureRingBufferFlushTest::RunTest(const FString& Parameters)
+{
+    FOmniCaptureSettings Settings;
+    Settings.OutputFormat = EOmniOutputFormat::ImageSequence;
+    Settings.RingBufferCapacity = 8;
+    Settings.RingBufferPolicy = EOmniCaptureRingBufferPolicy::BlockProducer;
+    Settings.RingBufferWorkerCount = 4;
+
+    constexpr int32 NumFrames = 4;
+    TAtomic<int32> ConsumedCount(0);
+    TAtomic<int32> CommittedCount(0);
+
+    FOmniCaptureRingBuffer RingBuffer;
+    RingBuffer.Initialize(Settings,
+        [&ConsumedCount](TUniquePtr<FOmniCaptureFrame>&& Frame)
+        {
+            FPlatformProcess::Sleep(0.05f);
+            ConsumedCount.IncrementExchange();
+        },
+        [&CommittedCount](const FOmniCaptureFrame& Frame)
+        {
+            CommittedCount.IncrementExchange();
+        });
+
+    for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+    {
+        TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
+        Frame->Metadata.FrameIndex = FrameIndex;
+        RingBuffer.Enqueue(MoveTemp(Frame));
+    }
+
+    // Give the workers time to pop the frames so Flush finds the ring empty while they are still consuming.
+    FPlatformProcess::Sleep(0.01f);
+    RingBuffer.Flush();
+
+    TestEqual(TEXT("Flush returns after every popped frame is consumed"), ConsumedCount.Load(), NumFrames);
+    TestEqual(TEXT("Flush returns after every popped frame is committed"), CommittedCount.Load(), NumFrames);
+    TestEqual(TEXT("Nothing is pending after Flush"), RingBuffer.GetStats().PendingFrames, 0);
+    return true;
+}
@@ -0,0 +1,94 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCaptureStageProfiler.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureStageProfilerPercentileTest, "OmniCapture.StageProfiler.Percentiles", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureStageProfilerPercentileTest::RunTest(const FString& Parameters)
+{
+    FOmniCaptureStageProfiler Profiler(false, 100);
+    for (int32 Index = 1; Index <= 100; ++Index)
+    {
+        Profiler.Record(Index, EOmniCaptureStage::Conversion, 10.0, 10.0 + Index / 1000.0);
+    }
+
+    FOmniCaptureStageLatency Latency = Profiler.GetLatency(EOmniCaptureStage::Conversion);
+    TestEqual(TEXT("Samples"), Latency.SampleCount, 100);
+    TestTrue(TEXT("p50"), FMath::IsNearlyEqual(Latency.P50Ms, 50.0f, 0.01f));
+    TestTrue(TEXT("p95"), FMath::IsNearlyEqual(Latency.P95Ms, 95.0f, 0.01f));
+    TestTrue(TEXT("p99"), FMath::IsNearlyEqual(Latency.P99Ms, 99.0f, 0.01f));
+    TestTrue(TEXT("Max"), FMath::IsNearlyEqual(Latency.MaxMs, 100.0f, 0.01f));
+    TestEqual(TEXT("Other stages stay empty"), Profiler.GetLatency(EOmniCaptureStage::Encode).SampleCount, 0);
+    TestEqual(TEXT("Trace records are only kept on request"), Profiler.GetTraceRecordCount(), 0);
+
+    // A full window rolls over: fifty 1 ms samples replace the fastest half.
+    for (int32 Index = 0; Index < 50; ++Index)
+    {
+        Profiler.Record(Index, EOmniCaptureStage::Conversion, 20.0, 20.001);
+    }
+    Latency = Profiler.GetLatency(EOmniCaptureStage::Conversion);
+    TestEqual(TEXT("Window size is capped"), Latency.SampleCount, 100);
+    TestTrue(TEXT("p50 after rollover"), FMath::IsNearlyEqual(Latency.P50Ms, 1.0f, 0.01f));
+    TestTrue(TEXT("p95 after rollover"), FMath::IsNearlyEqual(Latency.P95Ms, 95.0f, 0.01f));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureStageProfilerExportTest, "OmniCapture.StageProfiler.Export", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureStageProfilerExportTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = FPaths::AutomationTransientDir() / TEXT("OmniCaptureStageProfiler");
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+    FOmniCaptureStageProfiler Profiler(true);
+    for (int32 FrameIndex = 0; FrameIndex < 3; ++FrameIndex)
+    {
+        FOmniCaptureFrameMetadata Metadata;
+        Metadata.FrameIndex = FrameIndex;
+        const double FrameStart = 100.0 + FrameIndex * 0.016;
+        Metadata.StageTimestamps.Record(EOmniCaptureStage::SceneCapture, FrameStart, FrameStart + 0.002, 11);
+        Metadata.StageTimestamps.Record(EOmniCaptureStage::Conversion, FrameStart + 0.002, FrameStart + 0.007, 22);
+        TestFalse(TEXT("Unrecorded stages are absent"), Metadata.StageTimestamps.HasStage(EOmniCaptureStage::RenderFlush));
+        Profiler.RecordFrame(Metadata);
+    }
+    TestEqual(TEXT("Every recorded stage is kept"), Profiler.GetTraceRecordCount(), 6);
+
+    const FString CsvPath = Directory / TEXT("Take_StageTrace.csv");
+    if (TestTrue(TEXT("CSV export"), Profiler.ExportTrace(CsvPath, EOmniCaptureTraceFormat::CSV)))
+    {
+        TArray<FString> Lines;
+        FFileHelper::LoadFileToStringArray(Lines, *CsvPath);
+        if (TestEqual(TEXT("Header plus one row per record"), Lines.Num(), 7))
+        {
+            TestTrue(TEXT("First row is the first frame's capture on its own thread"), Lines[1].StartsWith(TEXT("0,SceneCapture,11,")));
+            TestTrue(TEXT("Conversion keeps the thread that stamped it"), Lines[2].StartsWith(TEXT("0,Conversion,22,")));
+        }
+    }
+
+    const FString JsonPath = Directory / TEXT("Take_StageTrace.json");
+    if (TestTrue(TEXT("Chrome trace export"), Profiler.ExportTrace(JsonPath, EOmniCaptureTraceFormat::ChromeTrace)))
+    {
+        FString JsonText;
+        FFileHelper::LoadFileToString(JsonText, *JsonPath);
+        TSharedPtr<FJsonObject> Root;
+        const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonText);
+        if (TestTrue(TEXT("Trace is valid JSON"), FJsonSerializer::Deserialize(Reader, Root) && Root.IsValid()))
+        {
+            const TArray<TSharedPtr<FJsonValue>>& Events = Root->GetArrayField(TEXT("traceEvents"));
+            if (TestEqual(TEXT("One event per record"), Events.Num(), 6))
+            {
+                const TSharedPtr<FJsonObject> Last = Events.Last()->AsObject();
+                TestEqual(TEXT("Complete events"), Last->GetStringField(TEXT("ph")), FString(TEXT("X")));
+                TestTrue(TEXT("Times are microseconds from the first record"), FMath::IsNearlyEqual(Last->GetNumberField(TEXT("ts")), 34000.0, 1.0));
+                TestTrue(TEXT("Durations in microseconds"), FMath::IsNearlyEqual(Last->GetNumberField(TEXT("dur")), 5000.0, 1.0));
+            }
+        }
+    }
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
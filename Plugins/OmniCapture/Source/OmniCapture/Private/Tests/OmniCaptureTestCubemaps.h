@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureCPUSampler.h"
+#include "Templates/Function.h"
+
+/**
+ * Allocates all six faces at Resolution with the given storage precision, sets every texel from Texel and fills the seam
+ * borders. Shared by the sampler, replay and benchmark specs.
+ */
+inline void FillTestCubemap(FOmniCaptureCPUCubemap& Cubemap, int32 Resolution, EOmniCapturePixelPrecision Precision, TFunctionRef<FLinearColor(int32 FaceIndex, int32 X, int32 Y)> Texel)
+{
+    Cubemap.Precision = Precision;
+    for (int32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
+    {
+        FOmniCaptureCPUFace& Face = Cubemap.Faces[FaceIndex];
+        Face.Precision = Precision;
+        Face.Allocate(Resolution);
+        for (int32 Y = 0; Y < Resolution; ++Y)
+        {
+            if (Face.IsHalf())
+            {
+                FFloat16Color* Row = Face.GetHalfRow(Y);
+                for (int32 X = 0; X < Resolution; ++X)
+                {
+                    Row[X] = FFloat16Color(Texel(FaceIndex, X, Y));
+                }
+            }
+            else
+            {
+                FLinearColor* Row = Face.GetRow(Y);
+                for (int32 X = 0; X < Resolution; ++X)
+                {
+                    Row[X] = Texel(FaceIndex, X, Y);
+                }
+            }
+        }
+    }
+    Cubemap.FillSeamBorders();
+}
@@ -0,0 +1,77 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCaptureWavWriter.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    uint32 ReadLE32(const TArray<uint8>& Bytes, int32 Offset)
+    {
+        return Bytes[Offset] | (Bytes[Offset + 1] << 8) | (Bytes[Offset + 2] << 16) | (static_cast<uint32>(Bytes[Offset + 3]) << 24);
+    }
+
+    uint16 ReadLE16(const TArray<uint8>& Bytes, int32 Offset)
+    {
+        return static_cast<uint16>(Bytes[Offset] | (Bytes[Offset + 1] << 8));
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureWavWriterSplitTest, "OmniCapture.Audio.WavWriterSplit", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureWavWriterSplitTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = FPaths::AutomationTransientDir() / TEXT("OmniCaptureWavWriter");
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    const FString FirstPath = Directory / TEXT("Take.wav");
+    const FString SecondPath = Directory / TEXT("Take_seg01.wav");
+
+    constexpr int32 SampleRate = 44100;
+    constexpr int32 NumChannels = 2;
+    constexpr int32 BufferSamples = 512 * NumChannels;
+    TArray<float> Buffer;
+    Buffer.Init(0.5f, BufferSamples);
+
+    FOmniCaptureWavWriter Writer;
+    if (!TestTrue(TEXT("Writer opens"), Writer.Open(FirstPath)))
+    {
+        return false;
+    }
+
+    for (int32 Index = 0; Index < 3; ++Index)
+    {
+        TestTrue(TEXT("Buffer accepted"), Writer.Push(Buffer.GetData(), BufferSamples, NumChannels, SampleRate, 0.0, 1.0f));
+    }
+    // Split does not wait for the writer, so the next buffer can be queued before the old file is closed.
+    TFuture<FString> FirstClosed = Writer.Split(SecondPath);
+    Writer.Push(Buffer.GetData(), BufferSamples, NumChannels, SampleRate, 0.0, 1.0f);
+    TestEqual(TEXT("Writer continues into the new file"), Writer.GetFilePath(), SecondPath);
+    TestEqual(TEXT("Split resolves to the closed file"), FirstClosed.Get(), FirstPath);
+
+    TestEqual(TEXT("Close returns the last file"), Writer.Close(), SecondPath);
+
+    const int64 BufferBytes = BufferSamples * sizeof(int16);
+    const TPair<FString, int64> Expected[] = { { FirstPath, 3 * BufferBytes }, { SecondPath, BufferBytes } };
+    for (const TPair<FString, int64>& File : Expected)
+    {
+        TArray<uint8> Bytes;
+        if (!TestTrue(TEXT("File is readable"), FFileHelper::LoadFileToArray(Bytes, *File.Key)))
+        {
+            continue;
+        }
+
+        TestEqual(TEXT("File size"), static_cast<int64>(Bytes.Num()), 44 + File.Value);
+        if (Bytes.Num() >= 46)
+        {
+            TestTrue(TEXT("RIFF/WAVE tags"), FMemory::Memcmp(Bytes.GetData(), "RIFF", 4) == 0 && FMemory::Memcmp(Bytes.GetData() + 8, "WAVE", 4) == 0);
+            TestEqual(TEXT("RIFF size"), static_cast<int64>(ReadLE32(Bytes, 4)), 36 + File.Value);
+            TestEqual(TEXT("Channels from the first buffer"), static_cast<int32>(ReadLE16(Bytes, 22)), NumChannels);
+            TestEqual(TEXT("Sample rate from the first buffer"), static_cast<int32>(ReadLE32(Bytes, 24)), SampleRate);
+            TestEqual(TEXT("Data size"), static_cast<int64>(ReadLE32(Bytes, 40)), File.Value);
+            TestEqual(TEXT("First sample"), static_cast<int32>(static_cast<int16>(ReadLE16(Bytes, 44))), 16384);
+        }
+    }
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
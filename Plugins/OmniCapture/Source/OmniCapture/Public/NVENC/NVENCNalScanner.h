@@ -0,0 +1,116 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NVENC/NVENCDefs.h"
+
+namespace OmniNVENC
+{
+    /** Coarse role of a NAL unit, shared by H.264 and HEVC. */
+    enum class ENVENCNalKind : uint8
+    {
+        Slice,
+        KeySlice,
+        VPS,
+        SPS,
+        PPS,
+        SEI,
+        AccessUnitDelimiter,
+        Other,
+    };
+
+    /** One NAL unit located in an Annex B buffer. The payload views the scanned buffer; nothing is copied. */
+    struct FNVENCNalUnit
+    {
+        TConstArrayView<uint8> Payload;
+        int64 Offset = 0;
+        uint8 Type = 0;
+        ENVENCNalKind Kind = ENVENCNalKind::Other;
+
+        bool IsParameterSet() const { return Kind == ENVENCNalKind::VPS || Kind == ENVENCNalKind::SPS || Kind == ENVENCNalKind::PPS; }
+    };
+
+    /** Splits Annex B byte streams into NAL units. Start codes are located with memchr on the 0x01 byte. */
+    class FNVENCNalScanner
+    {
+    public:
+        /**
+         * Position of the first 3- or 4-byte start code at or after From, or INDEX_NONE.
+         * A zero byte in front of 00 00 01 is treated as part of the start code.
+         */
+        static int64 FindStartCode(const uint8* Data, int64 Size, int64 From, int32* OutStartCodeSize = nullptr);
+
+        static ENVENCNalKind Classify(ENVENCCodec Codec, const uint8* Nal, int64 Size, uint8* OutType = nullptr);
+
+        /** Visits every NAL unit in Data in stream order. Trailing zero bytes are not part of a payload. */
+        static void ForEachNalUnit(TConstArrayView<uint8> Data, ENVENCCodec Codec, TFunctionRef<void(const FNVENCNalUnit&)> Visitor);
+        static int32 Scan(TConstArrayView<uint8> Data, ENVENCCodec Codec, TArray<FNVENCNalUnit>& OutUnits);
+    };
+
+    /** Distinct parameter sets seen in a stream, kept in first-seen order. */
+    struct FNVENCParameterSets
+    {
+        TArray<TArray<uint8>> VPS;
+        TArray<TArray<uint8>> SPS;
+        TArray<TArray<uint8>> PPS;
+
+        /** Stores Unit if it is a parameter set not seen before. Returns whether Unit was a parameter set at all. */
+        bool Add(const FNVENCNalUnit& Unit);
+        bool IsComplete(ENVENCCodec Codec) const;
+        void Reset();
+
+        /** VPS, SPS and PPS as one Annex B buffer with 4-byte start codes. */
+        TArray<uint8> ToAnnexB() const;
+    };
+
+    struct FNVENCKeyframeEntry
+    {
+        int64 AccessUnit = 0;
+        int64 ByteOffset = 0;
+    };
+
+    /**
+     * Keyframe/byte-offset index of an Annex B file, built while access units are appended to it. Saved next to the
+     * bitstream it allows seeking to the closest IDR and cutting the file at IDR boundaries without re-encoding.
+     */
+    class FNVENCBitstreamIndex
+    {
+    public:
+        void Reset(ENVENCCodec InCodec);
+
+        /** Collects parameter sets delivered outside the access units (e.g. the encoder's sequence header). */
+        void AddCodecConfig(TConstArrayView<uint8> AnnexB);
+
+        /** Records one access unit written at ByteOffset. Returns true if it starts with a keyframe. */
+        bool AddAccessUnit(TConstArrayView<uint8> AccessUnit, int64 ByteOffset);
+
+        ENVENCCodec GetCodec() const { return Codec; }
+        int64 GetAccessUnitCount() const { return AccessUnitCount; }
+        int64 GetEndOffset() const { return EndOffset; }
+        const TArray<FNVENCKeyframeEntry>& GetKeyframes() const { return Keyframes; }
+        const FNVENCParameterSets& GetParameterSets() const { return ParameterSets; }
+
+        /** Last keyframe at or before AccessUnit, or nullptr when AccessUnit precedes the first keyframe. */
+        const FNVENCKeyframeEntry* FindKeyframeAtOrBefore(int64 AccessUnit) const;
+
+        /**
+         * Copies keyframes [FirstKeyframe, FirstKeyframe + KeyframeCount) of SourcePath into a standalone Annex B file,
+         * prefixed with the parameter sets. KeyframeCount past the end copies through the end of the stream.
+         */
+        bool ExtractSegment(const FString& SourcePath, int32 FirstKeyframe, int32 KeyframeCount, const FString& OutputPath) const;
+
+        bool SaveToFile(const FString& Path) const;
+        bool LoadFromFile(const FString& Path);
+
+        /** Sidecar path used for a bitstream file. */
+        static FString GetIndexPath(const FString& BitstreamPath);
+
+    private:
+        ENVENCCodec Codec = ENVENCCodec::H264;
+        int64 AccessUnitCount = 0;
+        int64 EndOffset = 0;
+        TArray<FNVENCKeyframeEntry> Keyframes;
+        FNVENCParameterSets ParameterSets;
+    };
+}
@@ -2,6 +2,8 @@
 
 #include "CoreMinimal.h"
 #include "OmniCaptureTypes.h"
+#include "OmniCaptureAudioRing.h"
+#include "OmniCaptureWavWriter.h"
 #include "Templates/Atomic.h"
 
 class UWorld;
@@ -18,12 +20,20 @@ public:
     FOmniCaptureAudioRecorder();
 
     bool Initialize(UWorld* InWorld, const FOmniCaptureSettings& Settings);
-    void Start();
-    void Stop(const FString& OutputDirectory, const FString& BaseFileName);
+    /** Starts streaming <OutputDirectory>/<BaseFileName>.wav to disk as submix buffers arrive. */
+    void Start(const FString& OutputDirectory, const FString& BaseFileName);
+    void Stop();
+    /**
+     * Cuts the current WAV at the latest submix buffer and continues into a new file without waiting for the disk. The
+     * future yields the cut file's path once the WAV writer has closed it; it is invalid when nothing is being written.
+     */
+    TFuture<FString> SplitOutput(const FString& OutputDirectory, const FString& BaseFileName);
 
     void GatherAudio(double FrameTimestamp, TArray<FOmniAudioPacket>& OutPackets);
     FString GetDebugStatus() const;
     int32 GetPendingPacketCount() const;
+    /** PCM bytes written to the current WAV file. */
+    int64 GetBytesWritten() const { return WavWriter ? WavWriter->GetDataBytesWritten() : 0; }
 
     void SetPaused(bool bInPaused);
     bool IsPaused() const { return bPaused.Load(); }
@@ -41,15 +51,14 @@ private:
     float Gain = 1.0f;
     FString OutputFilePath;
 
-    mutable FCriticalSection PacketCS;
-    TQueue<FOmniAudioPacket, EQueueMode::Mpsc> PendingPackets;
+    FOmniCaptureAudioRing AudioRing;
+    TUniquePtr<FOmniCaptureWavWriter> WavWriter;
     TWeakObjectPtr<USoundSubmix> TargetSubmix;
     class FOmniCaptureSubmixListener* SubmixListener = nullptr;
     class Audio::FMixerDevice* MixerDevice = nullptr;
     double AudioClockOrigin = -1.0;
     double AudioStartTime = 0.0;
     int32 CachedSampleRate = 48000;
-    TAtomic<int32> PendingPacketCount = 0;
     TAtomic<int32> DroppedPacketCount = 0;
     TAtomic<bool> bPaused = false;
     TAtomic<bool> bLoggedOverflowWarning = false;
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "Templates/Function.h"
+
+#include <atomic>
+
+/**
+ * Pre-allocated PCM16 ring between the audio render thread (single producer) and one consumer thread, such as the
+ * capture tick or the WAV writer.
+ * Each submix callback becomes one chunk: its samples are converted straight into the sample ring and a descriptor
+ * with the chunk's timestamp and format is published after them. The producer never allocates or locks; when the
+ * consumer falls a full ring behind, Write rejects the newest chunk instead.
+ */
+class OMNICAPTURE_API FOmniCaptureAudioRing
+{
+public:
+    /** A queued chunk seen in place; Second is non-empty when the chunk wraps around the end of the storage. */
+    struct FChunkView
+    {
+        double Timestamp = 0.0;
+        TConstArrayView<int16> First;
+        TConstArrayView<int16> Second;
+        int32 NumChannels = 0;
+        int32 SampleRate = 0;
+    };
+
+    /**
+     * Sizing shared by the recorder's frame ring and the WAV writer's ring: about ten seconds of 48 kHz stereo and
+     * several hundred submix callbacks, so a stalled capture tick or disk does not lose audio.
+     */
+    static constexpr int32 DefaultSampleCapacity = 1 << 20;
+    static constexpr int32 DefaultChunkCapacity = 1024;
+
+    /** Allocates storage for at least the requested samples and chunks (rounded up to powers of two) and empties the ring. Not thread-safe. */
+    void Reset(int32 InSampleCapacity = DefaultSampleCapacity, int32 InChunkCapacity = DefaultChunkCapacity);
+
+    /** Producer side. Applies Gain, converts to PCM16 and publishes the chunk; returns false without writing anything when it does not fit. */
+    bool Write(const float* Source, int32 NumSamples, int32 NumChannels, int32 SampleRate, double Timestamp, float Gain);
+
+    /**
+     * Consumer side. Moves every chunk stamped at or before MaxTimestamp into OutPackets, merging back-to-back chunks of
+     * the same format into one packet. Returns the number of chunks consumed.
+     * The samples are copied: packets travel with their frame through the frame ring until commit, and holding ring
+     * space that long would make the audio thread drop buffers. Each packet is sized once, so the copy is one pass.
+     */
+    int32 Read(double MaxTimestamp, TArray<FOmniAudioPacket>& OutPackets);
+
+    /** Consumer side. Visits up to MaxChunks queued chunks without copying them, releasing each after its visit. */
+    int32 Consume(int32 MaxChunks, TFunctionRef<void(const FChunkView&)> Visitor);
+
+    /** Consumer side. Discards everything currently queued. */
+    void Discard();
+
+    int32 GetPendingChunkCount() const;
+    /** Chunks published or consumed since Reset; their difference is the pending count. */
+    uint64 GetWrittenChunkCount() const { return ChunkWrite.load(std::memory_order_acquire); }
+    uint64 GetReadChunkCount() const { return ChunkRead.load(std::memory_order_acquire); }
+    int32 GetSampleCapacity() const { return static_cast<int32>(SampleMask + 1); }
+
+    /** Sample * Gain scaled to 16 bits, clamped and rounded half to even, four samples per vector step. */
+    static void ConvertToPCM16(const float* Source, int16* Destination, int32 NumSamples, float Gain);
+
+private:
+    struct FChunk
+    {
+        double Timestamp = 0.0;
+        uint64 SampleStart = 0;
+        int32 NumSamples = 0;
+        int32 NumChannels = 0;
+        int32 SampleRate = 0;
+    };
+
+    TArray<int16> Samples;
+    TArray<FChunk> Chunks;
+    uint64 SampleMask = 0;
+    uint64 ChunkMask = 0;
+
+    // Positions grow monotonically and are masked on access. The producer owns the write side, the consumer the read side.
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> SampleWrite{ 0 };
+    std::atomic<uint64> ChunkWrite{ 0 };
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> SampleRead{ 0 };
+    std::atomic<uint64> ChunkRead{ 0 };
+};
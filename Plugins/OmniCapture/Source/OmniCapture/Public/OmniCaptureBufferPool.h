@@ -0,0 +1,193 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ImageWriteTypes.h"
+#include "Templates/SharedPointer.h"
+#include "Misc/ScopeLock.h"
+
+struct FOmniCaptureBufferPoolStats
+{
+    int64 PooledBytes = 0;
+    int64 InUseBytes = 0;
+    int64 HighWaterBytes = 0;
+    int64 Hits = 0;
+    int64 Misses = 0;
+};
+
+/**
+ * Size-class pool for frame pixel buffers. Buffers handed out through AcquirePixelData return themselves to the
+ * pool when the owning FImagePixelData is destroyed, on whatever thread that happens; if the pool is gone by then
+ * they are simply freed. Idle buffers beyond MaxPooledBytes are released instead of kept.
+ */
+class OMNICAPTURE_API FOmniCaptureBufferPool : public TSharedFromThis<FOmniCaptureBufferPool, ESPMode::ThreadSafe>
+{
+public:
+    explicit FOmniCaptureBufferPool(int64 InMaxPooledBytes);
+
+    template <typename PixelType>
+    TUniquePtr<TImagePixelData<PixelType>> AcquirePixelData(const FIntPoint& Size);
+
+    /** Sizes OutPixels to NumPixels, reusing a pooled allocation when one fits. Contents are uninitialized. */
+    void AcquirePreviewPixels(TArray<FColor>& OutPixels, int32 NumPixels);
+    void ReleasePreviewPixels(TArray<FColor>&& Pixels);
+
+    void Trim();
+    FOmniCaptureBufferPoolStats GetStats() const;
+
+private:
+    template <typename PixelType>
+    class TPooledPixelData;
+
+    template <typename ArrayType>
+    struct TFreeList
+    {
+        TMap<int64, TArray<ArrayType>> Buckets;
+    };
+
+    /** Returns the size class the buffer was drawn from. */
+    template <typename ArrayType>
+    int64 Acquire(TFreeList<ArrayType>& FreeList, ArrayType& OutArray, int64 NumElements, bool bTrackInUse);
+
+    /** Files the buffer under the largest class its capacity covers, or frees it when over budget. */
+    template <typename ArrayType>
+    void Release(TFreeList<ArrayType>& FreeList, ArrayType&& Array, int64 InUseSizeClass);
+
+    template <typename PixelType>
+    TFreeList<TArray64<PixelType>>& GetFreeList();
+
+    static constexpr int64 SizeClassGranularity = 64 * 1024;
+
+    TFreeList<TArray64<FColor>> ColorBuffers;
+    TFreeList<TArray64<FFloat16Color>> HalfBuffers;
+    TFreeList<TArray64<FLinearColor>> FloatBuffers;
+    TFreeList<TArray<FColor>> PreviewBuffers;
+
+    mutable FCriticalSection PoolCS;
+    int64 MaxPooledBytes = 0;
+    FOmniCaptureBufferPoolStats Stats;
+};
+
+template <>
+inline FOmniCaptureBufferPool::TFreeList<TArray64<FColor>>& FOmniCaptureBufferPool::GetFreeList<FColor>() { return ColorBuffers; }
+
+template <>
+inline FOmniCaptureBufferPool::TFreeList<TArray64<FFloat16Color>>& FOmniCaptureBufferPool::GetFreeList<FFloat16Color>() { return HalfBuffers; }
+
+template <>
+inline FOmniCaptureBufferPool::TFreeList<TArray64<FLinearColor>>& FOmniCaptureBufferPool::GetFreeList<FLinearColor>() { return FloatBuffers; }
+
+template <typename ArrayType>
+int64 FOmniCaptureBufferPool::Acquire(TFreeList<ArrayType>& FreeList, ArrayType& OutArray, int64 NumElements, bool bTrackInUse)
+{
+    using ElementType = typename ArrayType::ElementType;
+    const int64 SizeClass = Align(FMath::Max<int64>(NumElements * static_cast<int64>(sizeof(ElementType)), 1), SizeClassGranularity);
+
+    {
+        FScopeLock Lock(&PoolCS);
+        TArray<ArrayType>* Bucket = FreeList.Buckets.Find(SizeClass);
+        if (Bucket && Bucket->Num() > 0)
+        {
+            OutArray = Bucket->Pop(EAllowShrinking::No);
+            Stats.PooledBytes -= SizeClass;
+            ++Stats.Hits;
+        }
+        else
+        {
+            ++Stats.Misses;
+        }
+
+        if (bTrackInUse)
+        {
+            Stats.InUseBytes += SizeClass;
+        }
+        Stats.HighWaterBytes = FMath::Max(Stats.HighWaterBytes, Stats.InUseBytes + Stats.PooledBytes);
+    }
+
+    // New buffers are reserved to the full size class so they can serve any request that maps to it later.
+    using SizeType = typename ArrayType::SizeType;
+    OutArray.Reserve(static_cast<SizeType>(SizeClass / static_cast<int64>(sizeof(ElementType))));
+    OutArray.SetNumUninitialized(static_cast<SizeType>(NumElements), EAllowShrinking::No);
+    return SizeClass;
+}
+
+template <typename ArrayType>
+void FOmniCaptureBufferPool::Release(TFreeList<ArrayType>& FreeList, ArrayType&& Array, int64 InUseSizeClass)
+{
+    using ElementType = typename ArrayType::ElementType;
+    const int64 SizeClass = AlignDown(static_cast<int64>(Array.Max()) * static_cast<int64>(sizeof(ElementType)), SizeClassGranularity);
+
+    ArrayType Discarded;
+    {
+        FScopeLock Lock(&PoolCS);
+        Stats.InUseBytes = FMath::Max<int64>(0, Stats.InUseBytes - InUseSizeClass);
+        if (SizeClass > 0 && Stats.PooledBytes + SizeClass <= MaxPooledBytes)
+        {
+            Array.Reset();
+            FreeList.Buckets.FindOrAdd(SizeClass).Add(MoveTemp(Array));
+            Stats.PooledBytes += SizeClass;
+            return;
+        }
+        Discarded = MoveTemp(Array);
+    }
+}
+
+template <typename PixelType>
+class FOmniCaptureBufferPool::TPooledPixelData final : public TImagePixelData<PixelType>
+{
+public:
+    TPooledPixelData(const FIntPoint& InSize, TArray64<PixelType>&& InPixels, int64 InSizeClass, const TSharedRef<FOmniCaptureBufferPool, ESPMode::ThreadSafe>& InPool)
+        : TImagePixelData<PixelType>(InSize, MoveTemp(InPixels))
+        , Pool(InPool)
+        , SizeClass(InSizeClass)
+    {
+    }
+
+    /** Takes over the other wrapper's buffer and its claim on the pool; the moved-from wrapper releases nothing. */
+    TPooledPixelData(TPooledPixelData&& Other)
+        : TImagePixelData<PixelType>(MoveTemp(Other))
+        , Pool(MoveTemp(Other.Pool))
+        , SizeClass(Other.SizeClass)
+    {
+        Other.Pool.Reset();
+        Other.SizeClass = 0;
+    }
+
+    virtual ~TPooledPixelData() override
+    {
+        if (TSharedPtr<FOmniCaptureBufferPool, ESPMode::ThreadSafe> PinnedPool = Pool.Pin())
+        {
+            PinnedPool->Release(PinnedPool->GetFreeList<PixelType>(), MoveTemp(this->Pixels), SizeClass);
+        }
+    }
+
+private:
+    // The TImagePixelData versions would hand the buffer to a plain TImagePixelData, so it would never come back.
+    virtual TUniquePtr<FImagePixelData> Move() override
+    {
+        return MakeUnique<TPooledPixelData<PixelType>>(MoveTemp(*this));
+    }
+
+    virtual TUniquePtr<FImagePixelData> Copy() const override
+    {
+        TSharedPtr<FOmniCaptureBufferPool, ESPMode::ThreadSafe> PinnedPool = Pool.Pin();
+        if (!PinnedPool.IsValid())
+        {
+            return MakeUnique<TImagePixelData<PixelType>>(*this);
+        }
+
+        TUniquePtr<TImagePixelData<PixelType>> Copied = PinnedPool->AcquirePixelData<PixelType>(this->GetSize());
+        FMemory::Memcpy(Copied->Pixels.GetData(), this->Pixels.GetData(), FMath::Min(Copied->Pixels.Num(), this->Pixels.Num()) * sizeof(PixelType));
+        return Copied;
+    }
+
+    TWeakPtr<FOmniCaptureBufferPool, ESPMode::ThreadSafe> Pool;
+    int64 SizeClass = 0;
+};
+
+template <typename PixelType>
+TUniquePtr<TImagePixelData<PixelType>> FOmniCaptureBufferPool::AcquirePixelData(const FIntPoint& Size)
+{
+    TArray64<PixelType> Pixels;
+    const int64 SizeClass = Acquire(GetFreeList<PixelType>(), Pixels, static_cast<int64>(Size.X) * Size.Y, true);
+    return MakeUnique<TPooledPixelData<PixelType>>(Size, MoveTemp(Pixels), SizeClass, AsShared());
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+
+/** Cubemap lookup for a single output pixel. UV is stored as 16-bit fixed point over [0, 1]. */
+struct FOmniCaptureCPUSample
+{
+    static constexpr uint16 FaceMask = 0x7;
+    static constexpr uint16 InvalidFace = 0x7;
+    static constexpr uint16 RightEyeFlag = 0x8;
+
+    uint16 FaceAndFlags = InvalidFace;
+    uint16 U = 0;
+    uint16 V = 0;
+
+    bool IsValid() const { return (FaceAndFlags & FaceMask) != InvalidFace; }
+    int32 GetFace() const { return FaceAndFlags & FaceMask; }
+    bool IsRightEye() const { return (FaceAndFlags & RightEyeFlag) != 0; }
+};
+
+/**
+ * Precomputed output pixel -> (face, u, v) mapping used by the CPU projection fallback.
+ * The mapping only depends on the capture settings, so it is built once per capture and
+ * each frame's conversion becomes a pure gather.
+ */
+class OMNICAPTURE_API FOmniCaptureCPUSampleMap
+{
+public:
+    struct FKey
+    {
+        EOmniCaptureProjection Projection = EOmniCaptureProjection::Equirectangular;
+        FIntPoint OutputSize = FIntPoint::ZeroValue;
+        FIntPoint FisheyeEyeSize = FIntPoint::ZeroValue;
+        int32 FaceResolution = 0;
+        bool bStereo = false;
+        bool bSideBySide = false;
+        bool bHalfSphere = false;
+        double LongitudeSpan = 0.0;
+        double LatitudeSpan = 0.0;
+        double FisheyeFovRadians = 0.0;
+        float SeamBlend = 0.0f;
+        float PolarDampening = 0.0f;
+
+        bool operator==(const FKey& Other) const;
+        bool operator!=(const FKey& Other) const { return !(*this == Other); }
+    };
+
+    static FKey MakeKey(const FOmniCaptureSettings& Settings, int32 FaceResolution);
+
+    /** Returns the shared map for the settings, rebuilding it if the cached one was built for different settings. */
+    static TSharedPtr<const FOmniCaptureCPUSampleMap, ESPMode::ThreadSafe> GetOrBuild(const FOmniCaptureSettings& Settings, int32 FaceResolution);
+    static void ReleaseCached();
+
+    /** Maps a direction to a cube face and raw [0, 1] face UV, using the same face layout as the capture rig. */
+    static void DirectionToFaceUV(const FVector& Direction, int32& OutFaceIndex, FVector2D& OutUV);
+    /** Inverse of DirectionToFaceUV. UV outside [0, 1] extrapolates past the face edge. */
+    static FVector FaceUVToDirection(int32 FaceIndex, const FVector2D& UV);
+
+    bool Build(const FKey& InKey);
+
+    const FKey& GetKey() const { return Key; }
+    FIntPoint GetSize() const { return Key.OutputSize; }
+    const TArray64<FOmniCaptureCPUSample>& GetSamples() const { return Samples; }
+    int64 GetAllocatedSize() const { return Samples.GetAllocatedSize(); }
+
+private:
+    FKey Key;
+    TArray64<FOmniCaptureCPUSample> Samples;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "OmniCaptureCPUSampleMap.h"
+
+/**
+ * Square cube face stored with a one texel border so filtered taps never need to branch at the edges. HalfFloat faces
+ * keep their texels as FFloat16Color in HalfPixels and are only widened per tap; all other faces use Pixels. Set
+ * Precision before calling Allocate.
+ */
+struct OMNICAPTURE_API FOmniCaptureCPUFace
+{
+    int32 Resolution = 0;
+    EOmniCapturePixelPrecision Precision = EOmniCapturePixelPrecision::Unknown;
+    TArray<FLinearColor> Pixels;
+    TArray<FFloat16Color> HalfPixels;
+
+    void Allocate(int32 InResolution);
+    bool IsValid() const;
+
+    bool IsHalf() const { return Precision == EOmniCapturePixelPrecision::HalfFloat; }
+    int32 GetStride() const { return Resolution + 2; }
+    FLinearColor* GetRow(int32 Y) { check(!IsHalf()); return Pixels.GetData() + (Y + 1) * GetStride() + 1; }
+    const FLinearColor* GetRow(int32 Y) const { check(!IsHalf()); return Pixels.GetData() + (Y + 1) * GetStride() + 1; }
+    FFloat16Color* GetHalfRow(int32 Y) { check(IsHalf()); return HalfPixels.GetData() + (Y + 1) * GetStride() + 1; }
+    const FFloat16Color* GetHalfRow(int32 Y) const { check(IsHalf()); return HalfPixels.GetData() + (Y + 1) * GetStride() + 1; }
+};
+
+struct OMNICAPTURE_API FOmniCaptureCPUCubemap
+{
+    FOmniCaptureCPUFace Faces[6];
+    EOmniCapturePixelPrecision Precision = EOmniCapturePixelPrecision::Unknown;
+
+    bool IsValid() const;
+
+    /** Copies the texels adjacent to each face edge from the neighbouring faces so bilinear taps blend across seams. */
+    void FillSeamBorders();
+};
+
+class OMNICAPTURE_API FOmniCaptureCPUSampler
+{
+public:
+    /**
+     * Resolves a run of sample map entries to colours. Invalid entries produce transparent black. Both cubemaps must
+     * share one storage precision; the right eye is ignored when it is empty.
+     */
+    static void SampleRun(
+        const FOmniCaptureCPUCubemap& LeftCubemap,
+        const FOmniCaptureCPUCubemap& RightCubemap,
+        const FOmniCaptureCPUSample* Samples,
+        int32 NumSamples,
+        EOmniCaptureCPUSampling Sampling,
+        FLinearColor* OutColors);
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FOmniCaptureQuantizeOptions
+{
+    /** Applies the sRGB transfer function to RGB; alpha is always quantized linearly. */
+    bool bEncodeSRGB = true;
+    /** Replaces round-to-nearest with a 4x4 ordered dither keyed on the pixel position. */
+    bool bDither = false;
+};
+
+/**
+ * Row kernels that quantize linear colour into the BGRA order the image writers emit. Values are clamped to [0, 1]
+ * first. Stateless, so rows may be converted concurrently.
+ */
+class OMNICAPTURE_API FOmniCaptureColorConversion
+{
+public:
+    static void ConvertRow(const FLinearColor* Source, FColor* Dest, int32 Count, int32 RowIndex, const FOmniCaptureQuantizeOptions& Options);
+    static void ConvertRow(const FFloat16Color* Source, FColor* Dest, int32 Count, int32 RowIndex, const FOmniCaptureQuantizeOptions& Options);
+
+    /** Dest receives Count * 4 values in B, G, R, A order. */
+    static void ConvertRow(const FLinearColor* Source, uint16* Dest, int32 Count, int32 RowIndex, const FOmniCaptureQuantizeOptions& Options);
+    static void ConvertRow(const FFloat16Color* Source, uint16* Dest, int32 Count, int32 RowIndex, const FOmniCaptureQuantizeOptions& Options);
+
+    /** Correctly rounded 8-bit sRGB code for a linear value. */
+    static uint8 LinearToSRGB8(float Linear);
+};
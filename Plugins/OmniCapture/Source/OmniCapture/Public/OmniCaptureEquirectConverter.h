@@ -4,15 +4,21 @@
 #include "CoreMinimal.h"
 #include "OmniCaptureTypes.h"
 #include "OmniCaptureRigActor.h"
+#include "RHIGPUReadback.h"
+#include "Templates/Atomic.h"
 
 // 公共头只做前置声明，避免路径/版本差异在项目内扩散
 class UTextureRenderTarget2D;
 class FTextureRenderTargetResource;
+class FOmniCaptureBufferPool;
+struct FOmniCaptureCPUCubemap;
 
 struct FOmniCaptureEquirectResult
 {
     TUniquePtr<FImagePixelData> PixelData;
+    /** sRGB preview of PixelData at PreviewSize, filled by BuildPreview only for frames that will be displayed. */
     TArray<FColor> PreviewPixels;
+    FIntPoint PreviewSize = FIntPoint::ZeroValue;
     FIntPoint Size = FIntPoint::ZeroValue;
     bool bIsLinear = false;
     bool bUsedCPUFallback = false;
@@ -25,11 +31,55 @@ struct FOmniCaptureEquirectResult
     TArray<TRefCountPtr<IPooledRenderTarget>> EncoderPlanes;
 };
 
+/** A GPU conversion whose readback is still in flight. Result may only be read once IsComplete() returns true. */
+struct FOmniCaptureAsyncConversion
+{
+    FOmniCaptureEquirectResult Result;
+    TUniquePtr<FRHIGPUTextureReadback> Readback;
+    FIntPoint ReadbackSize = FIntPoint::ZeroValue;
+    EOmniCapturePixelPrecision ReadbackPrecision = EOmniCapturePixelPrecision::Unknown;
+    bool bReadbackLinear = false;
+    TAtomic<bool> bComplete{ false };
+
+    bool IsComplete() const { return bComplete.Load(); }
+};
+
 class OMNICAPTURE_API FOmniCaptureEquirectConverter
 {
 public:
     static FOmniCaptureEquirectResult ConvertToEquirectangular(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye);
     static FOmniCaptureEquirectResult ConvertToFisheye(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye);
     static FOmniCaptureEquirectResult ConvertToPlanar(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& SourceEye);
+
+    /**
+     * Builds the cached CPU sample map up front when the CPU fallback will be used, so the first frame does not pay for it.
+     * FaceResolution must be the size of the captured faces, which is what ConvertCubemapsOnCPU keys the map on.
+     */
+    static void PrepareCPUConversion(const FOmniCaptureSettings& Settings, int32 FaceResolution);
+    static void ReleaseCPUConversionCache();
+
+    /**
+     * The CPU fallback of ConvertToEquirectangular and ConvertToFisheye, starting from cubemaps that are already in
+     * memory. RightCubemap is only read for stereo output.
+     */
+    static bool ConvertCubemapsOnCPU(const FOmniCaptureSettings& Settings, const FOmniCaptureCPUCubemap& LeftCubemap, const FOmniCaptureCPUCubemap& RightCubemap, FOmniCaptureEquirectResult& OutResult);
+
+    /** Reads the six face render targets of an eye back into memory, flushing the render thread. Borders are left unfilled. */
+    static bool ReadCubemapOnCPU(const FOmniEyeCapture& Eye, FOmniCaptureCPUCubemap& OutCubemap);
+
+    /**
+     * Dispatches the GPU conversion for a cube capture and queues its readback without waiting on the render thread or
+     * the GPU. Returns null when the frame needs one of the synchronous paths (planar, CPU fallback, missing faces).
+     */
+    static TSharedPtr<FOmniCaptureAsyncConversion, ESPMode::ThreadSafe> BeginAsyncConversion(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye);
+
+    /** Copies the readback into Conversion.Result once the GPU is done, optionally waiting for it. Render thread only. */
+    static void ResolveAsyncConversion_RenderThread(FOmniCaptureAsyncConversion& Conversion, bool bWait);
+
+    /** Box-downsamples PixelData into PreviewPixels, no larger than Settings.GetPreviewResolution(). */
+    static bool BuildPreview(const FOmniCaptureSettings& Settings, FOmniCaptureEquirectResult& InOutResult);
+
+    /** Routes output and preview allocations through the given pool until cleared with nullptr. */
+    static void SetBufferPool(const TSharedPtr<FOmniCaptureBufferPool, ESPMode::ThreadSafe>& BufferPool);
 };
 
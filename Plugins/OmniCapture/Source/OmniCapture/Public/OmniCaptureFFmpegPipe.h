@@ -0,0 +1,85 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "ImageWriteTypes.h"
+#include "HAL/PlatformProcess.h"
+
+class FRunnableThread;
+class FOmniCaptureFFmpegPipeWriter;
+
+/**
+ * Encodes while capturing by streaming rawvideo into an FFmpeg child process over stdin. Frames are converted on the
+ * caller's thread and handed to a writer thread through a queue of FFmpegPipeQueueDepth frames; when FFmpeg falls
+ * behind, EnqueueFrame blocks, which backs up the ring buffer instead of growing memory.
+ *
+ * FFmpeg is launched on the first frame, once the pixel layout and size are known.
+ */
+class OMNICAPTURE_API FOmniCaptureFFmpegPipe
+{
+public:
+    FOmniCaptureFFmpegPipe();
+    ~FOmniCaptureFFmpegPipe();
+
+    /** @param bSeparateVideoFile Write <Base>_video.mp4 so the muxer can add the audio track into <Base>.mp4 afterwards. */
+    bool Initialize(const FOmniCaptureSettings& Settings, const FString& OutputDirectory, bool bSeparateVideoFile);
+    void EnqueueFrame(const FOmniCaptureFrame& Frame);
+    bool Finalize();
+
+    bool IsInitialized() const { return bInitialized; }
+    const FString& GetOutputFilePath() const { return OutputFilePath; }
+    /** Safe to call while the writer thread is running. */
+    FString GetLastError() const;
+    int64 GetBytesWritten() const { return BytesWritten.Load(); }
+
+    /** FFmpeg rawvideo pix_fmt used for a pixel payload, or nullptr when the payload cannot be piped. */
+    static const TCHAR* GetRawPixelFormat(EImagePixelType PixelType);
+
+    /**
+     * Packs PixelData in the layout named by GetRawPixelFormat. Float payloads hold linear scene values and are
+     * sRGB encoded to 16 bits on the way, so the video matches the gamma of the PNG and JPEG paths.
+     */
+    static bool PackFrame(const FImagePixelData& PixelData, TArray64<uint8>& OutBytes);
+
+private:
+    friend class FOmniCaptureFFmpegPipeWriter;
+
+    bool StartProcess(const FIntPoint& Size, EImagePixelType PixelType);
+    void StopWriter();
+    void ClosePipes();
+    void RunWriter();
+    bool WriteToPipe(const TArray64<uint8>& Bytes);
+    void Fail(const FString& Message);
+
+    FOmniCaptureSettings Settings;
+    FString FFmpegBinary;
+    FString OutputDirectory;
+    FString OutputFilePath;
+    // Written by the writer thread on failure and read from the capture and finalizer threads.
+    mutable FCriticalSection ErrorCS;
+    FString LastError;
+    bool bInitialized = false;
+
+    FProcHandle ProcessHandle;
+    void* PipeRead = nullptr;
+    void* PipeWrite = nullptr;
+    FIntPoint FrameSize = FIntPoint::ZeroValue;
+    EImagePixelType FramePixelType = EImagePixelType::Color;
+
+    FOmniCaptureFFmpegPipeWriter* Writer = nullptr;
+    TUniquePtr<FRunnableThread> WriterThread;
+
+    // Packed frames waiting for the writer, plus spent buffers kept for reuse so steady state does not allocate.
+    FCriticalSection QueueCS;
+    TArray<TArray64<uint8>> PendingFrames;
+    TArray<TArray64<uint8>> FreeBuffers;
+    int32 MaxPendingFrames = 1;
+    FEvent* DataEvent = nullptr;
+    FEvent* SpaceEvent = nullptr;
+
+    TAtomic<bool> bRunning{ false };
+    TAtomic<bool> bFailed{ false };
+    TAtomic<int64> BytesWritten{ 0 };
+    int32 FramesWritten = 0;
+    TAtomic<int32> FramesDropped{ 0 };
+};
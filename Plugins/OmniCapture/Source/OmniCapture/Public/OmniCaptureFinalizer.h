@@ -0,0 +1,93 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "Async/Future.h"
+#include "Delegates/Delegate.h"
+
+class FOmniCaptureImageWriter;
+class FOmniCaptureFFmpegPipe;
+
+struct FOmniCaptureSegmentRecord
+{
+    int32 SegmentIndex = 0;
+    FString Directory;
+    FString BaseFileName;
+    FString AudioPath;
+    FString VideoPath;
+    TArray<FOmniCaptureFrameMetadata> Frames;
+    int32 DroppedFrames = 0;
+    bool bHasImageSequence = false;
+};
+
+/** A completed segment plus the writers that still have to drain before it can be muxed. */
+struct OMNICAPTURE_API FOmniCaptureFinalizeJob
+{
+    FOmniCaptureFinalizeJob();
+    FOmniCaptureFinalizeJob(FOmniCaptureFinalizeJob&&);
+    FOmniCaptureFinalizeJob& operator=(FOmniCaptureFinalizeJob&&);
+    ~FOmniCaptureFinalizeJob();
+
+    FOmniCaptureSettings Settings;
+    FOmniCaptureSegmentRecord Segment;
+    TUniquePtr<FOmniCaptureImageWriter> ImageWriter;
+    TUniquePtr<FOmniCaptureFFmpegPipe> FFmpegPipe;
+    /** Set while the audio recorder's WAV writer is still closing Segment.AudioPath after a rotation. */
+    TFuture<FString> AudioFileClosed;
+    /** The capture asked for NVENC, so an image sequence in this segment is a fallback rather than the requested output. */
+    bool bRequestedNVENC = false;
+};
+
+struct FOmniCaptureFinalizeResult
+{
+    FOmniCaptureSettings Settings;
+    /** The segment as submitted, minus its frame metadata. */
+    FOmniCaptureSegmentRecord Segment;
+    int32 FrameCount = 0;
+    FString FinalVideoPath;
+    FString WriterError;
+    bool bSuccess = false;
+    bool bMuxingExpected = false;
+    bool bRequestedNVENC = false;
+    double DurationSeconds = 0.0;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOmniCaptureSegmentFinalizedDelegate, const FOmniCaptureFinalizeResult&);
+
+/**
+ * Runs segment finalization (writer drain, manifest, spatial metadata and FFmpeg muxing) off the game thread. Up to
+ * MaxConcurrentJobs segments are processed at once, each on its own thread since FFmpeg can run for minutes; the rest
+ * wait in submission order. Results are collected until the owner consumes them, so the owner decides which thread
+ * reacts to them.
+ */
+class OMNICAPTURE_API FOmniCaptureFinalizer
+{
+public:
+    explicit FOmniCaptureFinalizer(int32 InMaxConcurrentJobs = 2);
+    /** Blocks until every submitted job has finished. */
+    ~FOmniCaptureFinalizer();
+
+    void SetMaxConcurrentJobs(int32 InMaxConcurrentJobs);
+    void Submit(FOmniCaptureFinalizeJob&& Job);
+    void ConsumeCompleted(TArray<FOmniCaptureFinalizeResult>& OutResults);
+    void WaitForAll();
+
+    /** True when nothing is queued, running or waiting to be consumed. */
+    bool IsIdle() const;
+    FOmniCaptureFinalizationProgress GetProgress() const;
+
+    /** Finalizes one segment on the calling thread. */
+    static FOmniCaptureFinalizeResult RunJob(FOmniCaptureFinalizeJob& Job);
+
+private:
+    void LaunchQueuedJobs();
+
+    mutable FCriticalSection JobsCS;
+    TArray<TUniquePtr<FOmniCaptureFinalizeJob>> QueuedJobs;
+    TArray<TFuture<void>> RunningTasks;
+    TArray<FOmniCaptureFinalizeResult> CompletedResults;
+    int32 MaxConcurrentJobs = 2;
+    int32 RunningJobs = 0;
+    int32 CompletedJobs = 0;
+    int32 FailedJobs = 0;
+};
@@ -5,6 +5,10 @@
 #include "Async/Future.h"
 #include "Templates/Function.h"
 #include "ImageWriteTypes.h"
+#include "OmniCapturePNGEncoder.h"
+#include "OmniCaptureRawDump.h"
+
+class FOmniCaptureStageProfiler;
 
 class OMNICAPTURE_API FOmniCaptureImageWriter
 {
@@ -14,9 +18,16 @@ public:
 
     void Initialize(const FOmniCaptureSettings& Settings, const FString& InOutputDirectory);
     void EnqueueFrame(TUniquePtr<FOmniCaptureFrame>&& Frame, const FString& FrameFileName);
+    /** Receives a DiskWrite stage record for every frame written after the call. */
+    void SetStageProfiler(const TSharedPtr<FOmniCaptureStageProfiler, ESPMode::ThreadSafe>& InProfiler) { StageProfiler = InProfiler; }
     void Flush();
+    /** Blocks until every queued write has finished, without cancelling any of them the way Flush does. */
+    void WaitForPendingWrites();
     const TArray<FOmniCaptureFrameMetadata>& GetCapturedFrames() const { return CapturedMetadata; }
     TArray<FOmniCaptureFrameMetadata> ConsumeCapturedFrames();
+    FOmniCaptureImageWriterStats GetStats() const;
+    /** Bytes of finished files (or raw dump payload) written since Initialize. Safe to poll from any thread. */
+    int64 GetBytesWritten() const;
 
 private:
     struct FExrLayerRequest
@@ -45,9 +56,16 @@ private:
     bool WriteEXRInternal(TUniquePtr<FImagePixelData> PixelData, const FString& FilePath, EImagePixelType PixelType) const;
     bool WriteEXRFrame(const FString& FilePath, bool bIsLinear, TUniquePtr<FImagePixelData> PixelData, EOmniCapturePixelPrecision PixelPrecision, EOmniCapturePixelDataType PixelDataType, TMap<FName, FOmniCaptureLayerPayload>&& AuxiliaryLayers, const FString& LayerDirectory, const FString& LayerBaseName, const FString& LayerExtension) const;
     bool WriteCombinedEXR(const FString& FilePath, TArray<FExrLayerRequest>& Layers) const;
+    void RecordCapturedMetadata(const FOmniCaptureFrameMetadata& Metadata);
     void RequestStop();
     bool IsStopRequested() const;
-    void WaitForAvailableTaskSlot();
+    /** Waits for room under the task and byte limits, then charges the frame; false once a stop is requested. */
+    bool ReserveTaskSlot(int64 IncomingBytes);
+    /** Returns a reservation whose task was never tracked. */
+    void CancelTaskSlot(int64 Bytes);
+    void AddBytesWritten(int64 Bytes) const;
+    void ChargeInFlightBytes(int64 Bytes);
+    void ReleaseInFlightBytes(int64 Bytes);
     void TrackPendingTask(TFuture<bool>&& TaskFuture);
     void PruneCompletedTasks();
     void EnforcePendingTaskLimit();
@@ -58,16 +76,29 @@ private:
     FString SequenceBaseName;
     EOmniCaptureImageFormat TargetFormat = EOmniCaptureImageFormat::PNG;
     EOmniCapturePNGBitDepth TargetPNGBitDepth = EOmniCapturePNGBitDepth::BitDepth32;
+    bool bParallelPNGEncoding = true;
+    FOmniCapturePNGEncodeOptions PNGEncodeOptions;
+    bool bDitherQuantization = false;
     int32 MaxPendingTasks = 8;
+    int64 MaxInFlightBytes = 0;
     bool bPackEXRAuxiliaryLayers = true;
     bool bUseEXRMultiPart = false;
     EOmniCaptureEXRCompression TargetEXRCompression = EOmniCaptureEXRCompression::Zip;
+    EOmniCaptureEXRLayout TargetEXRLayout = EOmniCaptureEXRLayout::Scanline;
+    int32 EXRTileSize = 64;
+    TUniquePtr<FOmniCaptureRawDumpWriter> RawDumpWriter;
+    TSharedPtr<FOmniCaptureStageProfiler, ESPMode::ThreadSafe> StageProfiler;
 
     TArray<FOmniCaptureFrameMetadata> CapturedMetadata;
     FCriticalSection MetadataCS;
 
     TArray<TFuture<bool>> PendingTasks;
-    FCriticalSection PendingTasksCS;
+    int32 ReservedTaskSlots = 0;
+    mutable FCriticalSection PendingTasksCS;
     TAtomic<bool> bStopRequested;
+    TAtomic<int64> InFlightBytes;
+    TAtomic<int64> PeakInFlightBytes;
+    TAtomic<int32> BudgetStalls;
+    mutable TAtomic<int64> BytesWritten;
 };
 
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "NVENC/NVENCNalScanner.h"
+#include "Templates/Atomic.h"
+
+class IFileHandle;
+
+/**
+ * Streaming ISO-BMFF writer for encoded H.264/HEVC access units plus interleaved 16-bit PCM audio.
+ *
+ * Samples are appended to a single mdat as they arrive, converted from Annex B to 4-byte length-prefixed NAL units.
+ * Parameter sets are taken from SetCodecConfig or collected in-band and emitted as avcC/hvcC. Space for the moov box
+ * is reserved ahead of mdat so Finalize normally only patches the file in place; a moov that outgrows the reservation
+ * is still placed at the front by rewriting the file once. Spherical video (st3d/sv3d) and colour (colr) boxes follow
+ * the same settings as the FFmpeg path.
+ *
+ * Video is assumed to be constant frame rate without B-frame reordering, which is how the NVENC session is configured.
+ * All methods are safe to call from different threads.
+ */
+class OMNICAPTURE_API FOmniCaptureMP4Writer
+{
+public:
+    ~FOmniCaptureMP4Writer();
+
+    bool Open(const FString& InFilePath, const FOmniCaptureSettings& InSettings, const FIntPoint& InVideoSize, double InFrameRate, int64 InMoovReserveBytes = 1024 * 1024);
+
+    /** Annex B parameter sets (SPS/PPS, plus VPS for HEVC). May also arrive in-band with the first keyframe. */
+    void SetCodecConfig(TConstArrayView<uint8> AnnexBParameterSets);
+    bool WriteVideoSample(TConstArrayView<uint8> AnnexBAccessUnit, bool bKeyFrame);
+    bool WriteAudio(const FOmniAudioPacket& Packet);
+    bool Finalize();
+
+    bool IsOpen() const;
+    int32 GetVideoSampleCount() const;
+    /** Current file size, including the moov reservation. Lock-free, unlike the other accessors. */
+    int64 GetBytesWritten() const { return BytesWritten.Load(); }
+    const FString& GetFilePath() const { return FilePath; }
+
+private:
+    struct FTrack
+    {
+        TArray<uint32> SampleSizes;
+        TArray<int64> ChunkOffsets;
+        TArray<uint32> ChunkSampleCounts;
+        TArray<uint32> SyncSamples;
+        int64 SampleCount = 0;
+    };
+
+    OmniNVENC::ENVENCCodec GetNalCodec() const;
+    bool WriteToMdat(const uint8* Data, int64 Size);
+    TArray<uint8> BuildMoov(int64 OffsetShift) const;
+    bool RewriteWithMoovAtFront(const TArray<uint8>& Ftyp, int64 MdatOffset, int64 MdatEnd);
+
+    FString FilePath;
+    FOmniCaptureSettings Settings;
+    FIntPoint VideoSize = FIntPoint::ZeroValue;
+    uint32 VideoTimescale = 90000;
+    uint32 VideoSampleDelta = 1500;
+
+    TUniquePtr<IFileHandle> Handle;
+    TArray<uint8> FtypBox;
+    int64 ReserveOffset = 0;
+    int64 ReserveBytes = 0;
+    int64 MdatOffset = 0;
+    int64 WriteOffset = 0;
+    TAtomic<int64> BytesWritten{ 0 };
+
+    OmniNVENC::FNVENCParameterSets ParameterSets;
+
+    FTrack Video;
+    FTrack Audio;
+    int32 AudioSampleRate = 0;
+    int32 AudioChannels = 0;
+
+    TArray<uint8> SampleScratch;
+    mutable FCriticalSection WriterCS;
+};
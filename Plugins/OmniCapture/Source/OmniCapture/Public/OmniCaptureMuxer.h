@@ -14,6 +14,8 @@ public:
     FOmniAudioSyncStats GetAudioStats() const { return AudioStats; }
     static FString ResolveFFmpegBinary(const FOmniCaptureSettings& Settings);
     static bool IsFFmpegAvailable(const FOmniCaptureSettings& Settings, FString* OutResolvedPath = nullptr);
+    /** Codec, pixel format, spherical metadata, colour tags and container flags shared by every FFmpeg invocation. */
+    static FString BuildVideoEncodeArguments(const FOmniCaptureSettings& Settings, bool bCopyVideo);
 
 private:
     bool WriteManifest(const FOmniCaptureSettings& Settings, const TArray<FOmniCaptureFrameMetadata>& Frames, const FString& AudioPath, const FString& VideoPath, int32 DroppedFrames, FString& OutManifestPath) const;
@@ -2,9 +2,11 @@
 
 #include "CoreMinimal.h"
 #include "OmniCaptureTypes.h"
+#include "OmniCaptureMP4Writer.h"
 
 #include "NVENC/NVENCPlatform.h"
 #include "NVENC/NVENCDefs.h"
+#include "NVENC/NVENCNalScanner.h"
 
 #if PLATFORM_WINDOWS && WITH_OMNI_NVENC
     #define OMNI_WITH_NVENC 1
@@ -54,6 +56,8 @@ public:
 
     void Initialize(const FOmniCaptureSettings& Settings, const FString& OutputDirectory);
     void EnqueueFrame(const FOmniCaptureFrame& Frame);
+    /** Interleaves captured audio into the MP4 when muxing natively; ignored for raw Annex B output. */
+    void WriteAudio(const TArray<FOmniAudioPacket>& Packets);
     void Finalize();
 
     static bool IsNVENCAvailable();
@@ -68,6 +72,8 @@ public:
     bool IsInitialized() const { return bInitialized; }
     FString GetOutputFilePath() const { return OutputFilePath; }
     const FString& GetLastError() const { return LastErrorMessage; }
+    /** Size of the output file so far. Lock-free, so it can be polled while a frame is encoding. */
+    int64 GetBytesWritten() const { return BytesWritten.Load(); }
 
 private:
     FString OutputFilePath;
@@ -77,6 +83,7 @@ private:
     EOmniCaptureCodec RequestedCodec = EOmniCaptureCodec::HEVC;
     EOmniCaptureNVENCD3D12Interop ActiveD3D12InteropMode = EOmniCaptureNVENCD3D12Interop::Bridge;
     FString LastErrorMessage;
+    TAtomic<int64> BytesWritten{ 0 };
 
 #if OMNI_WITH_NVENC
     OmniNVENC::FNVENCSession EncoderSession;
@@ -87,9 +94,12 @@ private:
     OmniNVENC::FNVENCParameters ActiveParameters;
     FCriticalSection EncoderCS;
     TUniquePtr<IFileHandle> BitstreamFile;
+    TUniquePtr<FOmniCaptureMP4Writer> MP4Writer;
+    OmniNVENC::FNVENCBitstreamIndex BitstreamIndex;
     bool bAnnexBHeaderWritten = false;
 
     bool WriteAnnexBHeader();
+    void WriteEncodedPacket(const OmniNVENC::FNVENCEncodedPacket& Packet);
 
 #if PLATFORM_WINDOWS
 #if OMNI_WITH_D3D11_RHI
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "Templates/Function.h"
+
+struct FOmniCapturePNGEncodeOptions
+{
+    int32 CompressionLevel = 6;
+    EOmniCapturePNGFilter Filter = EOmniCapturePNGFilter::Adaptive;
+    /** Rows per deflate strip. 0 sizes strips from the image height and the number of task graph workers. */
+    int32 StripRows = 0;
+};
+
+/**
+ * pigz-style PNG encoder. Horizontal strips are filtered and raw-deflated in parallel on the task graph, each primed
+ * with the previous strip's last 32KB as its dictionary, then stitched into a single zlib stream of one IDAT per strip.
+ * Rows come from the same PrepareRows callback the libpng writer uses; it is called concurrently for disjoint ranges.
+ * Source rows are native-endian and BGRA when bSourceIsBGRA, as with png_set_swap/png_set_bgr on the libpng path.
+ */
+class OMNICAPTURE_API FOmniCaptureParallelPNGEncoder
+{
+public:
+    using FPrepareRows = TFunctionRef<void(int32 RowStart, int32 RowCount, int64 BytesPerRow, TArray64<uint8>& TempBuffer, TArray<uint8*>& RowPointers)>;
+
+    /** Supports 1 (gray) or 4 (RGBA) channels at 8 or 16 bits. Returns false on unsupported layouts, cancellation or write errors. */
+    static bool Encode(FArchive& Archive, const FIntPoint& Size, int32 Channels, int32 BitDepth, bool bSourceIsBGRA, const FOmniCapturePNGEncodeOptions& Options, FPrepareRows PrepareRows, TFunctionRef<bool()> ShouldCancel);
+};
@@ -9,6 +9,7 @@ class UStaticMeshComponent;
 class UMaterialInstanceDynamic;
 class UTexture2D;
 struct FOmniCaptureEquirectResult;
+struct FOmniCapturePreviewUpload;
 
 UCLASS()
 class OMNICAPTURE_API AOmniCapturePreviewActor : public AActor
@@ -19,7 +20,11 @@ public:
     AOmniCapturePreviewActor();
 
     void Initialize(float InScale, const FIntPoint& InitialResolution);
-    void UpdatePreviewTexture(const FOmniCaptureEquirectResult& Result, const FOmniCaptureSettings& Settings);
+    /**
+     * Streams Result's preview into the persistent preview texture. PreviewPixels is swapped with a retired upload
+     * buffer; the update is skipped rather than waited on while both buffers are still being uploaded.
+     */
+    void UpdatePreviewTexture(FOmniCaptureEquirectResult& Result, const FOmniCaptureSettings& Settings);
     void SetPreviewEnabled(bool bEnabled);
     void SetPreviewView(EOmniCapturePreviewView InView);
     UTexture2D* GetPreviewTexture() const { return PreviewTexture; }
@@ -48,5 +53,6 @@ private:
     float PreviewScale = 1.0f;
     FIntPoint PreviewResolution = FIntPoint::ZeroValue;
     EOmniCapturePreviewView PreviewViewMode = EOmniCapturePreviewView::StereoComposite;
-    TArray<FColor> PreviewScratchBuffer;
+    TSharedPtr<FOmniCapturePreviewUpload, ESPMode::ThreadSafe> Uploads[2];
+    int32 NextUpload = 0;
 };
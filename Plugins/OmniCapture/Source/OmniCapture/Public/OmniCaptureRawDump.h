@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "ImageWriteTypes.h"
+#include "Templates/Atomic.h"
+
+class IFileHandle;
+
+/** One payload in a raw dump: the main frame (empty Layer) or one auxiliary layer. */
+struct FOmniCaptureRawDumpRecord
+{
+    int32 FrameIndex = 0;
+    double Timecode = 0.0;
+    FString FrameName;
+    FString Layer;
+    int32 Segment = 0;
+    int64 Offset = 0;
+    int64 Bytes = 0;
+    FIntPoint Size = FIntPoint::ZeroValue;
+    bool bLinear = false;
+    EOmniCapturePixelPrecision Precision = EOmniCapturePixelPrecision::Unknown;
+    EOmniCapturePixelDataType PixelDataType = EOmniCapturePixelDataType::Unknown;
+};
+
+/**
+ * Streams raw pixel payloads back to back into large preallocated segment files (<Base>.NNN.omniraw) with records
+ * aligned to 4KB, and appends one JSON line per record to <Base>.omniraw.jsonl. Writes go through the platform's
+ * buffered file handles. Safe to call from several write tasks; records are serialized in arrival order. The index is
+ * flushed about once a second and whenever a segment closes, so a crashed take loses at most its last second.
+ */
+class OMNICAPTURE_API FOmniCaptureRawDumpWriter
+{
+public:
+    ~FOmniCaptureRawDumpWriter();
+
+    bool Open(const FString& InDirectory, const FString& InBaseName, int64 InSegmentCapacityBytes);
+    bool WriteFrame(const FOmniCaptureFrameMetadata& Metadata, const FString& FrameName, const FImagePixelData& PixelData, bool bLinear, EOmniCapturePixelPrecision Precision, EOmniCapturePixelDataType PixelDataType, const TMap<FName, FOmniCaptureLayerPayload>& AuxiliaryLayers);
+    void Close();
+
+    int64 GetBytesWritten() const { return BytesWritten.Load(); }
+
+    static FString GetIndexPath(const FString& Directory, const FString& BaseName);
+    static FString GetSegmentPath(const FString& Directory, const FString& BaseName, int32 Segment);
+
+private:
+    bool WriteRecord(FOmniCaptureRawDumpRecord& Record, const FImagePixelData& PixelData);
+    bool OpenSegment(int32 Segment);
+    void CloseSegment();
+
+    FString Directory;
+    FString BaseName;
+    int64 SegmentCapacityBytes = 0;
+
+    TUniquePtr<IFileHandle> SegmentHandle;
+    TUniquePtr<IFileHandle> IndexHandle;
+    int32 SegmentIndex = -1;
+    int64 SegmentOffset = 0;
+    double LastIndexFlushTime = 0.0;
+
+    FCriticalSection WriteCS;
+    TAtomic<int64> BytesWritten{ 0 };
+};
+
+/** Reads a raw dump back and converts it into a regular image sequence. */
+class OMNICAPTURE_API FOmniCaptureRawDumpReader
+{
+public:
+    static bool ReadIndex(const FString& IndexPath, TArray<FOmniCaptureRawDumpRecord>& OutRecords);
+    static TUniquePtr<FImagePixelData> ReadPayload(const FString& Directory, const FString& BaseName, const FOmniCaptureRawDumpRecord& Record);
+
+    /**
+     * Rewrites every frame of the dump through FOmniCaptureImageWriter as Settings.ImageFormat, using the frame names
+     * recorded at capture time. OutFrames receives the written frames' metadata, ready for FOmniCaptureMuxer.
+     */
+    static bool Transcode(const FString& IndexPath, const FOmniCaptureSettings& Settings, const FString& OutputDirectory, TArray<FOmniCaptureFrameMetadata>& OutFrames);
+
+    /** Capture base name for an index path produced by GetIndexPath. */
+    static FString GetBaseName(const FString& IndexPath);
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "OmniCaptureEquirectConverter.h"
+
+/**
+ * Bounded queue of GPU conversions whose readbacks are still in flight. The game thread submits a conversion per
+ * captured frame together with the metadata stamped at capture time, kicks a non-blocking render-thread poll each
+ * tick, and pops finished frames in submission order.
+ */
+class OMNICAPTURE_API FOmniCaptureReadbackQueue
+{
+public:
+    struct FEntry
+    {
+        TSharedPtr<FOmniCaptureAsyncConversion, ESPMode::ThreadSafe> Conversion;
+        FOmniCaptureFrameMetadata Metadata;
+    };
+
+    explicit FOmniCaptureReadbackQueue(int32 InMaxInFlight);
+
+    bool IsFull() const { return InFlight.Num() >= MaxInFlight; }
+    int32 Num() const { return InFlight.Num(); }
+    int32 GetStallCount() const { return StallCount; }
+
+    void Submit(const TSharedPtr<FOmniCaptureAsyncConversion, ESPMode::ThreadSafe>& Conversion, const FOmniCaptureFrameMetadata& Metadata);
+
+    /** Queues a render-thread pass that resolves every readback the GPU has finished. Never waits. */
+    void Poll();
+
+    /** Blocks until the oldest entry is resolved. Used when the queue is full. */
+    void WaitForOldest();
+
+    /** Blocks until every entry is resolved. Used before flushing the frame ring. */
+    void WaitForAll();
+
+    /** Hands completed entries to Sink in submission order, stopping at the first one still in flight. */
+    void PopCompleted(TFunctionRef<void(FEntry&&)> Sink);
+
+private:
+    void ResolveOnRenderThread(int32 Count, bool bWait);
+
+    TArray<FEntry> InFlight;
+    int32 MaxInFlight = 1;
+    int32 StallCount = 0;
+};
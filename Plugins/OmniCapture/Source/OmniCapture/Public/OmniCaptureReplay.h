@@ -0,0 +1,81 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "OmniCaptureCPUSampler.h"
+
+/** Cube faces of both eyes for the colour pass (PassType None) or one auxiliary pass. RightEye is empty in mono. */
+struct FOmniCaptureReplayLayer
+{
+    EOmniCaptureAuxiliaryPassType PassType = EOmniCaptureAuxiliaryPassType::None;
+    FOmniCaptureCPUCubemap LeftEye;
+    FOmniCaptureCPUCubemap RightEye;
+};
+
+/** One recorded frame: the colour layer first, then one layer per auxiliary pass. */
+struct FOmniCaptureReplayFrame
+{
+    int32 FrameIndex = 0;
+    double Timecode = 0.0;
+    TArray<FOmniCaptureReplayLayer> Layers;
+};
+
+/**
+ * Writes <Base>.omnireplay: the capture settings followed by the raw cube faces of every recorded frame. Half
+ * precision faces stay half on disk. Game thread only.
+ */
+class OMNICAPTURE_API FOmniCaptureReplayWriter
+{
+public:
+    ~FOmniCaptureReplayWriter();
+
+    bool Open(const FString& InFilePath, const FOmniCaptureSettings& Settings);
+    bool WriteFrame(const FOmniCaptureReplayFrame& Frame);
+    void Close();
+
+    bool IsOpen() const { return Archive.IsValid(); }
+    int32 GetFramesWritten() const { return FramesWritten; }
+    const FString& GetFilePath() const { return FilePath; }
+
+private:
+    TUniquePtr<FArchive> Archive;
+    FString FilePath;
+    int32 FramesWritten = 0;
+};
+
+class OMNICAPTURE_API FOmniCaptureReplayReader
+{
+public:
+    bool Open(const FString& InFilePath);
+    /** Returns false at the end of the file or on a truncated frame. */
+    bool ReadFrame(FOmniCaptureReplayFrame& OutFrame);
+    void Rewind();
+
+    const FOmniCaptureSettings& GetSettings() const { return Settings; }
+
+private:
+    TUniquePtr<FArchive> Archive;
+    FOmniCaptureSettings Settings;
+    int64 FirstFrameOffset = 0;
+};
+
+struct FOmniCaptureReplayOptions
+{
+    FString OutputDirectory;
+    int32 LoopCount = 1;
+    /** Reads every frame into memory before the timed run so disk reads stay out of the numbers. */
+    bool bPreloadFrames = false;
+};
+
+/**
+ * Pushes a recording through CPU conversion, the frame ring, the output writer and the muxer as fast as they accept
+ * frames, with no world or renderer involved. NVENC takes fall back to an image sequence.
+ */
+class OMNICAPTURE_API FOmniCaptureReplayDriver
+{
+public:
+    /** SettingsOverride replaces the recorded settings; it must match the recording's mono/stereo mode. */
+    static bool Run(const FString& ReplayPath, const FOmniCaptureReplayOptions& Options, FOmniCaptureReplayStats& OutStats, const FOmniCaptureSettings* SettingsOverride = nullptr);
+
+    static FString GetReplayPath(const FString& Directory, const FString& BaseName);
+};
@@ -69,6 +69,9 @@ public:
     void Capture(FOmniEyeCapture& OutLeftEye, FOmniEyeCapture& OutRightEye) const;
     void UpdateStereoParameters(float NewIPDCm, float NewConvergenceDistanceCm);
 
+    /** Edge length of the cube face render targets the rig captures into, or 0 before Configure. */
+    int32 GetFaceResolution() const;
+
     FORCEINLINE const FTransform& GetRigTransform() const { return RigRoot->GetComponentTransform(); }
 
 private:
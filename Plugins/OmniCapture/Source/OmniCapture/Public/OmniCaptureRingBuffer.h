@@ -3,36 +3,77 @@
 #include "CoreMinimal.h"
 #include "OmniCaptureTypes.h"
 
+#include <atomic>
+
 class FRunnableThread;
 class FOmniCaptureRingBufferWorker;
 
+/**
+ * Bounded, pre-allocated frame ring between the game thread (single producer) and the consumer workers.
+ * Slots carry sequence numbers so the consumer side claims entries with a CAS; that lets DropOldest evict,
+ * Flush drain from the producer thread and several workers pop concurrently without a lock.
+ *
+ * The consumer may run on several workers at once. The optional commit callback is the ordered stage: it
+ * runs once per consumed frame, never concurrently with itself, in the order frames were enqueued.
+ */
 class OMNICAPTURE_API FOmniCaptureRingBuffer
 {
 public:
     FOmniCaptureRingBuffer();
     ~FOmniCaptureRingBuffer();
 
-    void Initialize(const FOmniCaptureSettings& Settings, const TFunction<void(TUniquePtr<FOmniCaptureFrame>&&)>& InConsumer);
+    /**
+     * @param InConsumer Receives each frame's payload. Called from up to RingBufferWorkerCount threads at once.
+     * @param InCommit   Receives a frame shell holding only Metadata and AudioPackets, strictly in FrameIndex order.
+     */
+    void Initialize(const FOmniCaptureSettings& Settings, const TFunction<void(TUniquePtr<FOmniCaptureFrame>&&)>& InConsumer, const TFunction<void(const FOmniCaptureFrame&)>& InCommit = nullptr);
     void Enqueue(TUniquePtr<FOmniCaptureFrame>&& Frame);
+    /** Drains on the calling thread, then waits until every frame the workers popped has been consumed and committed. */
     void Flush();
     FOmniCaptureRingBufferStats GetStats() const;
 
 private:
+    friend class FOmniCaptureRingBufferWorker;
+
+    struct alignas(PLATFORM_CACHE_LINE_SIZE) FSlot
+    {
+        std::atomic<uint64> Sequence{ 0 };
+        TUniquePtr<FOmniCaptureFrame> Frame;
+    };
+
     void StartWorker();
     void StopWorker();
 
-    TQueue<TUniquePtr<FOmniCaptureFrame>, EQueueMode::Mpsc> Queue;
+    bool TryPush(TUniquePtr<FOmniCaptureFrame>& Frame);
+    bool TryPop(TUniquePtr<FOmniCaptureFrame>& OutFrame, uint64& OutPosition);
+    void Drain();
+    void ReleasePending();
+    void CommitInOrder(uint64 Position, TUniquePtr<FOmniCaptureFrame>&& CommitRecord);
+
+    TUniquePtr<FSlot[]> Slots;
+    uint64 SlotCount = 0;
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> WriteIndex{ 0 };
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> ReadIndex{ 0 };
+
     TFunction<void(TUniquePtr<FOmniCaptureFrame>&&)> Consumer;
+    TFunction<void(const FOmniCaptureFrame&)> Commit;
+
+    // Reorder window keyed by ring position. Positions follow enqueue order, so releasing them contiguously
+    // commits frames in FrameIndex order; dropped frames leave an empty record so the window never stalls.
+    TMap<uint64, TUniquePtr<FOmniCaptureFrame>> PendingCommits;
+    uint64 NextCommitPosition = 0;
+    FCriticalSection CommitCS;
 
-    TUniquePtr<FRunnableThread> WorkerThread;
-    FOmniCaptureRingBufferWorker* Worker = nullptr;
-    FEvent* DataEvent = nullptr;
-    FCriticalSection QueueCriticalSection;
+    TArray<TUniquePtr<FRunnableThread>> WorkerThreads;
+    TArray<FOmniCaptureRingBufferWorker*> Workers;
+    uint32 NextWorkerToWake = 0;
+    FEvent* SpaceEvent = nullptr;
+    FEvent* IdleEvent = nullptr;
     TAtomic<bool> bRunning;
     TAtomic<int32> PendingCount;
     TAtomic<int32> DroppedCount;
     TAtomic<int32> BlockedCount;
     int32 Capacity = 0;
+    int32 WorkerCount = 1;
     EOmniCaptureRingBufferPolicy Policy = EOmniCaptureRingBufferPolicy::DropOldest;
 };
-
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+DECLARE_STATS_GROUP(TEXT("OmniCapture"), STATGROUP_OmniCapture, STATCAT_Advanced);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Scene Capture"), STAT_OmniCapture_SceneCapture, STATGROUP_OmniCapture, OMNICAPTURE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Render Flush"), STAT_OmniCapture_RenderFlush, STATGROUP_OmniCapture, OMNICAPTURE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Conversion"), STAT_OmniCapture_Conversion, STATGROUP_OmniCapture, OMNICAPTURE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Auxiliary Passes"), STAT_OmniCapture_AuxiliaryPasses, STATGROUP_OmniCapture, OMNICAPTURE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ring Enqueue"), STAT_OmniCapture_RingEnqueue, STATGROUP_OmniCapture, OMNICAPTURE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Encode"), STAT_OmniCapture_Encode, STATGROUP_OmniCapture, OMNICAPTURE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Disk Write"), STAT_OmniCapture_DiskWrite, STATGROUP_OmniCapture, OMNICAPTURE_API);
+
+UE_TRACE_CHANNEL_EXTERN(OmniCaptureChannel, OMNICAPTURE_API);
+
+/** Cycle stat plus an Insights CPU event on the OmniCapture trace channel for the rest of the enclosing scope. */
+#define OMNICAPTURE_STAGE_SCOPE(StageName) \
+    SCOPE_CYCLE_COUNTER(STAT_OmniCapture_##StageName); \
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(OmniCapture_##StageName, OmniCaptureChannel)
+
+/**
+ * Collects per-stage frame timings from the game thread, ring workers and image writer tasks.
+ * Keeps a rolling window per stage for percentile queries and, when asked to, every record of the take for export.
+ */
+class OMNICAPTURE_API FOmniCaptureStageProfiler
+{
+public:
+    explicit FOmniCaptureStageProfiler(bool bInKeepTrace, int32 InWindowSize = 1024);
+
+    void Record(int32 FrameIndex, EOmniCaptureStage Stage, double BeginSeconds, double EndSeconds);
+    /** Records every stage present in the metadata's timestamps, each on the thread that stamped it. */
+    void RecordFrame(const FOmniCaptureFrameMetadata& Metadata);
+
+    /** Nearest-rank percentiles over the last window of samples. */
+    FOmniCaptureStageLatency GetLatency(EOmniCaptureStage Stage) const;
+    TArray<FOmniCaptureStageLatency> GetLatencies() const;
+
+    int32 GetTraceRecordCount() const;
+    /** Chrome trace events ("X" phase, one row per thread) or one CSV row per record, in microseconds from the first record. */
+    bool ExportTrace(const FString& FilePath, EOmniCaptureTraceFormat Format) const;
+
+    static const TCHAR* GetStageName(EOmniCaptureStage Stage);
+
+private:
+    struct FRecord
+    {
+        double BeginSeconds = 0.0;
+        double EndSeconds = 0.0;
+        int32 FrameIndex = 0;
+        uint32 ThreadId = 0;
+        EOmniCaptureStage Stage = EOmniCaptureStage::SceneCapture;
+    };
+
+    struct FWindow
+    {
+        TArray<float> DurationsMs;
+        int32 NextSlot = 0;
+    };
+
+    void RecordLocked(int32 FrameIndex, EOmniCaptureStage Stage, double BeginSeconds, double EndSeconds, uint32 ThreadId);
+
+    mutable FCriticalSection CS;
+    FWindow Windows[FOmniCaptureStageTimestamps::NumStages];
+    TArray<FRecord> Records;
+    int32 WindowSize = 1024;
+    bool bKeepTrace = false;
+};
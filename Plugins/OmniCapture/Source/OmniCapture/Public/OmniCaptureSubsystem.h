@@ -6,7 +6,14 @@
 #include "OmniCaptureImageWriter.h"
 #include "OmniCaptureAudioRecorder.h"
 #include "OmniCaptureNVENCEncoder.h"
+#include "OmniCaptureFFmpegPipe.h"
 #include "OmniCaptureMuxer.h"
+#include "OmniCaptureBufferPool.h"
+#include "OmniCaptureReadbackQueue.h"
+#include "OmniCaptureFinalizer.h"
+#include "OmniCaptureStageProfiler.h"
+#include "OmniCaptureReplay.h"
+#include "Containers/Ticker.h"
 #include "Templates/Atomic.h"
 #include "Logging/LogVerbosity.h"
 #include "OmniCaptureOptional.h"
@@ -17,18 +24,7 @@ class AOmniCaptureDirectorActor;
 class AOmniCapturePreviewActor;
 class UTexture2D;
 class IConsoleVariable;
-
-struct FOmniCaptureSegmentRecord
-{
-    int32 SegmentIndex = 0;
-    FString Directory;
-    FString BaseFileName;
-    FString AudioPath;
-    FString VideoPath;
-    TArray<FOmniCaptureFrameMetadata> Frames;
-    int32 DroppedFrames = 0;
-    bool bHasImageSequence = false;
-};
+struct FOmniEyeCapture;
 
 UCLASS()
 class OMNICAPTURE_API UOmniCaptureSubsystem final : public UWorldSubsystem
@@ -60,6 +56,14 @@ public:
     UFUNCTION(BlueprintCallable, Category = "OmniCapture")
     bool CapturePanoramaStill(const FOmniCaptureSettings& InSettings, FString& OutFilePath);
 
+    /** Converts a raw dump (<Base>.omniraw.jsonl) into Settings.ImageFormat files next to it, optionally muxing them with FFmpeg. */
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture")
+    bool TranscodeRawDump(const FString& IndexPath, const FOmniCaptureSettings& Settings, bool bMuxWithFFmpeg);
+
+    /** Runs a recording made with ReplayRecordFrameCount through conversion and output without rendering, LoopCount times. */
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture|Diagnostics")
+    bool ReplayCapture(const FString& ReplayPath, const FString& OutputDirectory, int32 LoopCount, FOmniCaptureReplayStats& OutStats);
+
     UFUNCTION(BlueprintCallable, Category = "OmniCapture")
     bool CanPause() const;
 
@@ -75,6 +79,9 @@ public:
     UFUNCTION(BlueprintCallable, Category = "OmniCapture")
     FOmniCaptureRingBufferStats GetRingBufferStats() const { return LatestRingBufferStats; }
 
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture")
+    FOmniCaptureImageWriterStats GetImageWriterStats() const { return ImageWriter ? ImageWriter->GetStats() : FOmniCaptureImageWriterStats(); }
+
     UFUNCTION(BlueprintCallable, Category = "OmniCapture")
     FOmniAudioSyncStats GetAudioSyncStats() const;
 
@@ -93,6 +100,25 @@ public:
     UFUNCTION(BlueprintCallable, Category = "OmniCapture")
     FString GetLastFinalizedOutputPath() const { return LastFinalizedOutput; }
 
+    /** Segments still draining or muxing in the background after rotation or EndCapture. */
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture")
+    FOmniCaptureFinalizationProgress GetFinalizationProgress() const;
+
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture")
+    bool IsFinalizing() const;
+
+    /** Blocks until every submitted segment is finalized and its result has been handled. */
+    void WaitForFinalization();
+
+    FOmniCaptureSegmentFinalizedDelegate& OnSegmentFinalized() { return SegmentFinalizedDelegate; }
+
+    /** Rolling p50/p95/p99 of one pipeline stage over the current or most recent capture. */
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture|Diagnostics")
+    FOmniCaptureStageLatency GetStageLatency(EOmniCaptureStage Stage) const;
+
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture|Diagnostics")
+    TArray<FOmniCaptureStageLatency> GetStageLatencies() const;
+
     UFUNCTION(BlueprintCallable, Category = "OmniCapture")
     FString GetLastStillImagePath() const { return LastStillImagePath; }
 
@@ -109,6 +135,7 @@ public:
     FString GetLastErrorMessage() const { return LastErrorMessage; }
 
     void SetPendingRigTransform(const FTransform& InTransform);
+    FOmniCaptureBufferPoolStats GetBufferPoolStats() const { return BufferPool.IsValid() ? BufferPool->GetStats() : FOmniCaptureBufferPoolStats(); }
 
 private:
     void CreateRig();
@@ -122,6 +149,11 @@ private:
     void InitializeOutputWriters();
     void ShutdownOutputWriters(bool bFinalizeOutputs);
     void FinalizeOutputs(bool bFinalizeOutputs);
+    void SubmitActiveSegmentForFinalization();
+    bool TickFinalization(float DeltaTime);
+    void HandleFinalizeResult(const FOmniCaptureFinalizeResult& Result);
+    /** Writes the take's stage trace once nothing can add records to it any more. */
+    void ExportPendingStageTrace();
 
     bool ValidateEnvironment();
     bool ApplyFallbacks(FString* OutFailureReason = nullptr);
@@ -131,6 +163,11 @@ private:
 
     void TickCapture(float DeltaTime);
     void CaptureFrame();
+    void RecordReplayFrame(const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye);
+    FOmniCaptureFrameMetadata MakeFrameMetadata();
+    void SubmitConvertedFrame(FOmniCaptureEquirectResult& ConversionResult, TMap<FName, FOmniCaptureLayerPayload>&& AuxiliaryLayers, const FOmniCaptureFrameMetadata& Metadata);
+    void SubmitCompletedReadbacks();
+    void DrainReadbackQueue();
     void FlushRingBuffer();
     void UpdateDynamicStereoParameters();
     void ApplyRenderFeatureOverrides();
@@ -138,6 +175,7 @@ private:
 
     void HandleDroppedFrame();
 
+    void GetSegmentOutputLocation(int32 SegmentIndex, FString& OutDirectory, FString& OutFileName) const;
     void ConfigureActiveSegment();
     void RotateSegmentIfNeeded();
     void CompleteActiveSegment(bool bStoreResults);
@@ -190,8 +228,9 @@ private:
     double LastFpsSampleTime = 0.0;
     int32 FramesSinceLastFpsSample = 0;
     double LastRuntimeWarningCheckTime = 0.0;
-    double LastSegmentSizeCheckTime = 0.0;
     double CurrentSegmentStartTime = 0.0;
+    double LastPipeOutputSizeCheckTime = 0.0;
+    int64 PipeOutputBytes = 0;
     int32 CurrentSegmentIndex = 0;
     double DynamicParameterStartTime = 0.0;
     float LastDynamicInterPupillaryDistance = -1.0f;
@@ -205,7 +244,17 @@ private:
     TUniquePtr<FOmniCaptureImageWriter> ImageWriter;
     TUniquePtr<FOmniCaptureAudioRecorder> AudioRecorder;
     TUniquePtr<FOmniCaptureNVENCEncoder> NVENCEncoder;
+    TUniquePtr<FOmniCaptureFFmpegPipe> FFmpegPipe;
     TUniquePtr<FOmniCaptureMuxer> OutputMuxer;
+    TSharedPtr<FOmniCaptureBufferPool, ESPMode::ThreadSafe> BufferPool;
+    TUniquePtr<FOmniCaptureReadbackQueue> ReadbackQueue;
+    TUniquePtr<FOmniCaptureFinalizer> Finalizer;
+    FTSTicker::FDelegateHandle FinalizationTickerHandle;
+    FOmniCaptureSegmentFinalizedDelegate SegmentFinalizedDelegate;
+    TSharedPtr<FOmniCaptureStageProfiler, ESPMode::ThreadSafe> StageProfiler;
+    FString PendingStageTracePath;
+    EOmniCaptureTraceFormat PendingStageTraceFormat = EOmniCaptureTraceFormat::None;
+    TUniquePtr<FOmniCaptureReplayWriter> ReplayWriter;
 
     TAtomic<bool> bUsingNVENCImageFallback{ false };
     bool bCapturedImageSequenceThisSegment = false;
@@ -215,6 +264,8 @@ private:
     TArray<FOmniCaptureFrameMetadata> CapturedFrameMetadata;
     TArray<FOmniCaptureSegmentRecord> CompletedSegments;
     FString RecordedAudioPath;
+    /** Pending close of RecordedAudioPath after a rotation; handed to the segment's finalize job. */
+    TFuture<FString> RecordedAudioClosed;
     FString RecordedVideoPath;
     FString LastFinalizedOutput;
     FString LastStillImagePath;
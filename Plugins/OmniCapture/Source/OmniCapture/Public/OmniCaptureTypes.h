@@ -7,6 +7,7 @@
 #include "ImagePixelData.h"
 #include "RenderGraphResources.h"
 #include "Misc/DateTime.h"
+#include "HAL/PlatformTLS.h"
 #include "OmniCaptureTypes.generated.h"
 
 namespace OmniCapture
@@ -55,11 +56,12 @@ enum class EOmniOutputFormat : uint8
 {
 	ImageSequence = 0 UMETA(DisplayName = "Image Sequence"),
 	NVENCHardware = 1 UMETA(DisplayName = "NVENC Hardware"),
+	FFmpegPipe = 2 UMETA(DisplayName = "FFmpeg Pipe", ToolTip = "Streams raw frames into an FFmpeg process over stdin and encodes while capturing"),
 	PNGSequence = ImageSequence UMETA(Hidden),
 };
 
 UENUM(BlueprintType)
-enum class EOmniCaptureImageFormat : uint8 { PNG, JPG, EXR, BMP };
+enum class EOmniCaptureImageFormat : uint8 { PNG, JPG, EXR, BMP, RawDump UMETA(DisplayName = "Raw Dump", ToolTip = "Unencoded payloads streamed into preallocated segment files; convert afterwards with UOmniCaptureSubsystem::TranscodeRawDump") };
 
 UENUM(BlueprintType)
 enum class EOmniCaptureEXRCompression : uint8
@@ -73,6 +75,13 @@ enum class EOmniCaptureEXRCompression : uint8
     Dwab,
     Rle
 };
+
+UENUM(BlueprintType)
+enum class EOmniCaptureEXRLayout : uint8
+{
+    Scanline,
+    Tiled
+};
 UENUM(BlueprintType)
 enum class EOmniCaptureHDRPrecision : uint8
 {
@@ -108,6 +117,15 @@ enum class EOmniCapturePNGBitDepth : uint8
         BitDepth8 = 2 UMETA(DisplayName = "8-bit Color")
 };
 
+UENUM(BlueprintType)
+enum class EOmniCapturePNGFilter : uint8
+{
+        None,
+        Sub,
+        Up,
+        Adaptive UMETA(ToolTip = "Picks the best of all five PNG filters per row")
+};
+
 UENUM(BlueprintType)
 enum class EOmniCaptureColorSpace : uint8 { BT709, BT2020, HDR10 };
 
@@ -133,6 +151,31 @@ enum class EOmniCaptureState : uint8 { Idle, Recording, Paused, DroppedFrames, F
 UENUM(BlueprintType)
 enum class EOmniCaptureRingBufferPolicy : uint8 { DropOldest, BlockProducer };
 
+UENUM(BlueprintType)
+enum class EOmniCaptureStage : uint8
+{
+        SceneCapture,
+        RenderFlush,
+        Readback UMETA(ToolTip = "Asynchronous GPU conversion and readback, from submission until the game thread collects it"),
+        Conversion,
+        AuxiliaryPasses,
+        RingBuffer UMETA(ToolTip = "From ring enqueue until a ring worker picks the frame up"),
+        Encode UMETA(ToolTip = "Hand-off to NVENC, FFmpeg or the image writer queue on a ring worker"),
+        DiskWrite UMETA(ToolTip = "Image encoding and file write on the thread pool"),
+        Count UMETA(Hidden)
+};
+
+UENUM(BlueprintType)
+enum class EOmniCaptureTraceFormat : uint8
+{
+        None,
+        ChromeTrace UMETA(DisplayName = "Chrome Trace JSON"),
+        CSV
+};
+
+UENUM(BlueprintType)
+enum class EOmniCaptureCPUSampling : uint8 { Nearest, Bilinear };
+
 UENUM(BlueprintType)
 enum class EOmniCapturePreviewView : uint8 { StereoComposite, LeftEye, RightEye };
 
@@ -240,28 +283,46 @@ struct OMNICAPTURE_API FOmniCaptureSettings
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") EOmniCaptureImageFormat ImageFormat = EOmniCaptureImageFormat::PNG;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") EOmniCaptureHDRPrecision HDRPrecision = EOmniCaptureHDRPrecision::HalfFloat;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") EOmniCapturePNGBitDepth PNGBitDepth = EOmniCapturePNGBitDepth::BitDepth32;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|PNG", meta = (ToolTip = "Filter and deflate horizontal strips on all cores and stitch them into one PNG. Falls back to single-threaded libpng when disabled.")) bool bParallelPNGEncoding = true;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|PNG", meta = (ClampMin = 0, UIMin = 0, ClampMax = 9, UIMax = 9)) int32 PNGCompressionLevel = 6;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|PNG") EOmniCapturePNGFilter PNGFilter = EOmniCapturePNGFilter::Adaptive;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") FString OutputDirectory;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") FString OutputFileName = TEXT("OmniCapture");
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") EOmniCaptureColorSpace ColorSpace = EOmniCaptureColorSpace::BT709;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") bool bEnableFastStart = true;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output", meta = (ToolTip = "Ordered dither instead of rounding when linear frames are quantized for PNG, JPEG and BMP output")) bool bDitherQuantization = false;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|EXR") bool bPackEXRAuxiliaryLayers = true;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|EXR") bool bUseEXRMultiPart = false;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|Raw", meta = (ClampMin = 64, UIMin = 64)) int32 RawDumpSegmentSizeMB = 4096;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|FFmpeg", meta = (ClampMin = 1, UIMin = 1, ToolTip = "Frames buffered ahead of the FFmpeg pipe before capture blocks")) int32 FFmpegPipeQueueDepth = 8;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|EXR") EOmniCaptureEXRCompression EXRCompression = EOmniCaptureEXRCompression::Zip;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|EXR", meta = (ToolTip = "Layout of packed multi-layer EXR files")) EOmniCaptureEXRLayout EXRLayout = EOmniCaptureEXRLayout::Scanline;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|EXR", meta = (ClampMin = 16, UIMin = 16, EditCondition = "EXRLayout == EOmniCaptureEXRLayout::Tiled")) int32 EXRTileSize = 64;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|EXR", meta = (ClampMin = 0, UIMin = 0, ToolTip = "Threads OpenEXR compresses line blocks and tiles on; 0 uses one per worker thread. The pool is shared by the process and never shrinks")) int32 EXRThreadCount = 0;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") bool bForceConstantFrameRate = true;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") bool bAllowNVENCFallback = true;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output", meta = (ClampMin = 1, UIMin = 1)) int32 MaxPendingImageTasks = 8;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output", meta = (ClampMin = 1, UIMin = 1, ToolTip = "Completed segments whose writers are drained and muxed in parallel off the game thread")) int32 MaxConcurrentFinalizeJobs = 2;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output", meta = (ClampMin = 0, UIMin = 0, ToolTip = "Upper bound on pixel data (main frame plus auxiliary layers) queued for image writing. Capture waits for writes to finish once it is reached. 0 only limits the task count.")) int32 MaxPendingImageMemoryMB = 4096;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output", meta = (ClampMin = 0, UIMin = 0, ToolTip = "Upper bound on idle frame buffers kept for reuse across frames. 0 disables pooling.")) int32 BufferPoolSizeMB = 2048;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Diagnostics", meta = (ClampMin = 0)) int32 MinimumFreeDiskSpaceGB = 2;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Diagnostics", meta = (ToolTip = "Keeps every frame's stage timings and writes them next to the manifest when the capture ends")) EOmniCaptureTraceFormat StageTraceFormat = EOmniCaptureTraceFormat::None;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Diagnostics", meta = (ClampMin = 0, ToolTip = "Records the cube faces of the first N frames to <Base>.omnireplay for UOmniCaptureSubsystem::ReplayCapture. Reads every face back on the game thread, so expect a slow start")) int32 ReplayRecordFrameCount = 0;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Diagnostics", meta = (ClampMin = 0.1, ClampMax = 1.0)) float LowFrameRateWarningRatio = 0.85f;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") FString PreferredFFmpegPath;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 0.0, ClampMax = 1.0)) float SeamBlend = 0.25f;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 0.0, ClampMax = 1.0)) float PolarDampening = 0.5f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ToolTip = "Filtering used by the CPU projection fallback. Nearest is fastest, Bilinear blends across cube face seams.")) EOmniCaptureCPUSampling CPUSampling = EOmniCaptureCPUSampling::Nearest;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 0, UIMin = 0, ClampMax = 8, UIMax = 8, ToolTip = "GPU readbacks kept in flight so the game thread does not wait on the GPU. 0 reads every frame back synchronously. Applies to image sequences of cube projections without auxiliary passes.")) int32 ReadbackQueueDepth = 3;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") FOmniCaptureQuality Quality;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC") EOmniCaptureCodec Codec = EOmniCaptureCodec::HEVC;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC") EOmniCaptureColorFormat NVENCColorFormat = EOmniCaptureColorFormat::NV12;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC") bool bZeroCopy = true;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC") EOmniCaptureNVENCD3D12Interop D3D12InteropMode = EOmniCaptureNVENCD3D12Interop::Bridge;
-        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC", meta = (ClampMin = 0, UIMin = 0)) int32 RingBufferCapacity = 6;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC", meta = (ToolTip = "Write <Base>.mp4 with the captured audio directly while encoding, so finalization needs no FFmpeg. When disabled a raw Annex B stream is written and remuxed with FFmpeg.")) bool bNativeMP4Muxing = true;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC", meta = (ClampMin = 0, UIMin = 0, ToolTip = "Frames the pre-allocated ring between capture and the writers can hold before RingBufferPolicy applies. 0 selects 64 slots; it no longer means unbounded.")) int32 RingBufferCapacity = 6;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC") EOmniCaptureRingBufferPolicy RingBufferPolicy = EOmniCaptureRingBufferPolicy::DropOldest;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC", meta = (ClampMin = 1, UIMin = 1, ClampMax = 16, UIMax = 16, ToolTip = "Worker threads draining the frame ring. Frames are dispatched in parallel and committed in FrameIndex order. NVENC output always uses one worker.")) int32 RingBufferWorkerCount = 1;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC") FString NVENCRuntimeDirectory;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC") FString NVENCDllPathOverride;
         UPROPERTY(meta = (DeprecatedProperty, DeprecationMessage = "Use NVENCRuntimeDirectory instead.")) FString AVEncoderModulePathOverride_DEPRECATED;
@@ -283,6 +344,8 @@ struct OMNICAPTURE_API FOmniCaptureSettings
         FIntPoint GetFisheyeResolution() const;
         FIntPoint GetOutputResolution() const;
         FIntPoint GetPerEyeOutputResolution() const;
+        /** Largest preview image for the output: a 1024 pixel long edge scaled by PreviewScreenScale, never above the output. */
+        FIntPoint GetPreviewResolution() const;
         bool IsStereo() const;
         bool IsVR180() const;
         bool IsFisheye() const;
@@ -333,6 +396,43 @@ struct FOmniAudioPacket
 	UPROPERTY() TArray<int16> PCM16;
 };
 
+/** When each pipeline stage ran for one frame, as millisecond offsets from the frame's first stage. */
+struct FOmniCaptureStageTimestamps
+{
+        static constexpr int32 NumStages = static_cast<int32>(EOmniCaptureStage::Count);
+
+        /** FPlatformTime::Seconds() at the first recorded stage. */
+        double Origin = 0.0;
+        float BeginMs[NumStages] = {};
+        float EndMs[NumStages] = {};
+        /** Thread that stamped each stage, so exported traces keep one lane per thread. */
+        uint32 ThreadIds[NumStages] = {};
+        uint16 StageMask = 0;
+
+        void Record(EOmniCaptureStage Stage, double BeginSeconds, double EndSeconds)
+        {
+                Record(Stage, BeginSeconds, EndSeconds, FPlatformTLS::GetCurrentThreadId());
+        }
+
+        void Record(EOmniCaptureStage Stage, double BeginSeconds, double EndSeconds, uint32 ThreadId)
+        {
+                if (StageMask == 0)
+                {
+                        Origin = BeginSeconds;
+                }
+                const int32 Index = static_cast<int32>(Stage);
+                BeginMs[Index] = static_cast<float>((BeginSeconds - Origin) * 1000.0);
+                EndMs[Index] = static_cast<float>((EndSeconds - Origin) * 1000.0);
+                ThreadIds[Index] = ThreadId;
+                StageMask |= static_cast<uint16>(1u << Index);
+        }
+
+        bool HasStage(EOmniCaptureStage Stage) const { return (StageMask & (1u << static_cast<int32>(Stage))) != 0; }
+        double GetBeginSeconds(EOmniCaptureStage Stage) const { return Origin + BeginMs[static_cast<int32>(Stage)] / 1000.0; }
+        double GetEndSeconds(EOmniCaptureStage Stage) const { return Origin + EndMs[static_cast<int32>(Stage)] / 1000.0; }
+        uint32 GetThreadId(EOmniCaptureStage Stage) const { return ThreadIds[static_cast<int32>(Stage)]; }
+};
+
 USTRUCT()
 struct FOmniCaptureFrameMetadata
 {
@@ -340,6 +440,7 @@ struct FOmniCaptureFrameMetadata
         UPROPERTY() int32 FrameIndex = 0;
         UPROPERTY() double Timecode = 0.0;
         UPROPERTY() bool bKeyFrame = false;
+        FOmniCaptureStageTimestamps StageTimestamps;
 };
 
 struct FOmniCaptureLayerPayload
@@ -375,6 +476,51 @@ struct FOmniCaptureRingBufferStats
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 BlockedPushes = 0;
 };
 
+USTRUCT(BlueprintType)
+struct FOmniCaptureImageWriterStats
+{
+	GENERATED_BODY()
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 PendingTasks = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int64 InFlightBytes = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int64 PeakInFlightBytes = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int64 BudgetBytes = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 BudgetStalls = 0;
+};
+
+USTRUCT(BlueprintType)
+struct FOmniCaptureFinalizationProgress
+{
+	GENERATED_BODY()
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 QueuedSegments = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 RunningSegments = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 CompletedSegments = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 FailedSegments = 0;
+};
+
+USTRUCT(BlueprintType)
+struct FOmniCaptureStageLatency
+{
+	GENERATED_BODY()
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") EOmniCaptureStage Stage = EOmniCaptureStage::SceneCapture;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 SampleCount = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") float P50Ms = 0.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") float P95Ms = 0.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") float P99Ms = 0.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") float MaxMs = 0.0f;
+};
+
+USTRUCT(BlueprintType)
+struct FOmniCaptureReplayStats
+{
+	GENERATED_BODY()
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 FramesReplayed = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 DroppedFrames = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") double ElapsedSeconds = 0.0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") double FramesPerSecond = 0.0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") bool bMuxed = false;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") TArray<FOmniCaptureStageLatency> StageLatencies;
+};
+
 USTRUCT(BlueprintType)
 struct FOmniAudioSyncStats
 {
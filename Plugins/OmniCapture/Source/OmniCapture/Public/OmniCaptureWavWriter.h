@@ -0,0 +1,88 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureAudioRing.h"
+#include "Async/Future.h"
+#include "Templates/Atomic.h"
+
+class FArchive;
+class FEvent;
+class FRunnableThread;
+class FOmniCaptureWavWriterThread;
+
+/**
+ * Streams 16-bit PCM to a .wav file while recording. The audio thread pushes submix buffers into an SPSC ring and a
+ * writer thread appends them to disk, patching the RIFF and data sizes about once a second so a file cut short by a
+ * crash still opens with everything up to the last patch.
+ *
+ * The file format is taken from the first buffer; later buffers with a different rate or channel count are dropped.
+ */
+class OMNICAPTURE_API FOmniCaptureWavWriter
+{
+public:
+    FOmniCaptureWavWriter();
+    ~FOmniCaptureWavWriter();
+
+    bool Open(const FString& InFilePath);
+
+    /** Audio thread. Returns false when the ring is full and the buffer was dropped. */
+    bool Push(const float* Samples, int32 NumSamples, int32 NumChannels, int32 SampleRate, double Timestamp, float Gain);
+
+    /**
+     * Everything pushed before the call ends up in the current file and everything after it in NewFilePath, so
+     * consecutive files join without a gap or overlap. Returns at once; the writer thread rotates the files when it
+     * reaches the boundary and then fulfils the future with the closed file's path.
+     */
+    TFuture<FString> Split(const FString& NewFilePath);
+
+    /** Drains what is queued, finishes any outstanding splits, writes the final header and closes the file. Returns its path. */
+    FString Close();
+
+    const FString& GetFilePath() const { return FilePath; }
+    /** PCM bytes written to the current file so far. */
+    int64 GetDataBytesWritten() const { return DataBytesWritten.Load(); }
+    int32 GetDroppedBufferCount() const { return DroppedBuffers.Load(); }
+
+    /** Canonical 44-byte PCM16 header. */
+    static void WriteHeader(FArchive& Archive, int32 SampleRate, int32 NumChannels, int64 DataBytes);
+
+private:
+    friend class FOmniCaptureWavWriterThread;
+
+    struct FSplitRequest
+    {
+        uint64 BoundaryChunk = 0;
+        FString FilePath;
+        TPromise<FString> Closed;
+    };
+
+    void RunWriter();
+    void ProcessSplits();
+    void DrainChunks(int32 MaxChunks);
+    bool OpenFile(const FString& InFilePath);
+    void CloseFile();
+    void PatchHeader();
+
+    // Game thread view: the file the next pushed buffer will land in once the writer catches up.
+    FString FilePath;
+    FOmniCaptureAudioRing Ring;
+
+    FOmniCaptureWavWriterThread* Runnable = nullptr;
+    TUniquePtr<FRunnableThread> Thread;
+    FEvent* WakeEvent = nullptr;
+    TAtomic<bool> bRunning{ false };
+
+    // Split markers in push order, guarded by SplitCS: the game thread queues them and the writer retires them.
+    FCriticalSection SplitCS;
+    TArray<FSplitRequest> PendingSplits;
+
+    // Owned by the writer thread while it runs.
+    FString WriterFilePath;
+    TUniquePtr<FArchive> Archive;
+    int32 FileSampleRate = 0;
+    int32 FileChannels = 0;
+    double LastPatchTime = 0.0;
+
+    TAtomic<int64> DataBytesWritten{ 0 };
+    TAtomic<int32> DroppedBuffers{ 0 };
+};
@@ -78,6 +78,8 @@ namespace
         {
         case EOmniOutputFormat::NVENCHardware:
             return LOCTEXT("OutputFormatNVENC", "NVENC (MP4)");
+        case EOmniOutputFormat::FFmpegPipe:
+            return LOCTEXT("OutputFormatFFmpegPipe", "FFmpeg Pipe (MP4)");
         case EOmniOutputFormat::ImageSequence:
         default:
             return LOCTEXT("OutputFormatImageSequence", "Image Sequence");
@@ -249,6 +251,7 @@ void SOmniCaptureControlPanel::Construct(const FArguments& InArgs)
     OutputFormatOptions.Reset();
     OutputFormatOptions.Add(MakeShared<TEnumOptionValue<EOmniOutputFormat>>(EOmniOutputFormat::NVENCHardware));
     OutputFormatOptions.Add(MakeShared<TEnumOptionValue<EOmniOutputFormat>>(EOmniOutputFormat::ImageSequence));
+    OutputFormatOptions.Add(MakeShared<TEnumOptionValue<EOmniOutputFormat>>(EOmniOutputFormat::FFmpegPipe));
 
     CodecOptions.Reset();
     CodecOptions.Add(MakeShared<TEnumOptionValue<EOmniCaptureCodec>>(EOmniCaptureCodec::HEVC));
@@ -2469,6 +2472,10 @@ bool SOmniCaptureControlPanel::IsOutputFormatSelectable(EOmniOutputFormat Format
     {
         return FeatureAvailability.NVENC.bAvailable;
     }
+    if (Format == EOmniOutputFormat::FFmpegPipe)
+    {
+        return FeatureAvailability.FFmpeg.bAvailable;
+    }
     return true;
 }
 
@@ -2478,6 +2485,10 @@ FText SOmniCaptureControlPanel::GetOutputFormatTooltip(EOmniOutputFormat Format)
     {
         return FeatureAvailability.NVENC.Reason;
     }
+    if (Format == EOmniOutputFormat::FFmpegPipe && !FeatureAvailability.FFmpeg.bAvailable)
+    {
+        return FeatureAvailability.FFmpeg.Reason;
+    }
     return LOCTEXT("OutputFormatTooltip", "Choose the capture output format.");
 }
 
@@ -3001,7 +3012,7 @@ void SOmniCaptureControlPanel::ApplyProjection(EOmniCaptureProjection Projection
 
 void SOmniCaptureControlPanel::ApplyOutputFormat(EOmniOutputFormat Format)
 {
-    const bool bPreferNVENC = Format != EOmniOutputFormat::ImageSequence;
+    const bool bPreferNVENC = Format == EOmniOutputFormat::NVENCHardware;
     ModifyCaptureSettings([this, Format, bPreferNVENC](FOmniCaptureSettings& Settings)
     {
         Settings.OutputFormat = Format;